@@ -0,0 +1,260 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * Arena.c - the allocation arena owned by each XConfigRec.
+ *
+ * The XConfigRec itself, and every section, subsection, option, mode,
+ * comment and pooled string hanging off of it, is carved out of the
+ * config's arena by bumping a pointer through large blocks.  Nothing in
+ * the tree is freed individually: removing a node from the tree only
+ * unlinks it, and xconfigFreeConfig() releases the whole config by
+ * freeing the arena's blocks.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+
+/* most allocations are carved out of blocks of this many bytes */
+#define ARENA_BLOCK_SIZE 8192
+
+/* allocations larger than this get a block of their own */
+#define ARENA_LARGE_SIZE (ARENA_BLOCK_SIZE / 4)
+
+typedef union {
+    void *p;
+    long l;
+    double d;
+} XConfigArenaAlignRec;
+
+#define ARENA_ALIGN sizeof(XConfigArenaAlignRec)
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+typedef struct __XConfigArenaBlockRec {
+    struct __XConfigArenaBlockRec *next;
+    XConfigArenaAlignRec align;    /* start of the block's storage */
+} XConfigArenaBlockRec, *XConfigArenaBlockPtr;
+
+#define ARENA_BLOCK_HEADER offsetof(XConfigArenaBlockRec, align)
+
+struct __XConfigArenaRec {
+    XConfigArenaBlockPtr blocks;   /* current block first */
+    char *free;                    /* unused space in the current block */
+    size_t avail;                  /* bytes available at free */
+    void *grown;                   /* the last allocation moved by */
+    size_t grownSize;              /* xconfigArenaGrow(), and its size */
+};
+
+
+/*
+ * ArenaAlloc() - return size bytes of zeroed, suitably aligned storage
+ * from the arena.
+ */
+
+static void *ArenaAlloc(XConfigArenaPtr arena, size_t size)
+{
+    XConfigArenaBlockPtr block;
+    void *m;
+
+    size = ARENA_ROUND(size);
+
+    if (size > ARENA_LARGE_SIZE) {
+
+        /*
+         * give a large allocation its own block, behind the current
+         * one so that the space left in the current block is not lost
+         */
+
+        block = xconfigAlloc(ARENA_BLOCK_HEADER + size);
+
+        if (arena->blocks) {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        } else {
+            arena->blocks = block;
+        }
+
+        return &block->align;
+    }
+
+    if (arena->avail < size) {
+        block = xconfigAlloc(ARENA_BLOCK_HEADER + ARENA_BLOCK_SIZE);
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->free = (char *) &block->align;
+        arena->avail = ARENA_BLOCK_SIZE;
+    }
+
+    m = arena->free;
+    arena->free += size;
+    arena->avail -= size;
+
+    return m;
+}
+
+
+/*
+ * xconfigAllocConfig() - allocate an empty config, along with the arena
+ * that will hold it and the string pool for its strings.
+ */
+
+XConfigPtr xconfigAllocConfig(void)
+{
+    XConfigArenaPtr arena = xconfigAlloc(sizeof(XConfigArenaRec));
+    XConfigPtr config = ArenaAlloc(arena, sizeof(XConfigRec));
+
+    config->arena = arena;
+    config->strings = xconfigAllocStringPool(config);
+
+    return config;
+}
+
+
+/*
+ * xconfigFreeArena() - release every block of the arena, and with them
+ * everything that was allocated from it.
+ */
+
+void xconfigFreeArena(XConfigArenaPtr *arena)
+{
+    XConfigArenaBlockPtr block, next;
+
+    if (arena == NULL || *arena == NULL)
+        return;
+
+    for (block = (*arena)->blocks; block; block = next) {
+        next = block->next;
+        free(block);
+    }
+
+    free(*arena);
+    *arena = NULL;
+}
+
+
+/*
+ * xconfigAdoptConfig() - make everything allocated from from's arena
+ * live as long as config does, and add from's strings to config's
+ * string pool; config can then refer to anything in from.  from is
+ * released along with config, and must not be freed or allocated from
+ * itself.
+ */
+
+void xconfigAdoptConfig(XConfigPtr config, XConfigPtr from)
+{
+    XConfigArenaPtr arena = config->arena, fromArena = from->arena;
+    XConfigArenaBlockPtr last;
+
+    xconfigMergeStringPool(config, from);
+
+    /*
+     * add from's blocks behind config's current block, so that the
+     * space left in it is still used
+     */
+
+    for (last = fromArena->blocks; last->next; last = last->next);
+
+    last->next = arena->blocks->next;
+    arena->blocks->next = fromArena->blocks;
+
+    free(fromArena);
+}
+
+
+/*
+ * xconfigArenaAlloc() - return size bytes of zeroed storage that live
+ * as long as config does; this never fails.
+ */
+
+void *xconfigArenaAlloc(XConfigPtr config, size_t size)
+{
+    return ArenaAlloc(config->arena, size);
+}
+
+
+/*
+ * xconfigArenaGrow() - resize the allocation at ptr, originally of
+ * oldSize bytes, to newSize bytes; the contents are preserved and any
+ * new bytes are zero.  The most recent allocation is grown in place
+ * when there is room, which is the common case when a comment is
+ * built up one line at a time.  Otherwise the allocation is moved to
+ * one twice the size needed, and the next growth of it is done within
+ * that space; this keeps a comment that is appended to between other
+ * allocations, such as the config's top level comment, from being
+ * copied for every line.
+ */
+
+void *xconfigArenaGrow(XConfigPtr config, void *ptr,
+                       size_t oldSize, size_t newSize)
+{
+    XConfigArenaPtr arena = config->arena;
+    size_t oldRounded = ARENA_ROUND(oldSize);
+    size_t newRounded = ARENA_ROUND(newSize);
+    void *m;
+
+    if (ptr == NULL) {
+        return ArenaAlloc(arena, newSize);
+    }
+
+    if (newRounded <= oldRounded) {
+        return ptr;
+    }
+
+    if (ptr == arena->grown && newRounded <= arena->grownSize) {
+        return ptr;
+    }
+
+    if ((char *) ptr + oldRounded == arena->free &&
+        newRounded - oldRounded <= arena->avail) {
+        arena->free += newRounded - oldRounded;
+        arena->avail -= newRounded - oldRounded;
+        return ptr;
+    }
+
+    m = ArenaAlloc(arena, 2 * newRounded);
+    memcpy(m, ptr, oldSize);
+
+    arena->grown = m;
+    arena->grownSize = 2 * newRounded;
+
+    return m;
+}
+
+
+/*
+ * xconfigArenaStrdup() - return a modifiable copy of s that lives as
+ * long as config does; NULL is returned unchanged.
+ */
+
+char *xconfigArenaStrdup(XConfigPtr config, const char *s)
+{
+    size_t len;
+    char *m;
+
+    if (!s) return NULL;
+
+    len = strlen(s);
+    m = ArenaAlloc(config->arena, len + 1);
+    memcpy(m, s, len);
+
+    return m;
+}
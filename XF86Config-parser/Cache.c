@@ -0,0 +1,1172 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * Cache.c - an on-disk cache of parsed and validated configs.
+ *
+ * xconfigReadConfigFileCached() saves the config returned by
+ * xconfigReadConfigFile() to a cache file.  As long as the config file
+ * is unchanged, later calls load the config from the cache instead of
+ * parsing and validating the config file again.  The cache is keyed by
+ * the path, device, inode, mtime and size of the config file, and by a
+ * hash of its contents.  A cache that is missing, stale or damaged is
+ * ignored and rewritten.
+ *
+ * The cache holds the config in a compact serialization, written and
+ * read by the same Xfer*() functions, so that the two cannot disagree.
+ * References between sections (a screen's device, for example) are
+ * stored as indices into the list they refer to.  Values are stored in
+ * the host's byte order and sizes; the cache is only meaningful on the
+ * machine, and to the version of the parser, that wrote it.
+ *
+ * The same functions also copy a config in memory, for
+ * xconfigCopyConfig(): each node is copied whole and then transferred
+ * in place, which pools its strings in the copy, copies its comments
+ * and lists, and points its references at the copies of the nodes they
+ * referred to.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+
+/* bump whenever the serialization below changes */
+#define CACHE_VERSION 1
+
+#define CACHE_MAGIC "NVXCACHE"
+
+typedef struct {
+    char magic[8];
+    unsigned int version;
+    unsigned int sizes;             /* sizes of the host's types */
+    unsigned long long dev;
+    unsigned long long ino;
+    unsigned long long mtime;
+    unsigned long long size;
+    unsigned long long hash;        /* of the config file's contents */
+} CacheKeyRec;
+
+typedef struct {
+    GenericListPtr *nodes;          /* when reading, the list's nodes */
+    int count;
+} CacheListRec;
+
+typedef struct {
+    const void *node;               /* a node of a list */
+    void *copy;                     /* when copying, the node's copy */
+    const CacheListRec *list;       /* when writing, the node's list */
+    int index;                      /* ... and its index in it */
+} CacheNodeSlotRec;
+
+/* the config's own lists, by the offset of their heads in XConfigRec */
+#define CACHE_CONFIG_LISTS (sizeof(XConfigRec) / sizeof(GenericListPtr))
+
+typedef struct {
+    XConfigPtr config;              /* being written, or read into */
+    FILE *file;                     /* when writing */
+    const char *data;               /* when reading */
+    size_t len;
+    size_t pos;
+    int error;
+    int copying;                    /* into config, from the nodes */
+    CacheNodeSlotRec *nodes;        /* ... found by node address */
+    size_t nodesMask;
+    size_t nodesCount;
+    CacheListRec lists[CACHE_CONFIG_LISTS];
+} CacheStreamRec, *CacheStreamPtr;
+
+typedef void (*CacheXferFunc)(CacheStreamPtr s, void *node);
+
+
+/*
+ * ContentHash() - 64-bit FNV-1a hash of the config file's contents
+ */
+
+static unsigned long long ContentHash(const char *data, size_t len)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h = (h ^ (unsigned char) data[i]) * 1099511628211ULL;
+    }
+
+    return h;
+}
+
+
+/*
+ * GetCacheKey() - fill in the cache key for the config file open in
+ * the given parser; returns FALSE if the file cannot be stat(2)ed.
+ */
+
+static int GetCacheKey(XConfigParserPtr parser, CacheKeyRec *key)
+{
+    struct stat st;
+
+    if (!parser->path || stat(parser->path, &st) != 0) {
+        return FALSE;
+    }
+
+    memset(key, 0, sizeof(*key));
+    memcpy(key->magic, CACHE_MAGIC, sizeof(key->magic));
+    key->version = CACHE_VERSION;
+    key->sizes = sizeof(int) | (sizeof(long) << 8) |
+                 (sizeof(float) << 16) | (sizeof(size_t) << 24);
+    key->dev = st.st_dev;
+    key->ino = st.st_ino;
+    key->mtime = st.st_mtime;
+    key->size = st.st_size;
+    key->hash = ContentHash(parser->data, parser->dataLen);
+
+    return TRUE;
+}
+
+
+
+/*
+ * Nodes referred to: XferRef() finds the node a reference points to in
+ * constant time.  When copying, each node copied by XferList() is
+ * recorded here with its copy.  When writing, each node of the config's
+ * own lists, which are the ones referred to, is recorded here with its
+ * index; when reading, those lists' nodes are kept in arrays, by index.
+ */
+
+static size_t NodeHash(const void *node)
+{
+    return (size_t) ((((unsigned long) node) >> 3) * 2654435761U);
+}
+
+static CacheNodeSlotRec *FindNodeSlot(CacheStreamPtr s, const void *node)
+{
+    size_t i;
+
+    for (i = NodeHash(node) & s->nodesMask; s->nodes[i].node;
+         i = (i + 1) & s->nodesMask) {
+        if (s->nodes[i].node == node) break;
+    }
+
+    return &s->nodes[i];
+}
+
+static CacheNodeSlotRec *AddNode(CacheStreamPtr s, const void *node)
+{
+    CacheNodeSlotRec *old = s->nodes, *slot;
+    size_t oldMask = s->nodesMask, i;
+
+    if ((s->nodesCount + 1) * 2 > s->nodesMask) {
+        s->nodesMask = old ? (oldMask << 1) | 1 : 255;
+        s->nodes = xconfigAlloc((s->nodesMask + 1) *
+                                sizeof(CacheNodeSlotRec));
+        for (i = 0; old && i <= oldMask; i++) {
+            if (old[i].node) *FindNodeSlot(s, old[i].node) = old[i];
+        }
+        free(old);
+    }
+
+    slot = FindNodeSlot(s, node);
+    slot->node = node;
+    s->nodesCount++;
+
+    return slot;
+}
+
+
+/*
+ * ConfigList() - return the record of the list whose head is at head,
+ * if it is one of the config's own lists, or NULL.
+ */
+
+static CacheListRec *ConfigList(CacheStreamPtr s, const void *head)
+{
+    const char *p = head, *config = (const char *) s->config;
+
+    if (p < config || p >= config + sizeof(XConfigRec)) {
+        return NULL;
+    }
+
+    return &s->lists[(p - config) / sizeof(GenericListPtr)];
+}
+
+
+/*
+ * FreeStream() - release what the stream kept to resolve references.
+ */
+
+static void FreeStream(CacheStreamPtr s)
+{
+    size_t i;
+
+    for (i = 0; i < CACHE_CONFIG_LISTS; i++) {
+        free(s->lists[i].nodes);
+    }
+
+    free(s->nodes);
+}
+
+
+/*
+ * Primitive transfers: each writes *p to the stream when writing, or
+ * sets *p from the stream when reading; when copying, *p was copied
+ * along with its node and is left alone.  Once an error has occurred,
+ * nothing more is transferred, and values read are zero.
+ */
+
+static void XferBytes(CacheStreamPtr s, void *p, size_t n)
+{
+    if (s->copying) {
+        return;
+    }
+
+    if (s->error) {
+        if (!s->file) memset(p, 0, n);
+        return;
+    }
+
+    if (s->file) {
+        if (fwrite(p, 1, n, s->file) != n) {
+            s->error = TRUE;
+        }
+    } else if (n > s->len - s->pos) {
+        memset(p, 0, n);
+        s->error = TRUE;
+    } else {
+        memcpy(p, s->data + s->pos, n);
+        s->pos += n;
+    }
+}
+
+static void XferInt(CacheStreamPtr s, int *p)
+{
+    XferBytes(s, p, sizeof(*p));
+}
+
+static void XferInts(CacheStreamPtr s, int *p, int n)
+{
+    XferBytes(s, p, n * sizeof(*p));
+}
+
+static void XferFloat(CacheStreamPtr s, float *p)
+{
+    XferBytes(s, p, sizeof(*p));
+}
+
+static void XferULong(CacheStreamPtr s, unsigned long *p)
+{
+    XferBytes(s, p, sizeof(*p));
+}
+
+static void XferRGB(CacheStreamPtr s, parser_rgb *p)
+{
+    XferInt(s, &p->red);
+    XferInt(s, &p->green);
+    XferInt(s, &p->blue);
+}
+
+static void XferRanges(CacheStreamPtr s, parser_range *p, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        XferFloat(s, &p[i].hi);
+        XferFloat(s, &p[i].lo);
+    }
+}
+
+
+/*
+ * XferLength() - transfer the length of a string, list or text that
+ * follows; lengths read are checked against what is left of the
+ * stream, as each unit takes at least one byte.  -1 is a NULL string.
+ */
+
+static int XferLength(CacheStreamPtr s, int len)
+{
+    XferInt(s, &len);
+
+    if (!s->file && !s->copying && !s->error &&
+        (len < -1 || (size_t) (len + 1) > s->len - s->pos + 1)) {
+        s->error = TRUE;
+    }
+
+    return s->error ? -1 : len;
+}
+
+
+/*
+ * XferStr() - transfer a pooled string
+ */
+
+static void XferStr(CacheStreamPtr s, const char **p)
+{
+    int len;
+
+    if (s->copying) {
+        *p = xconfigIntern(s->config, *p);
+        return;
+    }
+
+    len = XferLength(s, *p && s->file ? (int) strlen(*p) : -1);
+
+    if (s->file) {
+        if (len > 0) XferBytes(s, (void *) *p, len);
+    } else if (len < 0) {
+        *p = NULL;
+    } else {
+        *p = xconfigInternLen(s->config, s->data + s->pos, len);
+        s->pos += len;
+    }
+}
+
+
+/*
+ * XferText() - transfer *len bytes of text, such as a comment, that is
+ * held in the config's arena rather than its string pool; when reading,
+ * the text is returned and its length stored in *len.
+ */
+
+static char *XferText(CacheStreamPtr s, const char *text, int *len)
+{
+    char *m;
+
+    if (s->copying) {
+        if (!text) {
+            return NULL;
+        }
+        m = xconfigArenaAlloc(s->config, *len + 1);
+        memcpy(m, text, *len);
+        return m;
+    }
+
+    *len = XferLength(s, text ? *len : -1);
+
+    if (s->file) {
+        if (*len > 0) XferBytes(s, (void *) text, *len);
+        return (char *) text;
+    }
+    if (*len < 0) {
+        return NULL;
+    }
+
+    m = xconfigArenaAlloc(s->config, *len + 1);
+    memcpy(m, s->data + s->pos, *len);
+    s->pos += *len;
+
+    return m;
+}
+
+static void XferComment(CacheStreamPtr s, char **p)
+{
+    int len = *p ? strlen(*p) : 0;
+
+    *p = XferText(s, *p, &len);
+}
+
+
+/*
+ * XferList() - transfer a list of nodes of the given size, using xfer
+ * for each node; when reading or copying, each node is allocated from
+ * the config and appended to *head.
+ */
+
+static void XferList(CacheStreamPtr s, void *head, size_t size,
+                     CacheXferFunc xfer)
+{
+    GenericListPtr *pHead = head, node, from;
+    CacheListRec *list = ConfigList(s, head);
+    CacheNodeSlotRec *slot;
+    GenericListTailRec tail;
+    int n = 0, i;
+
+    if (s->copying) {
+        from = *pHead;
+        *pHead = NULL;
+        xconfigInitListTail(&tail, pHead);
+
+        for (; from; from = from->next) {
+            node = xconfigArenaAlloc(s->config, size);
+            memcpy(node, from, size);
+            node->next = NULL;
+            AddNode(s, from)->copy = node;
+            xfer(s, node);
+            xconfigAppendListItem(&tail, node);
+        }
+        return;
+    }
+
+    if (s->file) {
+        for (node = *pHead; node; node = node->next) {
+            if (list) {
+                slot = AddNode(s, node);
+                slot->list = list;
+                slot->index = n;
+            }
+            n++;
+        }
+        XferLength(s, n);
+        for (node = *pHead; node; node = node->next) xfer(s, node);
+        return;
+    }
+
+    n = XferLength(s, 0);
+
+    if (list && n > 0) {
+        list->nodes = xconfigAlloc(n * sizeof(GenericListPtr));
+    }
+
+    xconfigInitListTail(&tail, pHead);
+
+    for (i = 0; i < n && !s->error; i++) {
+        node = xconfigArenaAlloc(s->config, size);
+        xfer(s, node);
+        xconfigAppendListItem(&tail, node);
+        if (list) list->nodes[list->count++] = node;
+    }
+}
+
+
+/*
+ * XferRecord() - transfer a section that the config holds at most one
+ * of, such as the Files section
+ */
+
+static void XferRecord(CacheStreamPtr s, void *p, size_t size,
+                       CacheXferFunc xfer)
+{
+    void **pRecord = p;
+    int present = (*pRecord != NULL);
+
+    XferInt(s, &present);
+
+    if (!present || s->error) {
+        if (!s->file) *pRecord = NULL;
+        return;
+    }
+
+    if (s->copying) {
+        void *from = *pRecord;
+
+        *pRecord = xconfigArenaAlloc(s->config, size);
+        memcpy(*pRecord, from, size);
+    } else if (!s->file) {
+        *pRecord = xconfigArenaAlloc(s->config, size);
+    }
+
+    xfer(s, *pRecord);
+}
+
+
+/*
+ * XferRef() - transfer a reference to a node of the config's list whose
+ * head is at head, as the node's index in the list; the list must have
+ * been transferred already.  A reference to a node not in the list is
+ * written as none.
+ */
+
+static void XferRef(CacheStreamPtr s, void *p, void *head)
+{
+    void **pRef = p;
+    CacheListRec *list = ConfigList(s, head);
+    CacheNodeSlotRec *slot;
+    int index = -1;
+
+    if (s->copying) {
+        *pRef = (*pRef && s->nodes) ? FindNodeSlot(s, *pRef)->copy : NULL;
+        return;
+    }
+
+    if (s->file) {
+        if (*pRef && s->nodes) {
+            slot = FindNodeSlot(s, *pRef);
+            if (slot->node && slot->list == list) {
+                index = slot->index;
+            }
+        }
+        XferInt(s, &index);
+        return;
+    }
+
+    XferInt(s, &index);
+
+    if (index < 0) {
+        *pRef = NULL;
+    } else if (index < list->count) {
+        *pRef = list->nodes[index];
+    } else {
+        s->error = TRUE;
+    }
+}
+
+
+
+/*
+ * Node transfers; none of these touch the node's next pointer, which
+ * is handled by XferList().
+ */
+
+/*
+ * XferOption() - the parsed value of an option is not cached, but
+ * parsed again when the cache is read; a copy keeps it, if it is still
+ * good.
+ */
+
+static void XferOption(CacheStreamPtr s, void *p)
+{
+    XConfigOptionPtr opt = p;
+    int typed = (opt->typedVal == opt->val);
+
+    XferStr(s, &opt->name);
+    XferStr(s, &opt->val);
+    XferComment(s, &opt->comment);
+
+    if (s->copying) {
+        if (!typed) opt->type = XCONFIG_OPTION_STRING;
+        opt->typedVal = opt->val;
+    } else if (s->data) {
+        xconfigTypeOption(s->config, opt);
+    }
+}
+
+static void XferOptions(CacheStreamPtr s, XConfigOptionPtr *p)
+{
+    XferList(s, p, sizeof(XConfigOptionRec), XferOption);
+}
+
+static void XferFiles(CacheStreamPtr s, void *p)
+{
+    XConfigFilesPtr files = p;
+
+    XferStr(s, &files->logfile);
+    XferStr(s, &files->rgbpath);
+    XferStr(s, &files->modulepath);
+    XferStr(s, &files->inputdevs);
+    XferStr(s, &files->fontpath);
+    XferComment(s, &files->comment);
+}
+
+static void XferLoad(CacheStreamPtr s, void *p)
+{
+    XConfigLoadPtr load = p;
+
+    XferInt(s, &load->type);
+    XferStr(s, &load->name);
+    XferOptions(s, &load->opt);
+    XferComment(s, &load->comment);
+}
+
+static void XferModule(CacheStreamPtr s, void *p)
+{
+    XConfigModulePtr module = p;
+
+    XferList(s, &module->loads, sizeof(XConfigLoadRec), XferLoad);
+    XferList(s, &module->disables, sizeof(XConfigLoadRec), XferLoad);
+    XferComment(s, &module->comment);
+}
+
+static void XferFlags(CacheStreamPtr s, void *p)
+{
+    XConfigFlagsPtr flags = p;
+
+    XferOptions(s, &flags->options);
+    XferComment(s, &flags->comment);
+}
+
+static void XferVideoPort(CacheStreamPtr s, void *p)
+{
+    XConfigVideoPortPtr port = p;
+
+    XferStr(s, &port->identifier);
+    XferOptions(s, &port->options);
+    XferComment(s, &port->comment);
+}
+
+static void XferVideoAdaptor(CacheStreamPtr s, void *p)
+{
+    XConfigVideoAdaptorPtr adaptor = p;
+
+    XferStr(s, &adaptor->identifier);
+    XferStr(s, &adaptor->vendor);
+    XferStr(s, &adaptor->board);
+    XferStr(s, &adaptor->busid);
+    XferStr(s, &adaptor->driver);
+    XferOptions(s, &adaptor->options);
+    XferList(s, &adaptor->ports, sizeof(XConfigVideoPortRec),
+             XferVideoPort);
+    XferStr(s, &adaptor->fwdref);
+    XferComment(s, &adaptor->comment);
+}
+
+static void XferModeLine(CacheStreamPtr s, void *p)
+{
+    XConfigModeLinePtr modeline = p;
+
+    XferStr(s, &modeline->identifier);
+    XferStr(s, &modeline->clock);
+    XferInt(s, &modeline->hdisplay);
+    XferInt(s, &modeline->hsyncstart);
+    XferInt(s, &modeline->hsyncend);
+    XferInt(s, &modeline->htotal);
+    XferInt(s, &modeline->vdisplay);
+    XferInt(s, &modeline->vsyncstart);
+    XferInt(s, &modeline->vsyncend);
+    XferInt(s, &modeline->vtotal);
+    XferInt(s, &modeline->vscan);
+    XferInt(s, &modeline->flags);
+    XferInt(s, &modeline->hskew);
+    XferComment(s, &modeline->comment);
+}
+
+static void XferModes(CacheStreamPtr s, void *p)
+{
+    XConfigModesPtr modes = p;
+
+    XferStr(s, &modes->identifier);
+    XferList(s, &modes->modelines, sizeof(XConfigModeLineRec),
+             XferModeLine);
+    XferComment(s, &modes->comment);
+}
+
+static void XferModesLink(CacheStreamPtr s, void *p)
+{
+    XConfigModesLinkPtr link = p;
+
+    XferStr(s, &link->modes_name);
+    XferRef(s, &link->modes, &s->config->modes);
+}
+
+static void XferMonitor(CacheStreamPtr s, void *p)
+{
+    XConfigMonitorPtr monitor = p;
+
+    XferStr(s, &monitor->identifier);
+    XferStr(s, &monitor->vendor);
+    XferStr(s, &monitor->modelname);
+    XferInt(s, &monitor->width);
+    XferInt(s, &monitor->height);
+    XferList(s, &monitor->modelines, sizeof(XConfigModeLineRec),
+             XferModeLine);
+    XferInt(s, &monitor->n_hsync);
+    XferRanges(s, monitor->hsync, CONF_MAX_HSYNC);
+    XferInt(s, &monitor->n_vrefresh);
+    XferRanges(s, monitor->vrefresh, CONF_MAX_VREFRESH);
+    XferFloat(s, &monitor->gamma_red);
+    XferFloat(s, &monitor->gamma_green);
+    XferFloat(s, &monitor->gamma_blue);
+    XferOptions(s, &monitor->options);
+    XferList(s, &monitor->modes_sections, sizeof(XConfigModesLinkRec),
+             XferModesLink);
+    XferComment(s, &monitor->comment);
+}
+
+static void XferDevice(CacheStreamPtr s, void *p)
+{
+    XConfigDevicePtr device = p;
+    int clocks;
+
+    XferStr(s, &device->identifier);
+    XferStr(s, &device->vendor);
+    XferStr(s, &device->board);
+    XferStr(s, &device->chipset);
+    XferStr(s, &device->busid);
+    XferStr(s, &device->card);
+    XferStr(s, &device->driver);
+    XferStr(s, &device->ramdac);
+    XferInts(s, device->dacSpeeds, CONF_MAXDACSPEEDS);
+    XferInt(s, &device->videoram);
+    XferInt(s, &device->textclockfreq);
+    XferULong(s, &device->bios_base);
+    XferULong(s, &device->mem_base);
+    XferULong(s, &device->io_base);
+    XferStr(s, &device->clockchip);
+    XferInt(s, &device->clocks);
+
+    /*
+     * only the clocks in use are stored; a count the parser could not
+     * have made means the cache is damaged, and it is not loaded
+     */
+
+    if (device->clocks < 0 || device->clocks > CONF_MAXCLOCKS) {
+        s->error = TRUE;
+        device->clocks = 0;
+    }
+
+    clocks = device->clocks;
+
+    if (!s->file) {
+        int *from = device->clock;
+
+        device->clock = NULL;
+        if (clocks > 0) {
+            device->clock = xconfigArenaAlloc(s->config,
+                                              CONF_MAXCLOCKS * sizeof(int));
+            if (s->copying) {
+                memcpy(device->clock, from, clocks * sizeof(int));
+            }
+        }
+    }
+
+    if (clocks > 0) {
+        XferInts(s, device->clock, clocks);
+    }
+
+    XferInt(s, &device->chipid);
+    XferInt(s, &device->chiprev);
+    XferInt(s, &device->irq);
+    XferInt(s, &device->screen);
+    XferBytes(s, &device->index_id, sizeof(device->index_id));
+    XferOptions(s, &device->options);
+    XferComment(s, &device->comment);
+}
+
+static void XferMode(CacheStreamPtr s, void *p)
+{
+    XConfigModePtr mode = p;
+
+    XferStr(s, &mode->mode_name);
+}
+
+static void XferDisplay(CacheStreamPtr s, void *p)
+{
+    XConfigDisplayPtr display = p;
+
+    XferInt(s, &display->frameX0);
+    XferInt(s, &display->frameY0);
+    XferInt(s, &display->virtualX);
+    XferInt(s, &display->virtualY);
+    XferInt(s, &display->depth);
+    XferInt(s, &display->bpp);
+    XferStr(s, &display->visual);
+    XferRGB(s, &display->weight);
+    XferRGB(s, &display->black);
+    XferRGB(s, &display->white);
+    XferList(s, &display->modes, sizeof(XConfigModeRec), XferMode);
+    XferOptions(s, &display->options);
+    XferComment(s, &display->comment);
+}
+
+static void XferAdaptorLink(CacheStreamPtr s, void *p)
+{
+    XConfigAdaptorLinkPtr link = p;
+
+    XferStr(s, &link->adaptor_name);
+    XferRef(s, &link->adaptor, &s->config->videoadaptors);
+}
+
+static void XferScreen(CacheStreamPtr s, void *p)
+{
+    XConfigScreenPtr screen = p;
+
+    XferStr(s, &screen->identifier);
+    XferStr(s, &screen->obsolete_driver);
+    XferInt(s, &screen->defaultdepth);
+    XferInt(s, &screen->defaultbpp);
+    XferInt(s, &screen->defaultfbbpp);
+    XferStr(s, &screen->monitor_name);
+    XferRef(s, &screen->monitor, &s->config->monitors);
+    XferStr(s, &screen->device_name);
+    XferRef(s, &screen->device, &s->config->devices);
+    XferList(s, &screen->adaptors, sizeof(XConfigAdaptorLinkRec),
+             XferAdaptorLink);
+    XferList(s, &screen->displays, sizeof(XConfigDisplayRec), XferDisplay);
+    XferOptions(s, &screen->options);
+    XferComment(s, &screen->comment);
+}
+
+static void XferInput(CacheStreamPtr s, void *p)
+{
+    XConfigInputPtr input = p;
+
+    XferStr(s, &input->identifier);
+    XferStr(s, &input->driver);
+    XferOptions(s, &input->options);
+    XferComment(s, &input->comment);
+}
+
+static void XferInputClass(CacheStreamPtr s, void *p)
+{
+    XConfigInputClassPtr inputclass = p;
+
+    XferStr(s, &inputclass->identifier);
+    XferStr(s, &inputclass->driver);
+    XferStr(s, &inputclass->match_is_pointer);
+    XferStr(s, &inputclass->match_is_touchpad);
+    XferStr(s, &inputclass->match_is_touchscreen);
+    XferStr(s, &inputclass->match_is_keyboard);
+    XferStr(s, &inputclass->match_is_joystick);
+    XferStr(s, &inputclass->match_is_tablet);
+    XferStr(s, &inputclass->match_tag);
+    XferStr(s, &inputclass->match_device_path);
+    XferStr(s, &inputclass->match_os);
+    XferStr(s, &inputclass->match_usb_id);
+    XferStr(s, &inputclass->match_pnp_id);
+    XferStr(s, &inputclass->match_product);
+    XferStr(s, &inputclass->match_driver);
+    XferStr(s, &inputclass->match_vendor);
+    XferOptions(s, &inputclass->options);
+    XferComment(s, &inputclass->comment);
+}
+
+static void XferAdjacency(CacheStreamPtr s, void *p)
+{
+    XConfigAdjacencyPtr adj = p;
+    XConfigScreenPtr *screens = &s->config->screens;
+
+    XferInt(s, &adj->scrnum);
+    XferRef(s, &adj->screen, screens);
+    XferStr(s, &adj->screen_name);
+    XferRef(s, &adj->top, screens);
+    XferStr(s, &adj->top_name);
+    XferRef(s, &adj->bottom, screens);
+    XferStr(s, &adj->bottom_name);
+    XferRef(s, &adj->left, screens);
+    XferStr(s, &adj->left_name);
+    XferRef(s, &adj->right, screens);
+    XferStr(s, &adj->right_name);
+    XferInt(s, &adj->where);
+    XferInt(s, &adj->x);
+    XferInt(s, &adj->y);
+    XferStr(s, &adj->refscreen);
+}
+
+static void XferInactive(CacheStreamPtr s, void *p)
+{
+    XConfigInactivePtr inactive = p;
+
+    XferStr(s, &inactive->device_name);
+    XferRef(s, &inactive->device, &s->config->devices);
+}
+
+static void XferInputref(CacheStreamPtr s, void *p)
+{
+    XConfigInputrefPtr inputref = p;
+
+    XferRef(s, &inputref->input, &s->config->inputs);
+    XferStr(s, &inputref->input_name);
+    XferOptions(s, &inputref->options);
+}
+
+static void XferLayout(CacheStreamPtr s, void *p)
+{
+    XConfigLayoutPtr layout = p;
+
+    XferStr(s, &layout->identifier);
+    XferList(s, &layout->adjacencies, sizeof(XConfigAdjacencyRec),
+             XferAdjacency);
+    XferList(s, &layout->inactives, sizeof(XConfigInactiveRec),
+             XferInactive);
+    XferList(s, &layout->inputs, sizeof(XConfigInputrefRec), XferInputref);
+    XferOptions(s, &layout->options);
+    XferComment(s, &layout->comment);
+}
+
+static void XferVendSub(CacheStreamPtr s, void *p)
+{
+    XConfigVendSubPtr sub = p;
+
+    XferStr(s, &sub->name);
+    XferStr(s, &sub->identifier);
+    XferOptions(s, &sub->options);
+    XferComment(s, &sub->comment);
+}
+
+static void XferVendor(CacheStreamPtr s, void *p)
+{
+    XConfigVendorPtr vendor = p;
+
+    XferStr(s, &vendor->identifier);
+    XferOptions(s, &vendor->options);
+    XferList(s, &vendor->subs, sizeof(XConfigVendSubRec), XferVendSub);
+    XferComment(s, &vendor->comment);
+}
+
+static void XferBuffers(CacheStreamPtr s, void *p)
+{
+    XConfigBuffersPtr buffers = p;
+
+    XferInt(s, &buffers->count);
+    XferInt(s, &buffers->size);
+    XferStr(s, &buffers->flags);
+    XferComment(s, &buffers->comment);
+}
+
+static void XferDRI(CacheStreamPtr s, void *p)
+{
+    XConfigDRIPtr dri = p;
+
+    XferStr(s, &dri->group_name);
+    XferInt(s, &dri->group);
+    XferInt(s, &dri->mode);
+    XferList(s, &dri->buffers, sizeof(XConfigBuffersRec), XferBuffers);
+    XferComment(s, &dri->comment);
+}
+
+static void XferExtensions(CacheStreamPtr s, void *p)
+{
+    XConfigExtensionsPtr extensions = p;
+
+    XferOptions(s, &extensions->options);
+    XferComment(s, &extensions->comment);
+}
+
+static void XferDeferred(CacheStreamPtr s, void *p)
+{
+    XConfigDeferredPtr deferred = p;
+    int len = deferred->len;
+
+    XferBytes(s, &deferred->kind, sizeof(deferred->kind));
+    XferInt(s, &deferred->line);
+    deferred->text = XferText(s, deferred->text, &len);
+    deferred->len = deferred->text ? len : 0;
+}
+
+
+/*
+ * XferConfig() - transfer a whole config; sections are transferred
+ * before any section that refers to them.
+ */
+
+static void XferConfig(CacheStreamPtr s)
+{
+    XConfigPtr config = s->config;
+
+    XferList(s, &config->modes, sizeof(XConfigModesRec), XferModes);
+    XferList(s, &config->videoadaptors, sizeof(XConfigVideoAdaptorRec),
+             XferVideoAdaptor);
+    XferList(s, &config->monitors, sizeof(XConfigMonitorRec), XferMonitor);
+    XferList(s, &config->devices, sizeof(XConfigDeviceRec), XferDevice);
+    XferList(s, &config->inputs, sizeof(XConfigInputRec), XferInput);
+    XferList(s, &config->screens, sizeof(XConfigScreenRec), XferScreen);
+    XferList(s, &config->layouts, sizeof(XConfigLayoutRec), XferLayout);
+    XferList(s, &config->inputclasses, sizeof(XConfigInputClassRec),
+             XferInputClass);
+    XferList(s, &config->vendors, sizeof(XConfigVendorRec), XferVendor);
+    XferRecord(s, &config->files, sizeof(XConfigFilesRec), XferFiles);
+    XferRecord(s, &config->modules, sizeof(XConfigModuleRec), XferModule);
+    XferRecord(s, &config->flags, sizeof(XConfigFlagsRec), XferFlags);
+    XferRecord(s, &config->dri, sizeof(XConfigDRIRec), XferDRI);
+    XferRecord(s, &config->extensions, sizeof(XConfigExtensionsRec),
+               XferExtensions);
+    XferList(s, &config->deferred, sizeof(XConfigDeferredRec),
+             XferDeferred);
+    XferComment(s, &config->comment);
+    XferStr(s, &config->filename);
+}
+
+
+
+/*
+ * LoadCache() - return the config held in cacheFile if its key matches
+ * key and path, or NULL.  The config's option values are typed with
+ * registry, which need not be the one the cache was written with.
+ */
+
+static XConfigPtr LoadCache(const char *cacheFile, const CacheKeyRec *key,
+                            const char *path,
+                            XConfigOptionRegistryPtr registry)
+{
+    CacheStreamRec s;
+    XConfigPtr config;
+    struct stat st;
+    char *data;
+    size_t pathLen = strlen(path);
+    FILE *file;
+
+    file = fopen(cacheFile, "r");
+    if (!file) {
+        return NULL;
+    }
+
+    if (fstat(fileno(file), &st) != 0 ||
+        (size_t) st.st_size < sizeof(*key) + sizeof(int) + pathLen) {
+        fclose(file);
+        return NULL;
+    }
+
+    data = xconfigAlloc(st.st_size);
+
+    if (fread(data, 1, st.st_size, file) != (size_t) st.st_size ||
+        memcmp(data, key, sizeof(*key)) != 0) {
+        fclose(file);
+        free(data);
+        return NULL;
+    }
+
+    fclose(file);
+
+    config = xconfigAllocConfig();
+    config->optionTypes = registry;
+
+    memset(&s, 0, sizeof(s));
+    s.config = config;
+    s.data = data;
+    s.len = st.st_size;
+    s.pos = sizeof(*key);
+
+    /* the config file path, which is not part of the key record */
+
+    if (XferLength(&s, 0) != (int) pathLen ||
+        memcmp(s.data + s.pos, path, pathLen) != 0) {
+        s.error = TRUE;
+    }
+    s.pos += pathLen;
+
+    XferConfig(&s);
+    FreeStream(&s);
+
+    if (s.error || s.pos != s.len) {
+        xconfigFreeConfig(&config);
+    }
+
+    free(data);
+
+    return config;
+}
+
+
+/*
+ * SaveCache() - write config to cacheFile, under key and path; the
+ * cache is written to a new temporary file in the same directory,
+ * made with mkstemp(3) so that it cannot be an existing file or
+ * symlink, and then renamed, so that a reader never sees a partial
+ * cache.
+ */
+
+static void SaveCache(const char *cacheFile, const CacheKeyRec *key,
+                      const char *path, XConfigPtr config)
+{
+    CacheStreamRec s;
+    char *tmp;
+    int fd, pathLen = strlen(path);
+
+    tmp = xconfigStrcat(cacheFile, ".XXXXXX", NULL);
+
+    if ((fd = mkstemp(tmp)) < 0) {
+        free(tmp);
+        return;
+    }
+
+    memset(&s, 0, sizeof(s));
+    s.config = config;
+    s.file = fdopen(fd, "w");
+
+    if (!s.file) {
+        close(fd);
+        unlink(tmp);
+        free(tmp);
+        return;
+    }
+
+    XferBytes(&s, (void *) key, sizeof(*key));
+    XferText(&s, path, &pathLen);
+    XferConfig(&s);
+    FreeStream(&s);
+
+    if (fclose(s.file) != 0 || s.error || rename(tmp, cacheFile) != 0) {
+        unlink(tmp);
+    }
+
+    free(tmp);
+}
+
+
+/*
+ * xconfigReadConfigFileCached() - like xconfigReadConfigFile(), but use
+ * the cache in cacheFile: if it holds the config file open in the
+ * given parser, as it is now, return the cached config without parsing
+ * the file.  Otherwise the file is read, and the cache is rewritten
+ * with the result.  Parse warnings are only printed when the file is
+ * actually read.  Configs with deferred sections are not cached, and
+ * the cache is not used at all when the parser tracks source, since a
+ * cached config does not keep the text needed to patch the file.
+ */
+
+XConfigError xconfigReadConfigFileCached(XConfigParserPtr parser,
+                                         const char *cacheFile,
+                                         XConfigPtr *configPtr)
+{
+    CacheKeyRec key;
+    XConfigError error;
+    int haveKey = !parser->trackSource && GetCacheKey(parser, &key);
+
+    if (haveKey) {
+        *configPtr = LoadCache(cacheFile, &key, parser->path,
+                               parser->optionTypes);
+        if (*configPtr) {
+            return XCONFIG_RETURN_SUCCESS;
+        }
+    }
+
+    error = xconfigReadConfigFile(parser, configPtr);
+
+    if (error == XCONFIG_RETURN_SUCCESS && haveKey &&
+        !(*configPtr)->deferred) {
+        SaveCache(cacheFile, &key, parser->path, *configPtr);
+    }
+
+    return error;
+}
+
+
+/*
+ * xconfigCopyConfig() - return a copy of config that shares nothing
+ * with it, so that either can be changed, written out or freed without
+ * affecting the other; references between sections in the copy point
+ * at the copy's own sections.  The copy does not keep the text config
+ * was read from, so it is written out in full rather than patched.
+ */
+
+XConfigPtr xconfigCopyConfig(XConfigPtr config)
+{
+    CacheStreamRec s;
+    XConfigPtr copy = xconfigAllocConfig();
+
+    copy->files = config->files;
+    copy->modules = config->modules;
+    copy->flags = config->flags;
+    copy->videoadaptors = config->videoadaptors;
+    copy->modes = config->modes;
+    copy->monitors = config->monitors;
+    copy->devices = config->devices;
+    copy->screens = config->screens;
+    copy->inputs = config->inputs;
+    copy->inputclasses = config->inputclasses;
+    copy->layouts = config->layouts;
+    copy->vendors = config->vendors;
+    copy->dri = config->dri;
+    copy->extensions = config->extensions;
+    copy->deferred = config->deferred;
+    copy->comment = config->comment;
+    copy->filename = config->filename;
+    copy->optionTypes = config->optionTypes;
+
+    memset(&s, 0, sizeof(s));
+    s.config = copy;
+    s.copying = TRUE;
+
+    XferConfig(&s);
+
+    FreeStream(&s);
+
+    return copy;
+}
@@ -70,12 +70,223 @@
 typedef struct
 {
     int num;        /* returned number */
-    char *str;      /* private copy of the return-string */
+    const char *str; /* return-string, in the config's string pool */
     double realnum; /* returned number as a real */
 }
 LexRec, *LexPtr;
 
 
+/*
+ * A keyword table, as generated by gen-keyword-hash from the tables in
+ * xf86keywords.h: a perfect hash on the canonical form of each keyword
+ * (lower case, without '_', ' ' or '\t'; see xconfigNameCompare()).
+ * slots has mask + 1 entries; unused slots have token -1.
+ */
+
+struct __XConfigKeywordTableRec
+{
+    unsigned int seed;
+    unsigned int mask;
+    const XConfigSymTabRec *slots;
+};
+
+#define XCONFIG_KEYWORD_HASH_INIT 2166136261U
+
+#define XCONFIG_KEYWORD_HASH_STEP(h, c) \
+    (((h) ^ (unsigned char) (c)) * 16777619U)
+
+#define XCONFIG_KEYWORD_SLOT(h, seed, mask) \
+    (((((h) ^ (seed)) * 2654435761U) >> 16) & (mask))
+
+/*
+ * Define the keyword table tab from its generated description in
+ * xf86keywordhash.h.
+ */
+
+#define XCONFIG_KEYWORD_TABLE(tab)                             \
+    static const XConfigSymTabRec tab##Slots[] = tab##_SLOTS;  \
+    static const XConfigKeywordTableRec tab =                  \
+        { tab##_SEED, tab##_MASK, tab##Slots }
+
+
+/*
+ * The position of a parser within its data, as saved and restored by
+ * xconfigSaveScanState() and xconfigRestoreScanState().
+ */
+
+struct __XConfigScanStateRec
+{
+    size_t pos;
+    int bol;
+    const char *tok;
+    size_t tokLen;
+    int pushToken;
+    int eol_seen;
+    int lineNo;
+};
+
+
+/*
+ * A message held by a parser rather than printed; see
+ * xconfigHoldMessages().
+ */
+
+typedef struct __XConfigMessageRec
+{
+    struct __XConfigMessageRec *next;
+    MsgType type;
+    char *msg;
+}
+XConfigMessageRec, *XConfigMessagePtr;
+
+
+/*
+ * A section that failed to parse in error recovery mode, and its
+ * Identifier, if it was read before the error; see
+ * xconfigSectionFailed().
+ */
+
+typedef struct __XConfigFailedSectionRec
+{
+    struct __XConfigFailedSectionRec *next;
+    int token;                  /* section token, eg DEVICE_SECTION */
+    char *identifier;           /* or NULL */
+}
+XConfigFailedSectionRec, *XConfigFailedSectionPtr;
+
+
+/*
+ * The messages collected by a parser in error recovery mode, and the
+ * sections that failed to parse; see xconfigSetErrorRecovery().
+ */
+
+struct __XConfigDiagnosticsRec
+{
+    XConfigDiagnosticPtr list;  /* oldest first */
+    XConfigDiagnosticPtr *tail;
+    int errors;                 /* parse and validation errors in list */
+    XConfigFailedSectionPtr failed;
+};
+
+
+/*
+ * The text a config was read from, and where each of its sections came
+ * from; see Source.c.  Each span records the section's node, which is
+ * an XConfigDeferredPtr for a deferred section, and a hash of how it
+ * was printed when it was read, to tell whether it has changed since.
+ */
+
+typedef struct __XConfigSpanRec
+{
+    struct __XConfigSpanRec *next;
+    void *node;
+    int token;                  /* section token, eg DEVICE_SECTION */
+    int deferred;               /* node is an XConfigDeferredPtr */
+    size_t start;               /* offset of the "Section" keyword */
+    size_t end;                 /* offset just after its EndSection */
+    unsigned long long hash;
+}
+XConfigSpanRec, *XConfigSpanPtr;
+
+struct __XConfigSourceRec
+{
+    const char *text;           /* the config text, or NULL */
+    size_t len;
+    XConfigSpanPtr spans;       /* in the order they appear in text */
+    XConfigSpanPtr *spansTail;
+    int nspans;
+    unsigned long long commentHash;
+    int sawSection;             /* the parser has reached a section */
+    size_t leadingLen;          /* length of the comment before it */
+    const char *innerComment;   /* the rest of the comment, when read */
+};
+
+
+/*
+ * The canonical form of a name, as xconfigNameCompare() sees it, and
+ * its hash; see xconfigNameKey().
+ */
+
+struct __XConfigNameKeyRec {
+    unsigned int hash;
+    unsigned int len;
+    const char *key;
+};
+
+
+/*
+ * The kinds of sections looked up through the config's indexes; see
+ * Index.c.
+ */
+
+enum {
+    XCONFIG_INDEX_DEVICE = 0,
+    XCONFIG_INDEX_MONITOR,
+    XCONFIG_INDEX_MODES,
+    XCONFIG_INDEX_SCREEN,
+    XCONFIG_INDEX_INPUT,
+    XCONFIG_INDEX_LAYOUT,
+    XCONFIG_INDEX_VIDEOADAPTOR,
+    XCONFIG_INDEX_KINDS
+};
+
+
+/*
+ * The end of a list the parser has added to; see
+ * xconfigParserAddListItem().
+ */
+
+#define XCONFIG_LIST_ENDS 4
+
+typedef struct
+{
+    GenericListPtr *head;
+    GenericListTailRec tail;
+}
+XConfigListEndRec, *XConfigListEndPtr;
+
+
+/*
+ * All of the state for scanning and parsing one config file; see
+ * XConfigParserPtr in xf86Parser.h.
+ */
+
+struct __XConfigParserRec
+{
+    const char *data;           /* config text being scanned */
+    size_t dataLen;             /* length of data */
+    int dataOwner;              /* how to release data; see Scan.c */
+    size_t pos;                 /* current readers position */
+    int bol;                    /* next character starts a new line */
+    const char *tok;            /* current token, within data */
+    size_t tokLen;              /* length of tok */
+    char *rbuf;                 /* NUL-terminated copy of tok, on demand */
+    size_t rbufLen;             /* allocated length of rbuf */
+    int pushToken;
+    int eol_seen;               /* private state to handle comments */
+    LexRec val;
+    int lineNo;                 /* linenumber */
+    char *section;              /* name of current section being parsed */
+    char *path;                 /* path to config file */
+    XConfigPtr config;          /* config being read; owns val.str */
+    unsigned int deferKinds;    /* XCONFIG_DEFER_* sections to skip */
+    int skipping;               /* not pooling STRING tokens */
+    int trackSource;            /* record where each section came from */
+    int threads;                /* parse sections on this many threads */
+    size_t parallelMinSize;     /* ... when there is this much data */
+    int holdMessages;           /* hold messages rather than print them */
+    XConfigMessagePtr held;     /* the held messages, oldest first */
+    XConfigMessagePtr *heldTail;
+    int recover;                /* collect messages and keep parsing */
+    void *sectionRecord;        /* of the section being read, or NULL */
+    XConfigOptionRegistryPtr optionTypes; /* for configs read */
+    XConfigDiagnosticsRec diagnostics;
+    XConfigListEndRec configEnds[sizeof(XConfigRec) / sizeof(void *)];
+    XConfigListEndRec listEnds[XCONFIG_LIST_ENDS]; /* of other lists */
+    int nextListEnd;            /* listEnds entry to replace next */
+};
+
+
 #include "configProcs.h"
 #include <stdlib.h>
 
@@ -87,31 +298,40 @@ LexRec, *LexPtr;
 
 
 #define PARSE_PROLOGUE(typeptr,typerec)                         \
-    typeptr ptr;                                                \
-    if ((ptr = (typeptr) calloc(1, sizeof(typerec))) == NULL) { \
-        return NULL;                                            \
-    }                                                           \
-    memset(ptr, 0, sizeof(typerec));
+    typeptr ptr = xconfigParserAllocRecord(parser, sizeof(typerec));
 
 
 #define HANDLE_LIST(field,func,type)                                    \
 {                                                                       \
-    type p = func();                                                    \
+    type p = func(parser);                                              \
     if (p == NULL) {                                                    \
-        CLEANUP (&ptr);                                                 \
         return (NULL);                                                  \
     } else {                                                            \
-        xconfigAddListItem((GenericListPtr*)(&ptr->field),              \
-                           (GenericListPtr) p);                         \
+        xconfigParserAddListItem(parser,                                \
+                                 (GenericListPtr *)(&ptr->field),       \
+                                 (GenericListPtr) p);                   \
     }                                                                   \
 }
 
 
-#define Error(a,b)                            \
-    do {                                      \
-        xconfigErrorMsg(ParseErrorMsg, a, b); \
-        CLEANUP (&ptr);                       \
-        return NULL;                          \
+/*
+ * VALIDATION_FAILED() - after reporting a validation error in p, stop
+ * validating; unless p's messages are being collected (see
+ * xconfigSetErrorRecovery()), in which case ret is set to FALSE and
+ * validation carries on, to find any other errors.
+ */
+
+#define VALIDATION_FAILED(p,ret)                \
+    do {                                        \
+        if (!(p)->diagnostics) return FALSE;    \
+        (ret) = FALSE;                          \
+    } while (0)
+
+
+#define Error(a,b)                                          \
+    do {                                                    \
+        xconfigParserErrorMsg(parser, ParseErrorMsg, a, b); \
+        return NULL;                                        \
     } while (0)
 
 
@@ -207,5 +427,9 @@ LexRec, *LexPtr;
 "Ignoring obsolete keyword \"%s\"."
 #define MOVED_TO_FLAGS_MSG \
 "Keyword \"%s\" is now an Option flag in the ServerFlags section."
+#define NUMBER_RANGE_MSG \
+"The number %s is too large; using %u."
+#define OPTION_VALUE_MSG \
+"\"%s\" is not a valid value for option \"%s\"."
 
 #endif /* _Configint_h_ */
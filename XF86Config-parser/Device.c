@@ -58,43 +58,14 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
 #include <ctype.h>
 
-extern LexRec val;
-
-static
-XConfigSymTabRec DeviceTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {VENDOR, "vendorname"},
-    {BOARD, "boardname"},
-    {CHIPSET, "chipset"},
-    {RAMDAC, "ramdac"},
-    {DACSPEED, "dacspeed"},
-    {CLOCKS, "clocks"},
-    {OPTION, "option"},
-    {VIDEORAM, "videoram"},
-    {BIOSBASE, "biosbase"},
-    {MEMBASE, "membase"},
-    {IOBASE, "iobase"},
-    {CLOCKCHIP, "clockchip"},
-    {CHIPID, "chipid"},
-    {CHIPREV, "chiprev"},
-    {CARD, "card"},
-    {DRIVER, "driver"},
-    {BUSID, "busid"},
-    {TEXTCLOCKFRQ, "textclockfreq"},
-    {IRQ, "irq"},
-    {SCREEN, "screen"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeDeviceList
+XCONFIG_KEYWORD_TABLE(DeviceTab);
 
 XConfigDevicePtr
-xconfigParseDeviceSection (void)
+xconfigParseDeviceSection (XConfigParserPtr parser)
 {
     int i;
     int has_ident = FALSE;
@@ -106,148 +77,151 @@ xconfigParseDeviceSection (void)
     ptr->chiprev = -1;
     ptr->irq = -1;
     ptr->screen = -1;
-    while ((token = xconfigGetToken (DeviceTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &DeviceTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case VENDOR:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Vendor");
-            ptr->vendor = val.str;
+            ptr->vendor = parser->val.str;
             break;
         case BOARD:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Board");
-            ptr->board = val.str;
+            ptr->board = parser->val.str;
             break;
         case CHIPSET:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Chipset");
-            ptr->chipset = val.str;
+            ptr->chipset = parser->val.str;
             break;
         case CARD:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Card");
-            ptr->card = val.str;
+            ptr->card = parser->val.str;
             break;
         case DRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = parser->val.str;
             break;
         case RAMDAC:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Ramdac");
-            ptr->ramdac = val.str;
+            ptr->ramdac = parser->val.str;
             break;
         case DACSPEED:
             for (i = 0; i < CONF_MAXDACSPEEDS; i++)
                 ptr->dacSpeeds[i] = 0;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
             {
                 Error (DACSPEED_MSG, CONF_MAXDACSPEEDS);
             }
             else
             {
-                ptr->dacSpeeds[0] = (int) (val.realnum * 1000.0 + 0.5);
+                ptr->dacSpeeds[0] = (int) (parser->val.realnum * 1000.0 + 0.5);
                 for (i = 1; i < CONF_MAXDACSPEEDS; i++)
                 {
-                    if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
+                    if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
                         ptr->dacSpeeds[i] = (int)
-                            (val.realnum * 1000.0 + 0.5);
+                            (parser->val.realnum * 1000.0 + 0.5);
                     else
                     {
-                        xconfigUnGetToken (token);
+                        xconfigUnGetToken (parser, token);
                         break;
                     }
                 }
             }
             break;
         case VIDEORAM:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "VideoRam");
-            ptr->videoram = val.num;
+            ptr->videoram = parser->val.num;
             break;
         case BIOSBASE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "BIOSBase");
-            ptr->bios_base = val.num;
+            ptr->bios_base = parser->val.num;
             break;
         case MEMBASE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "MemBase");
-            ptr->mem_base = val.num;
+            ptr->mem_base = parser->val.num;
             break;
         case IOBASE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "IOBase");
-            ptr->io_base = val.num;
+            ptr->io_base = parser->val.num;
             break;
         case CLOCKCHIP:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "ClockChip");
-            ptr->clockchip = val.str;
+            ptr->clockchip = parser->val.str;
             break;
         case CHIPID:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "ChipID");
-            ptr->chipid = val.num;
+            ptr->chipid = parser->val.num;
             break;
         case CHIPREV:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "ChipRev");
-            ptr->chiprev = val.num;
+            ptr->chiprev = parser->val.num;
             break;
 
         case CLOCKS:
-            token = xconfigGetSubToken(&(ptr->comment));
+            if (!ptr->clock)
+                ptr->clock = xconfigArenaAlloc(parser->config,
+                                               CONF_MAXCLOCKS * sizeof(int));
+            token = xconfigGetSubToken(parser, &(ptr->comment));
             for( i = ptr->clocks;
                 token == NUMBER && i < CONF_MAXCLOCKS; i++ ) {
-                ptr->clock[i] = (int)(val.realnum * 1000.0 + 0.5);
-                token = xconfigGetSubToken(&(ptr->comment));
+                ptr->clock[i] = (int)(parser->val.realnum * 1000.0 + 0.5);
+                token = xconfigGetSubToken(parser, &(ptr->comment));
             }
             ptr->clocks = i;
-            xconfigUnGetToken (token);
+            xconfigUnGetToken (parser, token);
             break;
         case TEXTCLOCKFRQ:
-            if ((token = xconfigGetSubToken(&(ptr->comment))) != NUMBER)
+            if ((token = xconfigGetSubToken(parser, &(ptr->comment))) != NUMBER)
                 Error (NUMBER_MSG, "TextClockFreq");
-            ptr->textclockfreq = (int)(val.realnum * 1000.0 + 0.5);
+            ptr->textclockfreq = (int)(parser->val.realnum * 1000.0 + 0.5);
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case BUSID:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "BusID");
-            ptr->busid = val.str;
+            ptr->busid = parser->val.str;
             break;
         case IRQ:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (QUOTE_MSG, "IRQ");
-            ptr->irq = val.num;
+            ptr->irq = parser->val.num;
             break;
         case SCREEN:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Screen");
-            ptr->screen = val.num;
+            ptr->screen = parser->val.num;
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -258,8 +232,6 @@ xconfigParseDeviceSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintDeviceSection (FILE * cf, XConfigDevicePtr ptr)
 {
@@ -328,53 +300,27 @@ xconfigPrintDeviceSection (FILE * cf, XConfigDevicePtr ptr)
     }
 }
 
-void
-xconfigFreeDeviceList (XConfigDevicePtr *ptr)
-{
-    XConfigDevicePtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->vendor);
-        TEST_FREE ((*ptr)->board);
-        TEST_FREE ((*ptr)->chipset);
-        TEST_FREE ((*ptr)->card);
-        TEST_FREE ((*ptr)->driver);
-        TEST_FREE ((*ptr)->ramdac);
-        TEST_FREE ((*ptr)->clockchip);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeOptionList (&((*ptr)->options));
-
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
 int
 xconfigValidateDevice (XConfigPtr p)
 {
     XConfigDevicePtr device = p->devices;
+    int ret = TRUE;
 
-    if (!device) {
-        xconfigErrorMsg(ValidationErrorMsg, "At least one Device section "
-                     "is required.");
-        return (FALSE);
+    if (!device && !xconfigSectionFailed(p, DEVICE_SECTION, NULL)) {
+        xconfigValidationErrorMsg(p, "At least one Device section "
+                                  "is required.");
+        VALIDATION_FAILED(p, ret);
     }
 
     while (device) {
         if (!device->driver) {
-            xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_DRIVER_MSG,
-                         device->identifier);
-            return (FALSE);
+            xconfigValidationErrorMsg(p, UNDEFINED_DRIVER_MSG,
+                                      device->identifier);
+            VALIDATION_FAILED(p, ret);
         }
     device = device->next;
     }
-    return (TRUE);
+    return (ret);
 }
 
 XConfigDevicePtr
@@ -529,10 +475,10 @@ void xconfigAddInactiveDevice(XConfigPtr config, XConfigLayoutPtr layout,
     device = add_device(config, -1, -1, -1, NULL, device_n,
                         "modesetting", "Unknown", FALSE /* active */);
 
-    inac = xconfigAlloc(sizeof (XConfigInactiveRec));
+    inac = xconfigArenaAlloc(config, sizeof (XConfigInactiveRec));
     inac->next = NULL;
     inac->device = device;
-    inac->device_name = xconfigStrdup(device->identifier);
+    inac->device_name = device->identifier;
     xconfigAddListItem((GenericListPtr *)(&layout->inactives),
                        (GenericListPtr) inac);
 } /* xconfigAddInactiveDevice() */
@@ -34,38 +34,30 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec ExtensionsTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {OPTION,     "option"},
-    {-1,         ""},
-};
-
-#define CLEANUP xconfigFreeExtensions
+XCONFIG_KEYWORD_TABLE(ExtensionsTab);
 
 XConfigExtensionsPtr
-xconfigParseExtensionsSection (void)
+xconfigParseExtensionsSection (XConfigParserPtr parser)
 {
     int token;
     
     PARSE_PROLOGUE (XConfigExtensionsPtr, XConfigExtensionsRec);
 
-    while ((token = xconfigGetToken (ExtensionsTab)) != ENDSECTION) {
+    while ((token = xconfigGetToken (parser, &ExtensionsTab)) != ENDSECTION) {
         switch (token) {
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -73,8 +65,6 @@ xconfigParseExtensionsSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintExtensionsSection (FILE * cf, XConfigExtensionsPtr ptr)
 {
@@ -89,15 +79,3 @@ xconfigPrintExtensionsSection (FILE * cf, XConfigExtensionsPtr ptr)
     xconfigPrintOptionList(cf, p, 1);
     fprintf (cf, "EndSection\n\n");
 }
-
-void
-xconfigFreeExtensions (XConfigExtensionsPtr *ptr)
-{
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    xconfigFreeOptionList (&((*ptr)->options));
-    TEST_FREE ((*ptr)->comment);
-    free (*ptr);
-    *ptr = NULL;
-}
@@ -60,140 +60,89 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
+XCONFIG_KEYWORD_TABLE(FilesTab);
 
-static XConfigSymTabRec FilesTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {FONTPATH, "fontpath"},
-    {RGBPATH, "rgbpath"},
-    {MODULEPATH, "modulepath"},
-    {INPUTDEVICES, "inputdevices"},
-    {LOGFILEPATH, "logfile"},
-    {-1, ""},
-};
-
-static char *
-prependRoot (char *pathname)
+static const char *
+prependRoot (const char *pathname)
 {
     return pathname;
 }
 
-#define CLEANUP xconfigFreeFiles
+/*
+ * appendPath() - return the comma separated list of paths "list" with
+ * "path" added to the end, as a string in the config's string pool.
+ */
+
+static const char *
+appendPath (XConfigParserPtr parser, const char *list, const char *path)
+{
+    const char *ret;
+    size_t len;
+    char *s;
+
+    if (list == NULL)
+        return xconfigIntern (parser->config, path);
+
+    len = strlen (list);
+    if (len > 0 && list[len - 1] == ',')
+        s = xconfigStrcat (list, path, NULL);
+    else
+        s = xconfigStrcat (list, ",", path, NULL);
+
+    ret = xconfigIntern (parser->config, s);
+    free (s);
+
+    return ret;
+}
 
 XConfigFilesPtr
-xconfigParseFilesSection (void)
+xconfigParseFilesSection (XConfigParserPtr parser)
 {
-    int i, j;
-    int k, l;
-    char *str;
     int token;
     PARSE_PROLOGUE (XConfigFilesPtr, XConfigFilesRec)
 
-    while ((token = xconfigGetToken (FilesTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &FilesTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case FONTPATH:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "FontPath");
-            j = FALSE;
-            str = prependRoot (val.str);
-            if (ptr->fontpath == NULL)
-            {
-                ptr->fontpath = malloc (1);
-                ptr->fontpath[0] = '\0';
-                i = strlen (str) + 1;
-            }
-            else
-            {
-                i = strlen (ptr->fontpath) + strlen (str) + 1;
-                if (ptr->fontpath[strlen (ptr->fontpath) - 1] != ',')
-                {
-                    i++;
-                    j = TRUE;
-                }
-            }
-            ptr->fontpath = realloc (ptr->fontpath, i);
-            if (j)
-                strcat (ptr->fontpath, ",");
-
-            strcat (ptr->fontpath, str);
-            free (val.str);
+            ptr->fontpath = appendPath (parser, ptr->fontpath,
+                                        prependRoot (parser->val.str));
             break;
         case RGBPATH:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "RGBPath");
-            ptr->rgbpath = val.str;
+            ptr->rgbpath = parser->val.str;
             break;
         case MODULEPATH:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "ModulePath");
-            l = FALSE;
-            str = prependRoot (val.str);
-            if (ptr->modulepath == NULL)
-            {
-                ptr->modulepath = malloc (1);
-                ptr->modulepath[0] = '\0';
-                k = strlen (str) + 1;
-            }
-            else
-            {
-                k = strlen (ptr->modulepath) + strlen (str) + 1;
-                if (ptr->modulepath[strlen (ptr->modulepath) - 1] != ',')
-                {
-                    k++;
-                    l = TRUE;
-                }
-            }
-            ptr->modulepath = realloc (ptr->modulepath, k);
-            if (l)
-                strcat (ptr->modulepath, ",");
-
-            strcat (ptr->modulepath, str);
-            free (val.str);
+            ptr->modulepath = appendPath (parser, ptr->modulepath,
+                                          prependRoot (parser->val.str));
             break;
         case INPUTDEVICES:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "InputDevices");
-            l = FALSE;
-            str = prependRoot (val.str);
-            if (ptr->inputdevs == NULL)
-            {
-                ptr->inputdevs = malloc (1);
-                ptr->inputdevs[0] = '\0';
-                k = strlen (str) + 1;
-            }
-            else
-            {
-                k = strlen (ptr->inputdevs) + strlen (str) + 1;
-                if (ptr->inputdevs[strlen (ptr->inputdevs) - 1] != ',')
-                {
-                    k++;
-                    l = TRUE;
-                }
-            }
-            ptr->inputdevs = realloc (ptr->inputdevs, k);
-            if (l)
-                strcat (ptr->inputdevs, ",");
-
-            strcat (ptr->inputdevs, str);
-            free (val.str);
+            ptr->inputdevs = appendPath (parser, ptr->inputdevs,
+                                         prependRoot (parser->val.str));
             break;
         case LOGFILEPATH:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "LogFile");
-            ptr->logfile = val.str;
+            ptr->logfile = parser->val.str;
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -201,12 +150,10 @@ xconfigParseFilesSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintFileSection (FILE * cf, XConfigFilesPtr ptr)
 {
-    char *p, *s;
+    const char *p, *s;
 
     if (ptr == NULL)
         return;
@@ -223,9 +170,7 @@ xconfigPrintFileSection (FILE * cf, XConfigFilesPtr ptr)
         p = index (s, ',');
         while (p)
         {
-            *p = '\000';
-            fprintf (cf, "    ModulePath      \"%s\"\n", s);
-            *p = ',';
+            fprintf (cf, "    ModulePath      \"%.*s\"\n", (int) (p - s), s);
             s = p;
             s++;
             p = index (s, ',');
@@ -238,9 +183,7 @@ xconfigPrintFileSection (FILE * cf, XConfigFilesPtr ptr)
         p = index (s, ',');
         while (p)
         {
-            *p = '\000';
-            fprintf (cf, "    InputDevices      \"%s\"\n", s);
-            *p = ',';
+            fprintf (cf, "    InputDevices      \"%.*s\"\n", (int) (p - s), s);
             s = p;
             s++;
             p = index (s, ',');
@@ -253,9 +196,7 @@ xconfigPrintFileSection (FILE * cf, XConfigFilesPtr ptr)
         p = index (s, ',');
         while (p)
         {
-            *p = '\000';
-            fprintf (cf, "    FontPath        \"%s\"\n", s);
-            *p = ',';
+            fprintf (cf, "    FontPath        \"%.*s\"\n", (int) (p - s), s);
             s = p;
             s++;
             p = index (s, ',');
@@ -263,20 +204,3 @@ xconfigPrintFileSection (FILE * cf, XConfigFilesPtr ptr)
         fprintf (cf, "    FontPath        \"%s\"\n", s);
     }
 }
-
-void
-xconfigFreeFiles (XConfigFilesPtr *p)
-{
-    if (p == NULL || *p == NULL)
-        return;
-
-    TEST_FREE ((*p)->logfile);
-    TEST_FREE ((*p)->rgbpath);
-    TEST_FREE ((*p)->modulepath);
-    TEST_FREE ((*p)->inputdevs);
-    TEST_FREE ((*p)->fontpath);
-    TEST_FREE ((*p)->comment);
-
-    free (*p);
-    *p = NULL;
-}
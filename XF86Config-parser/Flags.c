@@ -58,40 +58,19 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 #include <math.h>
 #include "common-utils.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec ServerFlagsTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {NOTRAPSIGNALS, "notrapsignals"},
-    {DONTZAP, "dontzap"},
-    {DONTZOOM, "dontzoom"},
-    {DISABLEVIDMODE, "disablevidmodeextension"},
-    {ALLOWNONLOCAL, "allownonlocalxvidtune"},
-    {DISABLEMODINDEV, "disablemodindev"},
-    {MODINDEVALLOWNONLOCAL, "allownonlocalmodindev"},
-    {ALLOWMOUSEOPENFAIL, "allowmouseopenfail"},
-    {OPTION, "option"},
-    {BLANKTIME, "blanktime"},
-    {STANDBYTIME, "standbytime"},
-    {SUSPENDTIME, "suspendtime"},
-    {OFFTIME, "offtime"},
-    {DEFAULTLAYOUT, "defaultserverlayout"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeFlags
+XCONFIG_KEYWORD_TABLE(ServerFlagsTab);
 
 XConfigFlagsPtr
-xconfigParseFlagsSection (void)
+xconfigParseFlagsSection (XConfigParserPtr parser)
 {
     int token;
     PARSE_PROLOGUE (XConfigFlagsPtr, XConfigFlagsRec)
 
-    while ((token = xconfigGetToken (ServerFlagsTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &ServerFlagsTab)) != ENDSECTION)
     {
         int hasvalue = FALSE;
         int strvalue = FALSE;
@@ -99,7 +78,7 @@ xconfigParseFlagsSection (void)
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
             /* 
              * these old keywords are turned into standard generic options.
@@ -123,43 +102,44 @@ xconfigParseFlagsSection (void)
         case MODINDEVALLOWNONLOCAL:
         case ALLOWMOUSEOPENFAIL:
             {
-                int i = 0;
-                while (ServerFlagsTab[i].token != -1)
+                unsigned int i;
+                for (i = 0; i <= ServerFlagsTab.mask; i++)
                 {
-                    if (ServerFlagsTab[i].token == token)
+                    if (ServerFlagsTab.slots[i].token == token)
                     {
+                        char *name = ServerFlagsTab.slots[i].name;
                         char buff[16];
-                        char *valstr = NULL;
+                        const char *valstr = NULL;
                         if (hasvalue)
                         {
-                            tokentype = xconfigGetSubToken(&(ptr->comment));
+                            tokentype = xconfigGetSubToken(parser,
+                                                           &(ptr->comment));
                             if (strvalue) {
                                 if (tokentype != STRING)
-                                    Error (QUOTE_MSG, ServerFlagsTab[i].name);
-                                valstr = val.str;
+                                    Error (QUOTE_MSG, name);
+                                valstr = parser->val.str;
                             } else {
                                 if (tokentype != NUMBER)
-                                    Error (NUMBER_MSG, ServerFlagsTab[i].name);
-                                snprintf(buff, 16, "%d", val.num);
+                                    Error (NUMBER_MSG, name);
+                                snprintf(buff, 16, "%d", parser->val.num);
                                 valstr = buff;
                             }
                         }
-                        xconfigAddNewOption(&ptr->options,
-                                            ServerFlagsTab[i].name, valstr);
+                        xconfigAddNewOption(parser->config, &ptr->options,
+                                            name, valstr);
                     }
-                    i++;
                 }
             }
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
 
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -167,8 +147,6 @@ xconfigParseFlagsSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintServerFlagsSection (FILE * f, XConfigFlagsPtr flags)
 {
@@ -185,77 +163,44 @@ xconfigPrintServerFlagsSection (FILE * f, XConfigFlagsPtr flags)
 }
 
 void
-xconfigAddNewOption (XConfigOptionPtr *pHead, const char *name,
-                     const char *val)
+xconfigAddNewOption (XConfigPtr config, XConfigOptionPtr *pHead,
+                     const char *name, const char *val)
 {
     XConfigOptionPtr new;
     XConfigOptionPtr old = NULL;
 
     /* Don't allow duplicates */
     if (*pHead != NULL &&
-        ((old = xconfigFindOption(*pHead, name)) != NULL)) {
-        TEST_FREE(old->name);
-        TEST_FREE(old->val);
+        ((old = xconfigOptionMapFind(config, *pHead, name)) != NULL)) {
         new = old;
     } else {
-        new = calloc(1, sizeof (XConfigOptionRec));
-        new->next = NULL;
+        new = xconfigArenaAlloc(config, sizeof (XConfigOptionRec));
     }
-    new->name = xconfigStrdup(name);
-    new->val = xconfigStrdup(val);
+    new->name = xconfigIntern(config, name);
+    new->val = xconfigIntern(config, val);
+    xconfigTypeOption(config, new);
     
     if (old == NULL) {
-        xconfigAddListItem((GenericListPtr *)(pHead), (GenericListPtr)new);
+        xconfigOptionMapAppend(config, pHead, new);
     }
 }
 
-void
-xconfigFreeFlags (XConfigFlagsPtr *flags)
-{
-    if (flags == NULL || *flags == NULL)
-        return;
-
-    xconfigFreeOptionList (&((*flags)->options));
-    TEST_FREE((*flags)->comment);
-    free (*flags);
-    *flags = NULL;
-}
-
 XConfigOptionPtr
-xconfigOptionListDup (XConfigOptionPtr opt)
+xconfigOptionListDup (XConfigPtr config, XConfigOptionPtr opt)
 {
     XConfigOptionPtr newopt = NULL;
 
     while (opt) {
-        xconfigAddNewOption(&newopt, opt->name, opt->val);
+        xconfigAddNewOption(config, &newopt, opt->name, opt->val);
         if (newopt) {
-            newopt->comment = xconfigStrdup(opt->comment);
+            newopt->comment = xconfigArenaStrdup(config, opt->comment);
         }
         opt = opt->next;
     }
     return newopt;
 }
 
-void
-xconfigFreeOptionList (XConfigOptionPtr *opt)
-{
-    XConfigOptionPtr prev;
-
-    if (opt == NULL || *opt == NULL)
-        return;
-
-    while (*opt)
-    {
-        TEST_FREE ((*opt)->name);
-        TEST_FREE ((*opt)->val);
-        TEST_FREE ((*opt)->comment);
-        prev = *opt;
-        *opt = (*opt)->next;
-        free (prev);
-    }
-}
-
-char *
+const char *
 xconfigOptionName(XConfigOptionPtr opt)
 {
     if (opt)
@@ -263,7 +208,7 @@ xconfigOptionName(XConfigOptionPtr opt)
     return 0;
 }
 
-char *
+const char *
 xconfigOptionValue(XConfigOptionPtr opt)
 {
     if (opt)
@@ -272,16 +217,13 @@ xconfigOptionValue(XConfigOptionPtr opt)
 }
 
 XConfigOptionPtr
-xconfigNewOption(const char *name, const char *value)
+xconfigNewOption(XConfigPtr config, const char *name, const char *value)
 {
     XConfigOptionPtr opt;
 
-    opt = calloc(1, sizeof (XConfigOptionRec));
-    if (!opt)
-        return NULL;
-
-    opt->name = xconfigStrdup(name);
-    opt->val = xconfigStrdup(value);
+    opt = xconfigArenaAlloc(config, sizeof (XConfigOptionRec));
+    opt->name = xconfigIntern(config, name);
+    opt->val = xconfigIntern(config, value);
     opt->next = NULL;
 
     return opt;
@@ -291,11 +233,7 @@ void
 xconfigRemoveOption(XConfigOptionPtr *pHead, XConfigOptionPtr opt)
 {
     xconfigRemoveListItem((GenericListPtr *)pHead, (GenericListPtr)opt);
-
-    TEST_FREE(opt->name);
-    TEST_FREE(opt->val);
-    TEST_FREE(opt->comment);
-    free(opt);
+    xconfigOptionListsChanged();
 }
 
 XConfigOptionPtr
@@ -331,7 +269,7 @@ xconfigFindOption (XConfigOptionPtr list, const char *name)
  * returned.  If the option is not found, a NULL is returned.
  */
 
-char *
+const char *
 xconfigFindOptionValue (XConfigOptionPtr list, const char *name)
 {
     XConfigOptionPtr p = xconfigFindOption (list, name);
@@ -349,13 +287,18 @@ xconfigFindOptionValue (XConfigOptionPtr list, const char *name)
 /*
  * this function searches the given option list for the named option. If
  * found and the the value of the option is set to "1", "ON", "YES" or
- * "TRUE", 1 is returned.  Otherwise, 0 is returned.
+ * "TRUE", 1 is returned.  Otherwise, 0 is returned.  Values already
+ * parsed as booleans (see OptionType.c) are not looked at again.
  */
 
 int
 xconfigFindOptionBoolean (XConfigOptionPtr list, const char *name)
 {
     XConfigOptionPtr p = xconfigFindOption (list, name);
+    int value;
+
+    if (xconfigOptionTypedValue(p, XCONFIG_OPTION_BOOLEAN, &value))
+        return value;
 
     if (p && p->val)
     {
@@ -374,50 +317,94 @@ xconfigFindOptionBoolean (XConfigOptionPtr list, const char *name)
  * both, the option from the user list - specified in the second argument -
  * is used. The end result is a single valid list of options. Duplicates
  * are freed, and the original lists are no longer guaranteed to be complete.
+ *
+ * The user list is hashed by name first, so that merging is linear in the
+ * length of the lists; each name's slot holds the user options of that name
+ * not yet used, in order.
  */
+
+typedef struct {
+    unsigned int hash;
+    const char *name;
+    int first;              /* index of the next unused option, or -1 */
+} MergeSlotRec;
+
+static MergeSlotRec *
+MergeFindSlot (MergeSlotRec *slots, size_t mask, const char *name)
+{
+    unsigned int hash = xconfigNameHash(name);
+    size_t i;
+
+    for (i = hash & mask; slots[i].name; i = (i + 1) & mask) {
+        if (slots[i].hash == hash &&
+            xconfigNameCompare (slots[i].name, name) == 0)
+            break;
+    }
+    slots[i].hash = hash;
+    return &slots[i];
+}
+
 XConfigOptionPtr
 xconfigOptionListMerge (XConfigOptionPtr head, XConfigOptionPtr tail)
 {
-    XConfigOptionPtr a, b, ap = NULL, bp = NULL;
-
-    a = tail;
-    b = head;
-    while (tail && b) {
-        if (xconfigNameCompare (a->name, b->name) == 0) {
-            if (b == head)
-                head = a;
-            else
-                bp->next = a;
-            if (a == tail)
-                tail = a->next;
-            else
-                ap->next = a->next;
-            a->next = b->next;
-            b->next = NULL;
-            xconfigFreeOptionList (&b);
-            b = a->next;
-            bp = a;
-            a = tail;
-            ap = NULL;
-        } else {
-            ap = a;
-            if (!(a = a->next)) {
-                a = tail;
-                bp = b;
-                b = b->next;
-                ap = NULL;
-            }
-        }
+    XConfigOptionPtr a, b, next, *opts, result = NULL, *pNext = &result;
+    MergeSlotRec *slots, *slot;
+    size_t n = 0, mask = 15, i;
+    int *nextSame, *used;
+
+    if (!head || !tail)
+        return (head ? head : tail);
+
+    for (a = tail; a; a = a->next)
+        n++;
+    while (mask + 1 < n * 2)
+        mask = (mask << 1) | 1;
+
+    opts = xconfigAlloc(n * sizeof(XConfigOptionPtr));
+    nextSame = xconfigAlloc(n * sizeof(int));
+    used = xconfigAlloc(n * sizeof(int));
+    slots = xconfigAlloc((mask + 1) * sizeof(MergeSlotRec));
+
+    for (i = 0, a = tail; a; a = a->next, i++)
+        opts[i] = a;
+
+    /* chain the user options of each name, walking backwards */
+    for (i = n; i-- > 0; ) {
+        slot = MergeFindSlot(slots, mask, opts[i]->name);
+        nextSame[i] = slot->name ? slot->first : -1;
+        slot->name = opts[i]->name;
+        slot->first = i;
     }
 
-    if (head) {
-        for (a = head; a->next; a = a->next)
-            ;
-        a->next = tail;
-    } else 
-        head = tail;
+    for (b = head; b; b = next) {
+        next = b->next;
+        slot = MergeFindSlot(slots, mask, b->name);
+        if (slot->name && slot->first >= 0) {
+            i = slot->first;
+            slot->first = nextSame[i];
+            used[i] = TRUE;
+            *pNext = opts[i];
+        } else
+            *pNext = b;
+        pNext = &(*pNext)->next;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (used[i])
+            continue;
+        *pNext = opts[i];
+        pNext = &(*pNext)->next;
+    }
+    *pNext = NULL;
+
+    free(opts);
+    free(nextSame);
+    free(used);
+    free(slots);
+
+    xconfigOptionListsChanged();
 
-    return (head);
+    return (result);
 }
 
 char *
@@ -435,52 +422,51 @@ xconfigULongToString(unsigned long i)
 }
 
 XConfigOptionPtr
-xconfigParseOption(XConfigOptionPtr head)
+xconfigParseOption(XConfigParserPtr parser, XConfigOptionPtr head)
 {
     XConfigOptionPtr option, cnew, old;
-    char *name, *comment = NULL;
+    const char *name;
+    char *comment = NULL;
     int token;
 
-    if ((token = xconfigGetSubToken(&comment)) != STRING) {
-        xconfigErrorMsg(ParseErrorMsg, BAD_OPTION_MSG);
-        if (comment)
-            free(comment);
+    if ((token = xconfigGetSubToken(parser, &comment)) != STRING) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, BAD_OPTION_MSG);
         return (head);
     }
 
-    name = val.str;
-    if ((token = xconfigGetSubToken(&comment)) == STRING) {
-        option = xconfigNewOption(name, val.str);
+    name = parser->val.str;
+    if ((token = xconfigGetSubToken(parser, &comment)) == STRING) {
+        option = xconfigNewOption(parser->config, name, parser->val.str);
         option->comment = comment;
-        if ((token = xconfigGetToken(NULL)) == COMMENT)
-            option->comment = xconfigAddComment(option->comment, val.str);
+        if (!xconfigTypeOption(parser->config, option))
+            xconfigParserErrorMsg(parser, ParseWarningMsg, OPTION_VALUE_MSG,
+                                  option->val, option->name);
+        if ((token = xconfigGetToken(parser, NULL)) == COMMENT)
+            option->comment = xconfigParserAddComment(parser, option->comment);
         else
-            xconfigUnGetToken(token);
+            xconfigUnGetToken(parser, token);
     }
     else {
-        option = xconfigNewOption(name, NULL);
+        option = xconfigNewOption(parser->config, name, NULL);
         option->comment = comment;
         if (token == COMMENT)
-            option->comment = xconfigAddComment(option->comment, val.str);
+            option->comment = xconfigParserAddComment(parser, option->comment);
         else
-            xconfigUnGetToken(token);
+            xconfigUnGetToken(parser, token);
     }
 
     old = NULL;
 
     /* Don't allow duplicates */
-    if (head != NULL && (old = xconfigFindOption(head, name)) != NULL) {
+    if (head != NULL &&
+        (old = xconfigOptionMapFind(parser->config, head, name)) != NULL) {
         cnew = old;
-        free(option->name);
-        TEST_FREE(option->val);
-        TEST_FREE(option->comment);
-        free(option);
     }
     else
         cnew = option;
     
     if (old == NULL) {
-        xconfigAddListItem((GenericListPtr *)(&head), (GenericListPtr)cnew);
+        xconfigOptionMapAppend(parser->config, &head, cnew);
     }
 
     return head;
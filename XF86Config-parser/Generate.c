@@ -59,11 +59,11 @@ XConfigPtr xconfigGenerate(GenerateOptions *gop)
 {
     XConfigPtr config;
 
-    config = xconfigAlloc(sizeof(XConfigRec));
+    config = xconfigAllocConfig();
 
     /* add files, fonts, and modules */
 
-    config->files = xconfigAlloc(sizeof(XConfigFilesRec));
+    config->files = xconfigArenaAlloc(config, sizeof(XConfigFilesRec));
     add_font_path(gop, config);
     add_modules(gop, config);
 
@@ -99,25 +99,26 @@ XConfigScreenPtr xconfigGenerateAddScreen(XConfigPtr config,
     XConfigScreenPtr screen, s;
     XConfigDevicePtr device;
     XConfigMonitorPtr monitor;
+    char identifier[32];
 
     monitor = xconfigAddMonitor(config, count);
     device = add_device(config, bus, domain, slot, boardname, count,
                         driver, vendor, TRUE /* active */);
 
-    screen = xconfigAlloc(sizeof(XConfigScreenRec));
+    screen = xconfigArenaAlloc(config, sizeof(XConfigScreenRec));
 
-    screen->identifier = xconfigAlloc(32);
-    snprintf(screen->identifier, 32, SCREEN_IDENTIFIER, count);
+    snprintf(identifier, sizeof(identifier), SCREEN_IDENTIFIER, count);
+    screen->identifier = xconfigIntern(config, identifier);
 
-    screen->device_name = xconfigStrdup(device->identifier);
+    screen->device_name = device->identifier;
     screen->device = device;
 
-    screen->monitor_name = xconfigStrdup(monitor->identifier);
+    screen->monitor_name = monitor->identifier;
     screen->monitor = monitor;
 
     screen->defaultdepth = 24;
 
-    xconfigAddDisplay(&screen->displays, screen->defaultdepth);
+    xconfigAddDisplay(config, &screen->displays, screen->defaultdepth);
 
     /* append to the end of the screen list */
 
@@ -128,6 +129,8 @@ XConfigScreenPtr xconfigGenerateAddScreen(XConfigPtr config,
         s->next = screen;
     }
 
+    xconfigIndexAdd(config, XCONFIG_INDEX_SCREEN, screen);
+
     return screen;
 
 } /* xconfigGenerateAddScreen() */
@@ -149,7 +152,7 @@ void xconfigGenerateAssignScreenAdjacencies(XConfigLayoutPtr layout)
 
         if (prev) {
             adj->where = CONF_ADJ_RIGHTOF;
-            adj->refscreen = xconfigStrdup(prev->screen_name);
+            adj->refscreen = prev->screen_name;
         } else {
             adj->x = adj->y = -1;
         }
@@ -258,7 +261,7 @@ static char *find_libdir(GenerateOptions *gop)
 static void add_font_path(GenerateOptions *gop, XConfigPtr config)
 {
     int i, ret;
-    char *path, *p, *orig, *fonts_dir, *libdir;
+    char *path, *p, *fonts_dir, *libdir;
 
     /*
      * The below font path has been constructed from various examples
@@ -301,7 +304,7 @@ static void add_font_path(GenerateOptions *gop, XConfigPtr config)
     ret = system("ps -C xfs 2>&1 > /dev/null");
 #endif
     if (WEXITSTATUS(ret) == 0) {
-        config->files->fontpath = xconfigStrdup("unix/:7100");
+        config->files->fontpath = xconfigIntern(config, "unix/:7100");
     } else {
 
         /* get the X server libdir */
@@ -345,13 +348,12 @@ static void add_font_path(GenerateOptions *gop, XConfigPtr config)
              */
 
             if (config->files->fontpath) {
-                orig = config->files->fontpath;
-                config->files->fontpath = xconfigStrcat(orig, ",", path, NULL);
-                free(orig);
+                p = xconfigStrcat(config->files->fontpath, ",", path, NULL);
                 free(path);
-            } else {
-                config->files->fontpath = path;
+                path = p;
             }
+            config->files->fontpath = xconfigIntern(config, path);
+            free(path);
         }
 
         /* free the libdir string */
@@ -379,27 +381,27 @@ static void add_modules(GenerateOptions *gop, XConfigPtr config)
 
     if (gop->autoloads_glx) return;
 
-    config->modules = xconfigAlloc(sizeof(XConfigModuleRec));
+    config->modules = xconfigArenaAlloc(config, sizeof(XConfigModuleRec));
 
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("dbe"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("extmod"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("type1"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
+    xconfigAddNewLoadDirective(config, &l, "dbe",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
+    xconfigAddNewLoadDirective(config, &l, "extmod",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
+    xconfigAddNewLoadDirective(config, &l, "type1",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
 #if defined(NV_SUNOS)
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("IA"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("bitstream"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("xtsol"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
+    xconfigAddNewLoadDirective(config, &l, "IA",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
+    xconfigAddNewLoadDirective(config, &l, "bitstream",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
+    xconfigAddNewLoadDirective(config, &l, "xtsol",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
 #else
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("freetype"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
+    xconfigAddNewLoadDirective(config, &l, "freetype",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
 #endif
-    xconfigAddNewLoadDirective(&l, xconfigStrdup("glx"),
-                               XCONFIG_LOAD_MODULE, NULL, FALSE);
+    xconfigAddNewLoadDirective(config, &l, "glx",
+                               XCONFIG_LOAD_MODULE, NULL, NULL);
 
     config->modules->loads = l;
 
@@ -416,18 +418,19 @@ static void add_modules(GenerateOptions *gop, XConfigPtr config)
 XConfigMonitorPtr xconfigAddMonitor(XConfigPtr config, int count)
 {
     XConfigMonitorPtr monitor, m;
+    char identifier[32];
 
     /* XXX need to query resman for the EDID */
 
-    monitor = xconfigAlloc(sizeof(XConfigMonitorRec));
+    monitor = xconfigArenaAlloc(config, sizeof(XConfigMonitorRec));
 
-    monitor->identifier = xconfigAlloc(32);
-    snprintf(monitor->identifier, 32, MONITOR_IDENTIFIER, count);
-    monitor->vendor = xconfigStrdup("Unknown");  /* XXX */
-    monitor->modelname = xconfigStrdup("Unknown"); /* XXX */
+    snprintf(identifier, sizeof(identifier), MONITOR_IDENTIFIER, count);
+    monitor->identifier = xconfigIntern(config, identifier);
+    monitor->vendor = xconfigIntern(config, "Unknown");  /* XXX */
+    monitor->modelname = xconfigIntern(config, "Unknown"); /* XXX */
 
     monitor->options = NULL;
-    xconfigAddNewOption(&monitor->options, "DPMS", NULL);
+    xconfigAddNewOption(config, &monitor->options, "DPMS", NULL);
 
     /* append to the end of the monitor list */
 
@@ -438,6 +441,8 @@ XConfigMonitorPtr xconfigAddMonitor(XConfigPtr config, int count)
         m->next = monitor;
     }
 
+    xconfigIndexAdd(config, XCONFIG_INDEX_MONITOR, monitor);
+
     return monitor;
 
 } /* xconfigAddMonitor() */
@@ -453,22 +458,23 @@ XConfigDevicePtr add_device(XConfigPtr config, int bus, int domain,
                             const char *driver, const char *vendor, int active)
 {
     XConfigDevicePtr device, d;
+    char buf[32];
 
-    device = xconfigAlloc(sizeof(XConfigDeviceRec));
+    device = xconfigArenaAlloc(config, sizeof(XConfigDeviceRec));
 
-    device->identifier = xconfigAlloc(32);
-    snprintf(device->identifier, 32, DEVICE_IDENTIFIER,
+    snprintf(buf, sizeof(buf), DEVICE_IDENTIFIER,
              active ? "" : "Inactive", count);
+    device->identifier = xconfigIntern(config, buf);
     device->index_id = count;
-    device->driver = xconfigStrdup(driver);
-    device->vendor = xconfigStrdup(vendor);
+    device->driver = xconfigIntern(config, driver);
+    device->vendor = xconfigIntern(config, vendor);
 
     if (bus != -1 && domain != -1 && slot != -1) {
-        device->busid = xconfigAlloc(32);
-        xconfigFormatPciBusString(device->busid, 32, domain, bus, slot, 0);
+        xconfigFormatPciBusString(buf, sizeof(buf), domain, bus, slot, 0);
+        device->busid = xconfigIntern(config, buf);
     }
 
-    if (boardname) device->board = xconfigStrdup(boardname);
+    if (boardname) device->board = xconfigIntern(config, boardname);
 
     device->chipid = -1;
     device->chiprev = -1;
@@ -484,17 +490,20 @@ XConfigDevicePtr add_device(XConfigPtr config, int bus, int domain,
         d->next = device;
     }
 
+    xconfigIndexAdd(config, XCONFIG_INDEX_DEVICE, device);
+
     return device;
 
 } /* add_device() */
 
 
 
-void xconfigAddDisplay(XConfigDisplayPtr *pHead, const int depth)
+void xconfigAddDisplay(XConfigPtr config, XConfigDisplayPtr *pHead,
+                       const int depth)
 {
     XConfigDisplayPtr display;
 
-    display = xconfigAlloc(sizeof(XConfigDisplayRec));
+    display = xconfigArenaAlloc(config, sizeof(XConfigDisplayRec));
     display->depth = depth;
     display->modes = NULL;
     display->frameX0 = -1;
@@ -525,15 +534,15 @@ static void add_layout(GenerateOptions *gop, XConfigPtr config)
 
     /* create layout */
 
-    layout = xconfigAlloc(sizeof(XConfigLayoutRec));
+    layout = xconfigArenaAlloc(config, sizeof(XConfigLayoutRec));
 
-    layout->identifier = xconfigStrdup("Layout0");
+    layout->identifier = xconfigIntern(config, "Layout0");
 
-    adj = xconfigAlloc(sizeof(XConfigAdjacencyRec));
+    adj = xconfigArenaAlloc(config, sizeof(XConfigAdjacencyRec));
 
     adj->scrnum = 0;
     adj->screen = screen;
-    adj->screen_name = xconfigStrdup(screen->identifier);
+    adj->screen_name = screen->identifier;
 
     layout->adjacencies = adj;
 
@@ -558,11 +567,12 @@ static void add_inputref(XConfigPtr config, XConfigLayoutPtr layout,
 {
     XConfigInputrefPtr inputRef;
 
-    inputRef = xconfigAlloc(sizeof(XConfigInputrefRec));
-    inputRef->input_name = xconfigStrdup(name);
-    inputRef->input = xconfigFindInput(inputRef->input_name, config->inputs);
+    inputRef = xconfigArenaAlloc(config, sizeof(XConfigInputrefRec));
+    inputRef->input_name = xconfigIntern(config, name);
+    inputRef->input = xconfigIndexFind(config, XCONFIG_INDEX_INPUT,
+                                       inputRef->input_name);
     inputRef->options = NULL;
-    xconfigAddNewOption(&inputRef->options, coreKeyword, NULL);
+    xconfigAddNewOption(config, &inputRef->options, coreKeyword, NULL);
     inputRef->next = layout->inputs;
     layout->inputs = inputRef;
 
@@ -903,7 +913,7 @@ int xconfigAddMouse(GenerateOptions *gop, XConfigPtr config)
 {
     const MouseEntry *entry = NULL;
     XConfigInputPtr input;
-    char *device_path, *comment = "default";
+    char *device_path, *tmp, *comment = "default";
 
     /* if the user specified on the commandline, use that */
 
@@ -990,19 +1000,20 @@ int xconfigAddMouse(GenerateOptions *gop, XConfigPtr config)
 
     /* add a new mouse input section */
 
-    input = xconfigAlloc(sizeof(XConfigInputRec));
+    input = xconfigArenaAlloc(config, sizeof(XConfigInputRec));
 
-    input->comment = xconfigStrcat("    # generated from ",
-                                   comment, "\n", NULL);
-    input->identifier = xconfigStrdup("Mouse0");
-    input->driver = xconfigStrdup("mouse");
+    tmp = xconfigStrcat("    # generated from ", comment, "\n", NULL);
+    input->comment = xconfigArenaStrdup(config, tmp);
+    free(tmp);
+    input->identifier = xconfigIntern(config, "Mouse0");
+    input->driver = xconfigIntern(config, "mouse");
 
     device_path = xconfigStrcat("/dev/", entry->device, NULL);
 
     input->options = NULL;
-    xconfigAddNewOption(&input->options, "Protocol", entry->Xproto);
-    xconfigAddNewOption(&input->options, "Device", device_path);
-    xconfigAddNewOption(&input->options, "Emulate3Buttons",
+    xconfigAddNewOption(config, &input->options, "Protocol", entry->Xproto);
+    xconfigAddNewOption(config, &input->options, "Device", device_path);
+    xconfigAddNewOption(config, &input->options, "Emulate3Buttons",
                               (entry->emulate3 ? "yes" : "no"));
     TEST_FREE(device_path);
 
@@ -1012,7 +1023,7 @@ int xconfigAddMouse(GenerateOptions *gop, XConfigPtr config)
      * ignore ZAxisMapping
      */
 
-    xconfigAddNewOption(&input->options, "ZAxisMapping", "4 5");
+    xconfigAddNewOption(config, &input->options, "ZAxisMapping", "4 5");
 
     input->next = config->inputs;
     config->inputs = input;
@@ -1177,7 +1188,7 @@ void xconfigGeneratePrintPossibleKeyboards(void)
 
 int xconfigAddKeyboard(GenerateOptions *gop, XConfigPtr config)
 {
-    char *value, *comment = "default";
+    char *value, *tmp, *comment = "default";
     const KeyboardEntry *entry = NULL;
 
     XConfigInputPtr input;
@@ -1214,11 +1225,12 @@ int xconfigAddKeyboard(GenerateOptions *gop, XConfigPtr config)
 
     /* add a new keyboard input section */
 
-    input = xconfigAlloc(sizeof(XConfigInputRec));
+    input = xconfigArenaAlloc(config, sizeof(XConfigInputRec));
 
-    input->comment = xconfigStrcat("    # generated from ",
-                                   comment, "\n", NULL);
-    input->identifier = xconfigStrdup("Keyboard0");
+    tmp = xconfigStrcat("    # generated from ", comment, "\n", NULL);
+    input->comment = xconfigArenaStrdup(config, tmp);
+    free(tmp);
+    input->identifier = xconfigIntern(config, "Keyboard0");
 
     /*
      * determine which keyboard driver should be used (either "kbd" or
@@ -1229,12 +1241,12 @@ int xconfigAddKeyboard(GenerateOptions *gop, XConfigPtr config)
      */
 
     if (gop->keyboard_driver) {
-        input->driver = gop->keyboard_driver;
+        input->driver = xconfigIntern(config, gop->keyboard_driver);
     } else {
 #if defined(NV_SUNOS) || defined(NV_BSD)
-        input->driver = xconfigStrdup("keyboard");
+        input->driver = xconfigIntern(config, "keyboard");
 #else
-        input->driver = xconfigStrdup("kbd");
+        input->driver = xconfigIntern(config, "kbd");
 #endif
     }
 
@@ -1247,13 +1259,17 @@ int xconfigAddKeyboard(GenerateOptions *gop, XConfigPtr config)
 
     if (entry) {
         if (entry->layout)
-            xconfigAddNewOption(&input->options, "XkbLayout", entry->layout);
+            xconfigAddNewOption(config, &input->options, "XkbLayout",
+                                entry->layout);
         if (entry->model)
-            xconfigAddNewOption(&input->options, "XkbModel", entry->model);
+            xconfigAddNewOption(config, &input->options, "XkbModel",
+                                entry->model);
         if (entry->variant)
-            xconfigAddNewOption(&input->options, "XkbVariant", entry->variant);
+            xconfigAddNewOption(config, &input->options, "XkbVariant",
+                                entry->variant);
         if (entry->options)
-            xconfigAddNewOption(&input->options, "XkbOptions", entry->options);
+            xconfigAddNewOption(config, &input->options, "XkbOptions",
+                                entry->options);
     }
 
     input->next = config->inputs;
@@ -0,0 +1,254 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * Index.c - hash indexes on the identifiers of a config's sections.
+ *
+ * xconfigFindScreen() and friends walk a list comparing names, so
+ * resolving every reference in a config with hundreds of screens takes
+ * time proportional to references times sections.  Validation,
+ * sanitizing and merging instead look sections up with
+ * xconfigIndexFind(), which builds a hash table for a list the first
+ * time it is searched and answers from it after that; it finds the
+ * same section xconfigFind*() would, the first one whose identifier
+ * matches by xconfigNameCompare().  Identifiers are compared through
+ * their name keys (see Intern.c).
+ *
+ * A table is rebuilt when its list's head has changed; sections added
+ * anywhere else in a list must be recorded with xconfigIndexAdd().
+ * Other changes, such as removing a section or renaming one, need
+ * xconfigInvalidateIndexes().  Validation, sanitizing and merging start
+ * by invalidating the indexes, so lists changed directly between those
+ * steps are always seen correctly.  Like the string pool, the tables
+ * are allocated from the config's arena.
+ */
+
+#include <stddef.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+
+typedef struct {
+    XConfigNameKeyRec key;          /* of the node's identifier */
+    void *node;
+} XConfigIndexSlotRec;
+
+typedef struct {
+    void *head;                     /* the list the table describes */
+    XConfigIndexSlotRec *slots;     /* open addressing, linear probing */
+    size_t mask;                    /* number of slots - 1 */
+    size_t count;
+    int built;
+} XConfigIndexTableRec;
+
+struct __XConfigIndexRec {
+    XConfigIndexTableRec tables[XCONFIG_INDEX_KINDS];
+};
+
+
+/*
+ * where each kind of section's list is in XConfigRec, and where the
+ * identifier is in each section; in XCONFIG_INDEX_* order
+ */
+
+static const struct {
+    size_t list;
+    size_t identifier;
+} IndexKinds[XCONFIG_INDEX_KINDS] = {
+    { offsetof(XConfigRec, devices),
+      offsetof(XConfigDeviceRec, identifier) },
+    { offsetof(XConfigRec, monitors),
+      offsetof(XConfigMonitorRec, identifier) },
+    { offsetof(XConfigRec, modes),
+      offsetof(XConfigModesRec, identifier) },
+    { offsetof(XConfigRec, screens),
+      offsetof(XConfigScreenRec, identifier) },
+    { offsetof(XConfigRec, inputs),
+      offsetof(XConfigInputRec, identifier) },
+    { offsetof(XConfigRec, layouts),
+      offsetof(XConfigLayoutRec, identifier) },
+    { offsetof(XConfigRec, videoadaptors),
+      offsetof(XConfigVideoAdaptorRec, identifier) },
+};
+
+#define LIST_HEAD(config, kind) \
+    (*(void **) ((char *) (config) + IndexKinds[kind].list))
+
+#define IDENTIFIER(node, kind) \
+    (*(const char **) ((char *) (node) + IndexKinds[kind].identifier))
+
+
+/*
+ * TableInsert() - add node to the table, unless a node with the same
+ * name is already there; that one comes first in the list, so it is
+ * the one lookups should find.
+ */
+
+static void TableInsert(XConfigPtr config, XConfigIndexTableRec *table,
+                        int kind, void *node)
+{
+    XConfigNameKeyRec key;
+    size_t i;
+
+    xconfigNameKey(config, IDENTIFIER(node, kind), &key);
+
+    if ((table->count + 1) * 2 > table->mask + 1) {
+        XConfigIndexSlotRec *old = table->slots;
+        size_t oldMask = table->mask, j;
+
+        table->mask = table->mask ? (table->mask << 1) | 1 : 15;
+        table->slots = xconfigArenaAlloc(config, (table->mask + 1) *
+                                         sizeof(XConfigIndexSlotRec));
+
+        for (j = 0; old && j <= oldMask; j++) {
+            if (!old[j].node) continue;
+            for (i = old[j].key.hash & table->mask; table->slots[i].node;
+                 i = (i + 1) & table->mask);
+            table->slots[i] = old[j];
+        }
+    }
+
+    for (i = key.hash & table->mask; table->slots[i].node;
+         i = (i + 1) & table->mask) {
+        if (xconfigNameKeysEqual(&table->slots[i].key, &key)) {
+            return;
+        }
+    }
+
+    table->slots[i].key = key;
+    table->slots[i].node = node;
+    table->count++;
+}
+
+
+static XConfigIndexTableRec *GetTable(XConfigPtr config, int kind)
+{
+    if (!config->index) {
+        config->index = xconfigArenaAlloc(config, sizeof(XConfigIndexRec));
+    }
+
+    return &config->index->tables[kind];
+}
+
+
+/*
+ * BuildTable() - index the sections of the given kind in config.
+ */
+
+static void BuildTable(XConfigPtr config, XConfigIndexTableRec *table,
+                       int kind)
+{
+    GenericListPtr node;
+
+    table->head = LIST_HEAD(config, kind);
+    table->slots = NULL;
+    table->mask = 0;
+    table->count = 0;
+    table->built = TRUE;
+
+    for (node = table->head; node; node = node->next) {
+        TableInsert(config, table, kind, node);
+    }
+}
+
+
+/*
+ * xconfigIndexFind() - return the first section of the given
+ * XCONFIG_INDEX_* kind in config whose identifier matches ident, as
+ * the corresponding xconfigFind*() would, or NULL.
+ */
+
+void *xconfigIndexFind(XConfigPtr config, int kind, const char *ident)
+{
+    XConfigIndexTableRec *table = GetTable(config, kind);
+    XConfigNameKeyRec key;
+    size_t i;
+
+    if (!table->built || table->head != LIST_HEAD(config, kind)) {
+        BuildTable(config, table, kind);
+    }
+
+    if (!table->count) {
+        return NULL;
+    }
+
+    xconfigNameKey(config, ident, &key);
+
+    for (i = key.hash & table->mask; table->slots[i].node;
+         i = (i + 1) & table->mask) {
+        if (xconfigNameKeysEqual(&table->slots[i].key, &key)) {
+            return table->slots[i].node;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * xconfigIndexAdd() - record that node has just been added to the
+ * list of sections of the given kind in config.
+ */
+
+void xconfigIndexAdd(XConfigPtr config, int kind, void *node)
+{
+    XConfigIndexTableRec *table;
+
+    if (!config->index) {
+        return;
+    }
+
+    table = &config->index->tables[kind];
+
+    if (!table->built) {
+        return;
+    }
+
+    if (LIST_HEAD(config, kind) == node && table->head != node) {
+        /* node was put at the front; rebuild on the next lookup */
+        table->built = FALSE;
+        return;
+    }
+
+    TableInsert(config, table, kind, node);
+    table->head = LIST_HEAD(config, kind);
+}
+
+
+/*
+ * xconfigInvalidateIndexes() - have the indexes on config's sections
+ * rebuilt the next time they are used, and drop those on its option
+ * lists.  This is needed after sections are removed or renamed, or
+ * added other than by the parser's own functions, and after options
+ * are changed other than by the option functions.
+ */
+
+void xconfigInvalidateIndexes(XConfigPtr config)
+{
+    int kind;
+
+    xconfigInvalidateOptionMaps(config);
+
+    if (!config->index) {
+        return;
+    }
+
+    for (kind = 0; kind < XCONFIG_INDEX_KINDS; kind++) {
+        config->index->tables[kind].built = FALSE;
+    }
+}
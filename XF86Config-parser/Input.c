@@ -58,79 +58,47 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
+XCONFIG_KEYWORD_TABLE(InputTab);
 
-static
-XConfigSymTabRec InputTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {OPTION, "option"},
-    {DRIVER, "driver"},
-    {-1, ""},
-};
-
-static
-XConfigSymTabRec InputClassTab[] =
-{   {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {MATCHPRODUCT, "matchproduct"},
-    {MATCHVENDOR, "matchvendor"},
-    {MATCHOS, "matchos"},
-    {MATCHDEVICEPATH, "matchdevicepath"},
-    {MATCHPNPID, "matchpnpid"},
-    {MATCHUSBID, "matchusbid"},
-    {MATCHDRIVER, "matchdriver"},
-    {MATCHTAG, "matchtag"},
-    {MATCHISKEYBOARD, "matchiskeyboard"},
-    {MATCHISJOYSTICK, "matchisjoystick"},
-    {MATCHISTABLET, "matchistablet"},
-    {MATCHISTOUCHSCREEN, "matchistouchscreen"},
-    {MATCHISTOUCHPAD, "matchistouchpad"},
-    {MATCHISPOINTER, "matchispointer"},
-    {OPTION, "option"},
-    {DRIVER, "driver"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeInputList
+XCONFIG_KEYWORD_TABLE(InputClassTab);
 
 XConfigInputPtr
-xconfigParseInputSection (void)
+xconfigParseInputSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigInputPtr, XConfigInputRec)
 
-    while ((token = xconfigGetToken (InputTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &InputTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case DRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = parser->val.str;
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -141,115 +109,111 @@ xconfigParseInputSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
-#define CLEANUP xconfigFreeInputClassList
-
 XConfigInputClassPtr
-xconfigParseInputClassSection (void)
+xconfigParseInputClassSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigInputClassPtr, XConfigInputClassRec)
 
-    while ((token = xconfigGetToken (InputClassTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &InputClassTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case DRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = parser->val.str;
             break;
         case MATCHDEVICEPATH:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchDevicePath");
-            ptr->match_device_path = val.str;
+            ptr->match_device_path = parser->val.str;
             break;
         case MATCHISPOINTER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsPointer");
-            ptr->match_is_pointer = val.str;
+            ptr->match_is_pointer = parser->val.str;
             break;
         case MATCHISTOUCHPAD:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsTouchpad");
-            ptr->match_is_touchpad = val.str;
+            ptr->match_is_touchpad = parser->val.str;
             break;
         case MATCHISKEYBOARD:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsKeyboard");
-            ptr->match_is_keyboard = val.str;
+            ptr->match_is_keyboard = parser->val.str;
             break;
         case MATCHISTOUCHSCREEN:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsTouchscreen");
-            ptr->match_is_touchscreen = val.str;
+            ptr->match_is_touchscreen = parser->val.str;
             break;
         case MATCHISJOYSTICK:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsJoystick");
-            ptr->match_is_joystick = val.str;
+            ptr->match_is_joystick = parser->val.str;
             break;
         case MATCHISTABLET:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchIsTablet");
-            ptr->match_is_tablet = val.str;
+            ptr->match_is_tablet = parser->val.str;
             break;
         case MATCHUSBID:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchUSBID");
-            ptr->match_usb_id = val.str;
+            ptr->match_usb_id = parser->val.str;
             break;
         case MATCHPNPID:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchPnPID");
-            ptr->match_pnp_id = val.str;
+            ptr->match_pnp_id = parser->val.str;
             break;
         case MATCHPRODUCT:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchProduct");
-            ptr->match_product = val.str;
+            ptr->match_product = parser->val.str;
             break;
         case MATCHDRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchDriver");
-            ptr->match_driver = val.str;
+            ptr->match_driver = parser->val.str;
             break;
         case MATCHOS:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchOS");
-            ptr->match_os = val.str;
+            ptr->match_os = parser->val.str;
             break;
         case MATCHTAG:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchTag");
-            ptr->match_tag = val.str;
+            ptr->match_tag = parser->val.str;
             break;
         case MATCHVENDOR:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "MatchVendor");
-            ptr->match_vendor = val.str;
+            ptr->match_vendor = parser->val.str;
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -260,8 +224,6 @@ xconfigParseInputClassSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintInputSection (FILE * cf, XConfigInputPtr ptr)
 {
@@ -324,83 +286,29 @@ xconfigPrintInputClassSection (FILE * cf, XConfigInputClassPtr ptr)
     }
 }
 
-void
-xconfigFreeInputList (XConfigInputPtr *ptr)
-{
-    XConfigInputPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->driver);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeOptionList (&((*ptr)->options));
-
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeInputClassList (XConfigInputClassPtr *ptr)
-{
-    XConfigInputClassPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->driver);
-        TEST_FREE ((*ptr)->comment);
-        TEST_FREE ((*ptr)->match_product);
-        TEST_FREE ((*ptr)->match_vendor);
-        TEST_FREE ((*ptr)->match_driver);
-        TEST_FREE ((*ptr)->match_device_path);
-        TEST_FREE ((*ptr)->match_os);
-        TEST_FREE ((*ptr)->match_pnp_id);
-        TEST_FREE ((*ptr)->match_usb_id);
-        TEST_FREE ((*ptr)->match_is_pointer);
-        TEST_FREE ((*ptr)->match_is_touchpad);
-        TEST_FREE ((*ptr)->match_is_touchscreen);
-        TEST_FREE ((*ptr)->match_is_keyboard);
-        TEST_FREE ((*ptr)->match_is_tablet);
-        TEST_FREE ((*ptr)->match_is_joystick);
-        xconfigFreeOptionList (&((*ptr)->options));
-
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
 int
 xconfigValidateInput (XConfigPtr p)
 {
     XConfigInputPtr input = p->inputs;
+    int ret = TRUE;
 
 #if 0 /* Enable this later */
     if (!input) {
-        xconfigErrorMsg(ValidationErrorMsg, "At least one InputDevice section "
-                     "is required.");
-        return (FALSE);
+        xconfigValidationErrorMsg(p, "At least one InputDevice section "
+                                  "is required.");
+        VALIDATION_FAILED(p, ret);
     }
 #endif
 
     while (input) {
         if (!input->driver) {
-            xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_INPUTDRIVER_MSG,
-                         input->identifier);
-            return (FALSE);
+            xconfigValidationErrorMsg(p, UNDEFINED_INPUTDRIVER_MSG,
+                                      input->identifier);
+            VALIDATION_FAILED(p, ret);
         }
         input = input->next;
     }
-    return (TRUE);
+    return (ret);
 }
 
 XConfigInputPtr
@@ -509,7 +417,8 @@ static int getCoreInputDevice(GenerateOptions *gop,
  tryAgain:
     
     if (!core) {
-        input = xconfigFindInput(implicitDriverName, config->inputs);
+        input = xconfigIndexFind(config, XCONFIG_INDEX_INPUT,
+                                 implicitDriverName);
         if (!input && defaultDriver0) {
             input = xconfigFindInputByDriver(defaultDriver0, config->inputs);
         }
@@ -573,9 +482,9 @@ static int getCoreInputDevice(GenerateOptions *gop,
         }
     }
     if (!found) {
-        inputRef = calloc(1, sizeof(XConfigInputrefRec));
+        inputRef = xconfigArenaAlloc(config, sizeof(XConfigInputrefRec));
         inputRef->input = core;
-        inputRef->input_name = strdup(core->identifier);
+        inputRef->input_name = core->identifier;
         inputRef->next = layout->inputs;
         layout->inputs = inputRef;
     }
@@ -592,7 +501,8 @@ static int getCoreInputDevice(GenerateOptions *gop,
             opt2 = xconfigFindOption(inputRef->options, coreKeyword);
 
             if (!opt1 && !opt2) {
-                xconfigAddNewOption(&inputRef->options, coreKeyword, NULL);
+                xconfigAddNewOption(config, &inputRef->options, coreKeyword,
+                                    NULL);
             }
             break;
         }
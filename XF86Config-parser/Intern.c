@@ -0,0 +1,327 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * Intern.c - the string pool owned by each XConfigRec.
+ *
+ * Every identifier, section reference, driver name and option name or
+ * value in a config is stored in its config's pool; the tree only
+ * holds pointers into the pool.  Strings with equal pointers are equal,
+ * but not the other way around: a config that adopted another's pool
+ * (see xconfigMergeStringPool()) may hold two copies of a string, so
+ * strings must still be compared by their contents.  The pool, its
+ * hash table and its strings are all allocated from the config's
+ * arena.  Comments are the exception: they are edited in place with
+ * xconfigAddComment(), and so are allocated from the arena directly,
+ * without being pooled.
+ *
+ * Strings used as names also get a name key (see xconfigNameKey()): the
+ * canonical form xconfigNameCompare() compares, pooled, and its hash.
+ * Keys are computed the first time a string is used as a name and then
+ * found by the string's address, so indexes compare names with a hash
+ * check and a memcmp() rather than normalizing both every time.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+
+/* initial number of hash table slots; always a power of two */
+#define POOL_INITIAL_SLOTS 256
+#define KEYS_INITIAL_SLOTS 64
+
+/* names up to this long are made canonical without allocating */
+#define NAME_KEY_BUF_LEN 256
+
+typedef struct {
+    unsigned int hash;
+    const char *str;
+} XConfigStringSlotRec;
+
+typedef struct {
+    const char *str;               /* a pooled string, found by address */
+    XConfigNameKeyRec key;
+} XConfigNameKeySlotRec;
+
+struct __XConfigStringPoolRec {
+    XConfigStringSlotRec *slots;   /* open addressing, linear probing */
+    size_t mask;                   /* number of slots - 1 */
+    size_t count;                  /* number of strings in the pool */
+    XConfigNameKeySlotRec *keys;   /* name keys, by string address */
+    size_t keysMask;
+    size_t keysCount;
+};
+
+
+static unsigned int StringHash(const char *s, size_t len)
+{
+    unsigned int h = 2166136261U;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h = (h ^ (unsigned char) s[i]) * 16777619U;
+    }
+
+    return h;
+}
+
+
+/*
+ * PoolGrow() - double the number of hash table slots, rehashing the
+ * strings already in the pool.
+ */
+
+static void PoolGrow(XConfigPtr config)
+{
+    XConfigStringPoolPtr pool = config->strings;
+    XConfigStringSlotRec *old = pool->slots;
+    size_t oldMask = pool->mask, i, j;
+
+    pool->mask = (pool->mask << 1) | 1;
+    pool->slots = xconfigArenaAlloc(config, (pool->mask + 1) *
+                                    sizeof(XConfigStringSlotRec));
+
+    for (i = 0; i <= oldMask; i++) {
+        if (!old[i].str) continue;
+        for (j = old[i].hash & pool->mask;
+             pool->slots[j].str;
+             j = (j + 1) & pool->mask);
+        pool->slots[j] = old[i];
+    }
+}
+
+
+XConfigStringPoolPtr xconfigAllocStringPool(XConfigPtr config)
+{
+    XConfigStringPoolPtr pool =
+        xconfigArenaAlloc(config, sizeof(XConfigStringPoolRec));
+
+    pool->mask = POOL_INITIAL_SLOTS - 1;
+    pool->slots = xconfigArenaAlloc(config, POOL_INITIAL_SLOTS *
+                                    sizeof(XConfigStringSlotRec));
+
+    return pool;
+}
+
+
+/*
+ * xconfigInternLen() - return the pool's copy of the first len bytes of
+ * s, adding it to the pool if this is the first time it has been seen.
+ */
+
+const char *xconfigInternLen(XConfigPtr config, const char *s, size_t len)
+{
+    XConfigStringPoolPtr pool = config->strings;
+    unsigned int hash = StringHash(s, len);
+    char *str;
+    size_t i;
+
+    for (i = hash & pool->mask; pool->slots[i].str; i = (i + 1) & pool->mask) {
+        if (pool->slots[i].hash == hash &&
+            strncmp(pool->slots[i].str, s, len) == 0 &&
+            pool->slots[i].str[len] == '\0') {
+            return pool->slots[i].str;
+        }
+    }
+
+    str = xconfigArenaAlloc(config, len + 1);
+    memcpy(str, s, len);
+
+    pool->slots[i].hash = hash;
+    pool->slots[i].str = str;
+
+    /* keep the table at most half full */
+
+    if (++pool->count * 2 > pool->mask) {
+        PoolGrow(config);
+    }
+
+    return str;
+}
+
+
+/*
+ * xconfigIntern() - return config's copy of the string s; NULL is
+ * returned unchanged.  The result lives as long as config does.
+ */
+
+const char *xconfigIntern(XConfigPtr config, const char *s)
+{
+    if (!s) return NULL;
+
+    return xconfigInternLen(config, s, strlen(s));
+}
+
+
+/*
+ * name keys
+ */
+
+static size_t AddressHash(const char *s)
+{
+    uintptr_t v = (uintptr_t) s;
+
+    return (size_t) ((v >> 3) * 2654435761U);
+}
+
+
+static XConfigNameKeySlotRec *FindKeySlot(XConfigStringPoolPtr pool,
+                                          const char *str)
+{
+    size_t i;
+
+    for (i = AddressHash(str) & pool->keysMask; pool->keys[i].str;
+         i = (i + 1) & pool->keysMask) {
+        if (pool->keys[i].str == str) break;
+    }
+
+    return &pool->keys[i];
+}
+
+
+static void KeysGrow(XConfigPtr config)
+{
+    XConfigStringPoolPtr pool = config->strings;
+    XConfigNameKeySlotRec *old = pool->keys;
+    size_t oldMask = pool->keysMask, i;
+
+    pool->keysMask = old ? (oldMask << 1) | 1 : KEYS_INITIAL_SLOTS - 1;
+    pool->keys = xconfigArenaAlloc(config, (pool->keysMask + 1) *
+                                   sizeof(XConfigNameKeySlotRec));
+
+    for (i = 0; old && i <= oldMask; i++) {
+        if (old[i].str) *FindKeySlot(pool, old[i].str) = old[i];
+    }
+}
+
+
+/*
+ * xconfigNameKey() - set *key to the name key of s: s lowercased and
+ * without '_', ' ' and '\t', held in config's pool, and its hash, which
+ * is xconfigNameHash(s).  NULL has the key of "".  s need not be from
+ * config's pool, but keys are only remembered for strings that are, so
+ * for those this is a single probe after the first time.
+ */
+
+void xconfigNameKey(XConfigPtr config, const char *s, XConfigNameKeyRec *key)
+{
+    XConfigStringPoolPtr pool = config->strings;
+    XConfigNameKeySlotRec *slot;
+    char buf[NAME_KEY_BUF_LEN], *canon = buf;
+    const char *c;
+    size_t len = 0, size;
+
+    if (!s) s = "";
+
+    if (pool->keys) {
+        slot = FindKeySlot(pool, s);
+        if (slot->str) {
+            *key = slot->key;
+            return;
+        }
+    }
+
+    s = xconfigIntern(config, s);
+
+    if (pool->keys) {
+        slot = FindKeySlot(pool, s);
+        if (slot->str) {
+            *key = slot->key;
+            return;
+        }
+    }
+
+    size = strlen(s);
+    if (size >= sizeof(buf)) canon = xconfigAlloc(size + 1);
+
+    for (c = s; *c; c++) {
+        if (*c == '_' || *c == ' ' || *c == '\t') continue;
+        canon[len++] = (*c >= 'A' && *c <= 'Z') ? *c - 'A' + 'a' : *c;
+    }
+
+    key->key = xconfigInternLen(config, canon, len);
+    key->len = len;
+    key->hash = StringHash(canon, len);
+
+    if (canon != buf) free(canon);
+
+    if ((pool->keysCount + 1) * 2 > pool->keysMask) {
+        KeysGrow(config);
+    }
+
+    slot = FindKeySlot(pool, s);
+    slot->str = s;
+    slot->key = *key;
+    pool->keysCount++;
+}
+
+
+/*
+ * xconfigNameKeysEqual() - whether the names two keys were made from
+ * are equal by xconfigNameCompare(); the keys may come from different
+ * configs.
+ */
+
+int xconfigNameKeysEqual(const XConfigNameKeyRec *k1,
+                         const XConfigNameKeyRec *k2)
+{
+    if (k1->hash != k2->hash || k1->len != k2->len) return FALSE;
+
+    return k1->key == k2->key || memcmp(k1->key, k2->key, k1->len) == 0;
+}
+
+
+/*
+ * xconfigMergeStringPool() - add the strings in from's pool to
+ * config's, without copying them; the strings must live as long as
+ * config does.  Strings config already has are left alone, so the
+ * parts of the tree from from keep pointing at from's copies of them.
+ */
+
+void xconfigMergeStringPool(XConfigPtr config, XConfigPtr from)
+{
+    XConfigStringPoolPtr pool = config->strings;
+    XConfigStringPoolPtr fromPool = from->strings;
+    XConfigStringSlotRec *slot;
+    size_t i, j;
+
+    for (i = 0; i <= fromPool->mask; i++) {
+        slot = &fromPool->slots[i];
+        if (!slot->str) continue;
+
+        for (j = slot->hash & pool->mask;
+             pool->slots[j].str;
+             j = (j + 1) & pool->mask) {
+            if (pool->slots[j].hash == slot->hash &&
+                strcmp(pool->slots[j].str, slot->str) == 0) {
+                break;
+            }
+        }
+
+        if (pool->slots[j].str) continue;
+
+        pool->slots[j] = *slot;
+
+        if (++pool->count * 2 > pool->mask) {
+            PoolGrow(config);
+        }
+    }
+}
@@ -58,213 +58,189 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 #include "ctype.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec KeyboardTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {KPROTOCOL, "protocol"},
-    {AUTOREPEAT, "autorepeat"},
-    {XLEDS, "xleds"},
-    {PANIX106, "panix106"},
-    {XKBKEYMAP, "xkbkeymap"},
-    {XKBCOMPAT, "xkbcompat"},
-    {XKBTYPES, "xkbtypes"},
-    {XKBKEYCODES, "xkbkeycodes"},
-    {XKBGEOMETRY, "xkbgeometry"},
-    {XKBSYMBOLS, "xkbsymbols"},
-    {XKBDISABLE, "xkbdisable"},
-    {XKBRULES, "xkbrules"},
-    {XKBMODEL, "xkbmodel"},
-    {XKBLAYOUT, "xkblayout"},
-    {XKBVARIANT, "xkbvariant"},
-    {XKBOPTIONS, "xkboptions"},
-    /* The next two have become ServerFlags options */
-    {VTINIT, "vtinit"},
-    {VTSYSREQ, "vtsysreq"},
-    /* Obsolete keywords */
-    {SERVERNUM, "servernumlock"},
-    {LEFTALT, "leftalt"},
-    {RIGHTALT, "rightalt"},
-    {RIGHTALT, "altgr"},
-    {SCROLLLOCK_TOK, "scrolllock"},
-    {RIGHTCTL, "rightctl"},
-    {-1, ""},
-};
+XCONFIG_KEYWORD_TABLE(KeyboardTab);
 
 /* Obsolete */
-static XConfigSymTabRec KeyMapTab[] =
-{
-    {CONF_KM_META, "meta"},
-    {CONF_KM_COMPOSE, "compose"},
-    {CONF_KM_MODESHIFT, "modeshift"},
-    {CONF_KM_MODELOCK, "modelock"},
-    {CONF_KM_SCROLLLOCK, "scrolllock"},
-    {CONF_KM_CONTROL, "control"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeInputList
+XCONFIG_KEYWORD_TABLE(KeyMapTab);
 
 XConfigInputPtr
-xconfigParseKeyboardSection (void)
+xconfigParseKeyboardSection (XConfigParserPtr parser)
 {
     char *s, *s1, *s2;
     int l;
     int token, ntoken;
     PARSE_PROLOGUE (XConfigInputPtr, XConfigInputRec)
 
-        while ((token = xconfigGetToken (KeyboardTab)) != ENDSECTION)
+        while ((token = xconfigGetToken (parser, &KeyboardTab)) != ENDSECTION)
         {
             switch (token)
             {
             case COMMENT:
-                ptr->comment = xconfigAddComment(ptr->comment, val.str);
+                ptr->comment = xconfigParserAddComment(parser, ptr->comment);
                 break;
             case KPROTOCOL:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "Protocol");
-                xconfigAddNewOption(&ptr->options, "Protocol", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "Protocol",
+                                    parser->val.str);
                 break;
             case AUTOREPEAT:
-                if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                     Error (AUTOREPEAT_MSG, NULL);
-                s1 = xconfigULongToString(val.num);
-                if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+                s1 = xconfigULongToString(parser->val.num);
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                     Error (AUTOREPEAT_MSG, NULL);
-                s2 = xconfigULongToString(val.num);
+                s2 = xconfigULongToString(parser->val.num);
                 l = strlen(s1) + 1 + strlen(s2) + 1;
                 s = malloc(l);
                 sprintf(s, "%s %s", s1, s2);
                 free(s1);
                 free(s2);
-                xconfigAddNewOption(&ptr->options, "AutoRepeat", s);
+                xconfigAddNewOption(parser->config, &ptr->options, "AutoRepeat",
+                                    s);
+                free(s);
                 break;
             case XLEDS:
-                if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                     Error (XLEDS_MSG, NULL);
-                s = xconfigULongToString(val.num);
+                s = xconfigULongToString(parser->val.num);
                 l = strlen(s) + 1;
-                while ((token = xconfigGetSubToken(&(ptr->comment))) == NUMBER)
+                while ((token = xconfigGetSubToken(parser,
+                                                   &(ptr->comment))) == NUMBER)
                 {
-                    s1 = xconfigULongToString(val.num);
+                    s1 = xconfigULongToString(parser->val.num);
                     l += (1 + strlen(s1));
                     s = realloc(s, l);
                     strcat(s, " ");
                     strcat(s, s1);
                     free(s1);
                 }
-                xconfigUnGetToken (token);
+                xconfigUnGetToken (parser, token);
                 break;
             case SERVERNUM:
-                xconfigErrorMsg(ParseWarningMsg, OBSOLETE_MSG,
-                                xconfigTokenString());
+                xconfigParserErrorMsg(parser, ParseWarningMsg, OBSOLETE_MSG,
+                                      xconfigTokenString(parser));
                 break;
             case LEFTALT:
             case RIGHTALT:
             case SCROLLLOCK_TOK:
             case RIGHTCTL:
-                xconfigErrorMsg(ParseWarningMsg, OBSOLETE_MSG,
-                                xconfigTokenString());
+                xconfigParserErrorMsg(parser, ParseWarningMsg, OBSOLETE_MSG,
+                                      xconfigTokenString(parser));
                 break;
-                ntoken = xconfigGetToken (KeyMapTab);
+                ntoken = xconfigGetToken (parser, &KeyMapTab);
                 switch (ntoken)
                 {
                 case EOF_TOKEN:
-                    xconfigErrorMsg(ParseErrorMsg, UNEXPECTED_EOF_MSG);
-                    CLEANUP (&ptr);
+                    xconfigParserErrorMsg(parser, ParseErrorMsg,
+                                          UNEXPECTED_EOF_MSG);
                     return (NULL);
                     break;
                     
                 default:
-                    Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+                    Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
                     break;
                 }
                 break;
             case VTINIT:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "VTInit");
-                xconfigErrorMsg(ParseWarningMsg, MOVED_TO_FLAGS_MSG, "VTInit");
+                xconfigParserErrorMsg(parser, ParseWarningMsg,
+                                      MOVED_TO_FLAGS_MSG, "VTInit");
                 break;
             case VTSYSREQ:
-                xconfigErrorMsg(ParseWarningMsg,
-                                MOVED_TO_FLAGS_MSG, "VTSysReq");
+                xconfigParserErrorMsg(parser, ParseWarningMsg,
+                                      MOVED_TO_FLAGS_MSG, "VTSysReq");
                 break;
             case XKBDISABLE:
-                xconfigAddNewOption(&ptr->options, "XkbDisable", NULL);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbDisable",
+                                    NULL);
                 break;
             case XKBKEYMAP:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBKeymap");
-                xconfigAddNewOption(&ptr->options, "XkbKeymap", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbKeymap",
+                                    parser->val.str);
                 break;
             case XKBCOMPAT:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBCompat");
-                xconfigAddNewOption(&ptr->options, "XkbCompat", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbCompat",
+                                    parser->val.str);
                 break;
             case XKBTYPES:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBTypes");
-                xconfigAddNewOption(&ptr->options, "XkbTypes", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbTypes",
+                                    parser->val.str);
                 break;
             case XKBKEYCODES:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBKeycodes");
-                xconfigAddNewOption(&ptr->options, "XkbKeycodes", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options,
+                                    "XkbKeycodes", parser->val.str);
                 break;
             case XKBGEOMETRY:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBGeometry");
-                xconfigAddNewOption(&ptr->options, "XkbGeometry", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options,
+                                    "XkbGeometry", parser->val.str);
                 break;
             case XKBSYMBOLS:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBSymbols");
-                xconfigAddNewOption(&ptr->options, "XkbSymbols", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbSymbols",
+                                    parser->val.str);
                 break;
             case XKBRULES:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBRules");
-                xconfigAddNewOption(&ptr->options, "XkbRules", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbRules",
+                                    parser->val.str);
                 break;
             case XKBMODEL:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBModel");
-                xconfigAddNewOption(&ptr->options, "XkbModel", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbModel",
+                                    parser->val.str);
                 break;
             case XKBLAYOUT:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBLayout");
-                xconfigAddNewOption(&ptr->options, "XkbLayout", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbLayout",
+                                    parser->val.str);
                 break;
             case XKBVARIANT:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBVariant");
-                xconfigAddNewOption(&ptr->options, "XkbVariant", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbVariant",
+                                    parser->val.str);
                 break;
             case XKBOPTIONS:
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "XKBOptions");
-                xconfigAddNewOption(&ptr->options, "XkbOptions", val.str);
+                xconfigAddNewOption(parser->config, &ptr->options, "XkbOptions",
+                                    parser->val.str);
                 break;
             case PANIX106:
-                xconfigAddNewOption(&ptr->options, "Panix106", NULL);
+                xconfigAddNewOption(parser->config, &ptr->options, "Panix106",
+                                    NULL);
                 break;
             case EOF_TOKEN:
                 Error (UNEXPECTED_EOF_MSG, NULL);
                 break;
             default:
-                Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+                Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
                 break;
             }
         }
     
-    ptr->identifier = xconfigStrdup(CONF_IMPLICIT_KEYBOARD);
-    ptr->driver = xconfigStrdup("keyboard");
-    xconfigAddNewOption(&ptr->options, "CoreKeyboard", NULL);
+    ptr->identifier = xconfigIntern(parser->config, CONF_IMPLICIT_KEYBOARD);
+    ptr->driver = xconfigIntern(parser->config, "keyboard");
+    xconfigAddNewOption(parser->config, &ptr->options, "CoreKeyboard", NULL);
     
     return ptr;
 }
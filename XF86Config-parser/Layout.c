@@ -58,71 +58,52 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 #include <string.h>
 
-extern LexRec val;
+XCONFIG_KEYWORD_TABLE(LayoutTab);
 
-static XConfigSymTabRec LayoutTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {SCREEN, "screen"},
-    {IDENTIFIER, "identifier"},
-    {INACTIVE, "inactive"},
-    {INPUTDEVICE, "inputdevice"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-static XConfigSymTabRec AdjTab[] =
-{
-    {RIGHTOF, "rightof"},
-    {LEFTOF, "leftof"},
-    {ABOVE, "above"},
-    {BELOW, "below"},
-    {RELATIVE, "relative"},
-    {ABSOLUTE, "absolute"},
-    {-1, ""},
-};
+XCONFIG_KEYWORD_TABLE(AdjTab);
 
 
 static int addImpliedLayout(XConfigPtr config, const char *screenName);
 
 
-#define CLEANUP xconfigFreeLayoutList
-
 XConfigLayoutPtr
-xconfigParseLayoutSection (void)
+xconfigParseLayoutSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigLayoutPtr, XConfigLayoutRec)
 
-    while ((token = xconfigGetToken (LayoutTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &LayoutTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case INACTIVE:
             {
                 XConfigInactivePtr iptr;
 
-                iptr = calloc (1, sizeof (XConfigInactiveRec));
+                iptr = xconfigArenaAlloc (parser->config,
+                                          sizeof (XConfigInactiveRec));
                 iptr->next = NULL;
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (INACTIVE_MSG, NULL);
-                iptr->device_name = val.str;
-                xconfigAddListItem((GenericListPtr *)(&ptr->inactives),
-                                   (GenericListPtr) iptr);
+                iptr->device_name = parser->val.str;
+                xconfigParserAddListItem(parser,
+                                         (GenericListPtr *)(&ptr->inactives),
+                                         (GenericListPtr) iptr);
             }
             break;
         case SCREEN:
@@ -130,23 +111,26 @@ xconfigParseLayoutSection (void)
                 XConfigAdjacencyPtr aptr;
                 int absKeyword = 0;
 
-                aptr = calloc (1, sizeof (XConfigAdjacencyRec));
+                aptr = xconfigArenaAlloc (parser->config,
+                                          sizeof (XConfigAdjacencyRec));
                 aptr->next = NULL;
                 aptr->scrnum = -1;
                 aptr->where = CONF_ADJ_OBSOLETE;
                 aptr->x = 0;
                 aptr->y = 0;
                 aptr->refscreen = NULL;
-                if ((token = xconfigGetSubToken (&(ptr->comment))) == NUMBER)
-                    aptr->scrnum = val.num;
+                if ((token = xconfigGetSubToken (parser,
+                                                 &(ptr->comment))) == NUMBER)
+                    aptr->scrnum = parser->val.num;
                 else
-                    xconfigUnGetToken (token);
-                token = xconfigGetSubToken(&(ptr->comment));
+                    xconfigUnGetToken (parser, token);
+                token = xconfigGetSubToken(parser, &(ptr->comment));
                 if (token != STRING)
                     Error (SCREEN_MSG, NULL);
-                aptr->screen_name = val.str;
+                aptr->screen_name = parser->val.str;
 
-                token = xconfigGetSubTokenWithTab(&(ptr->comment), AdjTab);
+                token = xconfigGetSubTokenWithTab(parser, &(ptr->comment),
+                                                  &AdjTab);
                 switch (token)
                 {
                 case RIGHTOF:
@@ -172,8 +156,8 @@ xconfigParseLayoutSection (void)
                     Error (UNEXPECTED_EOF_MSG, NULL);
                     break;
                 default:
-                    xconfigUnGetToken (token);
-                    token = xconfigGetSubToken(&(ptr->comment));
+                    xconfigUnGetToken (parser, token);
+                    token = xconfigGetSubToken(parser, &(ptr->comment));
                     if (token == STRING)
                         aptr->where = CONF_ADJ_OBSOLETE;
                     else
@@ -183,19 +167,19 @@ xconfigParseLayoutSection (void)
                 {
                 case CONF_ADJ_ABSOLUTE:
                     if (absKeyword) 
-                        token = xconfigGetSubToken(&(ptr->comment));
+                        token = xconfigGetSubToken(parser, &(ptr->comment));
                     if (token == NUMBER)
                     {
-                        aptr->x = val.num;
-                        token = xconfigGetSubToken(&(ptr->comment));
+                        aptr->x = parser->val.num;
+                        token = xconfigGetSubToken(parser, &(ptr->comment));
                         if (token != NUMBER)
                             Error(INVALID_SCR_MSG, NULL);
-                        aptr->y = val.num;
+                        aptr->y = parser->val.num;
                     } else {
                         if (absKeyword)
                             Error(INVALID_SCR_MSG, NULL);
                         else
-                            xconfigUnGetToken (token);
+                            xconfigUnGetToken (parser, token);
                     }
                     break;
                 case CONF_ADJ_RIGHTOF:
@@ -203,72 +187,77 @@ xconfigParseLayoutSection (void)
                 case CONF_ADJ_ABOVE:
                 case CONF_ADJ_BELOW:
                 case CONF_ADJ_RELATIVE:
-                    token = xconfigGetSubToken(&(ptr->comment));
+                    token = xconfigGetSubToken(parser, &(ptr->comment));
                     if (token != STRING)
                         Error(INVALID_SCR_MSG, NULL);
-                    aptr->refscreen = val.str;
+                    aptr->refscreen = parser->val.str;
                     if (aptr->where == CONF_ADJ_RELATIVE)
                     {
-                        token = xconfigGetSubToken(&(ptr->comment));
+                        token = xconfigGetSubToken(parser, &(ptr->comment));
                         if (token != NUMBER)
                             Error(INVALID_SCR_MSG, NULL);
-                        aptr->x = val.num;
-                        token = xconfigGetSubToken(&(ptr->comment));
+                        aptr->x = parser->val.num;
+                        token = xconfigGetSubToken(parser, &(ptr->comment));
                         if (token != NUMBER)
                             Error(INVALID_SCR_MSG, NULL);
-                        aptr->y = val.num;
+                        aptr->y = parser->val.num;
                     }
                     break;
                 case CONF_ADJ_OBSOLETE:
                     /* top */
-                    aptr->top_name = val.str;
+                    aptr->top_name = parser->val.str;
 
                     /* bottom */
-                    if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                    if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                         Error (SCREEN_MSG, NULL);
-                    aptr->bottom_name = val.str;
+                    aptr->bottom_name = parser->val.str;
 
                     /* left */
-                    if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                    if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                         Error (SCREEN_MSG, NULL);
-                    aptr->left_name = val.str;
+                    aptr->left_name = parser->val.str;
 
                     /* right */
-                    if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                    if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                         Error (SCREEN_MSG, NULL);
-                    aptr->right_name = val.str;
+                    aptr->right_name = parser->val.str;
 
                 }
-                xconfigAddListItem((GenericListPtr *)(&ptr->adjacencies),
-                                   (GenericListPtr) aptr);
+                xconfigParserAddListItem(parser,
+                                         (GenericListPtr *)(&ptr->adjacencies),
+                                         (GenericListPtr) aptr);
             }
             break;
         case INPUTDEVICE:
             {
                 XConfigInputrefPtr iptr;
 
-                iptr = calloc (1, sizeof (XConfigInputrefRec));
+                iptr = xconfigArenaAlloc (parser->config,
+                                          sizeof (XConfigInputrefRec));
                 iptr->next = NULL;
                 iptr->options = NULL;
-                if (xconfigGetSubToken(&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken(parser, &(ptr->comment)) != STRING)
                     Error (INPUTDEV_MSG, NULL);
-                iptr->input_name = val.str;
-                while ((token = xconfigGetSubToken(&(ptr->comment))) == STRING) {
-                    xconfigAddNewOption(&iptr->options, val.str, NULL);
+                iptr->input_name = parser->val.str;
+                while ((token = xconfigGetSubToken(parser, &(ptr->comment)))
+                       == STRING) {
+                    xconfigAddNewOption(parser->config, &iptr->options,
+                                        parser->val.str, NULL);
                 }
-                xconfigUnGetToken(token);
-                xconfigAddListItem((GenericListPtr *)(&ptr->inputs),
-                                   (GenericListPtr) iptr);
+                xconfigUnGetToken(parser, token);
+                xconfigParserAddListItem(parser,
+                                         (GenericListPtr *)(&ptr->inputs),
+                                         (GenericListPtr) iptr);
             }
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -279,8 +268,6 @@ xconfigParseLayoutSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintLayoutSection (FILE * cf, XConfigLayoutPtr ptr)
 {
@@ -354,75 +341,13 @@ xconfigPrintLayoutSection (FILE * cf, XConfigLayoutPtr ptr)
     }
 }
 
-void
-xconfigFreeLayoutList (XConfigLayoutPtr *ptr)
-{
-    XConfigLayoutPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeAdjacencyList (&((*ptr)->adjacencies));
-        xconfigFreeInputrefList (&((*ptr)->inputs));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeAdjacencyList (XConfigAdjacencyPtr *ptr)
-{
-    XConfigAdjacencyPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->screen_name);
-        TEST_FREE ((*ptr)->top_name);
-        TEST_FREE ((*ptr)->bottom_name);
-        TEST_FREE ((*ptr)->left_name);
-        TEST_FREE ((*ptr)->right_name);
-
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-
-}
-
-void
-xconfigFreeInputrefList (XConfigInputrefPtr *ptr)
-{
-    XConfigInputrefPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->input_name);
-        xconfigFreeOptionList (&((*ptr)->options));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-
-}
-
 #define CheckScreen(str, ptr)\
 if (str[0] != '\0') \
 { \
 screen = xconfigFindScreen (str, p->conf_screen_lst); \
 if (!screen) \
 { \
-    xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_SCREEN_MSG, \
+    xconfigValidationErrorMsg(p, UNDEFINED_SCREEN_MSG, \
                    str, layout->identifier); \
     return (FALSE); \
 } \
@@ -430,6 +355,30 @@ else \
     ptr = screen; \
 }
 
+void
+xconfigResolveLayoutReferences (XConfigPtr p)
+{
+    XConfigLayoutPtr layout;
+    XConfigAdjacencyPtr adj;
+    XConfigInactivePtr iptr;
+    XConfigInputrefPtr inputRef;
+
+    for (layout = p->layouts; layout; layout = layout->next)
+    {
+        for (adj = layout->adjacencies; adj; adj = adj->next)
+            adj->screen = xconfigIndexFind(p, XCONFIG_INDEX_SCREEN,
+                                           adj->screen_name);
+
+        for (iptr = layout->inactives; iptr; iptr = iptr->next)
+            iptr->device = xconfigIndexFind(p, XCONFIG_INDEX_DEVICE,
+                                            iptr->device_name);
+
+        for (inputRef = layout->inputs; inputRef; inputRef = inputRef->next)
+            inputRef->input = xconfigIndexFind(p, XCONFIG_INDEX_INPUT,
+                                               inputRef->input_name);
+    }
+}
+
 int
 xconfigValidateLayout (XConfigPtr p)
 {
@@ -437,9 +386,7 @@ xconfigValidateLayout (XConfigPtr p)
     XConfigAdjacencyPtr adj;
     XConfigInactivePtr iptr;
     XConfigInputrefPtr inputRef;
-    XConfigScreenPtr screen;
-    XConfigDevicePtr device;
-    XConfigInputPtr input;
+    int ret = TRUE;
 
     /*
      * if we do not have a layout, just return TRUE; we'll add a
@@ -454,15 +401,13 @@ xconfigValidateLayout (XConfigPtr p)
         while (adj)
         {
             /* the first one can't be "" but all others can */
-            screen = xconfigFindScreen (adj->screen_name, p->screens);
-            if (!screen)
+            if (!adj->screen &&
+                !xconfigSectionFailed(p, SCREEN_SECTION, adj->screen_name))
             {
-                xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_SCREEN_MSG,
-                             adj->screen_name, layout->identifier);
-                return (FALSE);
+                xconfigValidationErrorMsg(p, UNDEFINED_SCREEN_MSG,
+                                          adj->screen_name, layout->identifier);
+                VALIDATION_FAILED(p, ret);
             }
-            else
-                adj->screen = screen;
 
 #if 0
             CheckScreen (adj->top_name, adj->top);
@@ -478,16 +423,14 @@ xconfigValidateLayout (XConfigPtr p)
         iptr = layout->inactives;
         while (iptr)
         {
-            device = xconfigFindDevice (iptr->device_name,
-                                     p->devices);
-            if (!device)
+            if (!iptr->device &&
+                !xconfigSectionFailed(p, DEVICE_SECTION, iptr->device_name))
             {
-                xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_DEVICE_MSG,
-                             iptr->device_name, layout->identifier);
-                return (FALSE);
+                xconfigValidationErrorMsg(p, UNDEFINED_DEVICE_MSG,
+                                          iptr->device_name,
+                                          layout->identifier);
+                VALIDATION_FAILED(p, ret);
             }
-            else
-                iptr->device = device;
             iptr = iptr->next;
         }
 
@@ -500,22 +443,20 @@ xconfigValidateLayout (XConfigPtr p)
         inputRef = layout->inputs;
         while (inputRef)
         {
-            input = xconfigFindInput (inputRef->input_name,
-                                   p->inputs);
-            if (!input)
+            if (!inputRef->input &&
+                !xconfigSectionFailed(p, INPUTDEVICE_SECTION,
+                                      inputRef->input_name))
             {
-                xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_INPUT_MSG,
-                             inputRef->input_name, layout->identifier);
-                return (FALSE);
-            }
-            else {
-                inputRef->input = input;
+                xconfigValidationErrorMsg(p, UNDEFINED_INPUT_MSG,
+                                          inputRef->input_name,
+                                          layout->identifier);
+                VALIDATION_FAILED(p, ret);
             }
             inputRef = inputRef->next;
         }
         layout = layout->next;
     }
-    return (TRUE);
+    return (ret);
 }
 
 int
@@ -573,7 +514,7 @@ static int addImpliedLayout(XConfigPtr config, const char *screenName)
      */
     
     if (screenName) {
-        screen = xconfigFindScreen(screenName, config->screens);
+        screen = xconfigIndexFind(config, XCONFIG_INDEX_SCREEN, screenName);
         if (!screen) {
             xconfigErrorMsg(ErrorMsg, "No Screen section called \"%s\"\n",
                             screenName);
@@ -589,21 +530,22 @@ static int addImpliedLayout(XConfigPtr config, const char *screenName)
     
     /* allocate the new layout section */
     
-    layout = calloc(1, sizeof(XConfigLayoutRec));
+    layout = xconfigArenaAlloc(config, sizeof(XConfigLayoutRec));
     
-    layout->identifier = xconfigStrdup("Default Layout");
+    layout->identifier = xconfigIntern(config, "Default Layout");
     
-    adj = calloc(1, sizeof(XConfigAdjacencyRec));
+    adj = xconfigArenaAlloc(config, sizeof(XConfigAdjacencyRec));
     adj->scrnum = -1;
     adj->screen = screen;
-    adj->screen_name = xconfigStrdup(screen->identifier);
+    adj->screen_name = screen->identifier;
     
     layout->adjacencies = adj;
 
     config->layouts = layout;
     
-    /* validate the Layout here to setup all the pointers */
+    /* resolve and validate the Layout here to setup all the pointers */
 
+    xconfigResolveLayoutReferences(config);
     if (!xconfigValidateLayout(config)) return FALSE;
 
     return TRUE;
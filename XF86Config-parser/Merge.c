@@ -38,12 +38,13 @@
  * removed.
  *
  */
-static void xconfigAddRemovedOptionComment(char **existing_comments,
+static void xconfigAddRemovedOptionComment(XConfigPtr config,
+                                           char **existing_comments,
                                            XConfigOptionPtr option)
 {
     int len;
     char *str;
-    char *name, *value;
+    const char *name, *value;
 
     if (!option || !existing_comments)
         return;
@@ -65,7 +66,8 @@ static void xconfigAddRemovedOptionComment(char **existing_comments,
         snprintf(str, len, "# Removed Option \"%s\"", name);
     }
 
-    *existing_comments = xconfigAddComment(*existing_comments, str);
+    *existing_comments = xconfigAddComment(config, *existing_comments, str);
+    free(str);
 
 } /* xconfigAddRemovedOptionComment() */
 
@@ -76,17 +78,17 @@ static void xconfigAddRemovedOptionComment(char **existing_comments,
  * list and (if specified) adds a comment to an existing comments string
  *
  */
-void xconfigRemoveNamedOption(XConfigOptionPtr *pHead, const char *name,
-                              char **comments)
+void xconfigRemoveNamedOption(XConfigPtr config, XConfigOptionPtr *pHead,
+                              const char *name, char **comments)
 {
     XConfigOptionPtr option;
 
-    option = xconfigFindOption(*pHead, name);
+    option = xconfigOptionMapFind(config, *pHead, name);
     if (option) {
         if (comments) {
-            xconfigAddRemovedOptionComment(comments, option);
+            xconfigAddRemovedOptionComment(config, comments, option);
         }
-        xconfigRemoveOption(pHead, option);
+        xconfigOptionMapRemove(config, pHead, option);
     }
 
 } /* xconfigRemoveNamedOption() */
@@ -96,13 +98,15 @@ void xconfigRemoveNamedOption(XConfigOptionPtr *pHead, const char *name,
 /*
  * xconfigOptionValuesDiffer() - return '1' if the option values for
  * option0 and option1 are different; return '0' if the option values
- * are the same.
+ * are the same.  Values parsed as the same type (see OptionType.c) are
+ * compared as parsed, so "On" and "true" are the same boolean.
  */
 
 static int xconfigOptionValuesDiffer(XConfigOptionPtr option0,
                                      XConfigOptionPtr option1)
 {
-    char *value0, *value1;
+    const char *value0, *value1;
+    int typed0, typed1;
 
     value0 = value1 = NULL;
 
@@ -110,6 +114,11 @@ static int xconfigOptionValuesDiffer(XConfigOptionPtr option0,
     if (!option0 &&  option1) return 1;
     if ( option0 && !option1) return 1;
 
+    if (xconfigOptionTypedValue(option0, option0->type, &typed0) &&
+        xconfigOptionTypedValue(option1, option0->type, &typed1)) {
+        return (typed0 != typed1);
+    }
+
     value0 = xconfigOptionValue(option0);
     value1 = xconfigOptionValue(option1);
 
@@ -135,14 +144,16 @@ static int xconfigOptionValuesDiffer(XConfigOptionPtr option0,
  * then the old option will be commented out instead of being
  * simply removed/replaced.
  */
-static void xconfigMergeOption(XConfigOptionPtr *dstHead,
+static void xconfigMergeOption(XConfigPtr dstConfig,
+                               XConfigOptionPtr *dstHead,
                                XConfigOptionPtr *srcHead,
                                const char *name, char **comments)
 {
     XConfigOptionPtr srcOption = xconfigFindOption(*srcHead, name);
-    XConfigOptionPtr dstOption = xconfigFindOption(*dstHead, name);
+    XConfigOptionPtr dstOption = xconfigOptionMapFind(dstConfig, *dstHead,
+                                                      name);
 
-    char *srcValue = NULL;
+    const char *srcValue = NULL;
 
     if (!srcOption) {
         /* Option does not exist in src, do nothing to dst. */
@@ -154,7 +165,7 @@ static void xconfigMergeOption(XConfigOptionPtr *dstHead,
     if (srcOption && !dstOption) {
 
         /* option exists in src but not in dst: add to dst */
-        xconfigAddNewOption(dstHead, name, srcValue);
+        xconfigAddNewOption(dstConfig, dstHead, name, srcValue);
 
     } else if (srcOption && dstOption) {
 
@@ -167,9 +178,10 @@ static void xconfigMergeOption(XConfigOptionPtr *dstHead,
 
         if (xconfigOptionValuesDiffer(srcOption, dstOption)) {
             if (comments) {
-                xconfigAddRemovedOptionComment(comments, dstOption);
+                xconfigAddRemovedOptionComment(dstConfig, comments,
+                                               dstOption);
             }
-            xconfigAddNewOption(dstHead, name, srcValue);
+            xconfigAddNewOption(dstConfig, dstHead, name, srcValue);
         }
     }
 
@@ -195,13 +207,13 @@ static int xconfigMergeFlags(XConfigPtr dstConfig, XConfigPtr srcConfig)
         /* Flag section was not found, create a new one */
         if (!dstConfig->flags) {
             dstConfig->flags =
-                (XConfigFlagsPtr) calloc(1, sizeof(XConfigFlagsRec));
+                xconfigArenaAlloc(dstConfig, sizeof(XConfigFlagsRec));
             if (!dstConfig->flags) return 0;
         }
         
         option = srcConfig->flags->options;
         while (option) {
-            xconfigMergeOption(&(dstConfig->flags->options),
+            xconfigMergeOption(dstConfig, &(dstConfig->flags->options),
                                &(srcConfig->flags->options),
                                xconfigOptionName(option),
                                &(dstConfig->flags->comment));
@@ -220,7 +232,8 @@ static int xconfigMergeFlags(XConfigPtr dstConfig, XConfigPtr srcConfig)
  * with that of the source monitor.
  *
  */
-static void xconfigMergeMonitors(XConfigMonitorPtr dstMonitor,
+static void xconfigMergeMonitors(XConfigPtr dstConfig,
+                                 XConfigMonitorPtr dstMonitor,
                                  XConfigMonitorPtr srcMonitor)
 {
     int i;
@@ -228,13 +241,11 @@ static void xconfigMergeMonitors(XConfigMonitorPtr dstMonitor,
 
     /* Update vendor */
     
-    free(dstMonitor->vendor);
-    dstMonitor->vendor = xconfigStrdup(srcMonitor->vendor);
+    dstMonitor->vendor = xconfigIntern(dstConfig, srcMonitor->vendor);
     
     /* Update modelname */
     
-    free(dstMonitor->modelname);
-    dstMonitor->modelname = xconfigStrdup(srcMonitor->modelname);
+    dstMonitor->modelname = xconfigIntern(dstConfig, srcMonitor->modelname);
     
     /* Update horizontal sync */
     
@@ -255,7 +266,7 @@ static void xconfigMergeMonitors(XConfigMonitorPtr dstMonitor,
     /* XXX Remove the destination monitor's "UseModes" references to
      *     avoid having the wrong modelines tied to the new monitor.
      */
-    xconfigFreeModesLinkList(&dstMonitor->modes_sections);
+    dstMonitor->modes_sections = NULL;
 
 } /* xconfigMergeMonitors() */
 
@@ -280,22 +291,25 @@ static int xconfigMergeAllMonitors(XConfigPtr dstConfig, XConfigPtr srcConfig)
          srcMonitor = srcMonitor->next) {
 
         dstMonitor =
-            xconfigFindMonitor(srcMonitor->identifier, dstConfig->monitors);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_MONITOR,
+                             srcMonitor->identifier);
 
         /* Monitor section was not found, create a new one and add it */
         if (!dstMonitor) {
             dstMonitor =
-                (XConfigMonitorPtr) calloc(1, sizeof(XConfigMonitorRec));
+                xconfigArenaAlloc(dstConfig, sizeof(XConfigMonitorRec));
             if (!dstMonitor) return 0;
 
-            dstMonitor->identifier = xconfigStrdup(srcMonitor->identifier);
+            dstMonitor->identifier =
+                xconfigIntern(dstConfig, srcMonitor->identifier);
 
             xconfigAddListItem((GenericListPtr *)(&dstConfig->monitors),
                                (GenericListPtr)dstMonitor);
+            xconfigIndexAdd(dstConfig, XCONFIG_INDEX_MONITOR, dstMonitor);
         }
 
         /* Do the merge */
-        xconfigMergeMonitors(dstMonitor, srcMonitor);
+        xconfigMergeMonitors(dstConfig, dstMonitor, srcMonitor);
     }
 
     return 1;
@@ -309,30 +323,27 @@ static int xconfigMergeAllMonitors(XConfigPtr dstConfig, XConfigPtr srcConfig)
  * with that of the source device.
  *
  */
-static void xconfigMergeDevices(XConfigDevicePtr dstDevice,
+static void xconfigMergeDevices(XConfigPtr dstConfig,
+                                XConfigDevicePtr dstDevice,
                                 XConfigDevicePtr srcDevice)
 {
     // XXX Zero out the device section?
 
     /* Update driver */
     
-    free(dstDevice->driver);
-    dstDevice->driver = xconfigStrdup(srcDevice->driver);
+    dstDevice->driver = xconfigIntern(dstConfig, srcDevice->driver);
     
     /* Update vendor */
     
-    free(dstDevice->vendor);
-    dstDevice->vendor = xconfigStrdup(srcDevice->vendor);
+    dstDevice->vendor = xconfigIntern(dstConfig, srcDevice->vendor);
     
     /* Update bus ID */
     
-    free(dstDevice->busid);
-    dstDevice->busid = xconfigStrdup(srcDevice->busid);
+    dstDevice->busid = xconfigIntern(dstConfig, srcDevice->busid);
     
     /* Update board */
     
-    free(dstDevice->board);
-    dstDevice->board = xconfigStrdup(srcDevice->board);
+    dstDevice->board = xconfigIntern(dstConfig, srcDevice->board);
     
     /* Update chip info */
     
@@ -370,22 +381,25 @@ static int xconfigMergeAllDevices(XConfigPtr dstConfig, XConfigPtr srcConfig)
          srcDevice = srcDevice->next) {
 
         dstDevice =
-            xconfigFindDevice(srcDevice->identifier, dstConfig->devices);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_DEVICE,
+                             srcDevice->identifier);
         
         /* Device section was not found, create a new one and add it */
         if (!dstDevice) {
             dstDevice =
-                (XConfigDevicePtr) calloc(1, sizeof(XConfigDeviceRec));
+                xconfigArenaAlloc(dstConfig, sizeof(XConfigDeviceRec));
             if (!dstDevice) return 0;
 
-            dstDevice->identifier = xconfigStrdup(srcDevice->identifier);
+            dstDevice->identifier =
+                xconfigIntern(dstConfig, srcDevice->identifier);
 
             xconfigAddListItem((GenericListPtr *)(&dstConfig->devices),
                                (GenericListPtr)dstDevice);
+            xconfigIndexAdd(dstConfig, XCONFIG_INDEX_DEVICE, dstDevice);
         }
 
         /* Do the merge */
-        xconfigMergeDevices(dstDevice, srcDevice);
+        xconfigMergeDevices(dstConfig, dstDevice, srcDevice);
     }
 
     return 1;
@@ -402,7 +416,8 @@ static int xconfigMergeAllDevices(XConfigPtr dstConfig, XConfigPtr srcConfig)
  * - Updates only those options listed in the srcScreen->options.
  *
  */
-static int xconfigMergeDriverOptions(XConfigScreenPtr dstScreen,
+static int xconfigMergeDriverOptions(XConfigPtr dstConfig,
+                                     XConfigScreenPtr dstScreen,
                                      XConfigScreenPtr srcScreen)
 {
     XConfigOptionPtr option;
@@ -410,20 +425,20 @@ static int xconfigMergeDriverOptions(XConfigScreenPtr dstScreen,
 
     option = srcScreen->options;
     while (option) {
-        char *name = xconfigOptionName(option);
+        const char *name = xconfigOptionName(option);
 
         /* Remove the option from all non-screen option lists */
         
         if (dstScreen->device) {
-            xconfigRemoveNamedOption(&(dstScreen->device->options), name,
-                                     &(dstScreen->device->comment));
+            xconfigRemoveNamedOption(dstConfig, &(dstScreen->device->options),
+                                     name, &(dstScreen->device->comment));
         }
         if (dstScreen->monitor) {
-            xconfigRemoveNamedOption(&(dstScreen->monitor->options), name,
-                                     &(dstScreen->monitor->comment));
+            xconfigRemoveNamedOption(dstConfig, &(dstScreen->monitor->options),
+                                     name, &(dstScreen->monitor->comment));
         }       
         for (display = dstScreen->displays; display; display = display->next) {
-            xconfigRemoveNamedOption(&(display->options), name,
+            xconfigRemoveNamedOption(dstConfig, &(display->options), name,
                                      &(display->comment));
         }
 
@@ -431,20 +446,20 @@ static int xconfigMergeDriverOptions(XConfigScreenPtr dstScreen,
         {
             // XXX Only add a comment if the value changed.
             XConfigOptionPtr old =
-                xconfigFindOption(dstScreen->options, name);
+                xconfigOptionMapFind(dstConfig, dstScreen->options, name);
 
             if (old && xconfigOptionValuesDiffer(option, old)) {
-                xconfigRemoveNamedOption(&(dstScreen->options), name,
+                xconfigRemoveNamedOption(dstConfig, &(dstScreen->options), name,
                                          &(dstScreen->comment));
             } else {
-                xconfigRemoveNamedOption(&(dstScreen->options), name,
+                xconfigRemoveNamedOption(dstConfig, &(dstScreen->options), name,
                                          NULL);
             }
         }
 
         /* Add the option to the screen->options list */
 
-        xconfigAddNewOption(&dstScreen->options,
+        xconfigAddNewOption(dstConfig, &dstScreen->options,
                             name, xconfigOptionValue(option));
         
         option = option->next;
@@ -461,16 +476,17 @@ static int xconfigMergeDriverOptions(XConfigScreenPtr dstScreen,
  * source screen to the destination screen.
  *
  */
-static int xconfigMergeDisplays(XConfigScreenPtr dstScreen,
+static int xconfigMergeDisplays(XConfigPtr dstConfig,
+                                XConfigScreenPtr dstScreen,
                                 XConfigScreenPtr srcScreen)
 {
     XConfigDisplayPtr dstDisplay;
     XConfigDisplayPtr srcDisplay;
     XConfigModePtr srcMode, dstMode, lastDstMode;
 
-    /* Free all the displays in the destination screen */
+    /* Drop all the displays in the destination screen */
 
-    xconfigFreeDisplayList(&dstScreen->displays);
+    dstScreen->displays = NULL;
 
     /* Copy all te displays */
     
@@ -480,7 +496,7 @@ static int xconfigMergeDisplays(XConfigScreenPtr dstScreen,
 
         /* Create a new display */
 
-        dstDisplay = xconfigAlloc(sizeof(XConfigDisplayRec));
+        dstDisplay = xconfigArenaAlloc(dstConfig, sizeof(XConfigDisplayRec));
         if (!dstDisplay) return 0;
 
         /* Copy display fields */
@@ -491,15 +507,17 @@ static int xconfigMergeDisplays(XConfigScreenPtr dstScreen,
         dstDisplay->virtualY = srcDisplay->virtualY;
         dstDisplay->depth = srcDisplay->depth;
         dstDisplay->bpp = srcDisplay->bpp;
-        dstDisplay->visual = xconfigStrdup(srcDisplay->visual);
+        dstDisplay->visual = xconfigIntern(dstConfig, srcDisplay->visual);
         dstDisplay->weight = srcDisplay->weight;
         dstDisplay->black = srcDisplay->black;
         dstDisplay->white = srcDisplay->white;
-        dstDisplay->comment = xconfigStrdup(srcDisplay->comment);
+        dstDisplay->comment = xconfigArenaStrdup(dstConfig,
+                                                 srcDisplay->comment);
 
         /* Copy options over */
 
-        dstDisplay->options = xconfigOptionListDup(srcDisplay->options);
+        dstDisplay->options = xconfigOptionListDup(dstConfig,
+                                                   srcDisplay->options);
 
         /* Copy modes over */
 
@@ -510,7 +528,7 @@ static int xconfigMergeDisplays(XConfigScreenPtr dstScreen,
 
             /* Copy the mode */
             
-            xconfigAddMode(&dstMode, srcMode->mode_name);
+            xconfigAddMode(dstConfig, &dstMode, srcMode->mode_name);
 
             /* Add mode at the end of the list */
 
@@ -549,18 +567,20 @@ static void xconfigMergeScreens(XConfigScreenPtr dstScreen,
 {
     /* Use the right device */
     
-    free(dstScreen->device_name);
-    dstScreen->device_name = xconfigStrdup(srcScreen->device_name);
+    dstScreen->device_name =
+        xconfigIntern(dstConfig, srcScreen->device_name);
     dstScreen->device =
-        xconfigFindDevice(dstScreen->device_name, dstConfig->devices);
+        xconfigIndexFind(dstConfig, XCONFIG_INDEX_DEVICE,
+                         dstScreen->device_name);
     
 
     /* Use the right monitor */
     
-    free(dstScreen->monitor_name);
-    dstScreen->monitor_name = xconfigStrdup(srcScreen->monitor_name);
+    dstScreen->monitor_name =
+        xconfigIntern(dstConfig, srcScreen->monitor_name);
     dstScreen->monitor =
-        xconfigFindMonitor(dstScreen->monitor_name, dstConfig->monitors);
+        xconfigIndexFind(dstConfig, XCONFIG_INDEX_MONITOR,
+                         dstScreen->monitor_name);
     
 
     /* Update the right default depth */
@@ -570,12 +590,12 @@ static void xconfigMergeScreens(XConfigScreenPtr dstScreen,
 
     /* Copy over the display section */
     
-    xconfigMergeDisplays(dstScreen, srcScreen);
+    xconfigMergeDisplays(dstConfig, dstScreen, srcScreen);
    
 
     /* Update the screen's driver options */
 
-    xconfigMergeDriverOptions(dstScreen, srcScreen);
+    xconfigMergeDriverOptions(dstConfig, dstScreen, srcScreen);
 
 } /* xconfigMergeScreens() */
 
@@ -600,18 +620,21 @@ static int xconfigMergeAllScreens(XConfigPtr dstConfig, XConfigPtr srcConfig)
          srcScreen = srcScreen->next) {
 
         dstScreen =
-            xconfigFindScreen(srcScreen->identifier, dstConfig->screens);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_SCREEN,
+                             srcScreen->identifier);
 
         /* Screen section was not found, create a new one and add it */
         if (!dstScreen) {
             dstScreen =
-                (XConfigScreenPtr) calloc(1, sizeof(XConfigScreenRec));
+                xconfigArenaAlloc(dstConfig, sizeof(XConfigScreenRec));
             if (!dstScreen) return 0;
 
-            dstScreen->identifier = xconfigStrdup(srcScreen->identifier);
+            dstScreen->identifier =
+                xconfigIntern(dstConfig, srcScreen->identifier);
 
             xconfigAddListItem((GenericListPtr *)(&dstConfig->screens),
                                (GenericListPtr)dstScreen);
+            xconfigIndexAdd(dstConfig, XCONFIG_INDEX_SCREEN, dstScreen);
         }
 
         /* Do the merge */
@@ -644,7 +667,7 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
 
     /* Clear the destination's adjacency list */
 
-    xconfigFreeAdjacencyList(&dstLayout->adjacencies);
+    dstLayout->adjacencies = NULL;
     
     /* Copy adjacencies over */
     
@@ -655,29 +678,34 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
         /* Copy the adjacency */
         
         dstAdj =
-            (XConfigAdjacencyPtr) calloc(1, sizeof(XConfigAdjacencyRec));
+            xconfigArenaAlloc(dstConfig, sizeof(XConfigAdjacencyRec));
 
         dstAdj->scrnum = srcAdj->scrnum;
-        dstAdj->screen_name = xconfigStrdup(srcAdj->screen_name);
-        dstAdj->top_name = xconfigStrdup(srcAdj->top_name);
-        dstAdj->bottom_name = xconfigStrdup(srcAdj->bottom_name);
-        dstAdj->left_name = xconfigStrdup(srcAdj->left_name);
-        dstAdj->right_name = xconfigStrdup(srcAdj->right_name);
+        dstAdj->screen_name = xconfigIntern(dstConfig, srcAdj->screen_name);
+        dstAdj->top_name = xconfigIntern(dstConfig, srcAdj->top_name);
+        dstAdj->bottom_name = xconfigIntern(dstConfig, srcAdj->bottom_name);
+        dstAdj->left_name = xconfigIntern(dstConfig, srcAdj->left_name);
+        dstAdj->right_name = xconfigIntern(dstConfig, srcAdj->right_name);
         dstAdj->where = srcAdj->where;
         dstAdj->x = srcAdj->x;
         dstAdj->y = srcAdj->y;
-        dstAdj->refscreen = xconfigStrdup(srcAdj->refscreen);
+        dstAdj->refscreen = xconfigIntern(dstConfig, srcAdj->refscreen);
 
         dstAdj->screen =
-            xconfigFindScreen(dstAdj->screen_name, dstConfig->screens);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_SCREEN,
+                             dstAdj->screen_name);
         dstAdj->top =
-            xconfigFindScreen(dstAdj->top_name, dstConfig->screens);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_SCREEN,
+                             dstAdj->top_name);
         dstAdj->bottom =
-            xconfigFindScreen(dstAdj->bottom_name, dstConfig->screens);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_SCREEN,
+                             dstAdj->bottom_name);
         dstAdj->left =
-            xconfigFindScreen(dstAdj->left_name, dstConfig->screens);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_SCREEN,
+                             dstAdj->left_name);
         dstAdj->right =
-            xconfigFindScreen(dstAdj->right_name, dstConfig->screens);
+            xconfigIndexFind(dstConfig, XCONFIG_INDEX_SCREEN,
+                             dstAdj->right_name);
 
         /* Add adjacency at the end of the list */
         
@@ -698,7 +726,7 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
 
         srcOption = srcLayout->options;
         while (srcOption) {
-            xconfigMergeOption(&(dstLayout->options),
+            xconfigMergeOption(dstConfig, &(dstLayout->options),
                                &(srcLayout->options),
                                xconfigOptionName(srcOption),
                                &(dstLayout->comment));
@@ -726,13 +754,13 @@ static int  xconfigMergeExtensions(XConfigPtr dstConfig, XConfigPtr srcConfig)
         /* Extension section was not found, create a new one */
         if (!dstConfig->extensions) {
             dstConfig->extensions =
-                (XConfigExtensionsPtr) calloc(1, sizeof(XConfigExtensionsRec));
+                xconfigArenaAlloc(dstConfig, sizeof(XConfigExtensionsRec));
             if (!dstConfig->extensions) return 0;
         }
 
         option = srcConfig->extensions->options;
         while (option) {
-            xconfigMergeOption(&(dstConfig->extensions->options),
+            xconfigMergeOption(dstConfig, &(dstConfig->extensions->options),
                                &(srcConfig->extensions->options),
                                xconfigOptionName(option),
                                &(dstConfig->extensions->comment));
@@ -760,6 +788,17 @@ int xconfigMergeConfigs(XConfigPtr dstConfig, XConfigPtr srcConfig)
     /* Make sure the X config is valid */
     // make_xconfig_usable(dstConfig);
 
+    xconfigInvalidateIndexes(dstConfig);
+
+    /* Parse any deferred sections that are about to be merged */
+
+    if (!xconfigParseDeferredSections(dstConfig, XCONFIG_DEFER_FLAGS |
+                                                 XCONFIG_DEFER_EXTENSIONS) ||
+        !xconfigParseDeferredSections(srcConfig, XCONFIG_DEFER_FLAGS |
+                                                 XCONFIG_DEFER_EXTENSIONS)) {
+        return 0;
+    }
+
 
     /* Merge the server flag (Xinerama) section */
 
@@ -58,30 +58,15 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
+XCONFIG_KEYWORD_TABLE(SubModuleTab);
 
-static XConfigSymTabRec SubModuleTab[] =
-{
-    {ENDSUBSECTION, "endsubsection"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-static XConfigSymTabRec ModuleTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {LOAD, "load"},
-    {LOAD_DRIVER, "loaddriver"},
-    {DISABLE, "disable"},
-    {SUBSECTION, "subsection"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeModules
+XCONFIG_KEYWORD_TABLE(ModuleTab);
 
 XConfigLoadPtr
-xconfigParseModuleSubSection (XConfigLoadPtr head, char *name)
+xconfigParseModuleSubSection (XConfigParserPtr parser, XConfigLoadPtr head,
+                              const char *name)
 {
     int token;
     PARSE_PROLOGUE (XConfigLoadPtr, XConfigLoadRec)
@@ -91,24 +76,22 @@ xconfigParseModuleSubSection (XConfigLoadPtr head, char *name)
     ptr->opt  = NULL;
     ptr->next = NULL;
 
-    while ((token = xconfigGetToken (SubModuleTab)) != ENDSUBSECTION)
+    while ((token = xconfigGetToken (parser, &SubModuleTab)) != ENDSUBSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case OPTION:
-            ptr->opt = xconfigParseOption(ptr->opt);
+            ptr->opt = xconfigParseOption(parser, ptr->opt);
             break;
         case EOF_TOKEN:
-            xconfigErrorMsg(ParseErrorMsg, UNEXPECTED_EOF_MSG);
-            free(ptr);
+            xconfigParserErrorMsg(parser, ParseErrorMsg, UNEXPECTED_EOF_MSG);
             return NULL;
         default:
-            xconfigErrorMsg(ParseErrorMsg, INVALID_KEYWORD_MSG,
-                         xconfigTokenString());
-            free(ptr);
+            xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                                  xconfigTokenString(parser));
             return NULL;
             break;
         }
@@ -120,47 +103,51 @@ xconfigParseModuleSubSection (XConfigLoadPtr head, char *name)
 }
 
 XConfigModulePtr
-xconfigParseModuleSection (void)
+xconfigParseModuleSection (XConfigParserPtr parser)
 {
     int token;
     PARSE_PROLOGUE (XConfigModulePtr, XConfigModuleRec)
 
-    while ((token = xconfigGetToken (ModuleTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &ModuleTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case LOAD:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Load");
-            xconfigAddNewLoadDirective (&ptr->loads, val.str,
-                                        XCONFIG_LOAD_MODULE, NULL, TRUE);
+            xconfigAddNewLoadDirective (parser->config, &ptr->loads,
+                                        parser->val.str, XCONFIG_LOAD_MODULE,
+                                        NULL, parser);
             break;
         case LOAD_DRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "LoadDriver");
-            xconfigAddNewLoadDirective (&ptr->loads, val.str,
-                                        XCONFIG_LOAD_DRIVER, NULL, TRUE);
+            xconfigAddNewLoadDirective (parser->config, &ptr->loads,
+                                        parser->val.str, XCONFIG_LOAD_DRIVER,
+                                        NULL, parser);
             break;
         case DISABLE:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Disable");
-            xconfigAddNewLoadDirective (&ptr->disables, val.str,
-                                        XCONFIG_DISABLE_MODULE, NULL, TRUE);
+            xconfigAddNewLoadDirective (parser->config, &ptr->disables,
+                                        parser->val.str, XCONFIG_DISABLE_MODULE,
+                                        NULL, parser);
             break;
         case SUBSECTION:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                         Error (QUOTE_MSG, "SubSection");
             ptr->loads =
-                xconfigParseModuleSubSection (ptr->loads, val.str);
+                xconfigParseModuleSubSection (parser, ptr->loads,
+                                              parser->val.str);
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -168,8 +155,6 @@ xconfigParseModuleSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintModuleSection (FILE * cf, XConfigModulePtr ptr)
 {
@@ -230,24 +215,31 @@ xconfigPrintModuleSection (FILE * cf, XConfigModulePtr ptr)
     }
 }
 
+/*
+ * xconfigAddNewLoadDirective() - append a load directive to the list;
+ * if parser is non-NULL, a comment following the directive on the same
+ * line is read from it and attached to the directive.
+ */
+
 void
-xconfigAddNewLoadDirective (XConfigLoadPtr *pHead, char *name, int type,
-                            XConfigOptionPtr opts, int do_token)
+xconfigAddNewLoadDirective (XConfigPtr config, XConfigLoadPtr *pHead,
+                            const char *name, int type,
+                            XConfigOptionPtr opts, XConfigParserPtr parser)
 {
     XConfigLoadPtr new;
     int token;
 
-    new = calloc (1, sizeof (XConfigLoadRec));
-    new->name = name;
+    new = xconfigArenaAlloc (config, sizeof (XConfigLoadRec));
+    new->name = xconfigIntern (config, name);
     new->type = type;
     new->opt  = opts;
     new->next = NULL;
 
-    if (do_token) {
-        if ((token = xconfigGetToken(NULL)) == COMMENT) {
-            new->comment = xconfigAddComment(new->comment, val.str);
+    if (parser) {
+        if ((token = xconfigGetToken(parser, NULL)) == COMMENT) {
+            new->comment = xconfigParserAddComment(parser, new->comment);
         } else {
-            xconfigUnGetToken(token);
+            xconfigUnGetToken(parser, token);
         }
     }
 
@@ -258,38 +250,4 @@ void
 xconfigRemoveLoadDirective(XConfigLoadPtr *pHead, XConfigLoadPtr load)
 {
      xconfigRemoveListItem((GenericListPtr *)pHead, (GenericListPtr)load);
-
-    TEST_FREE(load->name);
-    TEST_FREE(load->comment);
-    xconfigFreeOptionList(&(load->opt));
-    free(load);
-}
-
-static void
-FreeModule(XConfigLoadPtr lptr)
-{
-    XConfigLoadPtr prev;
-
-    while (lptr)
-    {
-        TEST_FREE (lptr->name);
-        TEST_FREE (lptr->comment);
-        prev = lptr;
-        lptr = lptr->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeModules (XConfigModulePtr *ptr)
-{
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    FreeModule((*ptr)->loads);
-    FreeModule((*ptr)->disables);
-    
-    TEST_FREE ((*ptr)->comment);
-    free (*ptr);
-    *ptr = NULL;
 }
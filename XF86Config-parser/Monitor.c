@@ -58,125 +58,73 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
+XCONFIG_KEYWORD_TABLE(MonitorTab);
 
-static XConfigSymTabRec MonitorTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {VENDOR, "vendorname"},
-    {MODEL, "modelname"},
-    {USEMODES, "usemodes"},
-    {MODELINE, "modeline"},
-    {DISPLAYSIZE, "displaysize"},
-    {HORIZSYNC, "horizsync"},
-    {VERTREFRESH, "vertrefresh"},
-    {MODE, "mode"},
-    {GAMMA, "gamma"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-static XConfigSymTabRec ModesTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {MODELINE, "modeline"},
-    {MODE, "mode"},
-    {-1, ""},
-};
-
-static XConfigSymTabRec TimingTab[] =
-{
-    {TT_INTERLACE, "interlace"},
-    {TT_PHSYNC, "+hsync"},
-    {TT_NHSYNC, "-hsync"},
-    {TT_PVSYNC, "+vsync"},
-    {TT_NVSYNC, "-vsync"},
-    {TT_CSYNC, "composite"},
-    {TT_PCSYNC, "+csync"},
-    {TT_NCSYNC, "-csync"},
-    {TT_DBLSCAN, "doublescan"},
-    {TT_HSKEW, "hskew"},
-    {TT_BCAST, "bcast"},
-    {TT_VSCAN, "vscan"},
-    {TT_CUSTOM, "CUSTOM"},
-    {-1, ""},
-};
-
-static XConfigSymTabRec ModeTab[] =
-{
-    {DOTCLOCK, "dotclock"},
-    {HTIMINGS, "htimings"},
-    {VTIMINGS, "vtimings"},
-    {FLAGS, "flags"},
-    {HSKEW, "hskew"},
-    {BCAST, "bcast"},
-    {VSCAN, "vscan"},
-    {ENDMODE, "endmode"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeModeLineList
+XCONFIG_KEYWORD_TABLE(ModesTab);
+
+XCONFIG_KEYWORD_TABLE(TimingTab);
+
+XCONFIG_KEYWORD_TABLE(ModeTab);
 
 XConfigModeLinePtr
-xconfigParseModeLine (void)
+xconfigParseModeLine (XConfigParserPtr parser)
 {
     int token;
     PARSE_PROLOGUE (XConfigModeLinePtr, XConfigModeLineRec)
 
     /* Identifier */
-    if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
         Error ("ModeLine identifier expected", NULL);
-    ptr->identifier = val.str;
+    ptr->identifier = parser->val.str;
 
     /* DotClock */
-    if ((xconfigGetSubToken (&(ptr->comment)) != NUMBER) || !val.str)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine dotclock expected", NULL);
-    ptr->clock = xconfigStrdup(val.str);
+    ptr->clock = xconfigIntern(parser->config, xconfigTokenString(parser));
 
     /* HDisplay */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine Hdisplay expected", NULL);
-    ptr->hdisplay = val.num;
+    ptr->hdisplay = parser->val.num;
 
     /* HSyncStart */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine HSyncStart expected", NULL);
-    ptr->hsyncstart = val.num;
+    ptr->hsyncstart = parser->val.num;
 
     /* HSyncEnd */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine HSyncEnd expected", NULL);
-    ptr->hsyncend = val.num;
+    ptr->hsyncend = parser->val.num;
 
     /* HTotal */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine HTotal expected", NULL);
-    ptr->htotal = val.num;
+    ptr->htotal = parser->val.num;
 
     /* VDisplay */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine Vdisplay expected", NULL);
-    ptr->vdisplay = val.num;
+    ptr->vdisplay = parser->val.num;
 
     /* VSyncStart */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine VSyncStart expected", NULL);
-    ptr->vsyncstart = val.num;
+    ptr->vsyncstart = parser->val.num;
 
     /* VSyncEnd */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine VSyncEnd expected", NULL);
-    ptr->vsyncend = val.num;
+    ptr->vsyncend = parser->val.num;
 
     /* VTotal */
-    if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+    if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
         Error ("ModeLine VTotal expected", NULL);
-    ptr->vtotal = val.num;
+    ptr->vtotal = parser->val.num;
 
-    token = xconfigGetSubTokenWithTab (&(ptr->comment), TimingTab);
+    token = xconfigGetSubTokenWithTab (parser, &(ptr->comment), &TimingTab);
     while ((token == TT_INTERLACE) || (token == TT_PHSYNC) ||
            (token == TT_NHSYNC) || (token == TT_PVSYNC) ||
            (token == TT_NVSYNC) || (token == TT_CSYNC) ||
@@ -215,18 +163,18 @@ xconfigParseModeLine (void)
             ptr->flags |= XCONFIG_MODE_DBLSCAN;
             break;
         case TT_HSKEW:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Hskew");
-            ptr->hskew = val.num;
+            ptr->hskew = parser->val.num;
             ptr->flags |= XCONFIG_MODE_HSKEW;
             break;
         case TT_BCAST:
             ptr->flags |= XCONFIG_MODE_BCAST;
             break;
         case TT_VSCAN:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Vscan");
-            ptr->vscan = val.num;
+            ptr->vscan = parser->val.num;
             ptr->flags |= XCONFIG_MODE_VSCAN;
             break;
         case TT_CUSTOM:
@@ -236,90 +184,91 @@ xconfigParseModeLine (void)
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
-        token = xconfigGetSubTokenWithTab (&(ptr->comment), TimingTab);
+        token = xconfigGetSubTokenWithTab (parser, &(ptr->comment), &TimingTab);
     }
-    xconfigUnGetToken (token);
+    xconfigUnGetToken (parser, token);
 
     return (ptr);
 }
 
 XConfigModeLinePtr
-xconfigParseVerboseMode (void)
+xconfigParseVerboseMode (XConfigParserPtr parser)
 {
     int token, token2;
     int had_dotclock = 0, had_htimings = 0, had_vtimings = 0;
     PARSE_PROLOGUE (XConfigModeLinePtr, XConfigModeLineRec)
 
-        if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+        if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
         Error ("Mode name expected", NULL);
-    ptr->identifier = val.str;
-    while ((token = xconfigGetToken (ModeTab)) != ENDMODE)
+    ptr->identifier = parser->val.str;
+    while ((token = xconfigGetToken (parser, &ModeTab)) != ENDMODE)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case DOTCLOCK:
-            if ((xconfigGetSubToken (&(ptr->comment)) != NUMBER) || !val.str)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DotClock");
-            ptr->clock = xconfigStrdup(val.str);
+            ptr->clock = xconfigIntern(parser->config,
+                                       xconfigTokenString(parser));
             had_dotclock = 1;
             break;
         case HTIMINGS:
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->hdisplay = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->hdisplay = parser->val.num;
             else
                 Error ("Horizontal display expected", NULL);
 
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->hsyncstart = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->hsyncstart = parser->val.num;
             else
                 Error ("Horizontal sync start expected", NULL);
 
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->hsyncend = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->hsyncend = parser->val.num;
             else
                 Error ("Horizontal sync end expected", NULL);
 
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->htotal = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->htotal = parser->val.num;
             else
                 Error ("Horizontal total expected", NULL);
             had_htimings = 1;
             break;
         case VTIMINGS:
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vdisplay = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->vdisplay = parser->val.num;
             else
                 Error ("Vertical display expected", NULL);
 
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vsyncstart = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->vsyncstart = parser->val.num;
             else
                 Error ("Vertical sync start expected", NULL);
 
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vsyncend = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->vsyncend = parser->val.num;
             else
                 Error ("Vertical sync end expected", NULL);
 
-            if (xconfigGetSubToken (&(ptr->comment)) == NUMBER)
-                ptr->vtotal = val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER)
+                ptr->vtotal = parser->val.num;
             else
                 Error ("Vertical total expected", NULL);
             had_vtimings = 1;
             break;
         case FLAGS:
-            token = xconfigGetSubToken (&(ptr->comment));
+            token = xconfigGetSubToken (parser, &(ptr->comment));
             if (token != STRING)
                 Error (QUOTE_MSG, "Flags");
             while (token == STRING)
             {
-                token2 = xconfigGetStringToken (TimingTab);
+                token2 = xconfigGetStringToken (parser, &TimingTab);
                 switch (token2)
                 {
                 case TT_INTERLACE:
@@ -359,21 +308,21 @@ xconfigParseVerboseMode (void)
                     Error ("Unknown flag string", NULL);
                     break;
                 }
-                token = xconfigGetSubToken (&(ptr->comment));
+                token = xconfigGetSubToken (parser, &(ptr->comment));
             }
-            xconfigUnGetToken (token);
+            xconfigUnGetToken (parser, token);
             break;
         case HSKEW:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error ("Horizontal skew expected", NULL);
             ptr->flags |= XCONFIG_MODE_HSKEW;
-            ptr->hskew = val.num;
+            ptr->hskew = parser->val.num;
             break;
         case VSCAN:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error ("Vertical scan count expected", NULL);
             ptr->flags |= XCONFIG_MODE_VSCAN;
-            ptr->vscan = val.num;
+            ptr->vscan = parser->val.num;
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
@@ -392,41 +341,37 @@ xconfigParseVerboseMode (void)
     return (ptr);
 }
 
-#undef CLEANUP
-
-#define CLEANUP xconfigFreeMonitorList
-
 XConfigMonitorPtr
-xconfigParseMonitorSection (void)
+xconfigParseMonitorSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigMonitorPtr, XConfigMonitorRec)
 
-        while ((token = xconfigGetToken (MonitorTab)) != ENDSECTION)
+        while ((token = xconfigGetToken (parser, &MonitorTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case VENDOR:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Vendor");
-            ptr->vendor = val.str;
+            ptr->vendor = parser->val.str;
             break;
         case MODEL:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "ModelName");
-            ptr->modelname = val.str;
+            ptr->modelname = parser->val.str;
             break;
         case MODE:
             HANDLE_LIST (modelines, xconfigParseVerboseMode,
@@ -437,31 +382,34 @@ xconfigParseMonitorSection (void)
                          XConfigModeLinePtr);
             break;
         case DISPLAYSIZE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (DISPLAYSIZE_MSG, NULL);
-            ptr->width = val.realnum;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->width = parser->val.realnum;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (DISPLAYSIZE_MSG, NULL);
-            ptr->height = val.realnum;
+            ptr->height = parser->val.realnum;
             break;
 
         case HORIZSYNC:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (HORIZSYNC_MSG, NULL);
             do {
-                ptr->hsync[ptr->n_hsync].lo = val.realnum;
-                switch (token = xconfigGetSubToken (&(ptr->comment)))
+                ptr->hsync[ptr->n_hsync].lo = parser->val.realnum;
+                switch (token = xconfigGetSubToken (parser, &(ptr->comment)))
                 {
                     case COMMA:
                         ptr->hsync[ptr->n_hsync].hi =
                         ptr->hsync[ptr->n_hsync].lo;
                         break;
                     case DASH:
-                        if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
-                            (float)val.realnum < ptr->hsync[ptr->n_hsync].lo)
+                        if (xconfigGetSubToken (parser,
+                                                &(ptr->comment)) != NUMBER ||
+                            (float)parser->val.realnum < ptr->hsync[ptr->n_hsync].lo)
                             Error (HORIZSYNC_MSG, NULL);
-                        ptr->hsync[ptr->n_hsync].hi = val.realnum;
-                        if ((token = xconfigGetSubToken (&(ptr->comment))) == COMMA)
+                        ptr->hsync[ptr->n_hsync].hi = parser->val.realnum;
+                        if ((token = xconfigGetSubToken (parser,
+                                                         &(ptr->comment)))
+                            == COMMA)
                             break;
                         ptr->n_hsync++;
                         goto HorizDone;
@@ -477,28 +425,32 @@ xconfigParseMonitorSection (void)
                 if (ptr->n_hsync >= CONF_MAX_HSYNC)
                     Error ("Sorry. Too many horizontal sync intervals.", NULL);
                 ptr->n_hsync++;
-            } while ((token = xconfigGetSubToken (&(ptr->comment))) == NUMBER);
+            } while ((token = xconfigGetSubToken (parser,
+                                                  &(ptr->comment))) == NUMBER);
 HorizDone:
-            xconfigUnGetToken (token);
+            xconfigUnGetToken (parser, token);
             break;
 
         case VERTREFRESH:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (VERTREFRESH_MSG, NULL);
             do {
-                ptr->vrefresh[ptr->n_vrefresh].lo = val.realnum;
-                switch (token = xconfigGetSubToken (&(ptr->comment)))
+                ptr->vrefresh[ptr->n_vrefresh].lo = parser->val.realnum;
+                switch (token = xconfigGetSubToken (parser, &(ptr->comment)))
                 {
                     case COMMA:
                         ptr->vrefresh[ptr->n_vrefresh].hi =
                         ptr->vrefresh[ptr->n_vrefresh].lo;
                         break;
                     case DASH:
-                        if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
-                            (float)val.realnum < ptr->vrefresh[ptr->n_vrefresh].lo)
+                        if (xconfigGetSubToken (parser,
+                                                &(ptr->comment)) != NUMBER ||
+                            (float)parser->val.realnum < ptr->vrefresh[ptr->n_vrefresh].lo)
                             Error (VERTREFRESH_MSG, NULL);
-                        ptr->vrefresh[ptr->n_vrefresh].hi = val.realnum;
-                        if ((token = xconfigGetSubToken (&(ptr->comment))) == COMMA)
+                        ptr->vrefresh[ptr->n_vrefresh].hi = parser->val.realnum;
+                        if ((token = xconfigGetSubToken (parser,
+                                                         &(ptr->comment)))
+                            == COMMA)
                             break;
                         ptr->n_vrefresh++;
                         goto VertDone;
@@ -514,26 +466,27 @@ HorizDone:
                 if (ptr->n_vrefresh >= CONF_MAX_VREFRESH)
                     Error ("Sorry. Too many vertical refresh intervals.", NULL);
                 ptr->n_vrefresh++;
-            } while ((token = xconfigGetSubToken (&(ptr->comment))) == NUMBER);
+            } while ((token = xconfigGetSubToken (parser,
+                                                  &(ptr->comment))) == NUMBER);
 VertDone:
-            xconfigUnGetToken (token);
+            xconfigUnGetToken (parser, token);
             break;
 
         case GAMMA:
-            if( xconfigGetSubToken (&(ptr->comment)) != NUMBER )
+            if( xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER )
             {
                 Error (INVALID_GAMMA_MSG, NULL);
             }
             else
             {
                 ptr->gamma_red = ptr->gamma_green =
-                    ptr->gamma_blue = val.realnum;
-                if( xconfigGetSubToken (&(ptr->comment)) == NUMBER )
+                    ptr->gamma_blue = parser->val.realnum;
+                if( xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER )
                 {
-                    ptr->gamma_green = val.realnum;
-                    if( xconfigGetSubToken (&(ptr->comment)) == NUMBER )
+                    ptr->gamma_green = parser->val.realnum;
+                    if( xconfigGetSubToken (parser, &(ptr->comment)) == NUMBER )
                     {
-                        ptr->gamma_blue = val.realnum;
+                        ptr->gamma_blue = parser->val.realnum;
                     }
                     else
                     {
@@ -541,36 +494,39 @@ VertDone:
                     }
                 }
                 else
-                    xconfigUnGetToken (token);
+                    xconfigUnGetToken (parser, token);
             }
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case USEMODES:
                 {
                 XConfigModesLinkPtr mptr;
 
-                if ((token = xconfigGetSubToken (&(ptr->comment))) != STRING)
+                if ((token = xconfigGetSubToken (parser,
+                                                 &(ptr->comment))) != STRING)
                     Error (QUOTE_MSG, "UseModes");
 
                 /* add to the end of the list of modes sections 
                    referenced here */
-                mptr = calloc (1, sizeof (XConfigModesLinkRec));
+                mptr = xconfigArenaAlloc (parser->config,
+                                          sizeof (XConfigModesLinkRec));
                 mptr->next = NULL;
-                mptr->modes_name = val.str;
+                mptr->modes_name = parser->val.str;
                 mptr->modes = NULL;
-                xconfigAddListItem((GenericListPtr *)(&ptr->modes_sections),
-                                   (GenericListPtr)mptr);
+                xconfigParserAddListItem(parser,
+                                         (GenericListPtr *)
+                                         (&ptr->modes_sections),
+                                         (GenericListPtr) mptr);
             }
             break;
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            xconfigErrorMsg(ParseErrorMsg, INVALID_KEYWORD_MSG,
-                         xconfigTokenString());
-            CLEANUP (&ptr);
+            xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                                  xconfigTokenString(parser));
             return NULL;
             break;
         }
@@ -582,29 +538,26 @@ VertDone:
     return ptr;
 }
 
-#undef CLEANUP
-#define CLEANUP xconfigFreeModesList
-
 XConfigModesPtr
-xconfigParseModesSection (void)
+xconfigParseModesSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigModesPtr, XConfigModesRec)
 
-    while ((token = xconfigGetToken (ModesTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &ModesTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case MODE:
@@ -616,9 +569,8 @@ xconfigParseModesSection (void)
                          XConfigModeLinePtr);
             break;
         default:
-            xconfigErrorMsg(ParseErrorMsg, INVALID_KEYWORD_MSG,
-                         xconfigTokenString());
-            CLEANUP (&ptr);
+            xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                                  xconfigTokenString(parser));
             return NULL;
             break;
         }
@@ -630,8 +582,6 @@ xconfigParseModesSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintMonitorSection (FILE * cf, XConfigMonitorPtr ptr)
 {
@@ -783,83 +733,6 @@ xconfigPrintModesSection (FILE * cf, XConfigModesPtr ptr)
     }
 }
 
-void
-xconfigFreeMonitorList (XConfigMonitorPtr *ptr)
-{
-    XConfigMonitorPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->vendor);
-        TEST_FREE ((*ptr)->modelname);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeOptionList (&((*ptr)->options));
-        xconfigFreeModeLineList (&((*ptr)->modelines));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeModesList (XConfigModesPtr *ptr)
-{
-    XConfigModesPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeModeLineList (&((*ptr)->modelines));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeModeLineList (XConfigModeLinePtr *ptr)
-{
-    XConfigModeLinePtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->comment);
-        TEST_FREE ((*ptr)->clock);
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeModesLinkList (XConfigModesLinkPtr *ptr)
-{
-    XConfigModesLinkPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->modes_name);
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
 XConfigMonitorPtr
 xconfigFindMonitor (const char *ident, XConfigMonitorPtr p)
 {
@@ -899,23 +772,35 @@ xconfigFindModeLine (const char *ident, XConfigModeLinePtr p)
     return (NULL);
 }
 
+void
+xconfigResolveMonitorModes (XConfigPtr p, XConfigMonitorPtr monitor)
+{
+    XConfigModesLinkPtr modeslnk;
+
+    for (modeslnk = monitor->modes_sections; modeslnk;
+         modeslnk = modeslnk->next)
+    {
+        modeslnk->modes = xconfigIndexFind(p, XCONFIG_INDEX_MODES,
+                                           modeslnk->modes_name);
+    }
+}
+
 int
 xconfigValidateMonitor (XConfigPtr p, XConfigScreenPtr screen)
 {
     XConfigMonitorPtr monitor = screen->monitor;
     XConfigModesLinkPtr modeslnk = monitor->modes_sections;
-    XConfigModesPtr modes;
+    int ret = TRUE;
     while(modeslnk)
     {
-        modes = xconfigFindModes (modeslnk->modes_name, p->modes);
-        if (!modes)
+        if (!modeslnk->modes &&
+            !xconfigSectionFailed(p, MODES_SECTION, modeslnk->modes_name))
         {
-            xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_MODES_MSG, 
-                         modeslnk->modes_name, screen->identifier);
-            return (FALSE);
+            xconfigValidationErrorMsg(p, UNDEFINED_MODES_MSG, 
+                                      modeslnk->modes_name, screen->identifier);
+            VALIDATION_FAILED(p, ret);
         }
-        modeslnk->modes = modes;
         modeslnk = modeslnk->next;
     }
-    return (TRUE);
+    return (ret);
 }
@@ -0,0 +1,507 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * OptionMap.c - hash indexes on the names in option lists.
+ *
+ * An option list is still a list, so it is written out in the order
+ * options were added, but once it holds OPTION_MAP_MIN_OPTIONS options
+ * its config keeps a map from each name, as xconfigNameCompare() sees
+ * it, to the option with that name and the option before it.  Finding,
+ * adding and removing an option through the config are then done
+ * without walking the list, so setting many options on many screens is
+ * no longer quadratic in the length of the lists.
+ *
+ * The maps are kept in a table of the config's, keyed by the address
+ * of each list's first option, so the options themselves carry
+ * nothing.  A map also remembers the list's last option, and a list
+ * that has been appended to by hand is searched the slow way.  Other
+ * changes are caught with generation counts: the public functions that
+ * change lists without their config, xconfigRemoveOption() and
+ * xconfigOptionListMerge(), bump a count that drops every config's
+ * maps, and xconfigInvalidateIndexes() drops a single config's, which
+ * is what is needed after options in the middle of a list are removed
+ * or renamed by hand.  Lists that hold two options of the same name,
+ * which the parser and xconfigAddNewOption() never make, have only the
+ * first of each name in the map, and lose the map when an option is
+ * removed.
+ *
+ * Maps are allocated from the config's arena, like the lists.
+ */
+
+#include <string.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+
+/* lists shorter than this are only ever searched the slow way */
+#define OPTION_MAP_MIN_OPTIONS 16
+
+typedef struct __XConfigOptionMapRec XConfigOptionMapRec, *XConfigOptionMapPtr;
+
+typedef struct {
+    unsigned int hash;
+    XConfigOptionPtr opt;           /* NULL if unused; see REMOVED */
+    XConfigOptionPtr prev;          /* the option before opt, or NULL */
+} XConfigOptionSlotRec;
+
+struct __XConfigOptionMapRec {
+    XConfigOptionMapPtr next;       /* the next map in the same bucket */
+    XConfigOptionPtr head;          /* the list's first option */
+    XConfigOptionPtr tail;          /* the list's last option */
+    XConfigOptionSlotRec *slots;    /* open addressing, linear probing */
+    size_t mask;                    /* number of slots - 1 */
+    size_t count;                   /* options in the map */
+    size_t used;                    /* slots in use, or removed from */
+    int duplicates;                 /* the list repeats a name */
+};
+
+struct __XConfigOptionMapsRec {
+    XConfigOptionMapPtr *buckets;   /* chained, by the head's address */
+    size_t mask;                    /* number of buckets - 1 */
+    size_t count;                   /* maps in the table */
+    unsigned int generation;        /* of OptionListGeneration */
+};
+
+/*
+ * bumped when option lists are changed without their config, which
+ * may be on any thread; a config's maps are dropped when it differs
+ * from the generation they were made in
+ */
+static unsigned int OptionListGeneration;
+
+/* marks a slot an option was removed from */
+static XConfigOptionRec Removed;
+#define REMOVED (&Removed)
+
+
+static size_t HeadBucket(XConfigOptionMapsPtr maps, XConfigOptionPtr head)
+{
+    unsigned long long h = (unsigned long long) (size_t) head;
+
+    return (size_t) ((h * 11400714819323198485ULL) >> 32) & maps->mask;
+}
+
+
+static void ClearMaps(XConfigOptionMapsPtr maps)
+{
+    memset(maps->buckets, 0, (maps->mask + 1) * sizeof(XConfigOptionMapPtr));
+    maps->count = 0;
+}
+
+
+/*
+ * GetMaps() - return config's table of maps, or NULL if it has none;
+ * the maps are dropped first if lists have been changed without their
+ * config since they were made.
+ */
+
+static XConfigOptionMapsPtr GetMaps(XConfigPtr config)
+{
+    XConfigOptionMapsPtr maps = config->optionMaps;
+    unsigned int generation = __atomic_load_n(&OptionListGeneration,
+                                              __ATOMIC_RELAXED);
+
+    if (maps && maps->generation != generation) {
+        ClearMaps(maps);
+        maps->generation = generation;
+    }
+
+    return maps;
+}
+
+
+static void LinkMap(XConfigOptionMapsPtr maps, XConfigOptionMapPtr map)
+{
+    size_t i = HeadBucket(maps, map->head);
+
+    map->next = maps->buckets[i];
+    maps->buckets[i] = map;
+}
+
+
+/*
+ * AddMap() - put map in config's table, which is made on first use and
+ * doubled once it holds as many maps as it has buckets.
+ */
+
+static void AddMap(XConfigPtr config, XConfigOptionMapPtr map)
+{
+    XConfigOptionMapsPtr maps = GetMaps(config);
+    XConfigOptionMapPtr *old, m, next;
+    size_t oldMask, i;
+
+    if (!maps) {
+        maps = xconfigArenaAlloc(config, sizeof(XConfigOptionMapsRec));
+        maps->mask = 15;
+        maps->buckets = xconfigArenaAlloc(config, 16 *
+                                          sizeof(XConfigOptionMapPtr));
+        maps->generation = __atomic_load_n(&OptionListGeneration,
+                                           __ATOMIC_RELAXED);
+        config->optionMaps = maps;
+    }
+
+    if (maps->count > maps->mask) {
+        old = maps->buckets;
+        oldMask = maps->mask;
+
+        maps->mask = oldMask * 2 + 1;
+        maps->buckets = xconfigArenaAlloc(config, (maps->mask + 1) *
+                                          sizeof(XConfigOptionMapPtr));
+
+        for (i = 0; i <= oldMask; i++) {
+            for (m = old[i]; m; m = next) {
+                next = m->next;
+                LinkMap(maps, m);
+            }
+        }
+    }
+
+    LinkMap(maps, map);
+    maps->count++;
+}
+
+
+static void UnlinkMap(XConfigOptionMapsPtr maps, XConfigOptionMapPtr map)
+{
+    XConfigOptionMapPtr *pMap = &maps->buckets[HeadBucket(maps, map->head)];
+
+    for (; *pMap; pMap = &(*pMap)->next) {
+        if (*pMap == map) {
+            *pMap = map->next;
+            maps->count--;
+            return;
+        }
+    }
+}
+
+
+/*
+ * GetMap() - return config's map of the list starting at head, if it
+ * has one that still describes it; one that has been appended to by
+ * hand is dropped.
+ */
+
+static XConfigOptionMapPtr GetMap(XConfigPtr config, XConfigOptionPtr head)
+{
+    XConfigOptionMapsPtr maps;
+    XConfigOptionMapPtr map;
+
+    if (!config || !head || !(maps = GetMaps(config))) {
+        return NULL;
+    }
+
+    for (map = maps->buckets[HeadBucket(maps, head)]; map; map = map->next) {
+        if (map->head == head) {
+            break;
+        }
+    }
+
+    if (map && map->tail->next) {
+        UnlinkMap(maps, map);
+        return NULL;
+    }
+
+    return map;
+}
+
+
+/*
+ * FindSlot() - return the slot of the option named name, or NULL.
+ */
+
+static XConfigOptionSlotRec *FindSlot(XConfigOptionMapPtr map,
+                                      const char *name, unsigned int hash)
+{
+    XConfigOptionSlotRec *slot;
+    size_t i;
+
+    if (!map->slots) {
+        return NULL;
+    }
+
+    for (i = hash & map->mask; map->slots[i].opt;
+         i = (i + 1) & map->mask) {
+        slot = &map->slots[i];
+        if (slot->opt != REMOVED && slot->hash == hash &&
+            xconfigNameCompare(slot->opt->name, name) == 0) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * FindOptionSlot() - return the slot holding opt itself, or NULL.
+ */
+
+static XConfigOptionSlotRec *FindOptionSlot(XConfigOptionMapPtr map,
+                                            XConfigOptionPtr opt)
+{
+    XConfigOptionSlotRec *slot = FindSlot(map, opt->name,
+                                          xconfigNameHash(opt->name));
+
+    return (slot && slot->opt == opt) ? slot : NULL;
+}
+
+
+/*
+ * MapResize() - rehash the options in the map into a table with room
+ * for twice as many, dropping the slots of removed options.
+ */
+
+static void MapResize(XConfigPtr config, XConfigOptionMapPtr map)
+{
+    XConfigOptionSlotRec *old = map->slots;
+    size_t oldMask = map->mask, i, j, n = 16;
+
+    while (n < map->count * 4) n <<= 1;
+
+    map->mask = n - 1;
+    map->slots = xconfigArenaAlloc(config, n * sizeof(XConfigOptionSlotRec));
+    map->used = map->count;
+
+    for (j = 0; old && j <= oldMask; j++) {
+        if (!old[j].opt || old[j].opt == REMOVED) continue;
+        for (i = old[j].hash & map->mask; map->slots[i].opt;
+             i = (i + 1) & map->mask);
+        map->slots[i] = old[j];
+    }
+}
+
+
+/*
+ * MapInsert() - add opt, which follows prev in the list, to the map.
+ */
+
+static void MapInsert(XConfigPtr config, XConfigOptionMapPtr map,
+                      XConfigOptionPtr opt, XConfigOptionPtr prev)
+{
+    unsigned int hash = xconfigNameHash(opt->name);
+    size_t i;
+
+    if (FindSlot(map, opt->name, hash)) {
+        map->duplicates = TRUE;
+        return;
+    }
+
+    if ((map->used + 1) * 2 > map->mask + 1) {
+        MapResize(config, map);
+    }
+
+    for (i = hash & map->mask; map->slots[i].opt &&
+         map->slots[i].opt != REMOVED; i = (i + 1) & map->mask);
+
+    if (!map->slots[i].opt) map->used++;
+
+    map->slots[i].hash = hash;
+    map->slots[i].opt = opt;
+    map->slots[i].prev = prev;
+    map->count++;
+}
+
+
+/*
+ * BuildMap() - index the list starting at head.
+ */
+
+static void BuildMap(XConfigPtr config, XConfigOptionPtr head)
+{
+    XConfigOptionMapPtr map;
+    XConfigOptionPtr opt, prev = NULL;
+
+    map = xconfigArenaAlloc(config, sizeof(XConfigOptionMapRec));
+    map->head = head;
+
+    for (opt = head; opt; prev = opt, opt = opt->next) {
+        MapInsert(config, map, opt, prev);
+    }
+
+    map->tail = prev;
+    AddMap(config, map);
+}
+
+
+/*
+ * xconfigOptionMapFind() - return the option named name in the list
+ * starting at head, or NULL; config's map of the list is used if it
+ * has one, and the list is searched otherwise.
+ */
+
+XConfigOptionPtr xconfigOptionMapFind(XConfigPtr config,
+                                      XConfigOptionPtr head, const char *name)
+{
+    XConfigOptionMapPtr map = GetMap(config, head);
+    XConfigOptionSlotRec *slot;
+
+    if (!map) {
+        return xconfigFindOption(head, name);
+    }
+
+    slot = FindSlot(map, name, xconfigNameHash(name));
+
+    return slot ? slot->opt : NULL;
+}
+
+
+/*
+ * xconfigOptionMapAppend() - add opt, which is not in any list, to the
+ * end of the list *pHead, indexing the list once it is long enough.
+ */
+
+void xconfigOptionMapAppend(XConfigPtr config, XConfigOptionPtr *pHead,
+                            XConfigOptionPtr opt)
+{
+    XConfigOptionMapPtr map = GetMap(config, *pHead);
+    XConfigOptionPtr prev;
+    size_t n;
+
+    opt->next = NULL;
+
+    if (!*pHead) {
+        *pHead = opt;
+        return;
+    }
+
+    if (map) {
+        prev = map->tail;
+        prev->next = opt;
+        map->tail = opt;
+        MapInsert(config, map, opt, prev);
+        return;
+    }
+
+    for (n = 1, prev = *pHead; prev->next; prev = prev->next, n++);
+    prev->next = opt;
+
+    if (n + 1 >= OPTION_MAP_MIN_OPTIONS) {
+        BuildMap(config, *pHead);
+    }
+}
+
+
+/*
+ * DropMap() - forget config's map of the list starting at head, if
+ * there is one.
+ */
+
+static void DropMap(XConfigPtr config, XConfigOptionPtr head)
+{
+    XConfigOptionMapPtr map = GetMap(config, head);
+
+    if (map) {
+        UnlinkMap(config->optionMaps, map);
+    }
+}
+
+
+/*
+ * xconfigOptionMapRemove() - take opt out of the list *pHead.
+ */
+
+void xconfigOptionMapRemove(XConfigPtr config, XConfigOptionPtr *pHead,
+                            XConfigOptionPtr opt)
+{
+    XConfigOptionMapPtr map = GetMap(config, *pHead);
+    XConfigOptionSlotRec *slot, *nextSlot = NULL;
+    XConfigOptionPtr prev;
+
+    if (!map || map->duplicates || !(slot = FindOptionSlot(map, opt)) ||
+        (opt->next && !(nextSlot = FindOptionSlot(map, opt->next)))) {
+        /* walk the list; it is left without a map */
+        DropMap(config, *pHead);
+        xconfigRemoveListItem((GenericListPtr *)pHead, (GenericListPtr)opt);
+        DropMap(config, *pHead);
+        return;
+    }
+
+    prev = slot->prev;
+    slot->opt = REMOVED;
+    slot->prev = NULL;
+    map->count--;
+
+    if (nextSlot) {
+        nextSlot->prev = prev;
+    }
+
+    if (map->tail == opt) {
+        map->tail = prev;
+    }
+
+    if (prev) {
+        prev->next = opt->next;
+    } else {
+        /* the list has a new first option, to find the map by */
+        *pHead = opt->next;
+        UnlinkMap(config->optionMaps, map);
+        if (*pHead) {
+            map->head = *pHead;
+            AddMap(config, map);
+        }
+    }
+}
+
+
+/*
+ * xconfigOptionListsChanged() - note that an option list has been
+ * changed without its config, so that no config's maps are trusted.
+ */
+
+void xconfigOptionListsChanged(void)
+{
+    __atomic_add_fetch(&OptionListGeneration, 1, __ATOMIC_RELAXED);
+}
+
+
+/*
+ * xconfigInvalidateOptionMaps() - drop config's maps, after its lists
+ * have been changed by hand.
+ */
+
+void xconfigInvalidateOptionMaps(XConfigPtr config)
+{
+    XConfigOptionMapsPtr maps = GetMaps(config);
+
+    if (maps) {
+        ClearMaps(maps);
+    }
+}
+
+
+/*
+ * xconfigAdoptOptionMaps() - move from's maps into config's table, when
+ * config takes over from's lists.
+ */
+
+void xconfigAdoptOptionMaps(XConfigPtr config, XConfigPtr from)
+{
+    XConfigOptionMapsPtr maps = GetMaps(from);
+    XConfigOptionMapPtr map, next;
+    size_t i;
+
+    for (i = 0; maps && i <= maps->mask; i++) {
+        for (map = maps->buckets[i]; map; map = next) {
+            next = map->next;
+            AddMap(config, map);
+        }
+    }
+
+    from->optionMaps = NULL;
+}
@@ -0,0 +1,314 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * OptionType.c - registries of the types of option values.
+ *
+ * Option values are text, and a program that uses a boolean or numeric
+ * option would otherwise parse its value each time it looks at it.  An
+ * option registry maps option names, as xconfigNameCompare() sees them,
+ * to the types of their values.  A config read by a parser that has
+ * been given a registry with xconfigSetOptionRegistry() keeps it, and
+ * the value of each option of a known type is parsed once, when the
+ * option is made by the parser or by xconfigAddNewOption(), into the
+ * option's type and value fields; xconfigOptionTypedValue() and
+ * xconfigFindOptionBoolean() then answer from those.  Values that are
+ * not valid for their type are kept as text, and the parser warns
+ * about them.
+ *
+ * A registry is built once from a table of types and then only read,
+ * so the threads of a parallel parse share it.  It must outlive the
+ * configs that use it.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+
+typedef int (*ParseFunc)(const XConfigOptionTypeRec *type, const char *val,
+                         int *value);
+
+typedef struct {
+    unsigned int hash;
+    XConfigOptionTypeRec type;      /* type.name is NULL if unused */
+    ParseFunc parse;
+} XConfigOptionTypeSlotRec;
+
+struct __XConfigOptionRegistryRec {
+    XConfigOptionTypeSlotRec *slots; /* open addressing, linear probing */
+    size_t mask;                    /* number of slots - 1 */
+};
+
+
+static int ParseString(const XConfigOptionTypeRec *type, const char *val,
+                       int *value)
+{
+    *value = 0;
+    return TRUE;
+}
+
+
+/*
+ * ParseBoolean() - accept the words the X server takes as booleans.
+ */
+
+static int ParseBoolean(const XConfigOptionTypeRec *type, const char *val,
+                        int *value)
+{
+    static const char * const trueWords[] = { "1", "on", "yes", "true" };
+    static const char * const falseWords[] = { "0", "off", "no", "false" };
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        if (strcasecmp(val, trueWords[i]) == 0) {
+            *value = 1;
+            return TRUE;
+        }
+        if (strcasecmp(val, falseWords[i]) == 0) {
+            *value = 0;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+/*
+ * ParseInteger() - accept a whole int, in decimal, octal or hex.
+ */
+
+static int ParseInteger(const XConfigOptionTypeRec *type, const char *val,
+                        int *value)
+{
+    char *end;
+    long l;
+
+    errno = 0;
+    l = strtol(val, &end, 0);
+
+    if (end == val || *end != '\0' || errno == ERANGE ||
+        l < INT_MIN || l > INT_MAX) {
+        return FALSE;
+    }
+
+    *value = (int) l;
+    return TRUE;
+}
+
+
+static int ParseEnum(const XConfigOptionTypeRec *type, const char *val,
+                     int *value)
+{
+    int i;
+
+    for (i = 0; type->values && type->values[i]; i++) {
+        if (strcasecmp(val, type->values[i]) == 0) {
+            *value = i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+static ParseFunc GetParseFunc(XConfigOptionType type)
+{
+    switch (type) {
+    case XCONFIG_OPTION_BOOLEAN: return ParseBoolean;
+    case XCONFIG_OPTION_INTEGER: return ParseInteger;
+    case XCONFIG_OPTION_ENUM: return ParseEnum;
+    default: return ParseString;
+    }
+}
+
+
+/*
+ * FindSlot() - return the slot of the type of the option named name,
+ * or NULL.
+ */
+
+static XConfigOptionTypeSlotRec *FindSlot(XConfigOptionRegistryPtr registry,
+                                          const char *name)
+{
+    XConfigOptionTypeSlotRec *slot;
+    unsigned int hash;
+    size_t i;
+
+    if (!registry || !name) {
+        return NULL;
+    }
+
+    hash = xconfigNameHash(name);
+
+    for (i = hash & registry->mask; registry->slots[i].type.name;
+         i = (i + 1) & registry->mask) {
+        slot = &registry->slots[i];
+        if (slot->hash == hash &&
+            xconfigNameCompare(slot->type.name, name) == 0) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * xconfigAllocOptionRegistry() - build a registry of the types in the
+ * given table, which ends with an entry whose name is NULL.  The table
+ * itself may be freed afterwards, but not the names and lists of enum
+ * values it points to.  If a name is given more than once, the first
+ * entry counts.
+ */
+
+XConfigOptionRegistryPtr
+xconfigAllocOptionRegistry(const XConfigOptionTypeRec *types)
+{
+    XConfigOptionRegistryPtr registry;
+    XConfigOptionTypeSlotRec *slot;
+    size_t n, slots = 16, i;
+
+    for (n = 0; types && types[n].name; n++);
+    while (slots < n * 2) slots <<= 1;
+
+    registry = xconfigAlloc(sizeof(XConfigOptionRegistryRec));
+    registry->slots = xconfigAlloc(slots * sizeof(XConfigOptionTypeSlotRec));
+    registry->mask = slots - 1;
+
+    for (n = 0; types && types[n].name; n++) {
+        if (FindSlot(registry, types[n].name)) {
+            continue;
+        }
+
+        for (i = xconfigNameHash(types[n].name) & registry->mask;
+             registry->slots[i].type.name; i = (i + 1) & registry->mask);
+
+        slot = &registry->slots[i];
+        slot->hash = xconfigNameHash(types[n].name);
+        slot->type = types[n];
+        slot->parse = GetParseFunc(types[n].type);
+    }
+
+    return registry;
+}
+
+
+void xconfigFreeOptionRegistry(XConfigOptionRegistryPtr *registry)
+{
+    if (!registry || !*registry) {
+        return;
+    }
+
+    free((*registry)->slots);
+    free(*registry);
+    *registry = NULL;
+}
+
+
+/*
+ * xconfigFindOptionType() - return the type of the option named name
+ * in registry, or NULL if it has none.
+ */
+
+const XConfigOptionTypeRec *
+xconfigFindOptionType(XConfigOptionRegistryPtr registry, const char *name)
+{
+    XConfigOptionTypeSlotRec *slot = FindSlot(registry, name);
+
+    return slot ? &slot->type : NULL;
+}
+
+
+/*
+ * xconfigParseOptionValue() - parse val as a value of the given type
+ * into *value; returns FALSE if val is not a valid value of the type.
+ * Any value is valid for a NULL type, or XCONFIG_OPTION_STRING, and an
+ * option may have no value whatever its type; *value is then 0.
+ */
+
+int xconfigParseOptionValue(const XConfigOptionTypeRec *type,
+                            const char *val, int *value)
+{
+    int dummy;
+
+    if (!value) value = &dummy;
+
+    *value = 0;
+
+    if (!type || !val) {
+        return TRUE;
+    }
+
+    return GetParseFunc(type->type)(type, val, value);
+}
+
+
+/*
+ * xconfigTypeOption() - parse the value of opt, if its type is known
+ * to config's registry; returns FALSE if the value is not valid for
+ * the type, in which case it is only kept as text.
+ */
+
+int xconfigTypeOption(XConfigPtr config, XConfigOptionPtr opt)
+{
+    XConfigOptionTypeSlotRec *slot = FindSlot(config->optionTypes,
+                                              opt->name);
+
+    opt->typedVal = opt->val;
+    opt->type = XCONFIG_OPTION_STRING;
+    opt->value = 0;
+
+    if (!slot || !opt->val) {
+        return TRUE;
+    }
+
+    if (!slot->parse(&slot->type, opt->val, &opt->value)) {
+        opt->value = 0;
+        return FALSE;
+    }
+
+    opt->type = slot->type.type;
+
+    return TRUE;
+}
+
+
+/*
+ * xconfigOptionTypedValue() - if opt's value has been parsed as the
+ * given type, and has not changed since, set *value to it and return
+ * TRUE; otherwise return FALSE, and leave the text to the caller.
+ */
+
+int xconfigOptionTypedValue(XConfigOptionPtr opt, XConfigOptionType type,
+                            int *value)
+{
+    if (!opt || type == XCONFIG_OPTION_STRING || opt->type != (int) type ||
+        opt->typedVal != opt->val) {
+        return FALSE;
+    }
+
+    *value = opt->value;
+    return TRUE;
+}
@@ -58,122 +58,106 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
+XCONFIG_KEYWORD_TABLE(PointerTab);
 
-static XConfigSymTabRec PointerTab[] =
-{
-    {PROTOCOL, "protocol"},
-    {EMULATE3, "emulate3buttons"},
-    {EM3TIMEOUT, "emulate3timeout"},
-    {ENDSUBSECTION, "endsubsection"},
-    {ENDSECTION, "endsection"},
-    {PDEVICE, "device"},
-    {PDEVICE, "port"},
-    {BAUDRATE, "baudrate"},
-    {SAMPLERATE, "samplerate"},
-    {CLEARDTR, "cleardtr"},
-    {CLEARRTS, "clearrts"},
-    {CHORDMIDDLE, "chordmiddle"},
-    {PRESOLUTION, "resolution"},
-    {DEVICE_NAME, "devicename"},
-    {ALWAYSCORE, "alwayscore"},
-    {PBUTTONS, "buttons"},
-    {ZAXISMAPPING, "zaxismapping"},
-    {-1, ""},
-};
-
-static XConfigSymTabRec ZMapTab[] =
-{
-    {XAXIS, "x"},
-    {YAXIS, "y"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeInputList
+XCONFIG_KEYWORD_TABLE(ZMapTab);
 
 XConfigInputPtr
-xconfigParsePointerSection (void)
+xconfigParsePointerSection (XConfigParserPtr parser)
 {
     char *s, *s1, *s2;
     int l;
     int token;
     PARSE_PROLOGUE (XConfigInputPtr, XConfigInputRec)
 
-    while ((token = xconfigGetToken (PointerTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &PointerTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case PROTOCOL:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Protocol");
-            xconfigAddNewOption(&ptr->options, "Protocol", val.str);
+            xconfigAddNewOption(parser->config, &ptr->options, "Protocol",
+                                parser->val.str);
             break;
         case PDEVICE:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Device");
-            xconfigAddNewOption(&ptr->options, "Device", val.str);
+            xconfigAddNewOption(parser->config, &ptr->options, "Device",
+                                parser->val.str);
             break;
         case EMULATE3:
-            xconfigAddNewOption(&ptr->options, "Emulate3Buttons", NULL);
+            xconfigAddNewOption(parser->config, &ptr->options,
+                                "Emulate3Buttons", NULL);
             break;
         case EM3TIMEOUT:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER ||
+                parser->val.num < 0)
                 Error (POSITIVE_INT_MSG, "Emulate3Timeout");
-            s = xconfigULongToString(val.num);
-            xconfigAddNewOption(&ptr->options, "Emulate3Timeout", s);
+            s = xconfigULongToString(parser->val.num);
+            xconfigAddNewOption(parser->config, &ptr->options,
+                                "Emulate3Timeout", s);
             TEST_FREE(s);
             break;
         case CHORDMIDDLE:
-            xconfigAddNewOption(&ptr->options, "ChordMiddle", NULL);
+            xconfigAddNewOption(parser->config, &ptr->options, "ChordMiddle",
+                                NULL);
             break;
         case PBUTTONS:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER ||
+                parser->val.num < 0)
                 Error (POSITIVE_INT_MSG, "Buttons");
-            s = xconfigULongToString(val.num);
-            xconfigAddNewOption(&ptr->options, "Buttons", s);
+            s = xconfigULongToString(parser->val.num);
+            xconfigAddNewOption(parser->config, &ptr->options, "Buttons", s);
             TEST_FREE(s);
             break;
         case BAUDRATE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER ||
+                parser->val.num < 0)
                 Error (POSITIVE_INT_MSG, "BaudRate");
-            s = xconfigULongToString(val.num);
-            xconfigAddNewOption(&ptr->options, "BaudRate", s);
+            s = xconfigULongToString(parser->val.num);
+            xconfigAddNewOption(parser->config, &ptr->options, "BaudRate", s);
             TEST_FREE(s);
             break;
         case SAMPLERATE:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER ||
+                parser->val.num < 0)
                 Error (POSITIVE_INT_MSG, "SampleRate");
-            s = xconfigULongToString(val.num);
-            xconfigAddNewOption(&ptr->options, "SampleRate", s);
+            s = xconfigULongToString(parser->val.num);
+            xconfigAddNewOption(parser->config, &ptr->options, "SampleRate", s);
             TEST_FREE(s);
             break;
         case PRESOLUTION:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER || val.num < 0)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER ||
+                parser->val.num < 0)
                 Error (POSITIVE_INT_MSG, "Resolution");
-            s = xconfigULongToString(val.num);
-            xconfigAddNewOption(&ptr->options, "Resolution", s);
+            s = xconfigULongToString(parser->val.num);
+            xconfigAddNewOption(parser->config, &ptr->options, "Resolution", s);
             TEST_FREE(s);
             break;
         case CLEARDTR:
-            xconfigAddNewOption(&ptr->options, "ClearDTR", NULL);
+            xconfigAddNewOption(parser->config, &ptr->options, "ClearDTR",
+                                NULL);
             break;
         case CLEARRTS:
-            xconfigAddNewOption(&ptr->options, "ClearRTS", NULL);
+            xconfigAddNewOption(parser->config, &ptr->options, "ClearRTS",
+                                NULL);
             break;
         case ZAXISMAPPING:
-            switch (xconfigGetToken(ZMapTab)) {
+            switch (xconfigGetToken(parser, &ZMapTab)) {
             case NUMBER:
-                if (val.num < 0)
+                if (parser->val.num < 0)
                     Error (ZAXISMAPPING_MSG, NULL);
-                s1 = xconfigULongToString(val.num);
-                if (xconfigGetSubToken (&(ptr->comment)) != NUMBER ||
-                    val.num < 0)
+                s1 = xconfigULongToString(parser->val.num);
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER ||
+                    parser->val.num < 0)
                     Error (ZAXISMAPPING_MSG, NULL);
-                s2 = xconfigULongToString(val.num);
+                s2 = xconfigULongToString(parser->val.num);
                 l = strlen(s1) + 1 + strlen(s2) + 1;
                 s = malloc(l);
                 sprintf(s, "%s %s", s1, s2);
@@ -190,7 +174,8 @@ xconfigParsePointerSection (void)
                 Error (ZAXISMAPPING_MSG, NULL);
                 break;
             }
-            xconfigAddNewOption(&ptr->options, "ZAxisMapping", s);
+            xconfigAddNewOption(parser->config, &ptr->options, "ZAxisMapping",
+                                s);
             TEST_FREE(s);
             break;
         case ALWAYSCORE:
@@ -199,17 +184,15 @@ xconfigParsePointerSection (void)
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
 
-    ptr->identifier = xconfigStrdup(CONF_IMPLICIT_POINTER);
-    ptr->driver = xconfigStrdup("mouse");
-    xconfigAddNewOption(&ptr->options, "CorePointer", NULL);
+    ptr->identifier = xconfigIntern(parser->config, CONF_IMPLICIT_POINTER);
+    ptr->driver = xconfigIntern(parser->config, "mouse");
+    xconfigAddNewOption(parser->config, &ptr->options, "CorePointer", NULL);
 
     return ptr;
 }
 
-#undef CLEANUP
-
@@ -53,213 +53,949 @@
  */
 
 
+#include <pthread.h>
+#include <unistd.h>
+
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec TopLevelTab[] =
-{
-    {SECTION, "section"},
-    {-1, ""},
-};
+XCONFIG_KEYWORD_TABLE(TopLevelTab);
 
+XCONFIG_KEYWORD_TABLE(SectionTab);
 
-#define CLEANUP xconfigFreeConfig
 
 #define READ_HANDLE_RETURN(f,func)         \
     if ((ptr->f=func) == NULL) {           \
-        xconfigFreeConfig(&ptr);           \
-        return XCONFIG_RETURN_PARSE_ERROR; \
-    }
+        return FALSE;                      \
+    }                                      \
+    *node = ptr->f;
 
 #define READ_HANDLE_LIST(field,func,type)                               \
 {                                                                       \
-    type p = func();                                                    \
+    type p = func(parser);                                              \
     if (p == NULL) {                                                    \
-        xconfigFreeConfig(&ptr);                                        \
-        return XCONFIG_RETURN_PARSE_ERROR;                              \
+        return FALSE;                                                   \
     } else {                                                            \
-        xconfigAddListItem((GenericListPtr *)(&ptr->field),             \
-                           (GenericListPtr) p);                         \
+        xconfigParserAddListItem(parser,                                \
+                                 (GenericListPtr *)(&ptr->field),       \
+                                 (GenericListPtr) p);                   \
+        *node = p;                                                      \
     }                                                                   \
 }
 
-#define READ_ERROR(a,b)                       \
-    do {                                      \
-        xconfigErrorMsg(ParseErrorMsg, a, b); \
-        xconfigFreeConfig(&ptr);              \
-        return XCONFIG_RETURN_PARSE_ERROR;    \
+#define READ_ERROR(a,b)                                     \
+    do {                                                    \
+        xconfigParserErrorMsg(parser, ParseErrorMsg, a, b); \
+        return FALSE;                                       \
     } while (0)
 
 
+/*
+ * the section kinds that may be deferred, and the section token of
+ * each; see xconfigSetDeferredSections()
+ */
+
+static const struct {
+    unsigned int kind;
+    int token;
+} DeferrableSections[] = {
+    { XCONFIG_DEFER_FILES,        FILES_SECTION },
+    { XCONFIG_DEFER_MODULE,       MODULE_SECTION },
+    { XCONFIG_DEFER_FLAGS,        SERVERFLAGS_SECTION },
+    { XCONFIG_DEFER_VENDOR,       VENDOR_SECTION },
+    { XCONFIG_DEFER_INPUTCLASS,   INPUTCLASS_SECTION },
+    { XCONFIG_DEFER_DRI,          DRI_SECTION },
+    { XCONFIG_DEFER_EXTENSIONS,   EXTENSIONS_SECTION },
+};
+
+static unsigned int DeferKind(int token)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(DeferrableSections) /
+                    sizeof(DeferrableSections[0]); i++) {
+        if (DeferrableSections[i].token == token) {
+            return DeferrableSections[i].kind;
+        }
+    }
+
+    return 0;
+}
+
 
 /*
- * xconfigReadConfigFile() - read the open XConfig file, returning the
- * parsed data as XConfigPtr.
+ * DeferSection() - skip the section whose "Section" keyword starts at
+ * offset start on the given line, keeping a verbatim copy of its text
+ * in the config for xconfigParseDeferredSections() or the writer; the
+ * copy is returned in *node.
  */
 
-XConfigError xconfigReadConfigFile(XConfigPtr *configPtr)
+static int DeferSection(XConfigParserPtr parser, XConfigPtr ptr,
+                        unsigned int kind, size_t start, int line,
+                        void **node)
 {
-    int token;
+    XConfigDeferredPtr deferred;
+    char *text;
+
+    if (!xconfigSkipSection(parser)) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, UNEXPECTED_EOF_MSG,
+                              NULL);
+        return FALSE;
+    }
+
+    deferred = xconfigArenaAlloc(ptr, sizeof(XConfigDeferredRec));
+    deferred->kind = kind;
+    deferred->line = line;
+    deferred->len = parser->pos - start;
+    text = xconfigArenaAlloc(ptr, deferred->len + 1);
+    memcpy(text, parser->data + start, deferred->len);
+    deferred->text = text;
+
+    xconfigParserAddListItem(parser, (GenericListPtr *)(&ptr->deferred),
+                             (GenericListPtr) deferred);
+    *node = deferred;
+
+    return TRUE;
+}
+
+
+/*
+ * ReadSectionName() - read the name of the section whose "Section"
+ * keyword was just returned by xconfigGetToken(), and look up its
+ * section token; returns FALSE on a parse error, after reporting it.
+ */
+
+static int ReadSectionName(XConfigParserPtr parser, XConfigPtr ptr,
+                           int *token)
+{
+    if (xconfigGetSubToken(parser, &(ptr->comment)) != STRING) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, QUOTE_MSG,
+                              "Section");
+        return FALSE;
+    }
+
+    xconfigSetSection(parser, parser->val.str);
+
+    *token = xconfigGetStringToken(parser, &SectionTab);
+
+    return TRUE;
+}
+
+
+/*
+ * ReadSectionBody() - read the rest of the section whose name was just
+ * read by ReadSectionName(), adding it to ptr and returning the new
+ * node in *node.  start and line are the offset and line of its
+ * "Section" keyword.  Returns FALSE on a parse error, after reporting
+ * it.
+ */
+
+static int ReadSectionBody(XConfigParserPtr parser, XConfigPtr ptr,
+                           int token, size_t start, int line, void **node)
+{
+    unsigned int kind;
+
+    parser->sectionRecord = NULL;
+
+    kind = DeferKind(token);
+    if (kind & parser->deferKinds) {
+        return DeferSection(parser, ptr, kind, start, line, node);
+    }
+
+    switch (token) {
+    case FILES_SECTION:
+        READ_HANDLE_RETURN(files, xconfigParseFilesSection(parser));
+        break;
+    case SERVERFLAGS_SECTION:
+        READ_HANDLE_RETURN(flags, xconfigParseFlagsSection(parser));
+        break;
+    case KEYBOARD_SECTION:
+        READ_HANDLE_LIST(inputs, xconfigParseKeyboardSection,
+                         XConfigInputPtr);
+        break;
+    case POINTER_SECTION:
+        READ_HANDLE_LIST(inputs, xconfigParsePointerSection,
+                         XConfigInputPtr);
+        break;
+    case VIDEOADAPTOR_SECTION:
+        READ_HANDLE_LIST(videoadaptors, xconfigParseVideoAdaptorSection,
+                         XConfigVideoAdaptorPtr);
+        break;
+    case DEVICE_SECTION:
+        READ_HANDLE_LIST(devices, xconfigParseDeviceSection,
+                         XConfigDevicePtr);
+        break;
+    case MONITOR_SECTION:
+        READ_HANDLE_LIST(monitors, xconfigParseMonitorSection,
+                         XConfigMonitorPtr);
+        break;
+    case MODES_SECTION:
+        READ_HANDLE_LIST(modes, xconfigParseModesSection,
+                         XConfigModesPtr);
+        break;
+    case SCREEN_SECTION:
+        READ_HANDLE_LIST(screens, xconfigParseScreenSection,
+                         XConfigScreenPtr);
+        break;
+    case INPUTDEVICE_SECTION:
+        READ_HANDLE_LIST(inputs, xconfigParseInputSection,
+                         XConfigInputPtr);
+        break;
+    case INPUTCLASS_SECTION:
+        READ_HANDLE_LIST(inputclasses, xconfigParseInputClassSection,
+                         XConfigInputClassPtr);
+        break;
+    case MODULE_SECTION:
+        READ_HANDLE_RETURN(modules, xconfigParseModuleSection(parser));
+        break;
+    case SERVERLAYOUT_SECTION:
+        READ_HANDLE_LIST(layouts, xconfigParseLayoutSection,
+                         XConfigLayoutPtr);
+        break;
+    case VENDOR_SECTION:
+        READ_HANDLE_LIST(vendors, xconfigParseVendorSection,
+                         XConfigVendorPtr);
+        break;
+    case DRI_SECTION:
+        READ_HANDLE_RETURN(dri, xconfigParseDRISection(parser));
+        break;
+    case EXTENSIONS_SECTION:
+        READ_HANDLE_RETURN(extensions,
+                           xconfigParseExtensionsSection(parser));
+        break;
+    default:
+        READ_ERROR(INVALID_SECTION_MSG, xconfigTokenString(parser));
+    }
+
+    return TRUE;
+}
+
+
+/*
+ * AddFailedSection() - note that a section of the given kind failed to
+ * parse, along with its Identifier if that was read before the error,
+ * so that validation does not also report the section as missing; see
+ * xconfigSectionFailed().
+ */
+
+static void AddFailedSection(XConfigParserPtr parser, int token)
+{
+    XConfigFailedSectionPtr failed;
+    void *record = parser->sectionRecord;
+    const char *identifier = NULL;
+
+    if (token == KEYBOARD_SECTION || token == POINTER_SECTION) {
+        token = INPUTDEVICE_SECTION;
+    }
+
+    if (record) {
+        switch (token) {
+        case DEVICE_SECTION:
+            identifier = ((XConfigDevicePtr) record)->identifier;
+            break;
+        case MONITOR_SECTION:
+            identifier = ((XConfigMonitorPtr) record)->identifier;
+            break;
+        case MODES_SECTION:
+            identifier = ((XConfigModesPtr) record)->identifier;
+            break;
+        case SCREEN_SECTION:
+            identifier = ((XConfigScreenPtr) record)->identifier;
+            break;
+        case INPUTDEVICE_SECTION:
+            identifier = ((XConfigInputPtr) record)->identifier;
+            break;
+        case VIDEOADAPTOR_SECTION:
+            identifier = ((XConfigVideoAdaptorPtr) record)->identifier;
+            break;
+        case SERVERLAYOUT_SECTION:
+            identifier = ((XConfigLayoutPtr) record)->identifier;
+            break;
+        }
+    }
+
+    failed = xconfigAlloc(sizeof(XConfigFailedSectionRec));
+    failed->token = token;
+    failed->identifier = xconfigStrdup(identifier);
+    failed->next = parser->diagnostics.failed;
+    parser->diagnostics.failed = failed;
+}
+
+
+/*
+ * ReadSection() - read the section whose "Section" keyword was just
+ * returned by xconfigGetToken(), adding it to ptr; the new node and its
+ * section token are returned in *node and *token.  Returns FALSE on a
+ * parse error, after reporting it.
+ */
+
+static int ReadSection(XConfigParserPtr parser, XConfigPtr ptr,
+                       void **node, int *token)
+{
+    size_t start = parser->tok - parser->data;
+    int line = parser->lineNo;
+
+    if (!ReadSectionName(parser, ptr, token)) {
+        return FALSE;
+    }
+
+    if (!ReadSectionBody(parser, ptr, *token, start, line, node)) {
+        if (parser->recover) {
+            AddFailedSection(parser, *token);
+        }
+        return FALSE;
+    }
+
+    if (parser->trackSource) {
+        xconfigAddSourceSpan(ptr, *node, *token,
+                             (DeferKind(*token) & parser->deferKinds) != 0,
+                             start, parser->pos);
+    }
+
+    return TRUE;
+}
+
+
+/*
+ * Parallel reading (see xconfigSetParallelParse()).  The main thread
+ * first runs through the top level of the config: it reads comments
+ * and section names exactly as ReadSection() does, but skips over the
+ * body of each section, noting where it starts and where its
+ * EndSection is.  The sections are then split into contiguous runs of
+ * about the same size, and the runs are parsed on separate threads,
+ * each into a config of its own and with a parser of its own that
+ * holds its messages.  Finally, the runs are joined to the main config
+ * in order, and their messages printed in order.
+ *
+ * Everything is done just as it would be when reading serially, so the
+ * result is the same, with a few cases to take care of:
+ *
+ * - if the run through the top level meets something other than a
+ *   comment or a well formed section, it stops and backs up to before
+ *   it, and the rest of the config is read serially once the sections
+ *   before it have been.
+ *
+ * - if a section has a parse error, the sections after it are ignored,
+ *   along with their messages.
+ *
+ * - if a section does not end where xconfigSkipSection() thought it
+ *   would, eg because its EndSection was taken as the argument of some
+ *   keyword, the sections after it were not split correctly.  The
+ *   whole config is then read again serially.
+ */
+
+typedef struct {
+    int token;                  /* the section's token */
+    size_t start;               /* offset of its "Section" keyword */
+    int line;                   /* ... and its line */
+    const char *name;           /* the section's name */
+    XConfigScanStateRec body;   /* position just after the name */
+    size_t end;                 /* position just after EndSection */
+} SectionSpanRec, *SectionSpanPtr;
+
+enum {
+    RUN_READ,                   /* each section read as expected */
+    RUN_PARSE_ERROR,            /* a section had a parse error */
+    RUN_MISPLACED               /* a section did not end at its end */
+};
+
+typedef struct {
+    XConfigParserPtr parser;    /* the run's own parser */
+    XConfigPtr config;          /* the config the run is read into */
+    SectionSpanPtr sections;
+    int nsections;
+    int status;
+    pthread_t thread;
+    int threaded;               /* whether thread was started */
+} SectionRunRec, *SectionRunPtr;
+
+
+/*
+ * ScanSections() - run through the top level of the config from the
+ * parser's current position, adding comments to ptr and returning the
+ * spans of the sections found, until the end of the config or until
+ * something that should be left to ReadSection(); the parser is left
+ * before that.
+ */
+
+static SectionSpanPtr ScanSections(XConfigParserPtr parser, XConfigPtr ptr,
+                                   int *nsections)
+{
+    SectionSpanPtr sections = NULL, tmp;
+    SectionSpanRec span;
+    XConfigScanStateRec before;
+    size_t commentLen;
+    int n = 0, size = 0, token;
+
+    /*
+     * only a malformed section name can cause a message, and that
+     * section is read again by ReadSection()
+     */
+
+    xconfigHoldMessages(parser);
+
+    for (;;) {
+        xconfigSaveScanState(parser, &before);
+        commentLen = ptr->comment ? strlen(ptr->comment) : 0;
+
+        token = xconfigGetToken(parser, &TopLevelTab);
+
+        if (token == EOF_TOKEN) {
+            break;
+        }
+
+        if (token == COMMENT) {
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
+            continue;
+        }
+
+        if (token != SECTION) {
+            xconfigRestoreScanState(parser, &before);
+            break;
+        }
+
+        if (parser->trackSource) {
+            xconfigNoteFirstSection(ptr);
+        }
+
+        span.start = parser->tok - parser->data;
+        span.line = parser->lineNo;
+
+        if (!ReadSectionName(parser, ptr, &span.token)) {
+            goto backup;
+        }
+
+        span.name = parser->val.str;
+        xconfigSaveScanState(parser, &span.body);
+
+        if (!xconfigSkipSection(parser)) {
+            goto backup;
+        }
+
+        span.end = parser->pos;
+
+        if (n == size) {
+            size = size ? size * 2 : 64;
+            tmp = realloc(sections, size * sizeof(SectionSpanRec));
+            if (!tmp) {
+                goto backup;
+            }
+            sections = tmp;
+        }
+        sections[n++] = span;
+        continue;
+
+    backup:
+
+        /* forget any comments read along with the section name */
+
+        if (commentLen) {
+            ptr->comment[commentLen] = '\0';
+        } else {
+            ptr->comment = NULL;
+        }
+        xconfigRestoreScanState(parser, &before);
+        break;
+    }
+
+    xconfigReleaseMessages(parser, FALSE);
+
+    *nsections = n;
+    return sections;
+}
+
+
+/*
+ * ReadSectionRun() - read the run's sections into its config; this is
+ * the start routine of the run's thread.
+ */
+
+static void *ReadSectionRun(void *arg)
+{
+    SectionRunPtr run = arg;
+    SectionSpanPtr span;
+    void *node;
+    int i;
+
+    run->status = RUN_READ;
+
+    for (i = 0; i < run->nsections; i++) {
+        span = &run->sections[i];
+
+        xconfigRestoreScanState(run->parser, &span->body);
+        xconfigSetSection(run->parser, span->name);
+
+        if (!ReadSectionBody(run->parser, run->config, span->token,
+                             span->start, span->line, &node)) {
+            run->status = RUN_PARSE_ERROR;
+            break;
+        }
+
+        if (run->parser->pos != span->end) {
+            run->status = RUN_MISPLACED;
+            break;
+        }
+
+        if (run->parser->trackSource) {
+            xconfigAddSourceSpan(run->config, node, span->token,
+                                 (DeferKind(span->token) &
+                                  run->parser->deferKinds) != 0,
+                                 span->start, span->end);
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * JoinSectionRun() - add what the run read to ptr, in the same way
+ * ReadSectionBody() would have.
+ */
+
+#define JOIN_LIST(field)                                                \
+    if (from->field) {                                                  \
+        xconfigAddListItem((GenericListPtr *)(&ptr->field),             \
+                           (GenericListPtr) from->field);               \
+    }
+
+#define JOIN_ONE(field)                                                 \
+    if (from->field) {                                                  \
+        ptr->field = from->field;                                       \
+    }
+
+static void JoinSectionRun(XConfigPtr ptr, SectionRunPtr run)
+{
+    XConfigPtr from = run->config;
+
+    JOIN_ONE(files);
+    JOIN_ONE(modules);
+    JOIN_ONE(flags);
+    JOIN_LIST(videoadaptors);
+    JOIN_LIST(modes);
+    JOIN_LIST(monitors);
+    JOIN_LIST(devices);
+    JOIN_LIST(screens);
+    JOIN_LIST(inputs);
+    JOIN_LIST(inputclasses);
+    JOIN_LIST(layouts);
+    JOIN_LIST(vendors);
+    JOIN_ONE(dri);
+    JOIN_ONE(extensions);
+    JOIN_LIST(deferred);
+
+    xconfigJoinSourceSpans(ptr, from);
+    xconfigAdoptOptionMaps(ptr, from);
+    xconfigAdoptConfig(ptr, from);
+    run->config = NULL;
+}
+
+#undef JOIN_LIST
+#undef JOIN_ONE
+
+
+/*
+ * ReadSectionsInParallel() - read the sections at the start of the
+ * config on parser->threads threads, leaving the parser after them.
+ * Returns FALSE on a parse error, after reporting it.  If the config
+ * has to be read again serially, *configPtr is replaced with a new,
+ * empty config and the parser is moved back to where it started.
+ */
+
+static int ReadSectionsInParallel(XConfigParserPtr parser,
+                                  XConfigPtr *configPtr)
+{
+    XConfigPtr ptr = *configPtr;
+    XConfigScanStateRec start;
+    SectionSpanPtr sections;
+    SectionRunPtr runs;
+    char *section = parser->section ? strdup(parser->section) : NULL;
+    size_t total, done;
+    int nsections, nruns, i, first, ret = TRUE;
+
+    xconfigSaveScanState(parser, &start);
+
+    sections = ScanSections(parser, ptr, &nsections);
+
+    if (nsections == 0) {
+        free(sections);
+        free(section);
+        return TRUE;
+    }
+
+    /* split the sections into runs of about the same number of bytes */
+
+    nruns = (parser->threads < nsections) ? parser->threads : nsections;
+    runs = xconfigAlloc(nruns * sizeof(SectionRunRec));
+
+    total = sections[nsections - 1].end - sections[0].start;
+    done = 0;
+
+    for (i = 0; i < nsections; i++) {
+        int r = (int) (((double) done * nruns) / (total + 1));
+
+        if (r >= nruns) r = nruns - 1;
+
+        if (runs[r].nsections == 0) {
+            runs[r].sections = &sections[i];
+        }
+        runs[r].nsections++;
+        done += sections[i].end - sections[i].start;
+    }
+
+    for (i = 0; i < nruns; i++) {
+        runs[i].config = xconfigAllocConfig();
+        runs[i].parser = xconfigForkParser(parser, runs[i].config);
+        xconfigHoldMessages(runs[i].parser);
+    }
+
+    /* the main thread reads the first run itself */
+
+    for (i = 1; i < nruns; i++) {
+        runs[i].threaded = (pthread_create(&runs[i].thread, NULL,
+                                           ReadSectionRun, &runs[i]) == 0);
+    }
+
+    for (i = 0; i < nruns; i++) {
+        if (runs[i].threaded) {
+            pthread_join(runs[i].thread, NULL);
+        } else {
+            ReadSectionRun(&runs[i]);
+        }
+    }
+
+    /* the first run that was not read as expected, if any, decides */
+
+    for (first = 0; first < nruns; first++) {
+        if (runs[first].status != RUN_READ) break;
+    }
+
+    if (first < nruns && runs[first].status == RUN_MISPLACED) {
+        xconfigFreeConfig(configPtr);
+        *configPtr = xconfigAllocConfig();
+        (*configPtr)->optionTypes = parser->optionTypes;
+        parser->config = *configPtr;
+        xconfigRestoreScanState(parser, &start);
+        TEST_FREE(parser->section);
+        parser->section = section;
+        section = NULL;
+    } else {
+        for (i = 0; i < nruns && i <= first; i++) {
+            xconfigReleaseMessages(runs[i].parser, TRUE);
+            if (runs[i].status == RUN_READ) {
+                JoinSectionRun(ptr, &runs[i]);
+            }
+        }
+        ret = (first == nruns);
+    }
+
+    for (i = 0; i < nruns; i++) {
+        xconfigFreeParser(&runs[i].parser);
+        xconfigFreeConfig(&runs[i].config);
+    }
+
+    free(runs);
+    free(sections);
+    free(section);
+
+    return ret;
+}
+
+
+/*
+ * xconfigResolveReferences() - point every reference between sections
+ * (a screen's device, monitor and video adaptors, a monitor's Modes
+ * sections, and a layout's screens, inactive devices and input devices)
+ * at the section it names, looking each name up once in the config's
+ * indexes; a reference to a section that does not exist is set to NULL
+ * for validation to report.  The parser does this once the whole file
+ * has been read, so that forward references are patched in one pass.
+ */
+
+void xconfigResolveReferences(XConfigPtr p)
+{
+    xconfigInvalidateIndexes(p);
+
+    xconfigResolveScreenReferences(p);
+    xconfigResolveLayoutReferences(p);
+}
+
+
+/*
+ * CheckConfig() - report errors for missing drivers and for references
+ * xconfigResolveReferences() could not resolve.
+ */
+
+static int CheckConfig(XConfigPtr p)
+{
+    int ret = TRUE;
+
+    if (!xconfigValidateDevice(p))
+        VALIDATION_FAILED(p, ret);
+    if (!xconfigValidateScreen(p))
+        VALIDATION_FAILED(p, ret);
+    if (!xconfigValidateInput(p))
+        VALIDATION_FAILED(p, ret);
+    if (!xconfigValidateLayout(p))
+        VALIDATION_FAILED(p, ret);
+    
+    return ret;
+}
+
+
+/*
+ * xconfigReadConfigFile() - read the XConfig file opened in the given
+ * parser context, returning the parsed data as XConfigPtr.  In error
+ * recovery mode, reading carries on past parse errors, and the config
+ * is validated even if there were any, so that every message is
+ * collected; the config is still only returned if there were none.
+ */
+
+XConfigError xconfigReadConfigFile(XConfigParserPtr parser,
+                                   XConfigPtr *configPtr)
+{
+    int token, sectionToken, errors, valid;
     XConfigPtr ptr = NULL;
+    void *node;
 
     *configPtr = NULL;
 
-    ptr = xconfigAlloc(sizeof(XConfigRec));
+    ptr = xconfigAllocConfig();
+    ptr->optionTypes = parser->optionTypes;
+    parser->config = ptr;
+    xconfigForgetListEnds(parser);
+
+    if (parser->recover) {
+        xconfigFreeDiagnostics(parser);
+    } else if ((parser->threads > 1) &&
+               (parser->dataLen >= parser->parallelMinSize)) {
+        if (!ReadSectionsInParallel(parser, &ptr)) {
+            xconfigFreeConfig(&ptr);
+            return XCONFIG_RETURN_PARSE_ERROR;
+        }
+        xconfigForgetListEnds(parser);
+    }
     
-    while ((token = xconfigGetToken(TopLevelTab)) != EOF_TOKEN) {
+    while ((token = xconfigGetToken(parser, &TopLevelTab)) != EOF_TOKEN) {
         
         switch (token) {
             
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
             
         case SECTION:
-            if (xconfigGetSubToken(&(ptr->comment)) != STRING) {
-                xconfigErrorMsg(ParseErrorMsg, QUOTE_MSG, "Section");
+            if (parser->trackSource) {
+                xconfigNoteFirstSection(ptr);
+            }
+            if (!ReadSection(parser, ptr, &node, &sectionToken)) {
+                if (parser->recover) {
+                    xconfigSkipToSection(parser);
+                    break;
+                }
                 xconfigFreeConfig(&ptr);
                 return XCONFIG_RETURN_PARSE_ERROR;
             }
-            
-            xconfigSetSection(val.str);
-            
-            if (xconfigNameCompare(val.str, "files") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_RETURN(files, xconfigParseFilesSection());
-            }
-            else if (xconfigNameCompare(val.str, "serverflags") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_RETURN(flags, xconfigParseFlagsSection());
-            }
-            else if (xconfigNameCompare(val.str, "keyboard") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(inputs, xconfigParseKeyboardSection,
-                                 XConfigInputPtr);
-            }
-            else if (xconfigNameCompare(val.str, "pointer") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(inputs, xconfigParsePointerSection,
-                                 XConfigInputPtr);
-            }
-            else if (xconfigNameCompare(val.str, "videoadaptor") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(videoadaptors,
-                            xconfigParseVideoAdaptorSection,
-                                 XConfigVideoAdaptorPtr);
-            }
-            else if (xconfigNameCompare(val.str, "device") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(devices, xconfigParseDeviceSection,
-                                 XConfigDevicePtr);
-            }
-            else if (xconfigNameCompare(val.str, "monitor") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(monitors, xconfigParseMonitorSection,
-                                 XConfigMonitorPtr);
-            }
-            else if (xconfigNameCompare(val.str, "modes") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(modes, xconfigParseModesSection,
-                                 XConfigModesPtr);
-            }
-            else if (xconfigNameCompare(val.str, "screen") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(screens, xconfigParseScreenSection,
-                                 XConfigScreenPtr);
-            }
-            else if (xconfigNameCompare(val.str, "inputdevice") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(inputs, xconfigParseInputSection,
-                                 XConfigInputPtr);
-            }
-            else if ((xconfigNameCompare(val.str, "inputclass") == 0))
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(inputclasses, xconfigParseInputClassSection,
-                                 XConfigInputClassPtr);
-            }
-            else if (xconfigNameCompare(val.str, "module") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_RETURN(modules, xconfigParseModuleSection());
-            }
-            else if (xconfigNameCompare(val.str, "serverlayout") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(layouts, xconfigParseLayoutSection,
-                                 XConfigLayoutPtr);
-            }
-            else if (xconfigNameCompare(val.str, "vendor") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_LIST(vendors, xconfigParseVendorSection,
-                                 XConfigVendorPtr);
-            }
-            else if (xconfigNameCompare(val.str, "dri") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_RETURN(dri, xconfigParseDRISection());
-            }
-            else if (xconfigNameCompare (val.str, "extensions") == 0)
-            {
-                free(val.str);
-                val.str = NULL;
-                READ_HANDLE_RETURN(extensions, xconfigParseExtensionsSection());
-            }
-            else
-            {
-                READ_ERROR(INVALID_SECTION_MSG, xconfigTokenString());
-                free(val.str);
-                val.str = NULL;
-            }
             break;
             
         default:
-            READ_ERROR(INVALID_KEYWORD_MSG, xconfigTokenString());
-            free(val.str);
-            val.str = NULL;
+            xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                                  xconfigTokenString(parser));
+            if (parser->recover) {
+                xconfigSkipToSection(parser);
+                break;
+            }
+            xconfigFreeConfig(&ptr);
+            return XCONFIG_RETURN_PARSE_ERROR;
         }
     }
 
-    if (xconfigValidateConfig(ptr)) {
-        ptr->filename = strdup(xconfigGetConfigFileName());
-        *configPtr = ptr;
-        return XCONFIG_RETURN_SUCCESS;
+    ptr->filename = xconfigIntern(ptr, xconfigGetConfigFileName(parser));
+
+    xconfigResolveReferences(ptr);
+
+    if (parser->recover) {
+        errors = parser->diagnostics.errors;
+
+        ptr->diagnostics = &parser->diagnostics;
+        valid = CheckConfig(ptr);
+        ptr->diagnostics = NULL;
+
+        if (errors) {
+            xconfigFreeConfig(&ptr);
+            return XCONFIG_RETURN_PARSE_ERROR;
+        }
     } else {
+        valid = CheckConfig(ptr);
+    }
+
+    if (!valid) {
         xconfigFreeConfig(&ptr);
         return XCONFIG_RETURN_VALIDATION_ERROR;
     }
+
+    if (parser->trackSource) {
+        xconfigKeepSource(ptr, parser->data, parser->dataLen);
+        xconfigMarkSourceClean(ptr);
+    }
+
+    *configPtr = ptr;
+    return XCONFIG_RETURN_SUCCESS;
+}
+
+
+/*
+ * xconfigSetDeferredSections() - have xconfigReadConfigFile() skip the
+ * sections of the given XCONFIG_DEFER_* kinds rather than parsing them.
+ * Their text is kept, and is either parsed later by
+ * xconfigParseDeferredSections() or written out unchanged by
+ * xconfigWriteConfigFile(); a DRI section is not written, deferred or
+ * not.  Syntax errors within a deferred section are not reported until
+ * it is parsed.
+ */
+
+void xconfigSetDeferredSections(XConfigParserPtr parser, unsigned int kinds)
+{
+    parser->deferKinds = kinds & XCONFIG_DEFER_ALL;
+}
+
+
+/*
+ * xconfigSetParallelParse() - have xconfigReadConfigFile() parse the
+ * sections of configs of at least minSize bytes on the given number of
+ * threads, or on one thread per online processor if threads is
+ * XCONFIG_PARALLEL_AUTO.  This only pays off for configs with many
+ * sections, such as those for large multi-GPU display walls; smaller
+ * configs are read serially.  The config read, and any messages
+ * printed, are the same as when reading serially.  A threads value of
+ * 0 or 1 turns this off again.
+ */
+
+void xconfigSetParallelParse(XConfigParserPtr parser, int threads,
+                             size_t minSize)
+{
+    if (threads == XCONFIG_PARALLEL_AUTO) {
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    parser->threads = (threads > 1) ? threads : 0;
+    parser->parallelMinSize = minSize;
+}
+
+
+/*
+ * xconfigSetErrorRecovery() - turn error recovery mode on or off.  In
+ * this mode, xconfigReadConfigFile() does not stop at the first parse
+ * or validation error, but skips ahead to the next section and carries
+ * on; messages are collected rather than printed, and can be looked at
+ * with xconfigGetDiagnostics() until the next config is read.  Configs
+ * are read on one thread in this mode.
+ */
+
+void xconfigSetErrorRecovery(XConfigParserPtr parser, int recover)
+{
+    parser->recover = recover;
+}
+
+
+/*
+ * xconfigSetOptionRegistry() - have the configs read with parser keep
+ * the given registry of option types, and parse the values of the
+ * options it knows as they are read (see OptionType.c); NULL turns
+ * this off.  Values that are not valid for their type are warned about.
+ */
+
+void xconfigSetOptionRegistry(XConfigParserPtr parser,
+                              XConfigOptionRegistryPtr registry)
+{
+    parser->optionTypes = registry;
+}
+
+
+/*
+ * xconfigGetDiagnostics() - return the messages collected by the last
+ * xconfigReadConfigFile() in error recovery mode, in the order they
+ * were found; the list belongs to the parser.
+ */
+
+XConfigDiagnosticPtr xconfigGetDiagnostics(XConfigParserPtr parser)
+{
+    return parser->diagnostics.list;
+}
+
+
+/*
+ * xconfigParseDeferredSections() - parse the deferred sections of the
+ * given XCONFIG_DEFER_* kinds into config, in the order they appeared
+ * in the config file.  This must be done before the corresponding
+ * fields of config are used.  Returns FALSE if a section could not be
+ * parsed; sections parsed before it are kept.
+ */
+
+int xconfigParseDeferredSections(XConfigPtr config, unsigned int kinds)
+{
+    XConfigDeferredPtr deferred, next, *prev = &config->deferred;
+    XConfigParserPtr parser;
+    void *node;
+    int ret = TRUE, token;
+
+    for (deferred = config->deferred; deferred; deferred = next) {
+        next = deferred->next;
+
+        if (!(deferred->kind & kinds)) {
+            prev = &deferred->next;
+            continue;
+        }
+
+        parser = xconfigAllocParser();
+        xconfigOpenConfigBuffer(parser, deferred->text, deferred->len,
+                                config->filename);
+        parser->config = config;
+        parser->lineNo = deferred->line - 1;
+
+        if (xconfigGetToken(parser, &TopLevelTab) != SECTION ||
+            !ReadSection(parser, config, &node, &token)) {
+            ret = FALSE;
+        }
+
+        xconfigFreeParser(&parser);
+
+        if (!ret) {
+            break;
+        }
+
+        xconfigReplaceSourceNode(config, deferred, node, token);
+
+        *prev = next;
+    }
+
+    return ret;
 }
 
-#undef CLEANUP
+
+/*
+ * xconfigReadConfigFromBuffer() - parse the len bytes of config text at
+ * buf, returning the parsed data as XConfigPtr.  The text need not be
+ * NUL-terminated and has no line length limit; nothing in the returned
+ * config refers back to buf.  name is used in place of a file name in
+ * messages and as the config's filename; it may be NULL.
+ */
+
+XConfigError xconfigReadConfigFromBuffer(const char *buf, size_t len,
+                                         const char *name,
+                                         XConfigPtr *configPtr)
+{
+    XConfigParserPtr parser = xconfigAllocParser();
+    XConfigError error;
+
+    xconfigOpenConfigBuffer(parser, buf, len, name);
+    error = xconfigReadConfigFile(parser, configPtr);
+    xconfigFreeParser(&parser);
+
+    return error;
+}
 
 
 /* 
@@ -269,16 +1005,9 @@ XConfigError xconfigReadConfigFile(XConfigPtr *configPtr)
 
 int xconfigValidateConfig(XConfigPtr p)
 {
-    if (!xconfigValidateDevice(p))
-        return FALSE;
-    if (!xconfigValidateScreen(p))
-        return FALSE;
-    if (!xconfigValidateInput(p))
-        return FALSE;
-    if (!xconfigValidateLayout(p))
-        return FALSE;
-    
-    return(TRUE);
+    xconfigResolveReferences(p);
+
+    return CheckConfig(p);
 }
 
 
@@ -292,6 +1021,8 @@ int xconfigSanitizeConfig(XConfigPtr p,
                           const char *screenName,
                           GenerateOptions *gop)
 {
+    xconfigInvalidateIndexes(p);
+
     if (!xconfigSanitizeScreen(p))
         return FALSE;
     
@@ -330,6 +1061,107 @@ void xconfigAddListItem (GenericListPtr *pHead, GenericListPtr new)
  * whose first field is a GenericListRec can be cast to this type and used
  * with this function.
  */
+/*
+ * xconfigInitListTail() - find the end of the list at pHead, for
+ * xconfigAppendListItem().
+ */
+void xconfigInitListTail (GenericListTailPtr tail, GenericListPtr *pHead)
+{
+    tail->next = pHead;
+
+    while (*tail->next) {
+        tail->next = (GenericListPtr *) &(*tail->next)->next;
+    }
+}
+
+
+/*
+ * xconfigAppendListItem() - add item, and any items linked after it,
+ * to the end of the list whose end is tail.
+ */
+void xconfigAppendListItem (GenericListTailPtr tail, GenericListPtr item)
+{
+    *tail->next = item;
+
+    while (*tail->next) {
+        tail->next = (GenericListPtr *) &(*tail->next)->next;
+    }
+}
+
+
+/*
+ * xconfigParserAddListItem() - xconfigAddListItem() for lists being
+ * built while a config is read.  The parser remembers the end of each
+ * of the config's own lists, and of the few other lists it added to
+ * most recently, so that reading a list of n items, such as a config's
+ * Device sections or a Monitor's ModeLines, takes O(n) rather than
+ * O(n^2) time.  While a config is read, its lists must only be added
+ * to this way.
+ */
+void xconfigParserAddListItem (XConfigParserPtr parser, GenericListPtr *pHead,
+                               GenericListPtr item)
+{
+    XConfigListEndPtr end = NULL;
+    char *p = (char *) pHead, *config = (char *) parser->config;
+    int i;
+
+    if (p >= config && p < config + sizeof(XConfigRec)) {
+        end = &parser->configEnds[(p - config) / sizeof(GenericListPtr)];
+    } else {
+        for (i = 0; i < XCONFIG_LIST_ENDS; i++) {
+            if (parser->listEnds[i].head == pHead) {
+                end = &parser->listEnds[i];
+                break;
+            }
+        }
+    }
+
+    if (!end || end->head != pHead) {
+        if (!end) {
+            end = &parser->listEnds[parser->nextListEnd];
+            parser->nextListEnd = (parser->nextListEnd + 1) %
+                XCONFIG_LIST_ENDS;
+        }
+        end->head = pHead;
+        xconfigInitListTail(&end->tail, pHead);
+    }
+
+    xconfigAppendListItem(&end->tail, item);
+}
+
+
+/*
+ * xconfigParserAllocRecord() - allocate a record of the config being
+ * read.  The first record allocated for a section is the section's
+ * own, and is remembered so that a section that fails to parse can
+ * still be named.
+ */
+
+void *xconfigParserAllocRecord(XConfigParserPtr parser, size_t size)
+{
+    void *record = xconfigArenaAlloc(parser->config, size);
+
+    if (!parser->sectionRecord) {
+        parser->sectionRecord = record;
+    }
+
+    return record;
+}
+
+
+/*
+ * xconfigForgetListEnds() - have the parser forget the ends of lists
+ * it remembered for xconfigParserAddListItem(), when the lists may
+ * have been changed some other way.
+ */
+void xconfigForgetListEnds (XConfigParserPtr parser)
+{
+    memset(parser->configEnds, 0, sizeof(parser->configEnds));
+    memset(parser->listEnds, 0, sizeof(parser->listEnds));
+    parser->nextListEnd = 0;
+}
+
+
 void xconfigRemoveListItem (GenericListPtr *pHead, GenericListPtr item)
 {
     GenericListPtr cur = *pHead;
@@ -374,26 +1206,21 @@ xconfigItemNotSublist(GenericListPtr list_1, GenericListPtr list_2)
     return (!(last_1 == last_2));
 }
 
+/*
+ * xconfigFreeConfig() - release the config and everything in it, all of
+ * which lives in the config's arena.
+ */
+
 void
 xconfigFreeConfig (XConfigPtr *p)
 {
+    XConfigArenaPtr arena;
+
     if (p == NULL || *p == NULL)
         return;
 
-    xconfigFreeFiles (&((*p)->files));
-    xconfigFreeModules (&((*p)->modules));
-    xconfigFreeFlags (&((*p)->flags));
-    xconfigFreeMonitorList (&((*p)->monitors));
-    xconfigFreeModesList (&((*p)->modes));
-    xconfigFreeVideoAdaptorList (&((*p)->videoadaptors));
-    xconfigFreeDeviceList (&((*p)->devices));
-    xconfigFreeScreenList (&((*p)->screens));
-    xconfigFreeLayoutList (&((*p)->layouts));
-    xconfigFreeInputList (&((*p)->inputs));
-    xconfigFreeVendorList (&((*p)->vendors));
-    xconfigFreeDRI (&((*p)->dri));
-    TEST_FREE((*p)->comment);
-
-    free (*p);
+    arena = (*p)->arena;
+    xconfigFreeArena(&arena);
+
     *p = NULL;
 }
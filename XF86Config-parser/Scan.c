@@ -59,6 +59,17 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdarg.h>
+#include <float.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#endif
 
 #if !defined(X_NOT_POSIX)
 #if defined(_POSIX_SOURCE)
@@ -86,21 +97,6 @@
 
 #define CONFIG_BUF_LEN     1024
 
-static int StringToToken (char *, XConfigSymTabRec *);
-
-static FILE *configFile = NULL;
-static const char **builtinConfig = NULL;
-static int builtinIndex = 0;
-static int configPos = 0;            /* current readers position */
-static char *configBuf, *configRBuf; /* buffer for lines */
-static int pushToken = LOCK_TOKEN;
-static int eol_seen = 0;             /* private state to handle comments */
-LexRec val;
-
-int configLineNo = 0;         /* linenumber */
-char *configSection = NULL;   /* name of current section being parsed */
-char *configPath;             /* path to config file */
-
 
 
 
@@ -129,268 +125,440 @@ static char xconfigToLower(char c)
 }
 
 
-/* 
- * xconfigStrToUL --
- *
- *  A portable, but restricted, version of strtoul().  It only understands
- *  hex, octal, and decimal.  But it's good enough for our needs.
+static int xconfigDigitValue(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+        return c - '0';
+    if ((c >= 'a') && (c <= 'f'))
+        return 10 + (c - 'a');
+    if ((c >= 'A') && (c <= 'F'))
+        return 10 + (c - 'A');
+    return 16;
+}
+
+
+/* the powers of ten that are exactly representable as doubles */
+
+static const double xconfigPowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define MAX_EXACT_POWER_OF_10 22
+
+/* more significant digits than this are dropped from the real value */
+#define MAX_DECIMAL_DIGITS 19
+#define MAX_HEX_DIGITS 16
+
+
+/*
+ * xconfigDecimalValue() - return mant * 10^exp.  This is exact when
+ * both mant and the power of ten are exactly representable, which
+ * covers the numbers found in config files; otherwise it is done in
+ * long double, and may be off in the last bit.
  */
 
-static unsigned int xconfigStrToUL (char *str)
+static double xconfigDecimalValue(unsigned long long mant, int exp)
 {
-    int base = 10;
-    char *p = str;
-    unsigned int tot = 0;
+    long double r;
+    int e;
 
-    if (*p == '0')
-    {
-        p++;
-        if ((*p == 'x') || (*p == 'X'))
-        {
-            p++;
-            base = 16;
-        }
-        else
-            base = 8;
-    }
-    while (*p)
-    {
-        if ((*p >= '0') && (*p <= ((base == 8) ? '7' : '9')))
-        {
-            tot = tot * base + (*p - '0');
-        }
-        else if ((base == 16) && (*p >= 'a') && (*p <= 'f'))
-        {
-            tot = tot * base + 10 + (*p - 'a');
-        }
-        else if ((base == 16) && (*p >= 'A') && (*p <= 'F'))
-        {
-            tot = tot * base + 10 + (*p - 'A');
-        }
+    if (mant == 0 || exp == 0)
+        return (double) mant;
+
+    if ((mant < (1ULL << 53)) &&
+        (exp >= -MAX_EXACT_POWER_OF_10) && (exp <= MAX_EXACT_POWER_OF_10)) {
+        if (exp > 0)
+            return (double) mant * xconfigPowersOf10[exp];
         else
-        {
-            return (tot);
-        }
-        p++;
+            return (double) mant / xconfigPowersOf10[-exp];
     }
-    return (tot);
+
+    r = mant;
+    for (e = exp; e > 0 && r <= DBL_MAX; e -= MAX_EXACT_POWER_OF_10)
+        r *= xconfigPowersOf10[(e < MAX_EXACT_POWER_OF_10) ?
+                               e : MAX_EXACT_POWER_OF_10];
+    for (e = -exp; e > 0 && r != 0; e -= MAX_EXACT_POWER_OF_10)
+        r /= xconfigPowersOf10[(e < MAX_EXACT_POWER_OF_10) ?
+                               e : MAX_EXACT_POWER_OF_10];
+
+    return (double) r;
 }
 
 
 /*
- * xconfigGetNextLine --
+ * xconfigScanNumber --
+ *
+ *  scan the rest of the number token starting at parser->tok, whose
+ *  first digit has already been consumed, and set val.num and
+ *  val.realnum from it in the same pass.  This works on the parser's
+ *  data directly, and unlike strtoul(3) and atof(3) does not depend
+ *  on the locale.
  *
- *  read from the configFile FILE stream until we encounter a new
- *  line; this is effectively just a big wrapper for fgets(3).
+ *  val.num is read as hex after "0x", as octal after a leading "0" and
+ *  as decimal otherwise, up to the first character that is not a digit
+ *  in that base.  val.realnum is read as hex after "0x" and as decimal
+ *  otherwise, including any fraction after a '.'.
  *
- *  xconfigGetToken() assumes that we will read up to the next
- *  newline; we need to grow configBuf and configRBuf as needed to
- *  support that.
+ *  Returns FALSE if the whole token is an integer too large for an
+ *  unsigned int, in which case val.num is the largest one.
  */
 
-static char *xconfigGetNextLine(void)
+static int xconfigScanNumber(XConfigParserPtr parser)
 {
-    static int configBufLen = CONFIG_BUF_LEN;
-    char *tmpConfigBuf, *tmpConfigRBuf;
-    int c, i, pos = 0, eolFound = 0;
-    char *ret = NULL;
-    
-    /*
-     * reallocate the string if it was grown last time (i.e., is no
-     * longer CONFIG_BUF_LEN); we malloc the new strings first, so
-     * that if either of the mallocs fail, we can fall back on the
-     * existing buffer allocations
-     */
-    
-    if (configBufLen != CONFIG_BUF_LEN) {
-                 
-        tmpConfigBuf = malloc(CONFIG_BUF_LEN);
-        tmpConfigRBuf = malloc(CONFIG_BUF_LEN);
-        
-        if (!tmpConfigBuf || !tmpConfigRBuf) {
-            
-            /*
-             * at least one of the mallocs failed; keep the old buffers
-             * and free any partial allocations
-             */
-            
-            free(tmpConfigBuf);
-            free(tmpConfigRBuf);
-            
+    const char *p = parser->tok;
+    unsigned long long num = 0, mant = 0;
+    unsigned int base = 10, realBase, d;
+    int numDone = FALSE, overflow = FALSE;
+    int realDone = FALSE, fraction = FALSE, digits = 0, exp = 0;
+    char c;
+
+    if (p[0] == '0') {
+        if ((parser->pos < parser->dataLen) &&
+            ((p[1] == 'x') || (p[1] == 'X'))) {
+            base = 16;
+            parser->pos++;
+            p += 2;
         } else {
-            
-            /*
-             * malloc succeeded; free the old buffers and use the new
-             * buffers
-             */
-            
-            configBufLen = CONFIG_BUF_LEN;
-            
-            free(configBuf);
-            free(configRBuf);
-            
-            configBuf = tmpConfigBuf;
-            configRBuf = tmpConfigRBuf;
+            base = 8;
         }
     }
+    realBase = (base == 16) ? 16 : 10;
 
-    /* read in another block of chars */
-    
-    do {
-        ret = fgets(configBuf + pos, configBufLen - pos - 1, configFile);
-        
-        if (!ret) break;
-        
-        /* search for EOL in the new block of chars */
-        
-        for (i = pos; i < (configBufLen - 1); i++) {
-            c = configBuf[i];
-            
-            if (c == '\0') break;
-            
-            if ((c == '\n') || (c == '\r')) {
-                eolFound = 1;
+    for (;;) {
+
+        /* p is the next character of the token; extend the token to it */
+
+        if (p == parser->data + parser->pos) {
+            if (parser->pos >= parser->dataLen)
+                break;
+            c = parser->data[parser->pos];
+            if (!(xconfigIsDigit(c) ||
+                  (c == '.') || (c == 'x') || (c == 'X') ||
+                  ((base == 16) && (xconfigDigitValue(c) < 16))))
                 break;
+            parser->pos++;
+        }
+
+        c = *p++;
+        d = xconfigDigitValue(c);
+
+        if (!numDone) {
+            if (d >= base) {
+                numDone = TRUE;
+            } else if (!overflow) {
+                num = num * base + d;
+                if (num > UINT_MAX) {
+                    num = UINT_MAX;
+                    overflow = TRUE;
+                }
             }
         }
-        
-        /*
-         * if we didn't find EOL, then grow the string and
-         * read in more
-         */
-        
-        if (!eolFound) {
-            
-            tmpConfigBuf = realloc(configBuf, configBufLen + CONFIG_BUF_LEN);
-            tmpConfigRBuf = realloc(configRBuf, configBufLen + CONFIG_BUF_LEN);
-            
-            if (!tmpConfigBuf || !tmpConfigRBuf) {
-                
-                /*
-                 * at least one of the reallocations failed; use the
-                 * new allocation that succeeded, but we have to
-                 * fallback to the previous configBufLen size and use
-                 * the string we have, even though we don't have an
-                 * EOL
-                 */
-                
-                if (tmpConfigBuf) configBuf = tmpConfigBuf;
-                if (tmpConfigRBuf) configRBuf = tmpConfigRBuf;
-                
-                break;
-                
-            } else {
-                
-                /* reallocation succeeded */
 
-                configBuf = tmpConfigBuf;
-                configRBuf = tmpConfigRBuf;
-                pos = i;
-                configBufLen += CONFIG_BUF_LEN;
+        if (!realDone) {
+            if (d < realBase) {
+                if (mant == 0 && d == 0) {
+                    /* leading zeros are not significant */
+                } else if (digits < ((base == 16) ? MAX_HEX_DIGITS :
+                                                    MAX_DECIMAL_DIGITS)) {
+                    mant = mant * realBase + d;
+                    digits++;
+                } else {
+                    exp++;
+                }
+                if (fraction)
+                    exp--;
+            } else if (c == '.' && !fraction) {
+                fraction = TRUE;
+            } else {
+                realDone = TRUE;
             }
         }
-        
-    } while (!eolFound);
-    
-    return ret;
+    }
+
+    parser->tokLen = parser->data + parser->pos - parser->tok;
+    parser->val.num = (unsigned int) num;
+
+    if (base == 16)
+        parser->val.realnum = ldexp((double) mant, 4 * exp);
+    else
+        parser->val.realnum = xconfigDecimalValue(mant, exp);
+
+    return !(overflow && !numDone);
+}
+
+
+/*
+ * the parser's data is either supplied by the caller, a private
+ * malloc(3)ed copy of the config file, or the config file mmap(2)ed
+ * read-only; this records how xconfigCloseConfigFile() must release it
+ */
+
+#define DATA_CALLER 0
+#define DATA_MALLOC 1
+#define DATA_MMAP   2
+
+
+/*
+ * xconfigGetChar --
+ *
+ *  consume and return the next character of the parser's data; the
+ *  caller must check that we are not at the end of the data.  Line
+ *  numbers are advanced when the first character of a line is
+ *  consumed, so that a newline at the end of the file does not count
+ *  as another line.
+ */
+
+static inline char xconfigGetChar(XConfigParserPtr parser)
+{
+    char c = parser->data[parser->pos++];
+
+    if (parser->bol) {
+        parser->bol = 0;
+        parser->lineNo++;
+        parser->eol_seen = 1;
+    }
+    if (c == '\n')
+        parser->bol = 1;
+
+    return c;
+}
+
+static inline char xconfigPeekChar(XConfigParserPtr parser)
+{
+    if (parser->pos >= parser->dataLen)
+        return '\0';
+    return parser->data[parser->pos];
+}
+
+
+/*
+ * the delimiter sets for xconfigScanTo(); each stops at a newline, so
+ * the run skipped never spans lines
+ */
+
+#define DELIM_COMMENT 0     /* '\n' '\r' */
+#define DELIM_STRING  1     /* '"' '\n' '\r' '\0' */
+#define DELIM_WORD    2     /* ' ' '\t' '\n' '\r' '\0' '#' */
+
+static inline int xconfigIsDelim(char c, int set)
+{
+    switch (c) {
+        case '\n':
+        case '\r':
+            return 1;
+        case '\"':
+            return set == DELIM_STRING;
+        case '\0':
+            return set != DELIM_COMMENT;
+        case ' ':
+        case '\t':
+        case '#':
+            return set == DELIM_WORD;
+    }
+    return 0;
+}
+
+
+/*
+ * xconfigScanTo --
+ *
+ *  return the position of the first delimiter in the given set at or
+ *  after pos, or dataLen if there is none.  Where SSE2 is available the
+ *  data is searched 16 bytes at a time; the tail, and everything on
+ *  other targets, is searched a byte at a time.  The data is never read
+ *  past dataLen.
+ */
+
+static inline size_t xconfigScanTo(XConfigParserPtr parser, size_t pos,
+                                   int set)
+{
+    const char *data = parser->data;
+    size_t len = parser->dataLen;
+
+#if defined(__SSE2__) && defined(__GNUC__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i nul = _mm_setzero_si128();
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i hash = _mm_set1_epi8('#');
+    __m128i v, m;
+    int mask;
+
+    while (pos + 16 <= len) {
+        v = _mm_loadu_si128((const __m128i *) (data + pos));
+        m = _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr));
+        if (set == DELIM_STRING) {
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, quote));
+        }
+        if (set != DELIM_COMMENT) {
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, nul));
+        }
+        if (set == DELIM_WORD) {
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, space));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, tab));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, hash));
+        }
+        mask = _mm_movemask_epi8(m);
+        if (mask) {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 16;
+    }
+#endif /* __SSE2__ && __GNUC__ */
+
+    while (pos < len && !xconfigIsDelim(data[pos], set)) {
+        pos++;
+    }
+
+    return pos;
 }
 
 
+/*
+ * NameCompareLen --
+ *
+ *  xconfigNameCompare() for a (pointer, length) token slice; only
+ *  tests for equality.
+ */
+
+static int NameCompareLen(const char *s1, size_t len1, const char *s2)
+{
+    const char *end = s1 + len1;
+    char c1, c2;
+
+    for (;;) {
+        while (s1 < end && (*s1 == '_' || *s1 == ' ' || *s1 == '\t'))
+            s1++;
+        while (*s2 == '_' || *s2 == ' ' || *s2 == '\t')
+            s2++;
+        c1 = (s1 < end) ? xconfigToLower(*s1) : '\0';
+        c2 = xconfigToLower(*s2);
+        if (c1 != c2)
+            return 1;
+        if (c1 == '\0')
+            return 0;
+        s1++;
+        s2++;
+    }
+}
+
+
+
+/*
+ * LookupKeyword --
+ *
+ *  return the token for the keyword given by the (pointer, length)
+ *  slice str in the keyword table tab, or ERROR_TOKEN.  The slice is
+ *  hashed in a single pass over its canonical form; only the one
+ *  candidate keyword in the slot it selects is compared.
+ */
+
+static int LookupKeyword(const XConfigKeywordTableRec *tab,
+                         const char *str, size_t len)
+{
+    const XConfigSymTabRec *sym;
+    unsigned int h = XCONFIG_KEYWORD_HASH_INIT;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if (str[i] == '_' || str[i] == ' ' || str[i] == '\t')
+            continue;
+        h = XCONFIG_KEYWORD_HASH_STEP(h, xconfigToLower(str[i]));
+    }
+
+    sym = &tab->slots[XCONFIG_KEYWORD_SLOT(h, tab->seed, tab->mask)];
+
+    if ((sym->token != -1) && (NameCompareLen(str, len, sym->name) == 0))
+        return sym->token;
+
+    return ERROR_TOKEN;
+}
+
 
 /* 
  * xconfigGetToken --
- *      Read next Token from the config file. Handle the global variable
+ *      Read next Token from the config file. Handle the parser's
  *      pushToken.
+ *
+ *      The config data is scanned in place: on return, parser->tok and
+ *      parser->tokLen describe the token within the data.  Only
+ *      STRING tokens are copied, into the string pool of the config
+ *      being read, so val.str lives as long as that config does;
+ *      xconfigTokenString() provides a NUL-terminated copy of any
+ *      other token on demand.
  */
 
-int xconfigGetToken (XConfigSymTabRec * tab)
+int xconfigGetToken (XConfigParserPtr parser,
+                     const XConfigKeywordTableRec *tab)
 {
-    int c, i;
+    char c;
+    size_t start;
 
     /* 
      * First check whether pushToken has a different value than LOCK_TOKEN.
-     * In this case rBuf[] contains a valid STRING/TOKEN/NUMBER. But in the
-     * oth * case the next token must be read from the input.
+     * In this case tok still describes a valid STRING/TOKEN/NUMBER. But
+     * in the other case the next token must be read from the input.
      */
-    if (pushToken == EOF_TOKEN)
+    if (parser->pushToken == EOF_TOKEN)
         return (EOF_TOKEN);
-    else if (pushToken == LOCK_TOKEN)
+    else if (parser->pushToken == LOCK_TOKEN)
     {
         /*
          * eol_seen is only set for the first token after a newline.
          */
-        eol_seen = 0;
-
-        c = configBuf[configPos];
+        parser->eol_seen = 0;
 
         /* 
-         * Get start of next Token. EOF is handled,
-         * whitespaces are skipped. 
+         * Get start of next Token. EOF is handled, whitespaces are
+         * skipped; start tracks the whitespace preceding the token on
+         * its line, which is kept as part of comments.
          */
-
-again:
-        if (!c)
-        {
-            char *ret;
-            if (configFile)
-                ret = xconfigGetNextLine();
-            else {
-                if (builtinConfig[builtinIndex] == NULL)
-                    ret = NULL;
-                else {
-                    ret = strncpy(configBuf, builtinConfig[builtinIndex],
-                            CONFIG_BUF_LEN);
-                    builtinIndex++;
-                }
-            }
-            if (ret == NULL)
-            {
-                return (pushToken = EOF_TOKEN);
-            }
-            configLineNo++;
-            configPos = 0;
-            eol_seen = 1;
-        }
-
-        i = 0;
+        start = parser->pos;
         for (;;) {
-            c = configBuf[configPos++];
-            configRBuf[i++] = c;
+            if (parser->pos >= parser->dataLen)
+                return (parser->pushToken = EOF_TOKEN);
+            c = xconfigGetChar(parser);
             switch (c) {
                 case ' ':
                 case '\t':
                 case '\r':
+                case '\0':
                     continue;
                 case '\n':
-                    i = 0;
+                    start = parser->pos;
                     continue;
             }
             break;
         }
-        if (c == '\0')
-            goto again;
 
         if (c == '#')
         {
-            do
-            {
-                configRBuf[i++] = (c = configBuf[configPos++]);
-            }
-            while ((c != '\n') && (c != '\r') && (c != '\0'));
-            configRBuf[i] = '\0';
-            /* XXX no private copy.
-             * Use xconfigAddComment when setting a comment.
+            /* the comment holds no newline, so only its end can move
+             * the line count */
+            parser->pos = xconfigScanTo(parser, parser->pos, DELIM_COMMENT);
+            if (parser->pos < parser->dataLen)
+                xconfigGetChar(parser);
+            parser->tok = parser->data + start;
+            parser->tokLen = parser->pos - start;
+            /*
+             * Use xconfigParserAddComment when setting a comment.
              */
-            val.str = configRBuf;
+            parser->val.str = NULL;
             return (COMMENT);
         }
 
+        parser->tok = parser->data + parser->pos - 1;
+        parser->tokLen = 1;
+
         /* GJA -- handle '-' and ','  * Be careful: "-hsync" is a keyword. */
-        else if ((c == ',') && !xconfigIsAlpha(configBuf[configPos]))
+        if ((c == ',') && !xconfigIsAlpha(xconfigPeekChar(parser)))
         {
             return COMMA;
         }
-        else if ((c == '-') && !xconfigIsAlpha(configBuf[configPos]))
+        else if ((c == '-') && !xconfigIsAlpha(xconfigPeekChar(parser)))
         {
             return DASH;
         }
@@ -400,29 +568,12 @@ again:
          */
         if (xconfigIsDigit(c))
         {
-            int base;
-
-            if (c == '0')
-                if ((configBuf[configPos] == 'x') ||
-                    (configBuf[configPos] == 'X'))
-                    base = 16;
-                else
-                    base = 8;
-            else
-                base = 10;
-
-            configRBuf[0] = c;
-            i = 1;
-            while (xconfigIsDigit(c = configBuf[configPos++]) ||
-                   (c == '.') || (c == 'x') || (c == 'X') ||
-                   ((base == 16) && (((c >= 'a') && (c <= 'f')) ||
-                                     ((c >= 'A') && (c <= 'F')))))
-                configRBuf[i++] = c;
-            configPos--;        /* GJA -- one too far */
-            configRBuf[i] = '\0';
-            val.num = xconfigStrToUL (configRBuf);
-            val.realnum = atof (configRBuf);
-            val.str = configRBuf;
+            if (!xconfigScanNumber(parser) && !parser->skipping)
+                xconfigParserErrorMsg(parser, ParseWarningMsg,
+                                      NUMBER_RANGE_MSG,
+                                      xconfigTokenString(parser),
+                                      (unsigned int) parser->val.num);
+            parser->val.str = NULL;
             return (NUMBER);
         }
 
@@ -431,15 +582,22 @@ again:
          */
         else if (c == '\"')
         {
-            i = -1;
-            do
-            {
-                configRBuf[++i] = (c = configBuf[configPos++]);
+            size_t end = parser->dataLen;
+
+            start = parser->pos;
+            parser->pos = xconfigScanTo(parser, parser->pos, DELIM_STRING);
+            if (parser->pos < parser->dataLen) {
+                end = parser->pos;
+                xconfigGetChar(parser);
             }
-            while ((c != '\"') && (c != '\n') && (c != '\r') && (c != '\0'));
-            configRBuf[i] = '\0';
-            val.str = malloc (strlen (configRBuf) + 1);
-            strcpy (val.str, configRBuf);    /* private copy ! */
+            parser->tok = parser->data + start;
+            parser->tokLen = end - start;
+            if (parser->skipping)
+                parser->val.str = NULL;
+            else
+                parser->val.str = xconfigInternLen (parser->config,
+                                                    parser->tok,
+                                                    parser->tokLen);
             return (STRING);
         }
 
@@ -449,22 +607,8 @@ again:
          */
         else
         {
-            configRBuf[0] = c;
-            i = 0;
-            do
-            {
-                configRBuf[++i] = (c = configBuf[configPos++]);;
-            }
-            while ((c != ' ')  &&
-                   (c != '\t') &&
-                   (c != '\n') &&
-                   (c != '\r') &&
-                   (c != '\0') &&
-                   (c != '#'));
-            
-            --configPos;
-            configRBuf[i] = '\0';
-            i = 0;
+            parser->pos = xconfigScanTo(parser, parser->pos, DELIM_WORD);
+            parser->tokLen = parser->data + parser->pos - parser->tok;
         }
 
     }
@@ -475,8 +619,8 @@ again:
          * Here we deal with pushed tokens. Reinitialize pushToken again. If
          * the pushed token was NUMBER || STRING return them again ...
          */
-        int temp = pushToken;
-        pushToken = LOCK_TOKEN;
+        int temp = parser->pushToken;
+        parser->pushToken = LOCK_TOKEN;
 
         if (temp == COMMA || temp == DASH)
             return (temp);
@@ -488,27 +632,20 @@ again:
      * Joop, at last we have to lookup the token ...
      */
     if (tab)
-    {
-        i = 0;
-        while (tab[i].token != -1)
-            if (xconfigNameCompare (configRBuf, tab[i].name) == 0)
-                return (tab[i].token);
-            else
-                i++;
-    }
+        return LookupKeyword (tab, parser->tok, parser->tokLen);
 
     return (ERROR_TOKEN);        /* Error catcher */
 }
 
-int xconfigGetSubToken (char **comment)
+int xconfigGetSubToken (XConfigParserPtr parser, char **comment)
 {
     int token;
 
     for (;;) {
-        token = xconfigGetToken(NULL);
+        token = xconfigGetToken(parser, NULL);
         if (token == COMMENT) {
             if (comment)
-                *comment = xconfigAddComment(*comment, val.str);
+                *comment = xconfigParserAddComment(parser, *comment);
         }
         else
             return (token);
@@ -516,15 +653,16 @@ int xconfigGetSubToken (char **comment)
     /*NOTREACHED*/
 }
 
-int xconfigGetSubTokenWithTab (char **comment, XConfigSymTabRec *tab)
+int xconfigGetSubTokenWithTab (XConfigParserPtr parser, char **comment,
+                               const XConfigKeywordTableRec *tab)
 {
     int token;
 
     for (;;) {
-        token = xconfigGetToken(tab);
+        token = xconfigGetToken(parser, tab);
         if (token == COMMENT) {
             if (comment)
-                *comment = xconfigAddComment(*comment, val.str);
+                *comment = xconfigParserAddComment(parser, *comment);
         }
         else
             return (token);
@@ -532,14 +670,107 @@ int xconfigGetSubTokenWithTab (char **comment, XConfigSymTabRec *tab)
     /*NOTREACHED*/
 }
 
-void xconfigUnGetToken (int token)
+void xconfigUnGetToken (XConfigParserPtr parser, int token)
 {
-    pushToken = token;
+    parser->pushToken = token;
 }
 
-char *xconfigTokenString (void)
+/*
+ * xconfigSkipSection() - skip over the rest of the current section, up
+ * to and including its EndSection keyword, without building anything
+ * from it; returns FALSE if the data ends first.
+ */
+
+int xconfigSkipSection (XConfigParserPtr parser)
 {
-    return configRBuf;
+    int token, ret = FALSE;
+
+    parser->skipping = TRUE;
+
+    while ((token = xconfigGetToken(parser, NULL)) != EOF_TOKEN) {
+        if ((token == ERROR_TOKEN) &&
+            (NameCompareLen(parser->tok, parser->tokLen, "endsection") == 0)) {
+            ret = TRUE;
+            break;
+        }
+    }
+
+    parser->skipping = FALSE;
+
+    return ret;
+}
+
+/*
+ * xconfigSkipToSection() - after a parse error, skip ahead to where
+ * parsing can resume: just past the next EndSection keyword, or just
+ * before the next Section keyword, whichever comes first.  The token
+ * the error was found at counts; so a stray EndSection ends the
+ * section it was found in, and a Section keyword found within another
+ * section is read again as the start of a new one.
+ */
+
+void xconfigSkipToSection (XConfigParserPtr parser)
+{
+    int token = ERROR_TOKEN;
+
+    if (parser->pushToken == EOF_TOKEN)
+        return;
+
+    parser->pushToken = LOCK_TOKEN;
+
+    /*
+     * The token the error was found at may have been a string; the
+     * opening quote is not part of the token, but is just before it.
+     */
+
+    if (parser->tok && (parser->tok > parser->data) &&
+        (parser->tok[-1] == '"'))
+        token = STRING;
+
+    parser->skipping = TRUE;
+
+    for (;;) {
+        if ((token == ERROR_TOKEN) && parser->tok) {
+            if (NameCompareLen(parser->tok, parser->tokLen,
+                               "endsection") == 0)
+                break;
+            if (NameCompareLen(parser->tok, parser->tokLen,
+                               "section") == 0) {
+                /* have xconfigGetToken() look this token up again */
+                xconfigUnGetToken(parser, ERROR_TOKEN);
+                break;
+            }
+        }
+        if ((token = xconfigGetToken(parser, NULL)) == EOF_TOKEN)
+            break;
+    }
+
+    parser->skipping = FALSE;
+}
+
+/*
+ * xconfigTokenString() - return a NUL-terminated copy of the current
+ * token; the copy is owned by the parser and is only valid until the
+ * next call.  This is only needed for messages, so the copy is made on
+ * demand rather than for every token.
+ */
+
+char *xconfigTokenString (XConfigParserPtr parser)
+{
+    size_t len = parser->tok ? parser->tokLen : 0;
+
+    if (len + 1 > parser->rbufLen) {
+        char *tmp = realloc(parser->rbuf, len + 1);
+        if (!tmp)
+            return "";
+        parser->rbuf = tmp;
+        parser->rbufLen = len + 1;
+    }
+    if (len)
+        memcpy(parser->rbuf, parser->tok, len);
+    parser->rbuf[len] = '\0';
+
+    return parser->rbuf;
 }
 
 static int pathIsAbsolute(const char *path)
@@ -640,9 +871,9 @@ static char *DoSubstitution(const char *template,
 {
     char *result;
     int i, l;
-    static const char *env = NULL;
-    static char *hostname = NULL;
-    static char majorvers[3] = "";
+    const char *env = NULL;
+    char hostname[MAXHOSTNAMELEN + 1] = "";
+    char majorvers[16] = "";
 
     if (!template)
         return NULL;
@@ -688,17 +919,14 @@ static char *DoSubstitution(const char *template,
                 APPEND_STR(XConfigFile);
                 break;
             case 'H':
-                if (!hostname) {
-                    if ((hostname = malloc(MAXHOSTNAMELEN + 1))) {
-                        if (gethostname(hostname, MAXHOSTNAMELEN) == 0) {
-                            hostname[MAXHOSTNAMELEN] = '\0';
-                        } else {
-                            free(hostname);
-                            hostname = NULL;
-                        }
+                if (!hostname[0]) {
+                    if (gethostname(hostname, MAXHOSTNAMELEN) == 0) {
+                        hostname[MAXHOSTNAMELEN] = '\0';
+                    } else {
+                        hostname[0] = '\0';
                     }
                 }
-                if (hostname)
+                if (hostname[0])
                     APPEND_STR(hostname);
                 break;
             case 'E':
@@ -756,6 +984,7 @@ static char *DoSubstitution(const char *template,
             }
         }
     }
+    result[l] = '\0';
     return result;
 }
 
@@ -826,17 +1055,186 @@ static const char __user_configpath[] =
 
 
 
-const char *xconfigOpenConfigFile(const char *cmdline, const char *projroot)
+/*
+ * LoadConfigData() - make the contents of the given config file
+ * available to the scanner: regular files are mmap(2)ed; anything
+ * else (or a failed mmap) is read into a malloc(3)ed buffer.  Returns
+ * FALSE on failure.
+ */
+
+static int LoadConfigData(XConfigParserPtr parser, FILE *file)
+{
+    struct stat st;
+    char *data = NULL, *tmp;
+    size_t len = 0, size = 0, n;
+    void *map;
+
+    if ((fstat(fileno(file), &st) == 0) && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            parser->data = NULL;
+            parser->dataLen = 0;
+            parser->dataOwner = DATA_CALLER;
+            return TRUE;
+        }
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+                   fileno(file), 0);
+        if (map != MAP_FAILED) {
+            parser->data = map;
+            parser->dataLen = st.st_size;
+            parser->dataOwner = DATA_MMAP;
+            return TRUE;
+        }
+    }
+
+    do {
+        if (len == size) {
+            size = size ? size * 2 : CONFIG_BUF_LEN;
+            tmp = realloc(data, size);
+            if (!tmp) {
+                free(data);
+                return FALSE;
+            }
+            data = tmp;
+        }
+        n = fread(data + len, 1, size - len, file);
+        len += n;
+    } while (n > 0);
+
+    if (ferror(file)) {
+        free(data);
+        return FALSE;
+    }
+
+    parser->data = data;
+    parser->dataLen = len;
+    parser->dataOwner = DATA_MALLOC;
+
+    return TRUE;
+}
+
+
+/*
+ * ResetScanner() - prepare the parser to scan its data from the start.
+ */
+
+static void ResetScanner(XConfigParserPtr parser)
 {
-    const char *searchpath;
-    char *pathcopy;
+    parser->pos = 0;          /* current readers position */
+    parser->lineNo = 0;       /* linenumber */
+    parser->bol = 1;
+    parser->eol_seen = 0;
+    parser->tok = NULL;
+    parser->tokLen = 0;
+    parser->pushToken = LOCK_TOKEN;
+}
+
+
+/*
+ * The search for a config file.  For a given command line file name,
+ * project root and $XF86CONFIG, the search path always expands to the
+ * same list of candidate files, so the list is built once per process
+ * and kept, along with which candidate was found.  The list does not
+ * repeat candidates, and only holds those that are acceptable: when a
+ * command line file name is given, only the paths made from it.
+ *
+ * The searches are shared by the whole process, and configSearchLock
+ * guards the list and each search's found index; the candidates of a
+ * search never change once it is on the list, and are read without the
+ * lock.  Which candidate is found is only remembered, not watched: a
+ * program that runs for long enough to see config files come and go
+ * calls xconfigForgetConfigSearches() to have them looked for again.
+ */
+
+typedef struct __ConfigSearchRec {
+    struct __ConfigSearchRec *next;
+    char *cmdline;              /* the search's key; each may be NULL */
+    char *projroot;
+    char *env;
+    char **paths;               /* the candidates, in search order */
+    int npaths;
+    int found;                  /* index of the file found, or -1 */
+} ConfigSearchRec, *ConfigSearchPtr;
+
+static ConfigSearchPtr configSearches;
+static pthread_mutex_t configSearchLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static int SameString(const char *s1, const char *s2)
+{
+    if (!s1 || !s2)
+        return s1 == s2;
+    return strcmp(s1, s2) == 0;
+}
+
+
+/*
+ * AddCandidates() - expand each template of searchpath with the given
+ * default file name, and append the results to search's candidates.
+ */
+
+static void AddCandidates(ConfigSearchPtr search, const char *searchpath,
+                          char *XConfigFile)
+{
+    char *pathcopy, *saveptr, *path, **paths;
     const char *template;
-    int cmdlineUsed = 0;
+    int cmdlineUsed, i;
+
+    pathcopy = xconfigStrdup(searchpath);
+
+    for (template = strtok_r(pathcopy, ",", &saveptr); template;
+         template = strtok_r(NULL, ",", &saveptr)) {
+
+        path = DoSubstitution(template, search->cmdline, search->projroot,
+                              &cmdlineUsed, NULL, XConfigFile);
+        if (!path)
+            continue;
+
+        if (search->cmdline && !cmdlineUsed) {
+            free(path);
+            continue;
+        }
+
+        for (i = 0; i < search->npaths; i++) {
+            if (strcmp(search->paths[i], path) == 0)
+                break;
+        }
+
+        paths = (i < search->npaths) ? NULL :
+            realloc(search->paths, (search->npaths + 1) * sizeof(char *));
+        if (!paths) {
+            free(path);
+            continue;
+        }
+        search->paths = paths;
+        search->paths[search->npaths++] = path;
+    }
+
+    free(pathcopy);
+}
 
-    configFile = NULL;
-    configPos = 0;        /* current readers position */
-    configLineNo = 0;    /* linenumber */
-    pushToken = LOCK_TOKEN;
+
+/*
+ * GetConfigSearch() - return the search for the given command line file
+ * name and project root, building its list of candidates the first
+ * time it is needed.
+ */
+
+static ConfigSearchPtr GetConfigSearch(const char *cmdline,
+                                       const char *projroot)
+{
+    const char *searchpath, *env = getenv(XCONFENV);
+    ConfigSearchPtr search;
+
+    pthread_mutex_lock(&configSearchLock);
+
+    for (search = configSearches; search; search = search->next) {
+        if (SameString(search->cmdline, cmdline) &&
+            SameString(search->projroot, projroot) &&
+            SameString(search->env, env)) {
+            pthread_mutex_unlock(&configSearchLock);
+            return search;
+        }
+    }
 
     /*
      * select the search path: XFree86 uses a slightly different path
@@ -849,183 +1247,467 @@ const char *xconfigOpenConfigFile(const char *cmdline, const char *projroot)
         searchpath = __user_configpath;
     }
 
-    if (!projroot) projroot = PROJECTROOT;
-    
-    pathcopy = strdup(searchpath);
-    
-    template = strtok(pathcopy, ",");
-
-    /* First, search for a config file. */
-    while (template && !configFile) {
-        if ((configPath = DoSubstitution(template, cmdline, projroot,
-                                         &cmdlineUsed, NULL, XCONFIGFILE))) {
-            if ((configFile = fopen(configPath, "r")) != 0) {
-                if (cmdline && !cmdlineUsed) {
-                    fclose(configFile);
-                    configFile = NULL;
-                }
-            }
+    search = xconfigAlloc(sizeof(ConfigSearchRec));
+    search->cmdline = xconfigStrdup(cmdline);
+    search->projroot = xconfigStrdup(projroot);
+    search->env = xconfigStrdup(env);
+    search->found = -1;
+
+    /* first the config file, then the fallback */
+
+    AddCandidates(search, searchpath, XCONFIGFILE);
+    AddCandidates(search, searchpath, XFREE86CFGFILE);
+
+    search->next = configSearches;
+    configSearches = search;
+
+    pthread_mutex_unlock(&configSearchLock);
+
+    return search;
+}
+
+
+static int GetFound(ConfigSearchPtr search)
+{
+    int found;
+
+    pthread_mutex_lock(&configSearchLock);
+    found = search->found;
+    pthread_mutex_unlock(&configSearchLock);
+
+    return found;
+}
+
+
+static void SetFound(ConfigSearchPtr search, int found)
+{
+    pthread_mutex_lock(&configSearchLock);
+    search->found = found;
+    pthread_mutex_unlock(&configSearchLock);
+}
+
+
+/*
+ * xconfigForgetConfigSearches() - forget which config file each search
+ * found, so that the next xconfigFindConfigFile() or
+ * xconfigOpenConfigFile() looks for it again; for programs that run
+ * while config files are created or removed.  The lists of candidates
+ * are kept, so paths returned earlier stay valid.
+ */
+
+void xconfigForgetConfigSearches(void)
+{
+    ConfigSearchPtr search;
+
+    pthread_mutex_lock(&configSearchLock);
+
+    for (search = configSearches; search; search = search->next) {
+        search->found = -1;
+    }
+
+    pthread_mutex_unlock(&configSearchLock);
+}
+
+
+/*
+ * ProbeConfigSearch() - return the index of the first of search's
+ * candidates, starting from first, that can be read, or -1 if none
+ * can.  Each directory holding candidates is opened once, and its
+ * candidates checked with faccessat(2) relative to it; the candidates
+ * in a directory that does not exist are skipped without looking at
+ * each of them.
+ */
+
+#define MAX_SEARCH_DIRS 16
+
+static int ProbeConfigSearch(ConfigSearchPtr search, int first)
+{
+    struct {
+        const char *dir;
+        size_t len;
+        int fd;
+    } dirs[MAX_SEARCH_DIRS];
+    const char *path, *slash;
+    int ndirs = 0, i, j, fd, found = -1;
+    char dir[PATH_MAX + 1];
+    size_t len;
+
+    for (i = first; i < search->npaths && found < 0; i++) {
+        path = search->paths[i];
+        slash = strrchr(path, '/');
+
+        if (!slash) {
+            if (faccessat(AT_FDCWD, path, R_OK, AT_EACCESS) == 0)
+                found = i;
+            continue;
         }
-        if (configPath && !configFile) {
-            free(configPath);
-            configPath = NULL;
+
+        /* the directory, with its trailing '/' */
+
+        len = slash - path + 1;
+
+        for (j = 0; j < ndirs; j++) {
+            if (dirs[j].len == len && strncmp(dirs[j].dir, path, len) == 0)
+                break;
         }
-        template = strtok(NULL, ",");
-    }
 
-    /* Then search for fallback */
-    if (!configFile) {
-        strcpy(pathcopy, searchpath);
-        template = strtok(pathcopy, ",");
-        
-        while (template && !configFile) {
-            if ((configPath = DoSubstitution(template, cmdline, projroot,
-                                             &cmdlineUsed, NULL,
-                                             XFREE86CFGFILE))) {
-                if ((configFile = fopen(configPath, "r")) != 0) {
-                    if (cmdline && !cmdlineUsed) {
-                        fclose(configFile);
-                        configFile = NULL;
-                    }
-                }
-            }
-            if (configPath && !configFile) {
-                free(configPath);
-                configPath = NULL;
+        if (j < ndirs) {
+            fd = dirs[j].fd;
+        } else {
+            memcpy(dir, path, len);
+            dir[len] = '\0';
+            fd = open(dir, O_RDONLY | O_DIRECTORY);
+            if (ndirs < MAX_SEARCH_DIRS) {
+                dirs[ndirs].dir = path;
+                dirs[ndirs].len = len;
+                dirs[ndirs].fd = fd;
+                ndirs++;
+            } else if (fd >= 0) {
+                if (faccessat(fd, slash + 1, R_OK, AT_EACCESS) == 0)
+                    found = i;
+                close(fd);
+                continue;
             }
-            template = strtok(NULL, ",");
         }
+
+        if (fd >= 0 && faccessat(fd, slash + 1, R_OK, AT_EACCESS) == 0)
+            found = i;
     }
-    
-    free(pathcopy);
 
-    if (!configFile) {
+    for (j = 0; j < ndirs; j++) {
+        if (dirs[j].fd >= 0)
+            close(dirs[j].fd);
+    }
+
+    return found;
+}
+
+
+/*
+ * xconfigFindConfigFile() - return the path of the config file that
+ * xconfigOpenConfigFile() would open for the given command line file
+ * name and project root, or NULL if there is none, without opening
+ * it.  The result lives as long as the process does.
+ */
+
+const char *xconfigFindConfigFile(const char *cmdline, const char *projroot)
+{
+    ConfigSearchPtr search;
+    int i;
+
+    if (!projroot) projroot = PROJECTROOT;
+
+    search = GetConfigSearch(cmdline, projroot);
+
+    i = GetFound(search);
+    if (i < 0) {
+        i = ProbeConfigSearch(search, 0);
+        SetFound(search, i);
+    }
+
+    return (i < 0) ? NULL : search->paths[i];
+}
+
+
+const char *xconfigOpenConfigFile(XConfigParserPtr parser,
+                                  const char *cmdline, const char *projroot)
+{
+    ConfigSearchPtr search;
+    FILE *file = NULL;
+    int i;
+
+    ResetScanner(parser);
+
+    if (!projroot) projroot = PROJECTROOT;
+
+    search = GetConfigSearch(cmdline, projroot);
+
+    /*
+     * try the file found by an earlier search first; if it cannot be
+     * opened now, go on probing from the candidate after it
+     */
+
+    i = GetFound(search);
+    if (i < 0)
+        i = ProbeConfigSearch(search, 0);
+
+    while (i >= 0 && !(file = fopen(search->paths[i], "r")))
+        i = ProbeConfigSearch(search, i + 1);
+
+    SetFound(search, i);
+
+    if (!file) {
         return NULL;
     }
 
-    configBuf = malloc(CONFIG_BUF_LEN);
-    configRBuf = malloc(CONFIG_BUF_LEN);
-    configBuf[0] = '\0';
+    parser->path = xconfigStrdup(search->paths[i]);
 
-    return configPath;
+    if (!LoadConfigData(parser, file)) {
+        fclose(file);
+        free(parser->path);
+        parser->path = NULL;
+        return NULL;
+    }
+
+    fclose(file);
+
+    return parser->path;
 }
 
-void xconfigCloseConfigFile (void)
+
+/*
+ * xconfigOpenConfigBuffer() - like xconfigOpenConfigFile(), but scan
+ * the len bytes of config text at buf.  The text is scanned in place,
+ * so buf must remain valid and unmodified until the parser is closed.
+ * name is used in place of a file name in messages.
+ */
+
+void xconfigOpenConfigBuffer(XConfigParserPtr parser, const char *buf,
+                             size_t len, const char *name)
 {
-    free (configPath);
-    configPath = NULL;
-    free (configRBuf);
-    configRBuf = NULL;
-    free (configBuf);
-    configBuf = NULL;
-
-    if (configFile) {
-        fclose (configFile);
-        configFile = NULL;
-    } else {
-        builtinConfig = NULL;
-        builtinIndex = 0;
+    ResetScanner(parser);
+
+    parser->data = buf;
+    parser->dataLen = buf ? len : 0;
+    parser->dataOwner = DATA_CALLER;
+    parser->path = strdup(name ? name : "<buffer>");
+}
+
+
+void xconfigCloseConfigFile (XConfigParserPtr parser)
+{
+    free (parser->path);
+    parser->path = NULL;
+    free (parser->rbuf);
+    parser->rbuf = NULL;
+    parser->rbufLen = 0;
+
+    if (parser->dataOwner == DATA_MMAP) {
+        munmap((void *) parser->data, parser->dataLen);
+    } else if (parser->dataOwner == DATA_MALLOC) {
+        free((void *) parser->data);
     }
+    parser->data = NULL;
+    parser->dataLen = 0;
+    parser->dataOwner = DATA_CALLER;
+    parser->tok = NULL;
+    parser->tokLen = 0;
 }
 
 
-char *xconfigGetConfigFileName(void)
+char *xconfigGetConfigFileName(XConfigParserPtr parser)
 {
-    return configPath;
+    return parser->path;
 }
 
 
 void
-xconfigSetSection (char *section)
+xconfigSetSection (XConfigParserPtr parser, const char *section)
+{
+    if (parser->section)
+        free(parser->section);
+    parser->section = malloc(strlen (section) + 1);
+    strcpy (parser->section, section);
+}
+
+/*
+ * xconfigAllocParser() - allocate a parser context.  Each thread
+ * parsing a config file needs its own context.
+ */
+
+XConfigParserPtr xconfigAllocParser(void)
+{
+    XConfigParserPtr parser = xconfigAlloc(sizeof(XConfigParserRec));
+
+    parser->pushToken = LOCK_TOKEN;
+    parser->diagnostics.tail = &parser->diagnostics.list;
+
+    return parser;
+}
+
+
+/*
+ * xconfigFreeParser() - free a parser context allocated with
+ * xconfigAllocParser(), closing its config file if still open.
+ */
+
+void xconfigFreeParser(XConfigParserPtr *parser)
+{
+    if (parser == NULL || *parser == NULL)
+        return;
+
+    xconfigCloseConfigFile(*parser);
+    xconfigReleaseMessages(*parser, FALSE);
+    xconfigFreeDiagnostics(*parser);
+    TEST_FREE((*parser)->section);
+
+    free(*parser);
+    *parser = NULL;
+}
+
+
+/*
+ * xconfigForkParser() - return a new parser context for reading parts
+ * of the same data as parser into config, eg from another thread.  The
+ * new context starts at the same position, with the same settings as
+ * parser.  It scans parser's data in place, so it must be freed before
+ * parser is closed.
+ */
+
+XConfigParserPtr xconfigForkParser(XConfigParserPtr parser,
+                                   XConfigPtr config)
 {
-    if (configSection)
-        free(configSection);
-    configSection = malloc(strlen (section) + 1);
-    strcpy (configSection, section);
+    XConfigParserPtr fork = xconfigAllocParser();
+    XConfigScanStateRec state;
+
+    fork->data = parser->data;
+    fork->dataLen = parser->dataLen;
+    fork->dataOwner = DATA_CALLER;
+    fork->path = xconfigStrdup(parser->path);
+    fork->section = xconfigStrdup(parser->section);
+    fork->config = config;
+    fork->deferKinds = parser->deferKinds;
+    fork->trackSource = parser->trackSource;
+    fork->optionTypes = parser->optionTypes;
+    config->optionTypes = parser->optionTypes;
+
+    xconfigSaveScanState(parser, &state);
+    xconfigRestoreScanState(fork, &state);
+
+    return fork;
 }
 
+
+/*
+ * xconfigSaveScanState() - save the parser's position in its data, so
+ * that scanning can later continue from there.
+ */
+
+void xconfigSaveScanState(XConfigParserPtr parser,
+                          XConfigScanStateRec *state)
+{
+    state->pos = parser->pos;
+    state->bol = parser->bol;
+    state->tok = parser->tok;
+    state->tokLen = parser->tokLen;
+    state->pushToken = parser->pushToken;
+    state->eol_seen = parser->eol_seen;
+    state->lineNo = parser->lineNo;
+}
+
+
+/*
+ * xconfigRestoreScanState() - move the parser to a position saved by
+ * xconfigSaveScanState(), either from it or from a parser of the same
+ * data.
+ */
+
+void xconfigRestoreScanState(XConfigParserPtr parser,
+                             const XConfigScanStateRec *state)
+{
+    parser->pos = state->pos;
+    parser->bol = state->bol;
+    parser->tok = state->tok;
+    parser->tokLen = state->tokLen;
+    parser->pushToken = state->pushToken;
+    parser->eol_seen = state->eol_seen;
+    parser->lineNo = state->lineNo;
+}
+
+
 /* 
  * xconfigGetToken --
  *  Lookup a string if it is actually a token in disguise.
  */
 
 
-char *
-xconfigAddComment(char *cur, char *add)
+static char *
+AddComment(XConfigPtr config, char *cur, const char *add, size_t len,
+           int *eol_seen)
 {
-    char *str;
-    int len, curlen, iscomment, hasnewline = 0, endnewline;
+    size_t i, size;
+    int curlen, iscomment, hasnewline = 0, endnewline;
 
-    if (add == NULL || add[0] == '\0')
+    if (add == NULL || len == 0)
         return (cur);
 
     if (cur) {
         curlen = strlen(cur);
         if (curlen)
             hasnewline = cur[curlen - 1] == '\n';
-        eol_seen = 0;
+        *eol_seen = 0;
     }
     else
         curlen = 0;
 
-    str = add;
-    iscomment = 0;
-    while (*str) {
-        if (*str != ' ' && *str != '\t')
-        break;
-        ++str;
+    for (i = 0; i < len; i++) {
+        if (add[i] != ' ' && add[i] != '\t')
+            break;
     }
-    iscomment = (*str == '#');
+    iscomment = (i < len) && (add[i] == '#');
 
-    len = strlen(add);
     endnewline = add[len - 1] == '\n';
-    len +=  1 + iscomment + (!hasnewline) + (!endnewline) + eol_seen;
 
-    if ((str = realloc(cur, len + curlen)) == NULL)
-        return (cur);
-
-    cur = str;
+    size = curlen + len + 1 + iscomment + (!hasnewline) +
+           (!endnewline) + *eol_seen;
+    cur = xconfigArenaGrow(config, cur, curlen + 1, size);
 
-    if (eol_seen || (curlen && !hasnewline))
+    if (*eol_seen || (curlen && !hasnewline))
         cur[curlen++] = '\n';
     if (!iscomment)
         cur[curlen++] = '#';
-    strcpy(cur + curlen, add);
+    memcpy(cur + curlen, add, len);
+    curlen += len;
     if (!endnewline)
-        strcat(cur, "\n");
+        cur[curlen++] = '\n';
+    cur[curlen] = '\0';
 
     return (cur);
 }
 
-int
-xconfigGetStringToken (XConfigSymTabRec * tab)
+char *
+xconfigAddComment(XConfigPtr config, char *cur, const char *add)
 {
-    return StringToToken (val.str, tab);
+    int eol_seen = 0;
+
+    return AddComment(config, cur, add, add ? strlen(add) : 0, &eol_seen);
 }
 
-static int
-StringToToken (char *str, XConfigSymTabRec * tab)
+/*
+ * xconfigParserAddComment() - append the COMMENT token just read by the
+ * parser to cur; like xconfigAddComment(), but accounts for whether the
+ * comment was the first token on its line.
+ */
+
+char *
+xconfigParserAddComment(XConfigParserPtr parser, char *cur)
 {
-    int i;
+    return AddComment(parser->config, cur, parser->tok, parser->tokLen,
+                      &parser->eol_seen);
+}
 
-    for (i = 0; tab[i].token != -1; i++)
-    {
-        if (!xconfigNameCompare (tab[i].name, str))
-            return tab[i].token;
-    }
-    return (ERROR_TOKEN);
+int
+xconfigGetStringToken (XConfigParserPtr parser,
+                       const XConfigKeywordTableRec *tab)
+{
+    return LookupKeyword (tab, parser->val.str, strlen (parser->val.str));
 }
 
 
 /* 
  * Compare two names.  The characters '_', ' ', and '\t' are ignored
- * in the comparison.
+ * in the comparison.  Names from the same config's string pool are
+ * the same string exactly when they are the same pointer, so that
+ * case is checked first.
  */
 int
 xconfigNameCompare (const char *s1, const char *s2)
 {
     char c1, c2;
 
+    if (s1 == s2)
+        return (0);
+
     if (!s1 || *s1 == 0) {
         if (!s2 || *s2 == 0)
             return (0);
@@ -1055,6 +1737,25 @@ xconfigNameCompare (const char *s1, const char *s2)
     return (c1 - c2);
 }
 
+/*
+ * Hash a name so that names xconfigNameCompare() finds equal hash the
+ * same: case and the characters '_', ' ', and '\t' are ignored, and
+ * NULL hashes like "".
+ */
+unsigned int
+xconfigNameHash (const char *s)
+{
+    unsigned int h = 2166136261U;
+
+    for (; s && *s; s++) {
+        if (*s == '_' || *s == ' ' || *s == '\t')
+            continue;
+        h = (h ^ (unsigned char) xconfigToLower(*s)) * 16777619U;
+    }
+
+    return h;
+}
+
 /* 
  * Compare two modelines.  The modeline identifiers and comments are
  * ignored in the comparison.
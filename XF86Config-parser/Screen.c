@@ -58,31 +58,14 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec DisplayTab[] =
-{
-    {ENDSUBSECTION, "endsubsection"},
-    {MODES, "modes"},
-    {VIEWPORT, "viewport"},
-    {VIRTUAL, "virtual"},
-    {VISUAL, "visual"},
-    {BLACK_TOK, "black"},
-    {WHITE_TOK, "white"},
-    {DEPTH, "depth"},
-    {BPP, "fbbpp"},
-    {WEIGHT, "weight"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeDisplayList
+XCONFIG_KEYWORD_TABLE(DisplayTab);
 
 static int addImpliedScreen(XConfigPtr config);
 
 XConfigDisplayPtr
-xconfigParseDisplaySubSection (void)
+xconfigParseDisplaySubSection (XConfigParserPtr parser)
 {
     int token;
     PARSE_PROLOGUE (XConfigDisplayPtr, XConfigDisplayRec)
@@ -90,103 +73,105 @@ xconfigParseDisplaySubSection (void)
     ptr->black.red = ptr->black.green = ptr->black.blue = -1;
     ptr->white.red = ptr->white.green = ptr->white.blue = -1;
     ptr->frameX0 = ptr->frameY0 = -1;
-    while ((token = xconfigGetToken (DisplayTab)) != ENDSUBSECTION)
+    while ((token = xconfigGetToken (parser, &DisplayTab)) != ENDSUBSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case VIEWPORT:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (VIEWPORT_MSG, NULL);
-            ptr->frameX0 = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->frameX0 = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (VIEWPORT_MSG, NULL);
-            ptr->frameY0 = val.num;
+            ptr->frameY0 = parser->val.num;
             break;
         case VIRTUAL:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (VIRTUAL_MSG, NULL);
-            ptr->virtualX = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->virtualX = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (VIRTUAL_MSG, NULL);
-            ptr->virtualY = val.num;
+            ptr->virtualY = parser->val.num;
             break;
         case DEPTH:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Display");
-            ptr->depth = val.num;
+            ptr->depth = parser->val.num;
             break;
         case BPP:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "Display");
-            ptr->bpp = val.num;
+            ptr->bpp = parser->val.num;
             break;
         case VISUAL:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Display");
-            ptr->visual = val.str;
+            ptr->visual = parser->val.str;
             break;
         case WEIGHT:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (WEIGHT_MSG, NULL);
-            ptr->weight.red = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->weight.red = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (WEIGHT_MSG, NULL);
-            ptr->weight.green = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->weight.green = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (WEIGHT_MSG, NULL);
-            ptr->weight.blue = val.num;
+            ptr->weight.blue = parser->val.num;
             break;
         case BLACK_TOK:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (BLACK_MSG, NULL);
-            ptr->black.red = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->black.red = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (BLACK_MSG, NULL);
-            ptr->black.green = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->black.green = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (BLACK_MSG, NULL);
-            ptr->black.blue = val.num;
+            ptr->black.blue = parser->val.num;
             break;
         case WHITE_TOK:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (WHITE_MSG, NULL);
-            ptr->white.red = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->white.red = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (WHITE_MSG, NULL);
-            ptr->white.green = val.num;
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            ptr->white.green = parser->val.num;
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (WHITE_MSG, NULL);
-            ptr->white.blue = val.num;
+            ptr->white.blue = parser->val.num;
             break;
         case MODES:
             {
                 XConfigModePtr mptr;
 
                 while ((token =
-                        xconfigGetSubTokenWithTab(&(ptr->comment),
-                                                  DisplayTab)) == STRING)
+                        xconfigGetSubTokenWithTab(parser, &(ptr->comment),
+                                                  &DisplayTab)) == STRING)
                 {
-                    mptr = calloc (1, sizeof (XConfigModeRec));
-                    mptr->mode_name = val.str;
+                    mptr = xconfigArenaAlloc (parser->config,
+                                              sizeof (XConfigModeRec));
+                    mptr->mode_name = parser->val.str;
                     mptr->next = NULL;
-                    xconfigAddListItem((GenericListPtr *)(&ptr->modes),
-                                       (GenericListPtr) mptr);
+                    xconfigParserAddListItem(parser,
+                                             (GenericListPtr *)(&ptr->modes),
+                                             (GenericListPtr) mptr);
                 }
-                xconfigUnGetToken (token);
+                xconfigUnGetToken (parser, token);
             }
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
             
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -194,29 +179,10 @@ xconfigParseDisplaySubSection (void)
     return ptr;
 }
 
-#undef CLEANUP
+XCONFIG_KEYWORD_TABLE(ScreenTab);
 
-static XConfigSymTabRec ScreenTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {OBSDRIVER, "driver"},
-    {MDEVICE, "device"},
-    {MONITOR, "monitor"},
-    {VIDEOADAPTOR, "videoadaptor"},
-    {SCREENNO, "screenno"},
-    {SUBSECTION, "subsection"},
-    {DEFAULTDEPTH, "defaultcolordepth"},
-    {DEFAULTDEPTH, "defaultdepth"},
-    {DEFAULTBPP, "defaultbpp"},
-    {DEFAULTFBBPP, "defaultfbbpp"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeScreenList
 XConfigScreenPtr
-xconfigParseScreenSection (void)
+xconfigParseScreenSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int has_driver= FALSE;
@@ -224,85 +190,88 @@ xconfigParseScreenSection (void)
 
     PARSE_PROLOGUE (XConfigScreenPtr, XConfigScreenRec)
 
-        while ((token = xconfigGetToken (ScreenTab)) != ENDSECTION)
+        while ((token = xconfigGetToken (parser, &ScreenTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             if (has_ident || has_driver)
                 Error (ONLY_ONE_MSG,"Identifier or Driver");
             has_ident = TRUE;
             break;
         case OBSDRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->obsolete_driver = val.str;
+            ptr->obsolete_driver = parser->val.str;
             if (has_ident || has_driver)
                 Error (ONLY_ONE_MSG,"Identifier or Driver");
             has_driver = TRUE;
             break;
         case DEFAULTDEPTH:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DefaultDepth");
-            ptr->defaultdepth = val.num;
+            ptr->defaultdepth = parser->val.num;
             break;
         case DEFAULTBPP:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DefaultBPP");
-            ptr->defaultbpp = val.num;
+            ptr->defaultbpp = parser->val.num;
             break;
         case DEFAULTFBBPP:
-            if (xconfigGetSubToken (&(ptr->comment)) != NUMBER)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != NUMBER)
                 Error (NUMBER_MSG, "DefaultFbBPP");
-            ptr->defaultfbbpp = val.num;
+            ptr->defaultfbbpp = parser->val.num;
             break;
         case MDEVICE:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Device");
-            ptr->device_name = val.str;
+            ptr->device_name = parser->val.str;
             break;
         case MONITOR:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Monitor");
-            ptr->monitor_name = val.str;
+            ptr->monitor_name = parser->val.str;
             break;
         case VIDEOADAPTOR:
             {
                 XConfigAdaptorLinkPtr aptr;
 
-                if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+                if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                     Error (QUOTE_MSG, "VideoAdaptor");
 
                 /* Don't allow duplicates */
                 for (aptr = ptr->adaptors; aptr; 
                     aptr = (XConfigAdaptorLinkPtr) aptr->next)
-                    if (xconfigNameCompare (val.str, aptr->adaptor_name) == 0)
+                    if (xconfigNameCompare (parser->val.str,
+                                            aptr->adaptor_name) == 0)
                         break;
 
                 if (aptr == NULL)
                 {
-                    aptr = calloc (1, sizeof (XConfigAdaptorLinkRec));
+                    aptr = xconfigArenaAlloc (parser->config,
+                                              sizeof (XConfigAdaptorLinkRec));
                     aptr->next = NULL;
-                    aptr->adaptor_name = val.str;
-                    xconfigAddListItem ((GenericListPtr *)(&ptr->adaptors),
-                                        (GenericListPtr) aptr);
+                    aptr->adaptor_name = parser->val.str;
+                    xconfigParserAddListItem(parser,
+                                             (GenericListPtr *)
+                                             (&ptr->adaptors),
+                                             (GenericListPtr) aptr);
                 }
             }
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case SUBSECTION:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "SubSection");
             {
-                free(val.str);
                 HANDLE_LIST (displays, xconfigParseDisplaySubSection,
                              XConfigDisplayPtr);
             }
@@ -311,7 +280,7 @@ xconfigParseScreenSection (void)
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -420,87 +389,39 @@ xconfigPrintScreenSection (FILE * cf, XConfigScreenPtr ptr)
 }
 
 void
-xconfigFreeScreenList (XConfigScreenPtr *ptr)
+xconfigResolveScreenReferences (XConfigPtr p)
 {
-    XConfigScreenPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
+    XConfigScreenPtr screen;
+    XConfigMonitorPtr monitor;
+    XConfigAdaptorLinkPtr adaptor;
 
-    while (*ptr)
+    for (screen = p->screens; screen; screen = screen->next)
     {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->monitor_name);
-        TEST_FREE ((*ptr)->device_name);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeOptionList (&((*ptr)->options));
-        xconfigFreeAdaptorLinkList (&((*ptr)->adaptors));
-        xconfigFreeDisplayList (&((*ptr)->displays));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
+        if (screen->obsolete_driver && !screen->identifier)
+            screen->identifier = screen->obsolete_driver;
 
-void
-xconfigFreeAdaptorLinkList (XConfigAdaptorLinkPtr *ptr)
-{
-    XConfigAdaptorLinkPtr prev;
+        if (screen->monitor_name)
+            screen->monitor = xconfigIndexFind(p, XCONFIG_INDEX_MONITOR,
+                                               screen->monitor_name);
 
-    if (ptr == NULL || *ptr == NULL)
-        return;
+        screen->device = xconfigIndexFind(p, XCONFIG_INDEX_DEVICE,
+                                          screen->device_name);
 
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->adaptor_name);
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
+        for (adaptor = screen->adaptors; adaptor; adaptor = adaptor->next)
+            adaptor->adaptor = xconfigIndexFind(p, XCONFIG_INDEX_VIDEOADAPTOR,
+                                                adaptor->adaptor_name);
     }
-}
 
-void
-xconfigFreeDisplayList (XConfigDisplayPtr *ptr)
-{
-    XConfigDisplayPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        xconfigFreeModeList (&((*ptr)->modes));
-        xconfigFreeOptionList (&((*ptr)->options));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeModeList (XConfigModePtr *ptr)
-{
-    XConfigModePtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->mode_name);
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
+    for (monitor = p->monitors; monitor; monitor = monitor->next)
+        xconfigResolveMonitorModes(p, monitor);
 }
 
 int
 xconfigValidateScreen (XConfigPtr p)
 {
     XConfigScreenPtr screen = p->screens;
-    XConfigMonitorPtr monitor;
-    XConfigDevicePtr device;
     XConfigAdaptorLinkPtr adaptor;
+    int ret = TRUE;
 
     /*
      * if we do not have a screen, just return TRUE; we'll add a
@@ -511,60 +432,60 @@ xconfigValidateScreen (XConfigPtr p)
 
     while (screen)
     {
-        if (screen->obsolete_driver && !screen->identifier)
-            screen->identifier = screen->obsolete_driver;
-
-        monitor = xconfigFindMonitor (screen->monitor_name, p->monitors);
         if (screen->monitor_name)
         {
-            if (!monitor)
+            if (!screen->monitor)
             {
-                xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_MONITOR_MSG,
-                             screen->monitor_name, screen->identifier);
-                return (FALSE);
+                if (!xconfigSectionFailed(p, MONITOR_SECTION,
+                                          screen->monitor_name))
+                {
+                    xconfigValidationErrorMsg(p, UNDEFINED_MONITOR_MSG,
+                                              screen->monitor_name,
+                                              screen->identifier);
+                    VALIDATION_FAILED(p, ret);
+                }
             }
             else
             {
-                screen->monitor = monitor;
                 if (!xconfigValidateMonitor(p, screen))
-                    return (FALSE);
+                    VALIDATION_FAILED(p, ret);
             }
         }
 
-        device = xconfigFindDevice (screen->device_name, p->devices);
-        if (!device)
+        if (!screen->device &&
+            !xconfigSectionFailed(p, DEVICE_SECTION, screen->device_name))
         {
-            xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_DEVICE_MSG,
-                         screen->device_name, screen->identifier);
-            return (FALSE);
+            xconfigValidationErrorMsg(p, UNDEFINED_DEVICE_MSG,
+                                      screen->device_name, screen->identifier);
+            VALIDATION_FAILED(p, ret);
         }
-        else
-            screen->device = device;
 
         adaptor = screen->adaptors;
         while (adaptor) {
-            adaptor->adaptor = xconfigFindVideoAdaptor(adaptor->adaptor_name,
-                                                       p->videoadaptors);
             if (!adaptor->adaptor) {
-                xconfigErrorMsg(ValidationErrorMsg, UNDEFINED_ADAPTOR_MSG,
-                             adaptor->adaptor_name,
-                             screen->identifier);
-                return (FALSE);
+                if (!xconfigSectionFailed(p, VIDEOADAPTOR_SECTION,
+                                          adaptor->adaptor_name)) {
+                    xconfigValidationErrorMsg(p, UNDEFINED_ADAPTOR_MSG,
+                                              adaptor->adaptor_name,
+                                              screen->identifier);
+                    VALIDATION_FAILED(p, ret);
+                }
             } else if (adaptor->adaptor->fwdref) {
-                xconfigErrorMsg(ValidationErrorMsg, ADAPTOR_REF_TWICE_MSG,
-                             adaptor->adaptor_name,
-                             adaptor->adaptor->fwdref);
-                return (FALSE);
+                xconfigValidationErrorMsg(p, ADAPTOR_REF_TWICE_MSG,
+                                          adaptor->adaptor_name,
+                                          adaptor->adaptor->fwdref);
+                VALIDATION_FAILED(p, ret);
+            } else {
+                adaptor->adaptor->fwdref = screen->identifier;
             }
             
-            adaptor->adaptor->fwdref = xconfigStrdup(screen->identifier);
             adaptor = adaptor->next;
         }
 
         screen = screen->next;
     }
 
-    return (TRUE);
+    return (ret);
 }
 
 int xconfigSanitizeScreen(XConfigPtr p)
@@ -595,8 +516,8 @@ int xconfigSanitizeScreen(XConfigPtr p)
             }
 
             if (!monitor && screen->monitor_name) {
-                monitor = xconfigFindMonitor(screen->monitor_name,
-                                             p->monitors);
+                monitor = xconfigIndexFind(p, XCONFIG_INDEX_MONITOR,
+                                           screen->monitor_name);
             }
             
             if (!monitor && p->monitors) {
@@ -609,13 +530,9 @@ int xconfigSanitizeScreen(XConfigPtr p)
             
             if (monitor) {
                 screen->monitor = monitor;
+                screen->monitor_name = monitor->identifier;
                 
-                if (screen->monitor_name) {
-                    free(screen->monitor_name);
-                }
-                
-                screen->monitor_name = xconfigStrdup(monitor->identifier);
-                
+                xconfigResolveMonitorModes(p, monitor);
                 if (!xconfigValidateMonitor(p, screen)) {
                     return FALSE;
                 }
@@ -657,12 +574,12 @@ xconfigFindMode (const char *name, XConfigModePtr p)
 }
 
 void
-xconfigAddMode(XConfigModePtr *pHead, const char *name)
+xconfigAddMode(XConfigPtr config, XConfigModePtr *pHead, const char *name)
 {
     XConfigModePtr mode;
     
-    mode = xconfigAlloc(sizeof(XConfigModeRec));
-    mode->mode_name = xconfigStrdup(name);
+    mode = xconfigArenaAlloc(config, sizeof(XConfigModeRec));
+    mode->mode_name = xconfigIntern(config, name);
 
     mode->next = *pHead;
     *pHead = mode;
@@ -682,8 +599,6 @@ xconfigRemoveMode(XConfigModePtr *pHead, const char *name)
             } else {
                 *pHead = p->next;
             }
-            free(p->mode_name);
-            free(p);
             return;
         }
         last = p;
@@ -705,17 +620,17 @@ static int addImpliedScreen(XConfigPtr config)
 
     /* allocate the new screen section */
 
-    screen = calloc(1, sizeof(XConfigScreenRec));
+    screen = xconfigArenaAlloc(config, sizeof(XConfigScreenRec));
     if (!screen) return FALSE;
     
-    screen->identifier = xconfigStrdup("Default Screen");
+    screen->identifier = xconfigIntern(config, "Default Screen");
 
     /*
      * Use the first device section if there is one.
      */
     if (config->devices) {
         device = config->devices;
-        screen->device_name = xconfigStrdup(device->identifier);
+        screen->device_name = device->identifier;
         screen->device = device;
     }
 
@@ -724,7 +639,7 @@ static int addImpliedScreen(XConfigPtr config)
      */
     if (config->monitors) {
         monitor = config->monitors;
-        screen->monitor_name = xconfigStrdup(monitor->identifier);
+        screen->monitor_name = monitor->identifier;
         screen->monitor = monitor;
     }
 
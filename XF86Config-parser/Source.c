@@ -0,0 +1,749 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * Source.c - source tracking, and writing a config back over the text
+ * it was read from.
+ *
+ * With source tracking on (see xconfigSetSourceTracking()),
+ * xconfigReadConfigFile() keeps a copy of the config text, and records
+ * the span of text each section node was read from.  Once the config
+ * has been read, each node is printed as xconfigWriteConfigFile()
+ * would print it, and a hash of that is kept with its span.
+ *
+ * xconfigPatchConfigFile() then writes the config in the order of the
+ * original text.  A node that still prints the same way has not been
+ * changed, and its original text is written out; a node that prints
+ * differently is written as printed.  Nodes that have been removed
+ * from the config are left out, and nodes that were added are printed
+ * at the end.  Only the sections that changed differ from the original
+ * text, and the formatting and comments within the others are kept.
+ *
+ * Changes are detected per section: a changed Option is written by
+ * printing the section it is in.  The text between sections is always
+ * written as it was, with one exception.  The config's comment holds
+ * the comments outside of any section: those at the start of the file,
+ * before the first section, and then those between sections.  Programs
+ * edit the first part, eg to put a banner at the top; if the comment
+ * has changed, and still ends with the comments from between sections,
+ * the rest of it is written in place of the comments at the start of
+ * the file.  A comment that was changed in any other way cannot be put
+ * back into the text, and the config is then written in full.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "xf86Parser.h"
+#include "xf86tokens.h"
+#include "Configint.h"
+
+
+/*
+ * GetSource() - return the config's source record, allocating it if
+ * this is the first span or text recorded for the config.
+ */
+
+static XConfigSourcePtr GetSource(XConfigPtr config)
+{
+    if (!config->source) {
+        config->source = xconfigArenaAlloc(config, sizeof(XConfigSourceRec));
+        config->source->spansTail = &config->source->spans;
+    }
+
+    return config->source;
+}
+
+
+/*
+ * xconfigAddSourceSpan() - record that the section node, of the given
+ * section token, was read from the text between start and end.
+ * Spans must be added in the order they appear in the text.
+ */
+
+void xconfigAddSourceSpan(XConfigPtr config, void *node, int token,
+                          int deferred, size_t start, size_t end)
+{
+    XConfigSourcePtr source = GetSource(config);
+    XConfigSpanPtr span = xconfigArenaAlloc(config, sizeof(XConfigSpanRec));
+
+    span->node = node;
+    span->token = token;
+    span->deferred = deferred;
+    span->start = start;
+    span->end = end;
+
+    *source->spansTail = span;
+    source->spansTail = &span->next;
+    source->nspans++;
+}
+
+
+/*
+ * xconfigJoinSourceSpans() - add the spans recorded for from, which
+ * follow those of config in the text, to config.  from's spans must
+ * live as long as config does; see xconfigAdoptConfig().
+ */
+
+void xconfigJoinSourceSpans(XConfigPtr config, XConfigPtr from)
+{
+    XConfigSourcePtr source;
+
+    if (!from->source || !from->source->spans) {
+        return;
+    }
+
+    source = GetSource(config);
+
+    *source->spansTail = from->source->spans;
+    source->spansTail = from->source->spansTail;
+    source->nspans += from->source->nspans;
+}
+
+
+/*
+ * xconfigNoteFirstSection() - note that the parser has reached the
+ * config's first section, so that the comments read so far are those
+ * at the start of the file.  Only the first call counts.
+ */
+
+void xconfigNoteFirstSection(XConfigPtr config)
+{
+    XConfigSourcePtr source = GetSource(config);
+
+    if (!source->sawSection) {
+        source->sawSection = TRUE;
+        source->leadingLen = config->comment ? strlen(config->comment) : 0;
+    }
+}
+
+
+/*
+ * xconfigKeepSource() - keep a copy of the len bytes of text that
+ * config was read from.
+ */
+
+void xconfigKeepSource(XConfigPtr config, const char *text, size_t len)
+{
+    XConfigSourcePtr source = GetSource(config);
+    char *copy = xconfigArenaAlloc(config, len + 1);
+
+    if (len) {
+        memcpy(copy, text, len);
+    }
+
+    source->text = copy;
+    source->len = len;
+}
+
+
+/*
+ * Hash() - 64-bit FNV-1a hash of len bytes of data
+ */
+
+static unsigned long long Hash(const char *data, size_t len)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h = (h ^ (unsigned char) data[i]) * 1099511628211ULL;
+    }
+
+    return h;
+}
+
+
+/*
+ * PrintSpan() - print the span's node into a malloc(3)ed buffer, as
+ * xconfigWriteConfigFile() would print it; returns NULL if the buffer
+ * could not be made.
+ */
+
+static char *PrintSpan(XConfigSpanPtr span, size_t *len)
+{
+    XConfigDeferredPtr deferred;
+    char *buf = NULL;
+    FILE *f;
+
+    f = open_memstream(&buf, len);
+    if (!f) {
+        return NULL;
+    }
+
+    if (span->deferred) {
+        deferred = span->node;
+        fwrite(deferred->text, 1, deferred->len, f);
+        fprintf(f, "\n\n");
+    } else {
+        xconfigPrintOneSection(f, span->token, span->node);
+    }
+
+    if (fclose(f) != 0) {
+        free(buf);
+        return NULL;
+    }
+
+    return buf;
+}
+
+
+static unsigned long long HashSpan(XConfigSpanPtr span)
+{
+    unsigned long long h;
+    size_t len;
+    char *buf;
+
+    buf = PrintSpan(span, &len);
+    if (!buf) {
+        return 0;
+    }
+
+    h = Hash(buf, len);
+    free(buf);
+
+    return h;
+}
+
+
+static unsigned long long HashComment(const char *comment)
+{
+    return comment ? Hash(comment, strlen(comment)) : 0;
+}
+
+
+/*
+ * xconfigMarkSourceClean() - note how each of the config's nodes with
+ * a span prints now, to tell later whether they have been changed.
+ */
+
+void xconfigMarkSourceClean(XConfigPtr config)
+{
+    XConfigSourcePtr source = config->source;
+    XConfigSpanPtr span;
+    const char *comment = config->comment ? config->comment : "";
+    size_t len = strlen(comment);
+
+    if (!source) {
+        return;
+    }
+
+    for (span = source->spans; span; span = span->next) {
+        span->hash = HashSpan(span);
+    }
+
+    source->commentHash = HashComment(config->comment);
+
+    /* without a section, all of the comment is at the start */
+
+    if (!source->sawSection || source->leadingLen > len) {
+        source->leadingLen = len;
+    }
+    source->innerComment = xconfigArenaStrdup(config,
+                                              comment + source->leadingLen);
+}
+
+
+/*
+ * xconfigReplaceSourceNode() - give the span of the deferred section
+ * node old to the node, of the given section token, that it was just
+ * parsed into.
+ */
+
+void xconfigReplaceSourceNode(XConfigPtr config, void *old, void *node,
+                              int token)
+{
+    XConfigSpanPtr span;
+
+    if (!config->source) {
+        return;
+    }
+
+    for (span = config->source->spans; span; span = span->next) {
+        if (span->node == old) {
+            span->node = node;
+            span->token = token;
+            span->deferred = FALSE;
+            span->hash = HashSpan(span);
+            return;
+        }
+    }
+}
+
+
+/*
+ * xconfigSetSourceTracking() - have xconfigReadConfigFile() keep the
+ * text of the config, and where each section came from, so that the
+ * config can be written back with xconfigPatchConfigFile().
+ */
+
+void xconfigSetSourceTracking(XConfigParserPtr parser, int track)
+{
+    parser->trackSource = track;
+}
+
+
+/*
+ * A map from each node with a span to its span, built for
+ * xconfigPatchConfigFile(); open addressing, with linear probing.
+ */
+
+typedef struct {
+    XConfigSpanPtr *slots;
+    size_t mask;
+} SpanMapRec, *SpanMapPtr;
+
+static size_t NodeSlot(SpanMapPtr map, const void *node)
+{
+    unsigned long long h = (unsigned long long) (size_t) node;
+
+    return (size_t) ((h * 11400714819323198485ULL) >> 32) & map->mask;
+}
+
+static int BuildSpanMap(SpanMapPtr map, XConfigSourcePtr source)
+{
+    XConfigSpanPtr span;
+    size_t size = 16, i;
+
+    while (size < (size_t) source->nspans * 2) {
+        size *= 2;
+    }
+
+    map->slots = calloc(size, sizeof(XConfigSpanPtr));
+    if (!map->slots) {
+        return FALSE;
+    }
+    map->mask = size - 1;
+
+    for (span = source->spans; span; span = span->next) {
+        for (i = NodeSlot(map, span->node);
+             map->slots[i];
+             i = (i + 1) & map->mask);
+        map->slots[i] = span;
+    }
+
+    return TRUE;
+}
+
+static XConfigSpanPtr FindSpan(SpanMapPtr map, const void *node)
+{
+    size_t i;
+
+    if (!node) {
+        return NULL;
+    }
+
+    for (i = NodeSlot(map, node); map->slots[i]; i = (i + 1) & map->mask) {
+        if (map->slots[i]->node == node) {
+            return map->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * The state of xconfigPatchConfigFile(): the spans that are still in
+ * the config are marked present, by index in source order.
+ */
+
+typedef struct {
+    SpanMapRec map;
+    XConfigSpanPtr *spans;      /* the spans, in source order */
+    int nspans;
+    char *present;
+} PatchRec, *PatchPtr;
+
+static int SpanIndex(PatchPtr patch, XConfigSpanPtr span)
+{
+    int lo = 0, hi = patch->nspans, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (patch->spans[mid]->start < span->start) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+
+/*
+ * MarkList() - mark the spans of the nodes in the given list present.
+ * Returns FALSE if the nodes are not in the order of their spans, or a
+ * new node comes before one with a span; writing the list in the
+ * order of the original text would then change its order.
+ */
+
+static int MarkList(PatchPtr patch, GenericListPtr list)
+{
+    XConfigSpanPtr span;
+    size_t last = 0;
+    int sawNew = FALSE, sawSpan = FALSE;
+
+    for (; list; list = list->next) {
+        span = FindSpan(&patch->map, list);
+        if (!span) {
+            sawNew = TRUE;
+            continue;
+        }
+        if (sawNew || (sawSpan && span->start < last)) {
+            return FALSE;
+        }
+        patch->present[SpanIndex(patch, span)] = TRUE;
+        last = span->start;
+        sawSpan = TRUE;
+    }
+
+    return TRUE;
+}
+
+
+static void MarkOne(PatchPtr patch, void *node)
+{
+    XConfigSpanPtr span = FindSpan(&patch->map, node);
+
+    if (span) {
+        patch->present[SpanIndex(patch, span)] = TRUE;
+    }
+}
+
+
+/*
+ * MarkConfig() - mark the spans of every node in the config present;
+ * returns FALSE if the config cannot be written in the order of the
+ * original text.
+ */
+
+static int MarkConfig(PatchPtr patch, XConfigPtr cptr)
+{
+    MarkOne(patch, cptr->files);
+    MarkOne(patch, cptr->modules);
+    MarkOne(patch, cptr->flags);
+    MarkOne(patch, cptr->dri);
+    MarkOne(patch, cptr->extensions);
+
+    return MarkList(patch, (GenericListPtr) cptr->layouts) &&
+           MarkList(patch, (GenericListPtr) cptr->vendors) &&
+           MarkList(patch, (GenericListPtr) cptr->inputs) &&
+           MarkList(patch, (GenericListPtr) cptr->inputclasses) &&
+           MarkList(patch, (GenericListPtr) cptr->videoadaptors) &&
+           MarkList(patch, (GenericListPtr) cptr->modes) &&
+           MarkList(patch, (GenericListPtr) cptr->monitors) &&
+           MarkList(patch, (GenericListPtr) cptr->devices) &&
+           MarkList(patch, (GenericListPtr) cptr->screens) &&
+           MarkList(patch, (GenericListPtr) cptr->deferred);
+}
+
+
+/*
+ * LeadingCommentLen() - return the length of the part of the config's
+ * comment that goes at the start of the file, or -1 if the comment no
+ * longer ends with the comments that were between sections.
+ */
+
+static ssize_t LeadingCommentLen(XConfigSourcePtr source, const char *comment)
+{
+    size_t len = comment ? strlen(comment) : 0;
+    const char *innerComment = source->innerComment ?
+                               source->innerComment : "";
+    size_t inner = strlen(innerComment);
+
+    if (len < inner || strcmp(comment + len - inner, innerComment)) {
+        return -1;
+    }
+
+    return len - inner;
+}
+
+
+/*
+ * WriteLeadingComment() - write the first len bytes of the comment,
+ * which go at the start of the file.  The parser records a blank line
+ * before the first comment of a file, and programs that take lines out
+ * of the comment leave blank lines behind, so blank lines are only
+ * written between comment lines, one at a time; the text written then
+ * reads back as the same comment.  Returns whether anything was
+ * written.
+ */
+
+static int WriteLeadingComment(FILE *cf, const char *comment, size_t len)
+{
+    size_t pos, eol;
+    int blank = FALSE, wrote = FALSE;
+
+    for (pos = 0; pos < len; pos = eol) {
+        for (eol = pos; eol < len && comment[eol] != '\n'; eol++);
+        if (eol < len) eol++;
+
+        if (comment[pos] == '\n') {
+            blank = wrote;
+            continue;
+        }
+
+        if (blank) {
+            fputc('\n', cf);
+            blank = FALSE;
+        }
+        fwrite(comment + pos, 1, eol - pos, cf);
+        if (comment[eol - 1] != '\n') {
+            fputc('\n', cf);
+        }
+        wrote = TRUE;
+    }
+
+    return wrote;
+}
+
+
+/*
+ * CommentsEnd() - return the offset just after the last line holding
+ * a comment in the text between start and end, which holds only white
+ * space and comments; start if there is none.
+ */
+
+static size_t CommentsEnd(const char *text, size_t start, size_t end)
+{
+    size_t pos, eol, last = start;
+
+    for (pos = start; pos < end; pos = eol) {
+        for (eol = pos; eol < end && text[eol] != '\n'; eol++);
+        if (eol < end) eol++;
+
+        if (memchr(text + pos, '#', eol - pos)) {
+            last = eol;
+        }
+    }
+
+    return last;
+}
+
+
+/*
+ * WriteSpan() - write the node of a present span: its original text
+ * if it prints as it did when it was read, or else as it prints now.
+ * The printed node ends with blank lines where the original text ends
+ * at EndSection, so those are left out.
+ */
+
+static void WriteSpan(FILE *cf, const char *text, XConfigSpanPtr span)
+{
+    size_t len;
+    char *buf;
+
+    buf = PrintSpan(span, &len);
+
+    if (buf && Hash(buf, len) != span->hash) {
+        while (len && buf[len - 1] == '\n') len--;
+        fwrite(buf, 1, len, cf);
+    } else {
+        fwrite(text + span->start, 1, span->end - span->start, cf);
+    }
+
+    free(buf);
+}
+
+
+/*
+ * WriteNewNodes() - print the nodes of the list that have no span.
+ */
+
+static void WriteNewNodes(FILE *cf, PatchPtr patch, GenericListPtr list,
+                          int token)
+{
+    for (; list; list = list->next) {
+        if (!FindSpan(&patch->map, list)) {
+            xconfigPrintOneSection(cf, token, list);
+        }
+    }
+}
+
+static void WriteNewNode(FILE *cf, PatchPtr patch, void *node, int token)
+{
+    if (node && !FindSpan(&patch->map, node)) {
+        xconfigPrintOneSection(cf, token, node);
+    }
+}
+
+
+/*
+ * WriteNewSections() - print the nodes that were added to the config
+ * since it was read, in the order xconfigWriteConfigFile() uses.
+ */
+
+static void WriteNewSections(FILE *cf, PatchPtr patch, XConfigPtr cptr)
+{
+    XConfigDeferredPtr deferred;
+
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->layouts,
+                  SERVERLAYOUT_SECTION);
+    WriteNewNode(cf, patch, cptr->files, FILES_SECTION);
+    WriteNewNode(cf, patch, cptr->modules, MODULE_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->vendors,
+                  VENDOR_SECTION);
+    WriteNewNode(cf, patch, cptr->flags, SERVERFLAGS_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->inputs,
+                  INPUTDEVICE_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->inputclasses,
+                  INPUTCLASS_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->videoadaptors,
+                  VIDEOADAPTOR_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->modes, MODES_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->monitors,
+                  MONITOR_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->devices,
+                  DEVICE_SECTION);
+    WriteNewNodes(cf, patch, (GenericListPtr) cptr->screens,
+                  SCREEN_SECTION);
+    WriteNewNode(cf, patch, cptr->dri, DRI_SECTION);
+    WriteNewNode(cf, patch, cptr->extensions, EXTENSIONS_SECTION);
+
+    for (deferred = cptr->deferred; deferred; deferred = deferred->next) {
+        if (!FindSpan(&patch->map, deferred)) {
+            fwrite(deferred->text, 1, deferred->len, cf);
+            fprintf(cf, "\n\n");
+        }
+    }
+}
+
+
+/*
+ * xconfigPatchConfigFile() - write the config to the named file, as
+ * changes to the text it was read from; see the top of this file.
+ * When the config was not read with source tracking on, or the order
+ * of its sections has changed, it is written with
+ * xconfigWriteConfigFile() instead.
+ */
+
+int xconfigPatchConfigFile(const char *filename, XConfigPtr cptr)
+{
+    XConfigSourcePtr source = cptr->source;
+    XConfigSpanPtr span;
+    PatchRec patch;
+    FILE *cf;
+    char *locale;
+    size_t pos, end;
+    ssize_t leading = 0;
+    int i, n, commentChanged, ret = FALSE;
+
+    if (!source || !source->text) {
+        return xconfigWriteConfigFile(filename, cptr);
+    }
+
+    memset(&patch, 0, sizeof(patch));
+
+    n = patch.nspans = source->nspans;
+    patch.spans = calloc(n + 1, sizeof(XConfigSpanPtr));
+    patch.present = calloc(n + 1, 1);
+
+    if (!patch.spans || !patch.present || !BuildSpanMap(&patch.map, source)) {
+        goto fallback;
+    }
+
+    for (i = 0, span = source->spans; span; span = span->next) {
+        patch.spans[i++] = span;
+    }
+
+    if (!MarkConfig(&patch, cptr)) {
+        goto fallback;
+    }
+
+    commentChanged = (HashComment(cptr->comment) != source->commentHash);
+
+    if (commentChanged) {
+        leading = LeadingCommentLen(source, cptr->comment);
+        if (leading < 0) {
+            goto fallback;
+        }
+    }
+
+    if ((cf = xconfigOpenForWriting(filename, &locale)) == NULL) {
+        goto done;
+    }
+
+    pos = 0;
+
+    if (commentChanged) {
+
+        /*
+         * replace the comments at the start of the file, keeping the
+         * white space after them, or a blank line if there was none
+         */
+
+        pos = CommentsEnd(source->text, 0, n ? patch.spans[0]->start :
+                                              source->len);
+        if (WriteLeadingComment(cf, cptr->comment, leading) &&
+            (pos == source->len || source->text[pos] != '\n')) {
+            fputc('\n', cf);
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        span = patch.spans[i];
+
+        fwrite(source->text + pos, 1, span->start - pos, cf);
+        pos = span->end;
+
+        if (patch.present[i]) {
+            WriteSpan(cf, source->text, span);
+            continue;
+        }
+
+        /* leave out the rest of a removed section's last line */
+
+        for (end = pos; end < source->len; end++) {
+            if (source->text[end] == '\n') {
+                pos = end + 1;
+                break;
+            }
+            if (source->text[end] != ' ' && source->text[end] != '\t') {
+                break;
+            }
+        }
+    }
+
+    fwrite(source->text + pos, 1, source->len - pos, cf);
+
+    if (source->len && source->text[source->len - 1] != '\n') {
+        fputc('\n', cf);
+    }
+
+    WriteNewSections(cf, &patch, cptr);
+
+    xconfigCloseForWriting(cf, locale);
+    ret = TRUE;
+    goto done;
+
+ fallback:
+
+    ret = xconfigWriteConfigFile(filename, cptr);
+
+ done:
+
+    free(patch.map.slots);
+    free(patch.spans);
+    free(patch.present);
+
+    return ret;
+}
@@ -0,0 +1,503 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * Stream.c - event-driven reading of a config file.
+ *
+ * xconfigStreamConfigFile() runs the same scanner as
+ * xconfigReadConfigFile(), but only tracks the section structure of
+ * the file: each line is handed to the caller's callbacks as soon as
+ * it has been scanned, and nothing is kept once it has been.  No
+ * config is allocated, and strings are not pooled; the text passed to
+ * the callbacks is copied into a buffer that is reused for each event.
+ *
+ * Since the individual keywords of each section are not known here,
+ * an entry is taken to be a word that starts a line, along with what
+ * follows it up to the next such word.  Strings and numbers may start
+ * a line, continuing the entry before them, as the other parsers
+ * allow.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xf86Parser.h"
+#include "xf86tokens.h"
+#include "Configint.h"
+#include "xf86keywordhash.h"
+
+XCONFIG_KEYWORD_TABLE(StreamTab);
+
+/* deepest nesting of sections, subsections and modes accepted */
+#define STREAM_MAX_DEPTH 8
+
+typedef struct {
+    XConfigValueType type;
+    const char *tok;            /* within the parser's data */
+    size_t len;
+    double num;
+} StreamTokenRec;
+
+typedef struct {
+    int token;                  /* SECTION, SUBSECTION or MODE */
+    const char *name;           /* within the parser's data */
+    size_t len;
+} StreamBlockRec;
+
+typedef struct {
+    XConfigParserPtr parser;
+    const XConfigStreamHandlerRec *handler;
+    void *data;
+
+    StreamTokenRec *tokens;     /* keyword and values of current entry */
+    int ntokens;                /* 0 when there is no current entry */
+    int tokensLen;
+    int entryLine;
+    int lastLine;               /* line of the entry's last token */
+
+    XConfigValueRec *values;    /* values passed to handler->entry */
+    int valuesLen;
+    char *text;                 /* strings passed to the handler */
+    size_t textLen;
+
+    StreamBlockRec open[STREAM_MAX_DEPTH];
+    int depth;
+} StreamRec, *StreamPtr;
+
+
+static const char *BlockKind(int token)
+{
+    switch (token) {
+    case SECTION:    return "Section";
+    case SUBSECTION: return "SubSection";
+    default:         return "Mode";
+    }
+}
+
+
+static int BlockEnd(int token)
+{
+    switch (token) {
+    case SECTION:    return ENDSECTION;
+    case SUBSECTION: return ENDSUBSECTION;
+    default:         return ENDMODE;
+    }
+}
+
+
+/*
+ * GetText() - make sure the text buffer holds at least len bytes;
+ * returns FALSE if it cannot be grown.
+ */
+
+static int GetText(StreamPtr s, size_t len)
+{
+    char *text;
+
+    if (len <= s->textLen) {
+        return TRUE;
+    }
+
+    text = realloc(s->text, len);
+    if (!text) {
+        return FALSE;
+    }
+
+    s->text = text;
+    s->textLen = len;
+
+    return TRUE;
+}
+
+
+/*
+ * CopyText() - copy the len bytes at str, and a terminating NUL, to
+ * *pos in the text buffer, advancing *pos past them.
+ */
+
+static const char *CopyText(StreamPtr s, size_t *pos,
+                            const char *str, size_t len)
+{
+    char *m = s->text + *pos;
+
+    memcpy(m, str, len);
+    m[len] = '\0';
+    *pos += len + 1;
+
+    return m;
+}
+
+
+/*
+ * AddToken() - append a token to the current entry, starting a new
+ * entry if there is none.
+ */
+
+static int AddToken(StreamPtr s, XConfigValueType type, const char *tok,
+                    size_t len, int line, XConfigError *error)
+{
+    XConfigParserPtr parser = s->parser;
+    StreamTokenRec *t;
+
+    if (s->ntokens == s->tokensLen) {
+        int n = s->tokensLen ? 2 * s->tokensLen : 16;
+        t = realloc(s->tokens, n * sizeof(StreamTokenRec));
+        if (!t) {
+            *error = XCONFIG_RETURN_ALLOCATION_ERROR;
+            return FALSE;
+        }
+        s->tokens = t;
+        s->tokensLen = n;
+    }
+
+    if (!s->ntokens) {
+        s->entryLine = line;
+    }
+    s->lastLine = line;
+
+    t = &s->tokens[s->ntokens++];
+    t->type = type;
+    t->tok = tok;
+    t->len = len;
+    t->num = (type == XCONFIG_VALUE_NUMBER) ? parser->val.realnum : 0.0;
+
+    return TRUE;
+}
+
+
+/*
+ * FlushEntry() - pass the current entry, if any, to the handler.
+ * Returns FALSE if the handler asked to stop; *error is set if memory
+ * could not be allocated.
+ */
+
+static int FlushEntry(StreamPtr s, XConfigError *error)
+{
+    int i, n = s->ntokens - 1;
+    size_t len = 0, pos = 0;
+    const char *keyword;
+
+    s->ntokens = 0;
+
+    if (n < 0 || !s->handler->entry) {
+        return TRUE;
+    }
+
+    for (i = 0; i <= n; i++) {
+        len += s->tokens[i].len + 1;
+    }
+
+    if (n > s->valuesLen) {
+        XConfigValueRec *values = realloc(s->values,
+                                          n * sizeof(XConfigValueRec));
+        if (!values) {
+            *error = XCONFIG_RETURN_ALLOCATION_ERROR;
+            return FALSE;
+        }
+        s->values = values;
+        s->valuesLen = n;
+    }
+
+    if (!GetText(s, len)) {
+        *error = XCONFIG_RETURN_ALLOCATION_ERROR;
+        return FALSE;
+    }
+
+    keyword = CopyText(s, &pos, s->tokens[0].tok, s->tokens[0].len);
+
+    for (i = 0; i < n; i++) {
+        s->values[i].type = s->tokens[i + 1].type;
+        s->values[i].str = CopyText(s, &pos, s->tokens[i + 1].tok,
+                                    s->tokens[i + 1].len);
+        s->values[i].num = s->tokens[i + 1].num;
+    }
+
+    return s->handler->entry(s->data, keyword, s->values, n, s->entryLine);
+}
+
+
+/*
+ * BeginBlock() - handle a Section, SubSection or Mode keyword, whose
+ * name is the next token.  Returns FALSE if the handler asked to stop
+ * or on error, in which case *error is set.
+ */
+
+static int BeginBlock(StreamPtr s, int token, int line, XConfigError *error)
+{
+    XConfigParserPtr parser = s->parser;
+    StreamBlockRec *block;
+    size_t pos = 0;
+    const char *name;
+
+    if (xconfigGetSubToken(parser, NULL) != STRING) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, QUOTE_MSG,
+                              BlockKind(token));
+        *error = XCONFIG_RETURN_PARSE_ERROR;
+        return FALSE;
+    }
+
+    if (s->depth == STREAM_MAX_DEPTH) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                              BlockKind(token));
+        *error = XCONFIG_RETURN_PARSE_ERROR;
+        return FALSE;
+    }
+
+    block = &s->open[s->depth++];
+    block->token = token;
+    block->name = parser->tok;
+    block->len = parser->tokLen;
+
+    if (!GetText(s, block->len + 1)) {
+        *error = XCONFIG_RETURN_ALLOCATION_ERROR;
+        return FALSE;
+    }
+
+    name = CopyText(s, &pos, block->name, block->len);
+
+    if (token == SECTION) {
+        xconfigSetSection(parser, name);
+    }
+
+    if (!s->handler->sectionBegin) {
+        return TRUE;
+    }
+
+    return s->handler->sectionBegin(s->data, BlockKind(token), name, line);
+}
+
+
+/*
+ * EndBlock() - handle an EndSection, EndSubSection or EndMode keyword,
+ * which must close the innermost open block.
+ */
+
+static int EndBlock(StreamPtr s, int token, int line, XConfigError *error)
+{
+    XConfigParserPtr parser = s->parser;
+    StreamBlockRec *block;
+    size_t pos = 0;
+    const char *name;
+
+    if (s->depth == 0 || BlockEnd(s->open[s->depth - 1].token) != token) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                              xconfigTokenString(parser));
+        *error = XCONFIG_RETURN_PARSE_ERROR;
+        return FALSE;
+    }
+
+    block = &s->open[--s->depth];
+
+    if (!s->handler->sectionEnd) {
+        return TRUE;
+    }
+
+    if (!GetText(s, block->len + 1)) {
+        *error = XCONFIG_RETURN_ALLOCATION_ERROR;
+        return FALSE;
+    }
+
+    name = CopyText(s, &pos, block->name, block->len);
+
+    return s->handler->sectionEnd(s->data, BlockKind(block->token), name,
+                                  line);
+}
+
+
+/*
+ * ReadOption() - handle an Option keyword and the name and optional
+ * value that follow it.
+ */
+
+static int ReadOption(StreamPtr s, int line, XConfigError *error)
+{
+    XConfigParserPtr parser = s->parser;
+    const char *nameTok, *name, *value = NULL;
+    size_t nameLen, pos = 0;
+    int token;
+
+    if (xconfigGetSubToken(parser, NULL) != STRING) {
+        xconfigParserErrorMsg(parser, ParseErrorMsg, BAD_OPTION_MSG);
+        *error = XCONFIG_RETURN_PARSE_ERROR;
+        return FALSE;
+    }
+
+    nameTok = parser->tok;
+    nameLen = parser->tokLen;
+
+    token = xconfigGetSubToken(parser, NULL);
+    if (token != STRING) {
+        xconfigUnGetToken(parser, token);
+    }
+
+    if (!s->handler->option) {
+        return TRUE;
+    }
+
+    if (!GetText(s, nameLen + 1 +
+                 ((token == STRING) ? parser->tokLen + 1 : 0))) {
+        *error = XCONFIG_RETURN_ALLOCATION_ERROR;
+        return FALSE;
+    }
+
+    name = CopyText(s, &pos, nameTok, nameLen);
+    if (token == STRING) {
+        value = CopyText(s, &pos, parser->tok, parser->tokLen);
+    }
+
+    return s->handler->option(s->data, name, value, line);
+}
+
+
+/*
+ * ReadToken() - handle one token of the config file.  Returns FALSE
+ * once reading should stop, setting *error if that is due to an error.
+ */
+
+static int ReadToken(StreamPtr s, int token, XConfigError *error)
+{
+    XConfigParserPtr parser = s->parser;
+    int line = parser->lineNo;
+    const char *tok;
+    size_t len;
+
+    /*
+     * a word at the start of a line, a keyword, or EOF ends the current
+     * entry; values at the start of a line continue it
+     */
+
+    if (s->ntokens && token != STRING && token != NUMBER &&
+        token != COMMA && token != DASH &&
+        (line != s->lastLine || token != ERROR_TOKEN)) {
+        if (!FlushEntry(s, error)) {
+            return FALSE;
+        }
+    }
+
+    switch (token) {
+
+    case EOF_TOKEN:
+        if (s->depth) {
+            xconfigParserErrorMsg(parser, ParseErrorMsg, UNEXPECTED_EOF_MSG);
+            *error = XCONFIG_RETURN_PARSE_ERROR;
+        }
+        return FALSE;
+
+    case SECTION:
+        if (s->depth == 0) {
+            return BeginBlock(s, token, line, error);
+        }
+        break;
+
+    case SUBSECTION:
+        if (s->depth) {
+            return BeginBlock(s, token, line, error);
+        }
+        break;
+
+    case MODE:
+        if (s->depth == 0) {
+            break;
+        }
+
+        /* "Mode" is also a keyword taking a number in the DRI section */
+
+        tok = parser->tok;
+        len = parser->tokLen;
+        token = xconfigGetSubToken(parser, NULL);
+        xconfigUnGetToken(parser, token);
+        if (token == STRING) {
+            return BeginBlock(s, MODE, line, error);
+        }
+        return AddToken(s, XCONFIG_VALUE_WORD, tok, len, line, error);
+
+    case ENDSECTION:
+    case ENDSUBSECTION:
+    case ENDMODE:
+        return EndBlock(s, token, line, error);
+
+    case OPTION:
+        if (s->depth) {
+            return ReadOption(s, line, error);
+        }
+        break;
+
+    case ERROR_TOKEN:
+        if (s->depth) {
+            return AddToken(s, XCONFIG_VALUE_WORD, parser->tok,
+                            parser->tokLen, line, error);
+        }
+        break;
+
+    case STRING:
+    case NUMBER:
+    case COMMA:
+    case DASH:
+        if (s->ntokens) {
+            return AddToken(s, (token == STRING) ? XCONFIG_VALUE_STRING :
+                               (token == NUMBER) ? XCONFIG_VALUE_NUMBER :
+                                                   XCONFIG_VALUE_WORD,
+                            parser->tok, parser->tokLen, line, error);
+        }
+        break;
+    }
+
+    xconfigParserErrorMsg(parser, ParseErrorMsg, INVALID_KEYWORD_MSG,
+                          xconfigTokenString(parser));
+    *error = XCONFIG_RETURN_PARSE_ERROR;
+
+    return FALSE;
+}
+
+
+/*
+ * xconfigStreamConfigFile() - read the XConfig file opened in the given
+ * parser context, passing its sections, options and other entries to
+ * handler in the order they appear, along with data.  No config is
+ * built.  Returns XCONFIG_RETURN_SUCCESS when the whole file was read
+ * or a callback asked to stop; a syntax error stops reading, but the
+ * events before it will already have been reported.
+ */
+
+XConfigError xconfigStreamConfigFile(XConfigParserPtr parser,
+                                     const XConfigStreamHandlerRec *handler,
+                                     void *data)
+{
+    XConfigError error = XCONFIG_RETURN_SUCCESS;
+    StreamRec s;
+    int token;
+
+    memset(&s, 0, sizeof(s));
+    s.parser = parser;
+    s.handler = handler;
+    s.data = data;
+
+    parser->skipping = TRUE;
+
+    do {
+        token = xconfigGetSubTokenWithTab(parser, NULL, &StreamTab);
+    } while (ReadToken(&s, token, &error));
+
+    parser->skipping = FALSE;
+
+    free(s.tokens);
+    free(s.values);
+    free(s.text);
+
+    return error;
+}
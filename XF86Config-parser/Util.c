@@ -111,23 +111,23 @@ char *xconfigStrcat(const char *str, ...)
 
 #define NV_FMT_BUF_LEN 64
 
-extern int configLineNo;
-extern char *configSection;
-extern char *configPath;
+/*
+ * FormatString() - return the formatted string, in a malloc(3)ed
+ * string.
+ */
 
-void xconfigErrorMsg(MsgType t, char *fmt, ...)
+static char *FormatString(char *fmt, va_list ap)
 {
-    va_list ap;
+    va_list aq;
     int len, current_len = NV_FMT_BUF_LEN;
-    char *b, *pre = NULL, *msg;
-    char scratch[64];
+    char *b;
 
     b = xconfigAlloc(current_len);
     
     while (1) {
-        va_start(ap, fmt);
-        len = vsnprintf(b, current_len, fmt, ap);
-        va_end(ap);
+        va_copy(aq, ap);
+        len = vsnprintf(b, current_len, fmt, aq);
+        va_end(aq);
 
         if ((len > -1) && (len < current_len)) {
             break;
@@ -141,19 +141,36 @@ void xconfigErrorMsg(MsgType t, char *fmt, ...)
         b = xconfigAlloc(current_len);
     }
 
+    return b;
+}
+
+/*
+ * FormatErrorMsg() - return the formatted message, in a malloc(3)ed
+ * string; parse messages are prefixed with the location of the error,
+ * and validation messages with the name of the file being validated.
+ */
+
+static char *FormatErrorMsg(MsgType t, const char *path, int lineNo,
+                            const char *section, char *fmt, va_list ap)
+{
+    char *b, *pre = NULL, *msg;
+    char scratch[64];
+
+    b = FormatString(fmt, ap);
+
     switch (t) {
     case ParseErrorMsg:
-        sprintf(scratch, "%d", configLineNo);
+        sprintf(scratch, "%d", lineNo);
         pre = xconfigStrcat("Parse error on line ", scratch, " of section ",
-                         configSection, " in file ", configPath, ".\n", NULL);
+                         section, " in file ", path, ".\n", NULL);
         break;
     case ParseWarningMsg:
-        sprintf(scratch, "%d", configLineNo);
+        sprintf(scratch, "%d", lineNo);
         pre = xconfigStrcat("Parse warning on line ", scratch, " of section ",
-                         configSection, " in file ", configPath, ".\n", NULL);
+                         section, " in file ", path, ".\n", NULL);
         break;
     case ValidationErrorMsg:
-        pre = xconfigStrcat("Data incomplete in file ", configPath, ".\n", NULL);
+        pre = xconfigStrcat("Data incomplete in file ", path, ".\n", NULL);
         break;
     case InternalErrorMsg: break;
     case WriteErrorMsg: break;
@@ -166,15 +183,280 @@ void xconfigErrorMsg(MsgType t, char *fmt, ...)
     if (pre) {
         msg = xconfigStrcat(pre, b, NULL);
     } else {
-        msg = strdup(b);
+        msg = xconfigStrdup(b);
     }
     
+    free(b);
+    if (pre) free(pre);
+
+    return msg;
+}
+
+/*
+ * PrintErrorMsg() - format the message and pass it to xconfigPrint().
+ */
+
+static void PrintErrorMsg(MsgType t, const char *path, int lineNo,
+                          const char *section, char *fmt, va_list ap)
+{
+    char *msg = FormatErrorMsg(t, path, lineNo, section, fmt, ap);
+
     /* call back into the host to print the message */
 
     xconfigPrint(t, msg);
 
-    
-    free(b);
     free(msg);
-    if (pre) free(pre);
+}
+
+/*
+ * the code given to each collected message made with one of the *_MSG
+ * formats in Configint.h; other messages are coded by their type
+ */
+
+static const struct {
+    const char *fmt;
+    const char *code;
+} DiagnosticCodes[] = {
+    { BAD_OPTION_MSG, "BAD_OPTION" },
+    { INVALID_KEYWORD_MSG, "INVALID_KEYWORD" },
+    { INVALID_SECTION_MSG, "INVALID_SECTION" },
+    { UNEXPECTED_EOF_MSG, "UNEXPECTED_EOF" },
+    { QUOTE_MSG, "QUOTE" },
+    { NUMBER_MSG, "NUMBER" },
+    { POSITIVE_INT_MSG, "POSITIVE_INT" },
+    { ZAXISMAPPING_MSG, "ZAXISMAPPING" },
+    { AUTOREPEAT_MSG, "AUTOREPEAT" },
+    { XLEDS_MSG, "XLEDS" },
+    { DACSPEED_MSG, "DACSPEED" },
+    { DISPLAYSIZE_MSG, "DISPLAYSIZE" },
+    { HORIZSYNC_MSG, "HORIZSYNC" },
+    { VERTREFRESH_MSG, "VERTREFRESH" },
+    { VIEWPORT_MSG, "VIEWPORT" },
+    { VIRTUAL_MSG, "VIRTUAL" },
+    { WEIGHT_MSG, "WEIGHT" },
+    { BLACK_MSG, "BLACK" },
+    { WHITE_MSG, "WHITE" },
+    { SCREEN_MSG, "SCREEN" },
+    { INVALID_SCR_MSG, "INVALID_SCR" },
+    { INPUTDEV_MSG, "INPUTDEV" },
+    { INACTIVE_MSG, "INACTIVE" },
+    { UNDEFINED_SCREEN_MSG, "UNDEFINED_SCREEN" },
+    { UNDEFINED_MONITOR_MSG, "UNDEFINED_MONITOR" },
+    { UNDEFINED_MODES_MSG, "UNDEFINED_MODES" },
+    { UNDEFINED_DEVICE_MSG, "UNDEFINED_DEVICE" },
+    { UNDEFINED_ADAPTOR_MSG, "UNDEFINED_ADAPTOR" },
+    { ADAPTOR_REF_TWICE_MSG, "ADAPTOR_REF_TWICE" },
+    { UNDEFINED_DEVICE_LAY_MSG, "UNDEFINED_DEVICE_LAY" },
+    { UNDEFINED_INPUT_MSG, "UNDEFINED_INPUT" },
+    { NO_IDENT_MSG, "NO_IDENT" },
+    { ONLY_ONE_MSG, "ONLY_ONE" },
+    { UNDEFINED_DRIVER_MSG, "UNDEFINED_DRIVER" },
+    { UNDEFINED_INPUTDRIVER_MSG, "UNDEFINED_INPUTDRIVER" },
+    { INVALID_GAMMA_MSG, "INVALID_GAMMA" },
+    { GROUP_MSG, "GROUP" },
+    { MULTIPLE_MSG, "MULTIPLE" },
+    { OBSOLETE_MSG, "OBSOLETE" },
+    { MOVED_TO_FLAGS_MSG, "MOVED_TO_FLAGS" },
+    { NUMBER_RANGE_MSG, "NUMBER_RANGE" },
+    { OPTION_VALUE_MSG, "OPTION_VALUE" },
+};
+
+static const char *DiagnosticCode(MsgType t, const char *fmt)
+{
+    unsigned int i;
+
+    for (i = 0; i < sizeof(DiagnosticCodes) / sizeof(DiagnosticCodes[0]);
+         i++) {
+        if (strcmp(fmt, DiagnosticCodes[i].fmt) == 0) {
+            return DiagnosticCodes[i].code;
+        }
+    }
+
+    switch (t) {
+    case ParseErrorMsg: return "PARSE_ERROR";
+    case ParseWarningMsg: return "PARSE_WARNING";
+    case ValidationErrorMsg: return "VALIDATION_ERROR";
+    default: return "UNKNOWN";
+    }
+}
+
+/*
+ * CollectErrorMsg() - add the message to the end of diagnostics, rather
+ * than print it.
+ */
+
+static void CollectErrorMsg(XConfigDiagnosticsPtr diagnostics, MsgType t,
+                            const char *path, int lineNo,
+                            const char *section, char *fmt, va_list ap)
+{
+    XConfigDiagnosticPtr d = xconfigAlloc(sizeof(XConfigDiagnosticRec));
+
+    d->type = t;
+    d->code = DiagnosticCode(t, fmt);
+    d->file = xconfigStrdup(path);
+    d->line = lineNo;
+    d->section = xconfigStrdup(section);
+    d->message = FormatString(fmt, ap);
+
+    *diagnostics->tail = d;
+    diagnostics->tail = &d->next;
+
+    if (t != ParseWarningMsg) {
+        diagnostics->errors++;
+    }
+}
+
+void xconfigErrorMsg(MsgType t, char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    PrintErrorMsg(t, NULL, 0, NULL, fmt, ap);
+    va_end(ap);
+}
+
+/*
+ * xconfigParserErrorMsg() - report a message about the current
+ * location of the given parser; in error recovery mode, the message is
+ * collected rather than printed.
+ */
+
+void xconfigParserErrorMsg(XConfigParserPtr parser, MsgType t,
+                           char *fmt, ...)
+{
+    XConfigMessagePtr held;
+    va_list ap;
+
+    va_start(ap, fmt);
+    if (parser->holdMessages) {
+        held = xconfigAlloc(sizeof(XConfigMessageRec));
+        held->type = t;
+        held->msg = FormatErrorMsg(t, parser->path, parser->lineNo,
+                                   parser->section, fmt, ap);
+        *parser->heldTail = held;
+        parser->heldTail = &held->next;
+    } else if (parser->recover) {
+        CollectErrorMsg(&parser->diagnostics, t, parser->path,
+                        parser->lineNo, parser->section, fmt, ap);
+    } else {
+        PrintErrorMsg(t, parser->path, parser->lineNo, parser->section,
+                      fmt, ap);
+    }
+    va_end(ap);
+}
+
+/*
+ * xconfigHoldMessages() - have xconfigParserErrorMsg() keep the
+ * parser's messages, rather than print them, until
+ * xconfigReleaseMessages() is called.  This lets a parser running on
+ * another thread report its messages in order with everything else.
+ */
+
+void xconfigHoldMessages(XConfigParserPtr parser)
+{
+    parser->holdMessages = TRUE;
+    parser->heldTail = &parser->held;
+}
+
+/*
+ * xconfigReleaseMessages() - print the parser's held messages in the
+ * order they were made, or just discard them if print is FALSE, and
+ * stop holding messages.
+ */
+
+void xconfigReleaseMessages(XConfigParserPtr parser, int print)
+{
+    XConfigMessagePtr held, next;
+
+    for (held = parser->held; held; held = next) {
+        next = held->next;
+        if (print) {
+            xconfigPrint(held->type, held->msg);
+        }
+        free(held->msg);
+        free(held);
+    }
+
+    parser->held = NULL;
+    parser->heldTail = &parser->held;
+    parser->holdMessages = FALSE;
+}
+
+/*
+ * xconfigValidationErrorMsg() - report a validation error in the
+ * given config; the message is collected rather than printed while
+ * the config is validated in error recovery mode.
+ */
+
+void xconfigValidationErrorMsg(XConfigPtr p, char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    if (p->diagnostics) {
+        CollectErrorMsg(p->diagnostics, ValidationErrorMsg, p->filename, 0,
+                        NULL, fmt, ap);
+    } else {
+        PrintErrorMsg(ValidationErrorMsg, p->filename, 0, NULL, fmt, ap);
+    }
+    va_end(ap);
+}
+
+
+/*
+ * xconfigFreeDiagnostics() - discard the messages collected by the
+ * parser, and the sections it found had failed to parse.
+ */
+
+void xconfigFreeDiagnostics(XConfigParserPtr parser)
+{
+    XConfigDiagnosticPtr d, next;
+    XConfigFailedSectionPtr failed, nextFailed;
+
+    for (d = parser->diagnostics.list; d; d = next) {
+        next = d->next;
+        free((char *) d->file);
+        free((char *) d->section);
+        free((char *) d->message);
+        free(d);
+    }
+
+    for (failed = parser->diagnostics.failed; failed; failed = nextFailed) {
+        nextFailed = failed->next;
+        free(failed->identifier);
+        free(failed);
+    }
+
+    parser->diagnostics.list = NULL;
+    parser->diagnostics.tail = &parser->diagnostics.list;
+    parser->diagnostics.errors = 0;
+    parser->diagnostics.failed = NULL;
+}
+
+
+/*
+ * xconfigSectionFailed() - return whether p is being validated in
+ * error recovery mode, and a section of the given kind that failed to
+ * parse has the given Identifier, or one that is not known; with a
+ * NULL identifier, whether any section of the kind failed.  Reporting
+ * such a section as missing would only repeat its parse error.
+ */
+
+int xconfigSectionFailed(XConfigPtr p, int token, const char *identifier)
+{
+    XConfigFailedSectionPtr failed;
+
+    if (!p->diagnostics) {
+        return FALSE;
+    }
+
+    for (failed = p->diagnostics->failed; failed; failed = failed->next) {
+        if (failed->token == token &&
+            (!identifier || !failed->identifier ||
+             xconfigNameCompare(identifier, failed->identifier) == 0)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
 }
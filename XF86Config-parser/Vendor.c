@@ -58,50 +58,41 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec VendorSubTab[] =
-{
-    {ENDSUBSECTION, "endsubsection"},
-    {IDENTIFIER, "identifier"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeVendorSubList
+XCONFIG_KEYWORD_TABLE(VendorSubTab);
 
 XConfigVendSubPtr
-xconfigParseVendorSubSection (void)
+xconfigParseVendorSubSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigVendSubPtr, XConfigVendSubRec)
 
-    while ((token = xconfigGetToken (VendorSubTab)) != ENDSUBSECTION)
+    while ((token = xconfigGetToken (parser, &VendorSubTab)) != ENDSUBSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)))
+            if (xconfigGetSubToken (parser, &(ptr->comment)))
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
 
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -109,46 +100,35 @@ xconfigParseVendorSubSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
-static XConfigSymTabRec VendorTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {OPTION, "option"},
-    {SUBSECTION, "subsection"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeVendorList
+XCONFIG_KEYWORD_TABLE(VendorTab);
 
 XConfigVendorPtr
-xconfigParseVendorSection (void)
+xconfigParseVendorSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigVendorPtr, XConfigVendorRec)
 
-    while ((token = xconfigGetToken (VendorTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &VendorTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case SUBSECTION:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "SubSection");
             {
                 HANDLE_LIST (subs, xconfigParseVendorSubSection,
@@ -159,7 +139,7 @@ xconfigParseVendorSection (void)
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
 
@@ -171,8 +151,6 @@ xconfigParseVendorSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
 void
 xconfigPrintVendorSection (FILE * cf, XConfigVendorPtr ptr)
 {
@@ -202,40 +180,6 @@ xconfigPrintVendorSection (FILE * cf, XConfigVendorPtr ptr)
     }
 }
 
-void
-xconfigFreeVendorList (XConfigVendorPtr *p)
-{
-    if (p == NULL || *p == NULL)
-        return;
-
-    xconfigFreeVendorSubList (&((*p)->subs));
-    TEST_FREE ((*p)->identifier);
-    TEST_FREE ((*p)->comment);
-    xconfigFreeOptionList (&((*p)->options));
-    free (*p);
-    *p = NULL;
-}
-
-void
-xconfigFreeVendorSubList (XConfigVendSubPtr *ptr)
-{
-    XConfigVendSubPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->name);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeOptionList (&((*ptr)->options));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
 XConfigVendorPtr
 xconfigFindVendor (const char *name, XConfigVendorPtr list)
 {
@@ -57,50 +57,41 @@
 #include "xf86Parser.h"
 #include "xf86tokens.h"
 #include "Configint.h"
+#include "xf86keywordhash.h"
 
-extern LexRec val;
-
-static XConfigSymTabRec VideoPortTab[] =
-{
-    {ENDSUBSECTION, "endsubsection"},
-    {IDENTIFIER, "identifier"},
-    {OPTION, "option"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeVideoPortList
+XCONFIG_KEYWORD_TABLE(VideoPortTab);
 
 XConfigVideoPortPtr
-xconfigParseVideoPortSubSection (void)
+xconfigParseVideoPortSubSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
     PARSE_PROLOGUE (XConfigVideoPortPtr, XConfigVideoPortRec)
 
-    while ((token = xconfigGetToken (VideoPortTab)) != ENDSUBSECTION)
+    while ((token = xconfigGetToken (parser, &VideoPortTab)) != ENDSUBSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             has_ident = TRUE;
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
 
         case EOF_TOKEN:
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -108,71 +99,56 @@ xconfigParseVideoPortSubSection (void)
     return ptr;
 }
 
-#undef CLEANUP
-
-static XConfigSymTabRec VideoAdaptorTab[] =
-{
-    {ENDSECTION, "endsection"},
-    {IDENTIFIER, "identifier"},
-    {VENDOR, "vendorname"},
-    {BOARD, "boardname"},
-    {BUSID, "busid"},
-    {DRIVER, "driver"},
-    {OPTION, "option"},
-    {SUBSECTION, "subsection"},
-    {-1, ""},
-};
-
-#define CLEANUP xconfigFreeVideoAdaptorList
+XCONFIG_KEYWORD_TABLE(VideoAdaptorTab);
 
 XConfigVideoAdaptorPtr
-xconfigParseVideoAdaptorSection (void)
+xconfigParseVideoAdaptorSection (XConfigParserPtr parser)
 {
     int has_ident = FALSE;
     int token;
 
     PARSE_PROLOGUE (XConfigVideoAdaptorPtr, XConfigVideoAdaptorRec)
 
-    while ((token = xconfigGetToken (VideoAdaptorTab)) != ENDSECTION)
+    while ((token = xconfigGetToken (parser, &VideoAdaptorTab)) != ENDSECTION)
     {
         switch (token)
         {
         case COMMENT:
-            ptr->comment = xconfigAddComment(ptr->comment, val.str);
+            ptr->comment = xconfigParserAddComment(parser, ptr->comment);
             break;
         case IDENTIFIER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Identifier");
-            ptr->identifier = val.str;
+            ptr->identifier = parser->val.str;
             if (has_ident == TRUE)
                 Error (MULTIPLE_MSG, "Identifier");
             has_ident = TRUE;
             break;
         case VENDOR:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Vendor");
-            ptr->vendor = val.str;
+            ptr->vendor = parser->val.str;
             break;
         case BOARD:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Board");
-            ptr->board = val.str;
+            ptr->board = parser->val.str;
             break;
         case BUSID:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "BusID");
-            ptr->busid = val.str;
+            ptr->busid = parser->val.str;
             break;
         case DRIVER:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "Driver");
-            ptr->driver = val.str;
+            ptr->driver = parser->val.str;
             break;
         case OPTION:
-            ptr->options = xconfigParseOption(ptr->options);
+            ptr->options = xconfigParseOption(parser, ptr->options);
             break;
         case SUBSECTION:
-            if (xconfigGetSubToken (&(ptr->comment)) != STRING)
+            if (xconfigGetSubToken (parser, &(ptr->comment)) != STRING)
                 Error (QUOTE_MSG, "SubSection");
             {
                 HANDLE_LIST (ports, xconfigParseVideoPortSubSection,
@@ -184,7 +160,7 @@ xconfigParseVideoAdaptorSection (void)
             Error (UNEXPECTED_EOF_MSG, NULL);
             break;
         default:
-            Error (INVALID_KEYWORD_MSG, xconfigTokenString ());
+            Error (INVALID_KEYWORD_MSG, xconfigTokenString (parser));
             break;
         }
     }
@@ -232,50 +208,6 @@ xconfigPrintVideoAdaptorSection (FILE * cf, XConfigVideoAdaptorPtr ptr)
 
 }
 
-void
-xconfigFreeVideoAdaptorList (XConfigVideoAdaptorPtr *ptr)
-{
-    XConfigVideoAdaptorPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->vendor);
-        TEST_FREE ((*ptr)->board);
-        TEST_FREE ((*ptr)->busid);
-        TEST_FREE ((*ptr)->driver);
-        TEST_FREE ((*ptr)->fwdref);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeVideoPortList (&((*ptr)->ports));
-        xconfigFreeOptionList (&((*ptr)->options));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
-void
-xconfigFreeVideoPortList (XConfigVideoPortPtr *ptr)
-{
-    XConfigVideoPortPtr prev;
-
-    if (ptr == NULL || *ptr == NULL)
-        return;
-
-    while (*ptr)
-    {
-        TEST_FREE ((*ptr)->identifier);
-        TEST_FREE ((*ptr)->comment);
-        xconfigFreeOptionList (&((*ptr)->options));
-        prev = *ptr;
-        *ptr = (*ptr)->next;
-        free (prev);
-    }
-}
-
 XConfigVideoAdaptorPtr
 xconfigFindVideoAdaptor (const char *ident, XConfigVideoAdaptorPtr p)
 {
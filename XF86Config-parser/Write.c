@@ -67,31 +67,151 @@
 #include <locale.h>
 
 
-int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
+/*
+ * PrintDeferredSections() - write out, unchanged, the text of the
+ * config's deferred sections of the given kind
+ */
+
+static void PrintDeferredSections(FILE *cf, XConfigPtr cptr,
+                                  unsigned int kind)
+{
+    XConfigDeferredPtr deferred;
+
+    for (deferred = cptr->deferred; deferred; deferred = deferred->next) {
+        if (deferred->kind == kind) {
+            fwrite(deferred->text, 1, deferred->len, cf);
+            fprintf(cf, "\n\n");
+        }
+    }
+}
+
+
+/*
+ * xconfigPrintOneSection() - print the single section node, of the
+ * given section token, just as xconfigWriteConfigFile() would print
+ * it; the rest of the list node is in is not printed.
+ */
+
+#define PRINT_ONE(func, type)                   \
+    {                                           \
+        type p = node;                          \
+        type next = p->next;                    \
+        p->next = NULL;                         \
+        func(cf, p);                            \
+        p->next = next;                         \
+    }
+
+void xconfigPrintOneSection(FILE *cf, int token, void *node)
+{
+    switch (token) {
+    case FILES_SECTION:
+        fprintf (cf, "Section \"Files\"\n");
+        xconfigPrintFileSection (cf, node);
+        fprintf (cf, "EndSection\n\n");
+        break;
+    case MODULE_SECTION:
+        fprintf (cf, "Section \"Module\"\n");
+        xconfigPrintModuleSection (cf, node);
+        fprintf (cf, "EndSection\n\n");
+        break;
+    case SERVERFLAGS_SECTION:
+        xconfigPrintServerFlagsSection (cf, node);
+        break;
+    case DRI_SECTION:
+        xconfigPrintDRISection (cf, node);
+        break;
+    case EXTENSIONS_SECTION:
+        xconfigPrintExtensionsSection (cf, node);
+        break;
+    case SERVERLAYOUT_SECTION:
+        PRINT_ONE(xconfigPrintLayoutSection, XConfigLayoutPtr);
+        break;
+    case VENDOR_SECTION:
+        PRINT_ONE(xconfigPrintVendorSection, XConfigVendorPtr);
+        break;
+    case KEYBOARD_SECTION:
+    case POINTER_SECTION:
+    case INPUTDEVICE_SECTION:
+        PRINT_ONE(xconfigPrintInputSection, XConfigInputPtr);
+        break;
+    case INPUTCLASS_SECTION:
+        PRINT_ONE(xconfigPrintInputClassSection, XConfigInputClassPtr);
+        break;
+    case VIDEOADAPTOR_SECTION:
+        PRINT_ONE(xconfigPrintVideoAdaptorSection, XConfigVideoAdaptorPtr);
+        break;
+    case MODES_SECTION:
+        PRINT_ONE(xconfigPrintModesSection, XConfigModesPtr);
+        break;
+    case MONITOR_SECTION:
+        PRINT_ONE(xconfigPrintMonitorSection, XConfigMonitorPtr);
+        break;
+    case DEVICE_SECTION:
+        PRINT_ONE(xconfigPrintDeviceSection, XConfigDevicePtr);
+        break;
+    case SCREEN_SECTION:
+        PRINT_ONE(xconfigPrintScreenSection, XConfigScreenPtr);
+        break;
+    }
+}
+
+#undef PRINT_ONE
+
+
+/*
+ * xconfigOpenForWriting() - open the named file for writing a config
+ * to, and set the standard "C" locale, so that the X configuration
+ * writer does not use locale-specific formatting.  The original
+ * locale is returned in *locale, for xconfigCloseForWriting() to
+ * restore.
+ */
+
+FILE *xconfigOpenForWriting(const char *filename, char **locale)
 {
     FILE *cf;
-    char *locale;
-    
+
     if ((cf = fopen(filename, "w")) == NULL)
     {
         xconfigErrorMsg(WriteErrorMsg, "Unable to open the file \"%s\" for "
                      "writing (%s).\n", filename, strerror(errno));
-        return FALSE;
+        return NULL;
     }
 
-    /*
-     * read the current locale and then set the standard "C" locale,
-     * so that the X configuration writer does not use locale-specific
-     * formatting.  After writing the configuration file, we restore
-     * the original locale.
-     */
-
-    locale = setlocale(LC_ALL, NULL);
+    *locale = setlocale(LC_ALL, NULL);
     
-    if (locale) locale = strdup(locale);
+    if (*locale) *locale = strdup(*locale);
 
     setlocale(LC_ALL, "C");
+
+    return cf;
+}
+
+
+/*
+ * xconfigCloseForWriting() - close the file opened by
+ * xconfigOpenForWriting() and restore the original locale.
+ */
+
+void xconfigCloseForWriting(FILE *cf, char *locale)
+{
+    fclose(cf);
+
+    if (locale) {
+        setlocale(LC_ALL, locale);
+        free(locale);
+    }
+}
+
+
+int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
+{
+    FILE *cf;
+    char *locale;
     
+    if ((cf = xconfigOpenForWriting(filename, &locale)) == NULL)
+    {
+        return FALSE;
+    }
     
     if (cptr->comment)
         fprintf (cf, "%s\n", cptr->comment);
@@ -104,20 +224,30 @@ int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
         fprintf (cf, "EndSection\n\n");
     }
 
+    PrintDeferredSections (cf, cptr, XCONFIG_DEFER_FILES);
+
     if (cptr->modules) {
         fprintf (cf, "Section \"Module\"\n");
         xconfigPrintModuleSection (cf, cptr->modules);
         fprintf (cf, "EndSection\n\n");
     }
 
+    PrintDeferredSections (cf, cptr, XCONFIG_DEFER_MODULE);
+
     xconfigPrintVendorSection (cf, cptr->vendors);
 
+    PrintDeferredSections (cf, cptr, XCONFIG_DEFER_VENDOR);
+
     xconfigPrintServerFlagsSection (cf, cptr->flags);
 
+    PrintDeferredSections (cf, cptr, XCONFIG_DEFER_FLAGS);
+
     xconfigPrintInputSection (cf, cptr->inputs);
 
     xconfigPrintInputClassSection (cf, cptr->inputclasses);
 
+    PrintDeferredSections (cf, cptr, XCONFIG_DEFER_INPUTCLASS);
+
     xconfigPrintVideoAdaptorSection (cf, cptr->videoadaptors);
 
     xconfigPrintModesSection (cf, cptr->modes);
@@ -128,18 +258,18 @@ int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
 
     xconfigPrintScreenSection (cf, cptr->screens);
 
+    /*
+     * a deferred DRI section is not written either, as the parsed one
+     * is not
+     */
+
     xconfigPrintDRISection (cf, cptr->dri);
 
     xconfigPrintExtensionsSection (cf, cptr->extensions);
 
-    fclose(cf);
-
-    /* restore the original locale */
+    PrintDeferredSections (cf, cptr, XCONFIG_DEFER_EXTENSIONS);
 
-    if (locale) {
-        setlocale(LC_ALL, locale);
-        free(locale);
-    }
+    xconfigCloseForWriting(cf, locale);
 
     return TRUE;
 }
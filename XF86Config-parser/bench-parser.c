@@ -0,0 +1,642 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * bench-parser.c
+ */
+
+/*
+ * Measures the throughput of the config file parser, so that changes
+ * to it can be judged by numbers.  Built with "make bench-parser"; it
+ * is not installed.
+ *
+ * The config text is either a synthetic config made by Generate(), of
+ * a size and shape set on the command line, or read from the files
+ * named on the command line.  Each phase is run the given number of
+ * times over the text in memory, and reported separately:
+ *
+ *   scan      xconfigGetToken() over the whole text
+ *   read      xconfigReadConfigFile(), which also validates the config
+ *   validate  xconfigValidateConfig() on the config read
+ *   write     xconfigWriteConfigFile() to a temporary file
+ *
+ * MB/s is of the config text, or of the text written for the write
+ * phase; tokens/s counts the tokens of the config text.  Allocations
+ * are counted by wrapping malloc(3) and friends at link time (see the
+ * Makefile), and are per run.  Peak RSS is that of the process by the
+ * end of the phase.
+ *
+ * With -r, the config is instead read once, and the size and number
+ * of each kind of record in it are reported, along with the peak RSS,
+ * so that the memory a config takes can be compared between changes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+#include "xf86tokens.h"
+
+
+/*
+ * Allocation counting; the linker sends the parser's calls to
+ * malloc(3) and friends here (-Wl,--wrap=malloc etc).
+ */
+
+static unsigned long Allocs;
+static unsigned long AllocBytes;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(const char *s);
+
+static void CountAlloc(size_t size)
+{
+    __sync_fetch_and_add(&Allocs, 1);
+    __sync_fetch_and_add(&AllocBytes, size);
+}
+
+void *__wrap_malloc(size_t size)
+{
+    CountAlloc(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    CountAlloc(nmemb * size);
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    CountAlloc(size);
+    return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *s)
+{
+    CountAlloc(strlen(s) + 1);
+    return __real_strdup(s);
+}
+
+
+/*
+ * xconfigPrint() - the parser's messages; only errors are shown, so
+ * that a config with warnings does not flood the results.
+ */
+
+void xconfigPrint(MsgType t, const char *msg)
+{
+    if (t == ParseErrorMsg || t == ValidationErrorMsg ||
+        t == InternalErrorMsg || t == WriteErrorMsg || t == ErrorMsg) {
+        fprintf(stderr, "%s\n", msg);
+    }
+}
+
+
+/*
+ * The shape of a generated config.
+ */
+
+typedef struct {
+    int screens;        /* Device, Monitor and Screen sections of each */
+    int options;        /* Option lines in each of those sections */
+    int modelines;      /* ModeLines in each Monitor section */
+    int comments;       /* percentage of lines followed by a comment */
+    int lineLength;     /* length of Option and comment lines */
+} GenerateOptionsRec;
+
+
+/*
+ * A growing buffer of config text.
+ */
+
+typedef struct {
+    char *text;
+    size_t len;
+    size_t size;
+    unsigned int seed;  /* for placing comments */
+} TextRec;
+
+static void Append(TextRec *t, const char *fmt, ...)
+{
+    va_list ap;
+    int len;
+
+    for (;;) {
+        va_start(ap, fmt);
+        len = vsnprintf(t->text + t->len, t->size - t->len, fmt, ap);
+        va_end(ap);
+
+        if (len >= 0 && t->len + len < t->size) {
+            break;
+        }
+
+        t->size = t->size ? t->size * 2 : 4096;
+        t->text = realloc(t->text, t->size);
+        if (!t->text) {
+            fprintf(stderr, "Out of memory.\n");
+            exit(1);
+        }
+    }
+
+    t->len += len;
+}
+
+static void Pad(TextRec *t, char c, int n)
+{
+    while (n-- > 0) {
+        Append(t, "%c", c);
+    }
+}
+
+
+/*
+ * Line() - append one line of a section, maybe followed by a comment
+ * line, as often as gop->comments says.
+ */
+
+static void Line(TextRec *t, const GenerateOptionsRec *gop,
+                 const char *fmt, ...)
+{
+    char buf[256];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    Append(t, "    %s\n", buf);
+
+    t->seed = t->seed * 1103515245 + 12345;
+    if ((int) ((t->seed >> 16) % 100) < gop->comments) {
+        Append(t, "    # ");
+        Pad(t, 'c', gop->lineLength - 6);
+        Append(t, "\n");
+    }
+}
+
+static void Options(TextRec *t, const GenerateOptionsRec *gop,
+                    const char *prefix)
+{
+    char name[64];
+    int i, len;
+
+    for (i = 0; i < gop->options; i++) {
+        len = snprintf(name, sizeof(name), "%sOption%d", prefix, i);
+        Append(t, "    Option \"%s\" \"", name);
+        Pad(t, 'v', gop->lineLength - len - 16);
+        Append(t, "\"\n");
+    }
+}
+
+
+/*
+ * Generate() - return a synthetic config of the given shape, in a
+ * malloc(3)ed buffer; its length is returned in *len.  The config is
+ * valid, so that all of it is parsed and validated.
+ */
+
+static char *Generate(const GenerateOptionsRec *gop, size_t *len)
+{
+    TextRec t = { NULL, 0, 0, 1 };
+    int i, j;
+
+    Append(&t, "# synthetic config generated by bench-parser\n\n");
+
+    Append(&t, "Section \"ServerLayout\"\n");
+    Line(&t, gop, "Identifier \"Layout0\"");
+    for (i = 0; i < gop->screens; i++) {
+        Line(&t, gop, "Screen %d \"Screen%d\" %d 0", i, i, i * 1920);
+    }
+    Line(&t, gop, "InputDevice \"Keyboard0\" \"CoreKeyboard\"");
+    Line(&t, gop, "InputDevice \"Mouse0\" \"CorePointer\"");
+    Append(&t, "EndSection\n\n");
+
+    Append(&t, "Section \"InputDevice\"\n");
+    Line(&t, gop, "Identifier \"Keyboard0\"");
+    Line(&t, gop, "Driver \"kbd\"");
+    Append(&t, "EndSection\n\n");
+
+    Append(&t, "Section \"InputDevice\"\n");
+    Line(&t, gop, "Identifier \"Mouse0\"");
+    Line(&t, gop, "Driver \"mouse\"");
+    Line(&t, gop, "Option \"Protocol\" \"auto\"");
+    Append(&t, "EndSection\n\n");
+
+    for (i = 0; i < gop->screens; i++) {
+        Append(&t, "Section \"Monitor\"\n");
+        Line(&t, gop, "Identifier \"Monitor%d\"", i);
+        Line(&t, gop, "VendorName \"Unknown\"");
+        Line(&t, gop, "HorizSync 28.0 - 33.0, 45.5 - 110.0");
+        Line(&t, gop, "VertRefresh 43.0 - 72.0");
+        for (j = 0; j < gop->modelines; j++) {
+            Line(&t, gop, "ModeLine \"1920x1080_%d\" 148.5 1920 2008 2052 "
+                 "2200 1080 1084 1089 1125 +hsync +vsync", j);
+        }
+        Options(&t, gop, "Monitor");
+        Append(&t, "EndSection\n\n");
+
+        Append(&t, "Section \"Device\"\n");
+        Line(&t, gop, "Identifier \"Device%d\"", i);
+        Line(&t, gop, "Driver \"nvidia\"");
+        Line(&t, gop, "BusID \"PCI:%d:0:0\"", i + 1);
+        Options(&t, gop, "Device");
+        Append(&t, "EndSection\n\n");
+
+        Append(&t, "Section \"Screen\"\n");
+        Line(&t, gop, "Identifier \"Screen%d\"", i);
+        Line(&t, gop, "Device \"Device%d\"", i);
+        Line(&t, gop, "Monitor \"Monitor%d\"", i);
+        Line(&t, gop, "DefaultDepth 24");
+        Options(&t, gop, "Screen");
+        Append(&t, "    SubSection \"Display\"\n");
+        Line(&t, gop, "Depth 24");
+        Line(&t, gop, "Modes \"1920x1080\" \"1280x1024\"");
+        Append(&t, "    EndSubSection\n");
+        Append(&t, "EndSection\n\n");
+    }
+
+    *len = t.len;
+
+    return t.text;
+}
+
+
+/*
+ * ReadFiles() - return the contents of the named files, one after
+ * another, in a malloc(3)ed buffer; its length is returned in *len.
+ */
+
+static char *ReadFiles(char **files, int n, size_t *len)
+{
+    char *text = NULL;
+    struct stat st;
+    FILE *f;
+    int i;
+
+    *len = 0;
+
+    for (i = 0; i < n; i++) {
+        if ((f = fopen(files[i], "r")) == NULL || fstat(fileno(f), &st) != 0) {
+            fprintf(stderr, "Unable to read \"%s\".\n", files[i]);
+            exit(1);
+        }
+        text = realloc(text, *len + st.st_size + 1);
+        if (!text) {
+            fprintf(stderr, "Out of memory.\n");
+            exit(1);
+        }
+        *len += fread(text + *len, 1, st.st_size, f);
+        text[(*len)++] = '\n';
+        fclose(f);
+    }
+
+    return text;
+}
+
+
+/*
+ * Results of one phase.
+ */
+
+typedef struct {
+    double seconds;             /* per run */
+    unsigned long allocs;       /* per run */
+    unsigned long allocBytes;   /* per run */
+    size_t bytes;               /* text scanned or written per run */
+} PhaseRec;
+
+static double Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void Start(PhaseRec *phase, double *start)
+{
+    memset(phase, 0, sizeof(*phase));
+    Allocs = AllocBytes = 0;
+    *start = Now();
+}
+
+static void Stop(PhaseRec *phase, double start, int runs)
+{
+    phase->seconds = (Now() - start) / runs;
+    phase->allocs = Allocs / runs;
+    phase->allocBytes = AllocBytes / runs;
+}
+
+static void Report(const char *name, const PhaseRec *phase,
+                   unsigned long tokens)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("%-9s %10.3f %10.1f %12.0f %10lu %12lu %10ld\n", name,
+           phase->seconds * 1e3,
+           phase->bytes / phase->seconds / (1024.0 * 1024.0),
+           tokens / phase->seconds,
+           phase->allocs, phase->allocBytes,
+           (long) usage.ru_maxrss);
+}
+
+
+/*
+ * Record counting, for -r.
+ */
+
+typedef struct {
+    unsigned long devices, monitors, modelines, screens, displays;
+    unsigned long adjacencies, options;
+} RecordCountsRec;
+
+static unsigned long CountOptions(XConfigOptionPtr opt)
+{
+    unsigned long n = 0;
+
+    for (; opt; opt = opt->next) n++;
+
+    return n;
+}
+
+static void CountRecords(XConfigPtr config, RecordCountsRec *n)
+{
+    XConfigDevicePtr device;
+    XConfigMonitorPtr monitor;
+    XConfigModeLinePtr modeline;
+    XConfigScreenPtr screen;
+    XConfigDisplayPtr display;
+    XConfigLayoutPtr layout;
+    XConfigAdjacencyPtr adj;
+
+    memset(n, 0, sizeof(*n));
+
+    for (device = config->devices; device; device = device->next) {
+        n->devices++;
+        n->options += CountOptions(device->options);
+    }
+    for (monitor = config->monitors; monitor; monitor = monitor->next) {
+        n->monitors++;
+        n->options += CountOptions(monitor->options);
+        for (modeline = monitor->modelines; modeline;
+             modeline = modeline->next) {
+            n->modelines++;
+        }
+    }
+    for (screen = config->screens; screen; screen = screen->next) {
+        n->screens++;
+        n->options += CountOptions(screen->options);
+        for (display = screen->displays; display; display = display->next) {
+            n->displays++;
+            n->options += CountOptions(display->options);
+        }
+    }
+    for (layout = config->layouts; layout; layout = layout->next) {
+        n->options += CountOptions(layout->options);
+        for (adj = layout->adjacencies; adj; adj = adj->next) {
+            n->adjacencies++;
+        }
+    }
+}
+
+static void ReportRecord(const char *name, size_t size, unsigned long count)
+{
+    printf("%-22s %6lu %10lu %12lu\n", name, (unsigned long) size, count,
+           (unsigned long) size * count);
+}
+
+
+/*
+ * ReportRecords() - print the size and number of each kind of record
+ * in config, and the peak RSS.
+ */
+
+static void ReportRecords(XConfigPtr config)
+{
+    RecordCountsRec n;
+    struct rusage usage;
+
+    CountRecords(config, &n);
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("%-22s %6s %10s %12s\n", "record", "bytes", "count", "total");
+    ReportRecord("XConfigDeviceRec", sizeof(XConfigDeviceRec), n.devices);
+    ReportRecord("XConfigMonitorRec", sizeof(XConfigMonitorRec),
+                 n.monitors);
+    ReportRecord("XConfigModeLineRec", sizeof(XConfigModeLineRec),
+                 n.modelines);
+    ReportRecord("XConfigScreenRec", sizeof(XConfigScreenRec), n.screens);
+    ReportRecord("XConfigDisplayRec", sizeof(XConfigDisplayRec),
+                 n.displays);
+    ReportRecord("XConfigAdjacencyRec", sizeof(XConfigAdjacencyRec),
+                 n.adjacencies);
+    ReportRecord("XConfigOptionRec", sizeof(XConfigOptionRec), n.options);
+    printf("\npeak RSS %ld KB\n", (long) usage.ru_maxrss);
+}
+
+
+/*
+ * Read() - read a config from text, exiting on failure.
+ */
+
+static XConfigPtr Read(const char *text, size_t len, int threads)
+{
+    XConfigParserPtr parser = xconfigAllocParser();
+    XConfigPtr config = NULL;
+
+    xconfigOpenConfigBuffer(parser, text, len, "bench");
+    if (threads) {
+        xconfigSetParallelParse(parser, threads, 0);
+    }
+
+    if (xconfigReadConfigFile(parser, &config) != XCONFIG_RETURN_SUCCESS) {
+        fprintf(stderr, "Unable to read the config.\n");
+        exit(1);
+    }
+
+    xconfigFreeParser(&parser);
+
+    return config;
+}
+
+
+static void Usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] [config-file ...]\n"
+            "\n"
+            "Benchmark the config file parser on the given config files,\n"
+            "or on a generated config.\n"
+            "\n"
+            "  -n RUNS     runs of each phase (default 20)\n"
+            "  -t THREADS  parse on this many threads (default 1)\n"
+            "  -s N        Device, Monitor and Screen sections of each "
+            "(default 100)\n"
+            "  -o N        Option lines in each of those (default 8)\n"
+            "  -m N        ModeLines in each Monitor (default 16)\n"
+            "  -c PERCENT  lines followed by a comment line (default 10)\n"
+            "  -l N        length of Option and comment lines (default 60)\n"
+            "  -g FILE     write the generated config to FILE and exit\n"
+            "  -r          report the records of the config read, and "
+            "exit\n",
+            prog);
+    exit(1);
+}
+
+
+int main(int argc, char *argv[])
+{
+    GenerateOptionsRec gop = { 100, 8, 16, 10, 60 };
+    XConfigParserPtr parser;
+    XConfigPtr config;
+    PhaseRec phase;
+    struct stat st;
+    char *text, *genFile = NULL, outFile[] = "/tmp/bench-parser.XXXXXX";
+    size_t len;
+    unsigned long tokens = 0;
+    double start;
+    int c, i, fd, runs = 20, threads = 0, records = FALSE;
+
+    while ((c = getopt(argc, argv, "n:t:s:o:m:c:l:g:r")) != -1) {
+        switch (c) {
+        case 'n': runs = atoi(optarg); break;
+        case 't': threads = atoi(optarg); break;
+        case 's': gop.screens = atoi(optarg); break;
+        case 'o': gop.options = atoi(optarg); break;
+        case 'm': gop.modelines = atoi(optarg); break;
+        case 'c': gop.comments = atoi(optarg); break;
+        case 'l': gop.lineLength = atoi(optarg); break;
+        case 'g': genFile = optarg; break;
+        case 'r': records = TRUE; break;
+        default: Usage(argv[0]);
+        }
+    }
+
+    if (runs < 1 || gop.screens < 1) {
+        Usage(argv[0]);
+    }
+
+    if (optind < argc) {
+        text = ReadFiles(argv + optind, argc - optind, &len);
+    } else {
+        text = Generate(&gop, &len);
+    }
+
+    if (genFile) {
+        FILE *f = fopen(genFile, "w");
+        if (!f || fwrite(text, 1, len, f) != len || fclose(f) != 0) {
+            fprintf(stderr, "Unable to write \"%s\".\n", genFile);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (records) {
+        config = Read(text, len, threads);
+        printf("%lu bytes\n\n", (unsigned long) len);
+        ReportRecords(config);
+        xconfigFreeConfig(&config);
+        free(text);
+        return 0;
+    }
+
+    if ((fd = mkstemp(outFile)) < 0) {
+        fprintf(stderr, "Unable to create a temporary file.\n");
+        return 1;
+    }
+    close(fd);
+
+    printf("%lu bytes, %d runs\n\n", (unsigned long) len, runs);
+    printf("%-9s %10s %10s %12s %10s %12s %10s\n", "phase", "ms/run",
+           "MB/s", "tokens/s", "allocs", "alloc bytes", "peak KB");
+
+    /* scan */
+
+    Start(&phase, &start);
+    for (i = 0; i < runs; i++) {
+        parser = xconfigAllocParser();
+        xconfigOpenConfigBuffer(parser, text, len, "bench");
+        parser->config = xconfigAllocConfig();
+        for (tokens = 0; xconfigGetToken(parser, NULL) != EOF_TOKEN;
+             tokens++);
+        xconfigFreeConfig(&parser->config);
+        xconfigFreeParser(&parser);
+    }
+    Stop(&phase, start, runs);
+    phase.bytes = len;
+    Report("scan", &phase, tokens);
+
+    /* read */
+
+    Start(&phase, &start);
+    for (i = 0; i < runs; i++) {
+        config = Read(text, len, threads);
+        xconfigFreeConfig(&config);
+    }
+    Stop(&phase, start, runs);
+    phase.bytes = len;
+    Report("read", &phase, tokens);
+
+    /* validate */
+
+    config = Read(text, len, threads);
+
+    Start(&phase, &start);
+    for (i = 0; i < runs; i++) {
+        if (!xconfigValidateConfig(config)) {
+            fprintf(stderr, "Unable to validate the config.\n");
+            return 1;
+        }
+    }
+    Stop(&phase, start, runs);
+    phase.bytes = len;
+    Report("validate", &phase, tokens);
+
+    /* write */
+
+    Start(&phase, &start);
+    for (i = 0; i < runs; i++) {
+        if (!xconfigWriteConfigFile(outFile, config)) {
+            return 1;
+        }
+    }
+    Stop(&phase, start, runs);
+    phase.bytes = (stat(outFile, &st) == 0) ? st.st_size : 0;
+    Report("write", &phase, tokens);
+
+    unlink(outFile);
+    xconfigFreeConfig(&config);
+    free(text);
+
+    return 0;
+}
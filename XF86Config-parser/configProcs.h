@@ -29,97 +29,178 @@
 
 #include "xf86Parser.h"
 
+/* A keyword table; see Configint.h */
+typedef struct __XConfigKeywordTableRec XConfigKeywordTableRec;
+
+/* A saved scanner position; see Configint.h */
+typedef struct __XConfigScanStateRec XConfigScanStateRec;
+
+
+/* Arena.c */
+void xconfigFreeArena(XConfigArenaPtr *arena);
+void *xconfigArenaGrow(XConfigPtr config, void *ptr,
+                       size_t oldSize, size_t newSize);
+void xconfigAdoptConfig(XConfigPtr config, XConfigPtr from);
 
 /* Device.c */
-XConfigDevicePtr xconfigParseDeviceSection(void);
+XConfigDevicePtr xconfigParseDeviceSection(XConfigParserPtr parser);
 void xconfigPrintDeviceSection(FILE *cf, XConfigDevicePtr ptr);
 int xconfigValidateDevice(XConfigPtr p);
 
 /* Files.c */
-XConfigFilesPtr xconfigParseFilesSection(void);
+XConfigFilesPtr xconfigParseFilesSection(XConfigParserPtr parser);
 void xconfigPrintFileSection(FILE *cf, XConfigFilesPtr ptr);
 
 /* Flags.c */
-XConfigFlagsPtr xconfigParseFlagsSection(void);
+XConfigFlagsPtr xconfigParseFlagsSection(XConfigParserPtr parser);
 void xconfigPrintServerFlagsSection(FILE *f, XConfigFlagsPtr flags);
 
 /* Input.c */
-XConfigInputPtr xconfigParseInputSection(void);
-XConfigInputClassPtr xconfigParseInputClassSection(void);
+XConfigInputPtr xconfigParseInputSection(XConfigParserPtr parser);
+XConfigInputClassPtr xconfigParseInputClassSection(XConfigParserPtr parser);
 void xconfigPrintInputSection(FILE *f, XConfigInputPtr ptr);
 void xconfigPrintInputClassSection(FILE *f, XConfigInputClassPtr ptr);
 int xconfigValidateInput (XConfigPtr p);
 
 /* Keyboard.c */
-XConfigInputPtr xconfigParseKeyboardSection(void);
+XConfigInputPtr xconfigParseKeyboardSection(XConfigParserPtr parser);
 
 /* Layout.c */
-XConfigLayoutPtr xconfigParseLayoutSection(void);
+XConfigLayoutPtr xconfigParseLayoutSection(XConfigParserPtr parser);
 void xconfigPrintLayoutSection(FILE *cf, XConfigLayoutPtr ptr);
+void xconfigResolveLayoutReferences(XConfigPtr p);
 int xconfigValidateLayout(XConfigPtr p);
 int xconfigSanitizeLayout(XConfigPtr p, const char *screenName,
                           GenerateOptions *gop);
 
 /* Module.c */
-XConfigLoadPtr xconfigParseModuleSubSection(XConfigLoadPtr head, char *name);
-XConfigModulePtr xconfigParseModuleSection(void);
+XConfigLoadPtr xconfigParseModuleSubSection(XConfigParserPtr parser,
+                                            XConfigLoadPtr head,
+                                            const char *name);
+XConfigModulePtr xconfigParseModuleSection(XConfigParserPtr parser);
 void xconfigPrintModuleSection(FILE *cf, XConfigModulePtr ptr);
 
 /* Monitor.c */
-XConfigModeLinePtr xconfigParseModeLine(void);
-XConfigModeLinePtr xconfigParseVerboseMode(void);
-XConfigMonitorPtr xconfigParseMonitorSection(void);
-XConfigModesPtr xconfigParseModesSection(void);
+XConfigModeLinePtr xconfigParseModeLine(XConfigParserPtr parser);
+XConfigModeLinePtr xconfigParseVerboseMode(XConfigParserPtr parser);
+XConfigMonitorPtr xconfigParseMonitorSection(XConfigParserPtr parser);
+XConfigModesPtr xconfigParseModesSection(XConfigParserPtr parser);
 void xconfigPrintMonitorSection(FILE *cf, XConfigMonitorPtr ptr);
 void xconfigPrintModesSection(FILE *cf, XConfigModesPtr ptr);
+void xconfigResolveMonitorModes(XConfigPtr p, XConfigMonitorPtr monitor);
 int xconfigValidateMonitor(XConfigPtr p, XConfigScreenPtr screen);
 
 /* Pointer.c */
-XConfigInputPtr xconfigParsePointerSection(void);
+XConfigInputPtr xconfigParsePointerSection(XConfigParserPtr parser);
 
 /* Screen.c */
-XConfigDisplayPtr xconfigParseDisplaySubSection(void);
-XConfigScreenPtr xconfigParseScreenSection(void);
+XConfigDisplayPtr xconfigParseDisplaySubSection(XConfigParserPtr parser);
+XConfigScreenPtr xconfigParseScreenSection(XConfigParserPtr parser);
 void xconfigPrintScreenSection(FILE *cf, XConfigScreenPtr ptr);
+void xconfigResolveScreenReferences(XConfigPtr p);
 int xconfigValidateScreen(XConfigPtr p);
 int xconfigSanitizeScreen(XConfigPtr p);
 
 /* Vendor.c */
-XConfigVendorPtr xconfigParseVendorSection(void);
-XConfigVendSubPtr xconfigParseVendorSubSection (void);
+XConfigVendorPtr xconfigParseVendorSection(XConfigParserPtr parser);
+XConfigVendSubPtr xconfigParseVendorSubSection(XConfigParserPtr parser);
 void xconfigPrintVendorSection(FILE * cf, XConfigVendorPtr ptr);
 
 /* Video.c */
-XConfigVideoPortPtr xconfigParseVideoPortSubSection(void);
-XConfigVideoAdaptorPtr xconfigParseVideoAdaptorSection(void);
+XConfigVideoPortPtr xconfigParseVideoPortSubSection(XConfigParserPtr parser);
+XConfigVideoAdaptorPtr
+xconfigParseVideoAdaptorSection(XConfigParserPtr parser);
 void xconfigPrintVideoAdaptorSection(FILE *cf, XConfigVideoAdaptorPtr ptr);
 
 /* Read.c */
+void xconfigResolveReferences(XConfigPtr p);
 int xconfigValidateConfig(XConfigPtr p);
+void xconfigParserAddListItem(XConfigParserPtr parser, GenericListPtr *pHead,
+                              GenericListPtr item);
+void xconfigForgetListEnds(XConfigParserPtr parser);
+void *xconfigParserAllocRecord(XConfigParserPtr parser, size_t size);
 
 /* Scan.c */
-int xconfigGetToken(XConfigSymTabRec *tab);
-int xconfigGetSubToken(char **comment);
-int xconfigGetSubTokenWithTab(char **comment, XConfigSymTabRec *tab);
-void xconfigUnGetToken(int token);
-char *xconfigTokenString(void);
-void xconfigSetSection(char *section);
-int xconfigGetStringToken(XConfigSymTabRec *tab);
-char *xconfigGetConfigFileName(void);
+int xconfigGetToken(XConfigParserPtr parser,
+                    const XConfigKeywordTableRec *tab);
+int xconfigGetSubToken(XConfigParserPtr parser, char **comment);
+int xconfigGetSubTokenWithTab(XConfigParserPtr parser, char **comment,
+                              const XConfigKeywordTableRec *tab);
+void xconfigUnGetToken(XConfigParserPtr parser, int token);
+char *xconfigTokenString(XConfigParserPtr parser);
+void xconfigSetSection(XConfigParserPtr parser, const char *section);
+int xconfigGetStringToken(XConfigParserPtr parser,
+                          const XConfigKeywordTableRec *tab);
+char *xconfigGetConfigFileName(XConfigParserPtr parser);
+char *xconfigParserAddComment(XConfigParserPtr parser, char *cur);
+XConfigParserPtr xconfigForkParser(XConfigParserPtr parser,
+                                   XConfigPtr config);
+void xconfigSaveScanState(XConfigParserPtr parser,
+                          XConfigScanStateRec *state);
+void xconfigRestoreScanState(XConfigParserPtr parser,
+                             const XConfigScanStateRec *state);
+int xconfigSkipSection(XConfigParserPtr parser);
+void xconfigSkipToSection(XConfigParserPtr parser);
+unsigned int xconfigNameHash(const char *s);
+
+/* Source.c */
+void xconfigAddSourceSpan(XConfigPtr config, void *node, int token,
+                          int deferred, size_t start, size_t end);
+void xconfigJoinSourceSpans(XConfigPtr config, XConfigPtr from);
+void xconfigNoteFirstSection(XConfigPtr config);
+void xconfigKeepSource(XConfigPtr config, const char *text, size_t len);
+void xconfigMarkSourceClean(XConfigPtr config);
+void xconfigReplaceSourceNode(XConfigPtr config, void *old, void *node,
+                              int token);
 
 /* Write.c */
+void xconfigPrintOneSection(FILE *cf, int token, void *node);
+FILE *xconfigOpenForWriting(const char *filename, char **locale);
+void xconfigCloseForWriting(FILE *cf, char *locale);
 
 /* DRI.c */
-XConfigBuffersPtr xconfigParseBuffers (void);
-XConfigDRIPtr xconfigParseDRISection (void);
+XConfigBuffersPtr xconfigParseBuffers(XConfigParserPtr parser);
+XConfigDRIPtr xconfigParseDRISection(XConfigParserPtr parser);
 void xconfigPrintDRISection (FILE * cf, XConfigDRIPtr ptr);
 
+/* Index.c */
+void *xconfigIndexFind(XConfigPtr config, int kind, const char *ident);
+void xconfigIndexAdd(XConfigPtr config, int kind, void *node);
+
+/* OptionMap.c */
+XConfigOptionPtr xconfigOptionMapFind(XConfigPtr config,
+                                      XConfigOptionPtr head, const char *name);
+void xconfigOptionMapAppend(XConfigPtr config, XConfigOptionPtr *pHead,
+                            XConfigOptionPtr opt);
+void xconfigOptionMapRemove(XConfigPtr config, XConfigOptionPtr *pHead,
+                            XConfigOptionPtr opt);
+void xconfigOptionListsChanged(void);
+void xconfigInvalidateOptionMaps(XConfigPtr config);
+void xconfigAdoptOptionMaps(XConfigPtr config, XConfigPtr from);
+
+/* OptionType.c */
+int xconfigTypeOption(XConfigPtr config, XConfigOptionPtr opt);
+
+/* Intern.c */
+XConfigStringPoolPtr xconfigAllocStringPool(XConfigPtr config);
+const char *xconfigInternLen(XConfigPtr config, const char *s, size_t len);
+void xconfigMergeStringPool(XConfigPtr config, XConfigPtr from);
+void xconfigNameKey(XConfigPtr config, const char *s, XConfigNameKeyRec *key);
+int xconfigNameKeysEqual(const XConfigNameKeyRec *k1,
+                         const XConfigNameKeyRec *k2);
+
 /* Util.c */
 void *xconfigAlloc(size_t size);
 void xconfigErrorMsg(MsgType, char *fmt, ...);
+void xconfigParserErrorMsg(XConfigParserPtr parser, MsgType, char *fmt, ...);
+void xconfigValidationErrorMsg(XConfigPtr p, char *fmt, ...);
+void xconfigHoldMessages(XConfigParserPtr parser);
+void xconfigReleaseMessages(XConfigParserPtr parser, int print);
+void xconfigFreeDiagnostics(XConfigParserPtr parser);
+int xconfigSectionFailed(XConfigPtr p, int token, const char *identifier);
 
 /* Extensions.c */
-XConfigExtensionsPtr xconfigParseExtensionsSection (void);
+XConfigExtensionsPtr xconfigParseExtensionsSection(XConfigParserPtr parser);
 void xconfigPrintExtensionsSection (FILE * cf, XConfigExtensionsPtr ptr);
 
 /* Generate.c */
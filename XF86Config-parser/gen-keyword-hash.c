@@ -0,0 +1,217 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * gen-keyword-hash.c - turns each keyword table in xf86keywords.h into
+ * a perfect hash on the canonical keyword name, and prints the result
+ * as a header suitable for use with XCONFIG_KEYWORD_TABLE().
+ *
+ * The output is shipped as xf86keywordhash.h, so that programs that
+ * build the parser from src.mk need not run this; the nvidia-xconfig
+ * build checks that the shipped header is up to date.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Configint.h"
+#include "xf86keywords.h"
+
+/* the header of the generated file */
+static const char License[] =
+    "/*\n"
+    " * nvidia-xconfig: A tool for manipulating X config files,\n"
+    " * specifically for use by the NVIDIA Linux graphics driver.\n"
+    " *\n"
+    " * Copyright (C) 2005 NVIDIA Corporation\n"
+    " *\n"
+    " * This program is free software; you can redistribute it and/or modify it\n"
+    " * under the terms and conditions of the GNU General Public License,\n"
+    " * version 2, as published by the Free Software Foundation.\n"
+    " *\n"
+    " * This program is distributed in the hope that it will be useful, but WITHOUT\n"
+    " * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or\n"
+    " * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for\n"
+    " * more details.\n"
+    " *\n"
+    " * You should have received a copy of the GNU General Public License\n"
+    " * along with this program; if not, see <http://www.gnu.org/licenses>.\n"
+    " *\n"
+    " *\n";
+
+/* give up on a table size after this many seeds, and try a larger one */
+#define MAX_SEEDS (1 << 20)
+
+
+/*
+ * CanonicalChar() - return the next character of the canonical form of
+ * the keyword at *name, advancing *name past it; '\0' at the end.
+ */
+
+static char CanonicalChar(const char **name)
+{
+    char c;
+
+    while (**name == '_' || **name == ' ' || **name == '\t') {
+        (*name)++;
+    }
+
+    c = **name;
+    if (c == '\0') {
+        return c;
+    }
+    (*name)++;
+
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+
+/*
+ * KeywordHash() - hash the canonical form of name, matching what
+ * LookupKeyword() in Scan.c computes for a token.
+ */
+
+static unsigned int KeywordHash(const char *name)
+{
+    unsigned int h = XCONFIG_KEYWORD_HASH_INIT;
+    char c;
+
+    while ((c = CanonicalChar(&name)) != '\0') {
+        h = XCONFIG_KEYWORD_HASH_STEP(h, c);
+    }
+
+    return h;
+}
+
+
+static int SameKeyword(const char *s1, const char *s2)
+{
+    char c1, c2;
+
+    do {
+        c1 = CanonicalChar(&s1);
+        c2 = CanonicalChar(&s2);
+    } while (c1 == c2 && c1 != '\0');
+
+    return c1 == c2;
+}
+
+
+/*
+ * FindSeed() - find a seed for which every keyword in tab lands in a
+ * different slot of a table with mask + 1 slots; keywords whose
+ * canonical names collide with an earlier entry are dropped, as the
+ * earlier entry is the one a linear search would have found.  Fills
+ * slots[] with the index into tab of each slot's keyword, or -1.
+ */
+
+static int FindSeed(const XConfigSymTabRec *tab, unsigned int mask,
+                    unsigned int *seed, int *slots)
+{
+    unsigned int s, slot;
+    int i, j, ok;
+
+    for (s = 0; s < MAX_SEEDS; s++) {
+        for (i = 0; i <= (int) mask; i++) {
+            slots[i] = -1;
+        }
+        ok = 1;
+        for (i = 0; ok && tab[i].token != -1; i++) {
+            slot = XCONFIG_KEYWORD_SLOT(KeywordHash(tab[i].name), s, mask);
+            j = slots[slot];
+            if (j == -1) {
+                slots[slot] = i;
+            } else if (!SameKeyword(tab[j].name, tab[i].name)) {
+                ok = 0;
+            }
+        }
+        if (ok) {
+            *seed = s;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static void PrintTable(const char *name, const XConfigSymTabRec *tab)
+{
+    unsigned int mask, seed = 0;
+    int n, i, *slots = NULL;
+    const char *c;
+
+    for (n = 0; tab[n].token != -1; n++);
+
+    /* start with at least twice as many slots as keywords */
+
+    for (mask = 1; mask + 1 < 2 * n; mask = (mask << 1) | 1);
+
+    for (;; mask = (mask << 1) | 1) {
+        slots = realloc(slots, (mask + 1) * sizeof(int));
+        if (!slots) {
+            fprintf(stderr, "Out of memory.\n");
+            exit(1);
+        }
+        if (FindSeed(tab, mask, &seed, slots)) {
+            break;
+        }
+    }
+
+    printf("#define %s_SEED %uU\n", name, seed);
+    printf("#define %s_MASK %uU\n", name, mask);
+    printf("#define %s_SLOTS \\\n{ \\\n", name);
+
+    for (i = 0; i <= (int) mask; i++) {
+        if (slots[i] == -1) {
+            printf("    { -1, NULL }, \\\n");
+            continue;
+        }
+        printf("    { %d, \"", tab[slots[i]].token);
+        for (c = tab[slots[i]].name; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                putchar('\\');
+            }
+            putchar(*c);
+        }
+        printf("\" }, \\\n");
+    }
+
+    printf("}\n\n");
+
+    free(slots);
+}
+
+
+int main(void)
+{
+    size_t i;
+
+    printf("%s", License);
+    printf(" * xf86keywordhash.h - generated by gen-keyword-hash from\n"
+           " * xf86keywords.h; do not edit.  Run 'make update-keyword-hash'\n"
+           " * after changing the keyword tables.\n"
+           " */\n\n");
+
+    for (i = 0; i < sizeof(xconfigKeywordTables) /
+                    sizeof(xconfigKeywordTables[0]); i++) {
+        PrintTable(xconfigKeywordTables[i].name, xconfigKeywordTables[i].tab);
+    }
+
+    return 0;
+}
@@ -1,29 +1,48 @@
 # makefile fragment included by nvidia-xconfig and nvidia-settings
 
+XCONFIG_PARSER_SRC += Arena.c
+XCONFIG_PARSER_SRC += Cache.c
 XCONFIG_PARSER_SRC += DRI.c
 XCONFIG_PARSER_SRC += Device.c
 XCONFIG_PARSER_SRC += Extensions.c
 XCONFIG_PARSER_SRC += Files.c
 XCONFIG_PARSER_SRC += Flags.c
 XCONFIG_PARSER_SRC += Generate.c
+XCONFIG_PARSER_SRC += Index.c
 XCONFIG_PARSER_SRC += Input.c
+XCONFIG_PARSER_SRC += Intern.c
 XCONFIG_PARSER_SRC += Keyboard.c
 XCONFIG_PARSER_SRC += Layout.c
 XCONFIG_PARSER_SRC += Merge.c
 XCONFIG_PARSER_SRC += Module.c
 XCONFIG_PARSER_SRC += Monitor.c
+XCONFIG_PARSER_SRC += OptionMap.c
+XCONFIG_PARSER_SRC += OptionType.c
 XCONFIG_PARSER_SRC += Pointer.c
 XCONFIG_PARSER_SRC += Read.c
 XCONFIG_PARSER_SRC += Scan.c
 XCONFIG_PARSER_SRC += Screen.c
+XCONFIG_PARSER_SRC += Source.c
+XCONFIG_PARSER_SRC += Stream.c
 XCONFIG_PARSER_SRC += Util.c
 XCONFIG_PARSER_SRC += Vendor.c
 XCONFIG_PARSER_SRC += Video.c
 XCONFIG_PARSER_SRC += Write.c
 
+XCONFIG_PARSER_GEN_KEYWORD_HASH_SRC = gen-keyword-hash.c
+
+XCONFIG_PARSER_BENCH_SRC = bench-parser.c
+
+XCONFIG_PARSER_TEST_SRC = test-parser.c
+
 XCONFIG_PARSER_EXTRA_DIST += Configint.h
 XCONFIG_PARSER_EXTRA_DIST += configProcs.h
 XCONFIG_PARSER_EXTRA_DIST += xf86Parser.h
 XCONFIG_PARSER_EXTRA_DIST += xf86tokens.h
+XCONFIG_PARSER_EXTRA_DIST += xf86keywords.h
+XCONFIG_PARSER_EXTRA_DIST += xf86keywordhash.h
+XCONFIG_PARSER_EXTRA_DIST += $(XCONFIG_PARSER_GEN_KEYWORD_HASH_SRC)
+XCONFIG_PARSER_EXTRA_DIST += $(XCONFIG_PARSER_BENCH_SRC)
+XCONFIG_PARSER_EXTRA_DIST += $(XCONFIG_PARSER_TEST_SRC)
 XCONFIG_PARSER_EXTRA_DIST += src.mk
 
@@ -0,0 +1,784 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * test-parser.c
+ */
+
+/*
+ * Checks of config file parser behavior that is easy to break without
+ * noticing, run by "make check"; it is not installed.  Each test reads
+ * small configs from memory, both serially and on several threads, and
+ * prints what it found wrong.  The exit status is the number of tests
+ * that failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xf86Parser.h"
+#include "Configint.h"
+#include "nvidia-xconfig.h"
+
+
+/*
+ * xconfigPrint() - the parser's messages are what some tests look at,
+ * through the diagnostics of error recovery mode; they are not shown.
+ */
+
+void xconfigPrint(MsgType t, const char *msg)
+{
+}
+
+
+static int Threads;             /* parse on this many threads, or 0 */
+static int Failed;              /* the current test has failed */
+
+/*
+ * Fail() - report why the current test failed, followed by the text
+ * in question, if any.
+ */
+
+static void Fail(const char *why, const char *text)
+{
+    printf("  %s%s%s\n", why, text ? ":\n" : "", text ? text : "");
+    Failed = TRUE;
+}
+
+
+/*
+ * Read() - read a config from text, with the given parser settings;
+ * the parser is returned in *parserPtr if that is not NULL, and freed
+ * otherwise.  Returns NULL if the config could not be read.
+ */
+
+static XConfigPtr Read(const char *text, int track, int recover,
+                       XConfigParserPtr *parserPtr)
+{
+    XConfigParserPtr parser = xconfigAllocParser();
+    XConfigPtr config = NULL;
+
+    xconfigOpenConfigBuffer(parser, text, strlen(text), "test");
+    xconfigSetParallelParse(parser, Threads, 0);
+    xconfigSetSourceTracking(parser, track);
+    xconfigSetErrorRecovery(parser, recover);
+
+    if (xconfigReadConfigFile(parser, &config) != XCONFIG_RETURN_SUCCESS) {
+        xconfigFreeConfig(&config);
+    }
+
+    if (parserPtr) {
+        *parserPtr = parser;
+    } else {
+        xconfigFreeParser(&parser);
+    }
+
+    return config;
+}
+
+
+/*
+ * ReadFile() - return the contents of the named file, in a malloc(3)ed
+ * string, or NULL.
+ */
+
+static char *ReadFile(const char *name)
+{
+    FILE *f = fopen(name, "r");
+    char *text = NULL;
+    size_t len = 0, n;
+
+    if (!f) {
+        return NULL;
+    }
+
+    do {
+        text = realloc(text, len + 4096 + 1);
+        n = fread(text + len, 1, 4096, f);
+        len += n;
+    } while (n == 4096);
+
+    text[len] = '\0';
+    fclose(f);
+
+    return text;
+}
+
+
+/*
+ * PatchConfig() - replace the banner at the top of config's comment as
+ * nvidia-xconfig does, free config, and return the text written by
+ * xconfigPatchConfigFile(), or NULL.
+ */
+
+static char *PatchConfig(XConfigPtr config)
+{
+    static const char prefix[] = "# nvidia-xconfig: ";
+    char name[] = "/tmp/test-parser.XXXXXX", *comment, *line, *eol;
+    char *patched = NULL;
+    int fd;
+
+    /* take out the old banner's lines, and put the new one first */
+
+    comment = xconfigStrcat(prefix, "X configuration file generated by "
+                            "nvidia-xconfig\n", prefix, "test\n", NULL);
+
+    for (line = config->comment; line && *line; line = eol) {
+        eol = strchr(line, '\n');
+        eol = eol ? eol + 1 : line + strlen(line);
+        if (strncmp(line, prefix, sizeof(prefix) - 1) != 0) {
+            comment = realloc(comment, strlen(comment) + (eol - line) + 1);
+            strncat(comment, line, eol - line);
+        }
+    }
+
+    config->comment = xconfigArenaStrdup(config, comment);
+    free(comment);
+
+    if ((fd = mkstemp(name)) >= 0) {
+        close(fd);
+        if (xconfigPatchConfigFile(name, config)) {
+            patched = ReadFile(name);
+        }
+        unlink(name);
+    }
+
+    xconfigFreeConfig(&config);
+
+    return patched;
+}
+
+
+/*
+ * Patch() - read text with source tracking on, and patch it as
+ * PatchConfig() does.
+ */
+
+static char *Patch(const char *text)
+{
+    XConfigPtr config = Read(text, TRUE, FALSE, NULL);
+
+    return config ? PatchConfig(config) : NULL;
+}
+
+
+/*
+ * Write() - return the text xconfigWriteConfigFile() writes for config,
+ * or NULL.
+ */
+
+static char *Write(XConfigPtr config)
+{
+    char name[] = "/tmp/test-parser.XXXXXX";
+    char *text = NULL;
+    int fd;
+
+    if ((fd = mkstemp(name)) >= 0) {
+        close(fd);
+        if (xconfigWriteConfigFile(name, config)) {
+            text = ReadFile(name);
+        }
+        unlink(name);
+    }
+
+    return text;
+}
+
+
+/*
+ * TestPatchTwice() - patching the output of xconfigPatchConfigFile()
+ * again the same way must not change it, and the comments between
+ * sections must be kept.
+ */
+
+static void TestPatchTwice(void)
+{
+    static const char text[] =
+        "# the config of a test machine\n"
+        "#   with a second line\n"
+        "\n"
+        "Section \"Device\"\n"
+        "    Identifier \"Device0\"   # the only card\n"
+        "    Driver     \"nvidia\"\n"
+        "EndSection\n"
+        "\n"
+        "# the monitor\n"
+        "\n"
+        "Section \"Monitor\"\n"
+        "    Identifier \"Monitor0\"\n"
+        "EndSection   # after the monitor\n"
+        "\n"
+        "    # indented, between sections\n"
+        "Section \"Screen\"\n"
+        "    Identifier \"Screen0\"\n"
+        "    Device     \"Device0\"\n"
+        "    Monitor    \"Monitor0\"\n"
+        "EndSection\n"
+        "\n"
+        "# at the end\n";
+    static const char * const kept[] = {
+        "# the config of a test machine\n#   with a second line\n\n",
+        "# the only card\n",
+        "\n# the monitor\n\nSection",
+        "EndSection   # after the monitor\n",
+        "\n    # indented, between sections\nSection",
+        "EndSection\n\n# at the end\n",
+    };
+    char *once, *twice;
+    size_t i;
+
+    once = Patch(text);
+    twice = once ? Patch(once) : NULL;
+
+    if (!once || !twice) {
+        Fail("the config could not be patched", NULL);
+    } else {
+        if (strcmp(once, twice) != 0) {
+            Fail("patching again changed the text", twice);
+        }
+        if (strncmp(once, "# nvidia-xconfig: ", 18) != 0) {
+            Fail("the banner is not at the top", once);
+        }
+        for (i = 0; i < sizeof(kept) / sizeof(kept[0]); i++) {
+            if (!strstr(once, kept[i])) {
+                Fail("this was not kept", kept[i]);
+            }
+        }
+        if (strstr(once, "test\n# nvidia-xconfig: ")) {
+            Fail("the banner was written twice", once);
+        }
+    }
+
+    free(once);
+    free(twice);
+}
+
+
+/*
+ * TestPatchCached() - a config read with source tracking must be
+ * patched the same way whether or not a parse cache is given, and
+ * however often the unchanged file is read through it.
+ */
+
+static void TestPatchCached(void)
+{
+    static const char text[] =
+        "# a test machine\n"
+        "\n"
+        "Section \"Vendor\"\n"
+        "    Identifier \"Vendor0\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Modes\"\n"
+        "    Identifier \"Modes0\"\n"
+        "    ModeLine   \"1920x1080\"  148.5   1920 2008 2052 2200   "
+        "1080 1084 1089 1125\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Device\"\n"
+        "    Identifier \"Device0\"\n"
+        "    Driver     \"nvidia\"\n"
+        "EndSection\n";
+    char name[] = "/tmp/test-parser.XXXXXX";
+    char cache[] = "/tmp/test-parser.XXXXXX";
+    char *patched[3] = { NULL, NULL, NULL };
+    XConfigParserPtr parser;
+    XConfigPtr config;
+    FILE *f;
+    int fd, i;
+
+    if ((fd = mkstemp(name)) < 0 || !(f = fdopen(fd, "w"))) {
+        Fail("the config file could not be made", NULL);
+        return;
+    }
+    fputs(text, f);
+    fclose(f);
+
+    if ((fd = mkstemp(cache)) >= 0) {
+        close(fd);
+        unlink(cache);
+    }
+
+    for (i = 0; i < 3; i++) {
+        parser = xconfigAllocParser();
+        xconfigOpenConfigFile(parser, name, NULL);
+        xconfigSetParallelParse(parser, Threads, 0);
+        xconfigSetSourceTracking(parser, TRUE);
+
+        config = NULL;
+        if ((i == 0 ? xconfigReadConfigFile(parser, &config) :
+             xconfigReadConfigFileCached(parser, cache, &config)) !=
+            XCONFIG_RETURN_SUCCESS) {
+            xconfigFreeConfig(&config);
+        }
+        xconfigFreeParser(&parser);
+
+        patched[i] = config ? PatchConfig(config) : NULL;
+        if (!patched[i]) {
+            Fail("the config could not be read and patched", NULL);
+        } else if (i > 0 && patched[0] && strcmp(patched[0], patched[i])) {
+            Fail("reading through the cache changed the patch", patched[i]);
+        }
+    }
+
+    if (patched[0] &&
+        (!strstr(patched[0], "Section \"Vendor\"\n"
+                 "    Identifier \"Vendor0\"\n"
+                 "EndSection\n\nSection \"Modes\"") ||
+         !strstr(patched[0], "    ModeLine   \"1920x1080\"  148.5   "))) {
+        Fail("the sections were not kept as they were", patched[0]);
+    }
+
+    for (i = 0; i < 3; i++) {
+        free(patched[i]);
+    }
+
+    unlink(name);
+    unlink(cache);
+}
+
+
+/*
+ * SectionNames() - return the Section lines of text, in a malloc(3)ed
+ * string.
+ */
+
+static char *SectionNames(const char *text)
+{
+    char *names = calloc(1, strlen(text) + 1);
+    const char *line, *eol;
+
+    for (line = text; *line; line = eol) {
+        eol = strchr(line, '\n');
+        eol = eol ? eol + 1 : line + strlen(line);
+        if (strncmp(line, "Section ", 8) == 0) {
+            strncat(names, line, eol - line);
+        }
+    }
+
+    return names;
+}
+
+
+/*
+ * TestWriteDeferred() - deferred sections are written out as they were
+ * read, but a config must have the same sections written whether they
+ * were parsed or deferred; in particular, the DRI section is written
+ * by neither.
+ */
+
+static void TestWriteDeferred(void)
+{
+    static const char text[] =
+        "Section \"Files\"\n"
+        "    ModulePath \"/usr/lib/xorg/modules\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Device\"\n"
+        "    Identifier \"Device0\"\n"
+        "    Driver     \"nvidia\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"DRI\"\n"
+        "    Mode 0666\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Extensions\"\n"
+        "    Option \"Composite\" \"Disable\"\n"
+        "EndSection\n";
+    static const char expected[] =
+        "Section \"Files\"\n"
+        "Section \"Device\"\n"
+        "Section \"Extensions\"\n";
+    XConfigParserPtr parser;
+    XConfigPtr config;
+    char *written, *names;
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        parser = xconfigAllocParser();
+        xconfigOpenConfigBuffer(parser, text, strlen(text), "test");
+        xconfigSetParallelParse(parser, Threads, 0);
+        xconfigSetDeferredSections(parser, i ? XCONFIG_DEFER_ALL : 0);
+
+        config = NULL;
+        written = NULL;
+        if (xconfigReadConfigFile(parser, &config) ==
+            XCONFIG_RETURN_SUCCESS) {
+            written = Write(config);
+        }
+        xconfigFreeConfig(&config);
+        xconfigFreeParser(&parser);
+
+        if (!written) {
+            Fail("the config could not be read and written", NULL);
+            continue;
+        }
+
+        names = SectionNames(written);
+        if (strcmp(names, expected) != 0) {
+            Fail(i ? "the wrong sections were written when deferred" :
+                     "the wrong sections were written when parsed",
+                 written);
+        }
+
+        free(names);
+        free(written);
+    }
+}
+
+
+/*
+ * TestFailedSections() - in error recovery mode, the sections that
+ * failed to parse must not also be reported missing, while references
+ * to sections that really are missing still are.  The only Device and
+ * Monitor sections here have syntax errors; the Monitor's is before
+ * its Identifier.
+ */
+
+static void TestFailedSections(void)
+{
+    static const char text[] =
+        "Section \"Device\"\n"
+        "    Identifier \"Device0\"\n"
+        "    Driver     \"nvidia\"\n"
+        "    BusID      PCI:1:0:0\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Monitor\"\n"
+        "    HorizSync  bogus\n"
+        "    Identifier \"Monitor0\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Screen\"\n"
+        "    Identifier \"Screen0\"\n"
+        "    Device     \"Device0\"\n"
+        "    Monitor    \"Monitor0\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Screen\"\n"
+        "    Identifier \"Screen1\"\n"
+        "    Device     \"Device1\"\n"
+        "    Monitor    \"Monitor0\"\n"
+        "EndSection\n";
+    static const struct {
+        MsgType type;
+        const char *code;
+        int line;
+    } expected[] = {
+        { ParseErrorMsg,      "QUOTE",            4 },
+        { ParseErrorMsg,      "HORIZSYNC",        8 },
+        { ValidationErrorMsg, "UNDEFINED_DEVICE", 0 },
+    };
+    const size_t n = sizeof(expected) / sizeof(expected[0]);
+    XConfigParserPtr parser;
+    XConfigDiagnosticPtr d;
+    XConfigPtr config;
+    size_t i;
+
+    config = Read(text, FALSE, TRUE, &parser);
+    if (config) {
+        Fail("a config with errors was read", NULL);
+        xconfigFreeConfig(&config);
+    }
+
+    for (i = 0, d = xconfigGetDiagnostics(parser); d; i++, d = d->next) {
+        if (i >= n || d->type != expected[i].type ||
+            strcmp(d->code, expected[i].code) != 0 ||
+            d->line != expected[i].line) {
+            Fail("unexpected message", d->message);
+        }
+    }
+
+    if (i < n) {
+        Fail("missing message", expected[i].code);
+    }
+
+    xconfigFreeParser(&parser);
+}
+
+
+/*
+ * CountOption() - return how many options named name are in list, and
+ * set *pVal to the value of the last one.
+ */
+
+static int CountOption(XConfigOptionPtr list, const char *name,
+                       const char **pVal)
+{
+    int n = 0;
+
+    for (; list; list = list->next) {
+        if (xconfigNameCompare(list->name, name) == 0) {
+            *pVal = list->val;
+            n++;
+        }
+    }
+
+    return n;
+}
+
+
+/*
+ * TestOptionMaps() - the option functions must see changes made to a
+ * long option list without the config, and by hand followed by
+ * xconfigInvalidateIndexes(), rather than answer from an index of the
+ * list as it was.
+ */
+
+static void TestOptionMaps(void)
+{
+    char text[2048], line[64];
+    XConfigOptionPtr *pHead, opt;
+    XConfigPtr config;
+    const char *val;
+    int i;
+
+    strcpy(text, "Section \"Device\"\n"
+           "    Identifier \"Device0\"\n"
+           "    Driver     \"nvidia\"\n");
+    for (i = 0; i < 40; i++) {
+        snprintf(line, sizeof(line), "    Option \"Opt%d\" \"%d\"\n", i, i);
+        strcat(text, line);
+    }
+    strcat(text, "EndSection\n");
+
+    config = Read(text, FALSE, FALSE, NULL);
+    if (!config || !config->devices) {
+        Fail("the config could not be read", text);
+        xconfigFreeConfig(&config);
+        return;
+    }
+
+    pHead = &config->devices->options;
+
+    /* a removal without the config */
+
+    xconfigRemoveOption(pHead, xconfigFindOption(*pHead, "Opt20"));
+    xconfigAddNewOption(config, pHead, "Opt20", "new");
+    if (CountOption(*pHead, "Opt20", &val) != 1 || strcmp(val, "new") != 0) {
+        Fail("an option removed without the config was not added back",
+             NULL);
+    }
+
+    /* a rename by hand */
+
+    opt = xconfigFindOption(*pHead, "Opt30");
+    opt->name = xconfigIntern(config, "Renamed");
+    xconfigInvalidateIndexes(config);
+
+    xconfigAddNewOption(config, pHead, "Renamed", "set");
+    if (CountOption(*pHead, "Renamed", &val) != 1 || opt->val != val ||
+        strcmp(val, "set") != 0) {
+        Fail("a renamed option was not found by its new name", NULL);
+    }
+
+    xconfigAddNewOption(config, pHead, "Opt30", "again");
+    if (CountOption(*pHead, "Opt30", &val) != 1 || opt->val == val) {
+        Fail("a renamed option was found by its old name", NULL);
+    }
+
+    /* removals through the config, including of the first option */
+
+    xconfigRemoveNamedOption(config, pHead, "Opt0", NULL);
+    xconfigRemoveNamedOption(config, pHead, "Opt39", NULL);
+    xconfigRemoveNamedOption(config, pHead, "Opt1", NULL);
+    xconfigAddNewOption(config, pHead, "Opt1", "last");
+    for (i = 0; i < 40; i++) {
+        snprintf(line, sizeof(line), "Opt%d", i);
+        if (CountOption(*pHead, line, &val) != (i == 0 || i == 39 ? 0 : 1)) {
+            Fail("the options removed through the config are wrong", line);
+        }
+    }
+
+    xconfigFreeConfig(&config);
+}
+
+
+/*
+ * TestOptionTypes() - with nvidia-xconfig's option registry, options
+ * that take a display device as well as a boolean must not be parsed
+ * as booleans, or warned about, while plain boolean options still are.
+ */
+
+static void TestOptionTypes(void)
+{
+    static const char text[] =
+        "Section \"Device\"\n"
+        "    Identifier \"Device0\"\n"
+        "    Driver     \"nvidia\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Monitor\"\n"
+        "    Identifier \"Monitor0\"\n"
+        "EndSection\n"
+        "\n"
+        "Section \"Screen\"\n"
+        "    Identifier \"Screen0\"\n"
+        "    Device     \"Device0\"\n"
+        "    Monitor    \"Monitor0\"\n"
+        "    Option     \"UseEdidDpi\" \"DFP-0\"\n"
+        "    Option     \"IncludeImplicitMetaModes\"\n"
+        "                \"DisplayDevice = DFP-0\"\n"
+        "    Option     \"UBB\" \"on\"\n"
+        "EndSection\n";
+    XConfigParserPtr parser = xconfigAllocParser();
+    XConfigDiagnosticPtr d;
+    XConfigOptionPtr options;
+    XConfigPtr config = NULL;
+    int value;
+
+    xconfigOpenConfigBuffer(parser, text, strlen(text), "test");
+    xconfigSetParallelParse(parser, Threads, 0);
+    xconfigSetErrorRecovery(parser, TRUE);
+    xconfigSetOptionRegistry(parser, get_option_registry());
+
+    if (xconfigReadConfigFile(parser, &config) != XCONFIG_RETURN_SUCCESS ||
+        !config->screens) {
+        Fail("the config could not be read", text);
+        xconfigFreeConfig(&config);
+        xconfigFreeParser(&parser);
+        return;
+    }
+
+    for (d = xconfigGetDiagnostics(parser); d; d = d->next) {
+        Fail("unexpected message", d->message);
+    }
+
+    options = config->screens->options;
+
+    if (xconfigOptionTypedValue(xconfigFindOption(options, "UseEdidDpi"),
+                                XCONFIG_OPTION_BOOLEAN, &value) ||
+        xconfigOptionTypedValue(xconfigFindOption(options,
+                                                  "IncludeImplicitMetaModes"),
+                                XCONFIG_OPTION_BOOLEAN, &value)) {
+        Fail("a display device was parsed as a boolean", NULL);
+    }
+
+    if (!xconfigOptionTypedValue(xconfigFindOption(options, "UBB"),
+                                 XCONFIG_OPTION_BOOLEAN, &value) ||
+        value != 1) {
+        Fail("a boolean option was not parsed", NULL);
+    }
+
+    xconfigFreeConfig(&config);
+    xconfigFreeParser(&parser);
+}
+
+
+/*
+ * StreamEntry() - note the keyword and values of each entry streamed,
+ * one per line, in the text buffer passed as data.
+ */
+
+static int StreamEntry(void *data, const char *keyword,
+                       const XConfigValueRec *values, int nvalues, int line)
+{
+    char *text = data;
+    int i;
+
+    snprintf(text + strlen(text), 1024 - strlen(text), "%d %s", line,
+             keyword);
+    for (i = 0; i < nvalues; i++) {
+        snprintf(text + strlen(text), 1024 - strlen(text), " %s",
+                 values[i].str);
+    }
+    snprintf(text + strlen(text), 1024 - strlen(text), "\n");
+
+    return TRUE;
+}
+
+
+/*
+ * TestStreamContinued() - xconfigStreamConfigFile() must take values
+ * that start a line as part of the entry before them, as the other
+ * parsers do, rather than reject them.
+ */
+
+static void TestStreamContinued(void)
+{
+    static const char text[] =
+        "Section \"Monitor\"\n"
+        "    Identifier \"Monitor0\"\n"
+        "    ModeLine   \"1920x1080\" 148.5 1920 2008 2052 2200\n"
+        "                             1080 1084 1089 1125 +HSync\n"
+        "    HorizSync  30 - 83\n"
+        "EndSection\n";
+    static const char expected[] =
+        "2 Identifier Monitor0\n"
+        "3 ModeLine 1920x1080 148.5 1920 2008 2052 2200 "
+        "1080 1084 1089 1125 +HSync\n"
+        "5 HorizSync 30 - 83\n";
+    static const XConfigStreamHandlerRec handler = {
+        NULL, NULL, NULL, StreamEntry,
+    };
+    XConfigParserPtr parser = xconfigAllocParser();
+    char entries[1024] = "";
+
+    xconfigOpenConfigBuffer(parser, text, strlen(text), "test");
+
+    if (xconfigStreamConfigFile(parser, &handler, entries) !=
+        XCONFIG_RETURN_SUCCESS) {
+        Fail("the config could not be streamed", text);
+    } else if (strcmp(entries, expected) != 0) {
+        Fail("the entries streamed are wrong", entries);
+    }
+
+    xconfigFreeParser(&parser);
+}
+
+
+typedef struct {
+    const char *name;
+    void (*func)(void);
+} TestRec;
+
+static const TestRec Tests[] = {
+    { "patch-twice", TestPatchTwice },
+    { "patch-cached", TestPatchCached },
+    { "write-deferred", TestWriteDeferred },
+    { "failed-sections", TestFailedSections },
+    { "option-maps", TestOptionMaps },
+    { "option-types", TestOptionTypes },
+    { "stream-continued", TestStreamContinued },
+};
+
+
+int main(int argc, char *argv[])
+{
+    static const int threads[] = { 0, 4 };
+    size_t i, j;
+    int failures = 0;
+
+    for (i = 0; i < sizeof(Tests) / sizeof(Tests[0]); i++) {
+        for (j = 0; j < sizeof(threads) / sizeof(threads[0]); j++) {
+            Threads = threads[j];
+            Failed = FALSE;
+
+            Tests[i].func();
+
+            printf("%s %s (%s)\n", Failed ? "FAIL" : "PASS", Tests[i].name,
+                   Threads ? "parallel" : "serial");
+            failures += Failed;
+        }
+    }
+
+    return failures;
+}
@@ -139,30 +139,79 @@ void xconfigPrint(MsgType t, const char *msg);
 typedef struct { void *next; } GenericListRec, *GenericListPtr;
 
 
+/*
+ * the end of a list, for appending to it with xconfigAppendListItem()
+ * in constant time, rather than walking the list each time as
+ * xconfigAddListItem() does; it is only good while the list is added
+ * to through it
+ */
+
+typedef struct {
+    GenericListPtr *next;   /* next field of the last item, or the head */
+} GenericListTailRec, *GenericListTailPtr;
+
+
 
 /*
- * Options are stored in the XConfigOptionRec structure
+ * Options are stored in the XConfigOptionRec structure.  A config also
+ * keeps hash indexes on the names of its long option lists (see
+ * OptionMap.c); such lists should be changed only with
+ * xconfigAddNewOption(), xconfigRemoveOption() and the other option
+ * functions, or xconfigInvalidateIndexes() called after changing them
+ * by hand.
+ *
+ * The value of an option whose type is known from the config's option
+ * registry (see OptionType.c) is also kept parsed, in type and value;
+ * typedVal is the val it was parsed from, so the parsed value is
+ * simply ignored once val is set to something else.
  */
 
 typedef struct __xconfigoptionrec {
     struct __xconfigoptionrec *next;
-    char *name;
-    char *val;
+    const char *name;
+    const char *val;
     char *comment;
+    const char *typedVal;
+    int type;                   /* XCONFIG_OPTION_*, of val as parsed */
+    int value;
 } XConfigOptionRec, *XConfigOptionPtr;
 
 
+/*
+ * The types of option values an option registry knows: a boolean is
+ * parsed to 0 or 1, an integer to its value, and an enum to the index
+ * of the value in the type's list of values, which are compared
+ * without regard to case.
+ */
+
+typedef enum {
+    XCONFIG_OPTION_STRING = 0,
+    XCONFIG_OPTION_BOOLEAN,
+    XCONFIG_OPTION_INTEGER,
+    XCONFIG_OPTION_ENUM
+} XConfigOptionType;
+
+typedef struct {
+    const char *name;
+    XConfigOptionType type;
+    const char * const *values;     /* XCONFIG_OPTION_ENUM; NULL ends */
+} XConfigOptionTypeRec, *XConfigOptionTypePtr;
+
+typedef struct __XConfigOptionRegistryRec XConfigOptionRegistryRec,
+    *XConfigOptionRegistryPtr;
+
+
 
 /*
  * Files Section
  */
 
 typedef struct {
-    char *logfile;
-    char *rgbpath;
-    char *modulepath;
-    char *inputdevs;
-    char *fontpath;
+    const char *logfile;
+    const char *rgbpath;
+    const char *modulepath;
+    const char *inputdevs;
+    const char *fontpath;
     char *comment;
 } XConfigFilesRec, *XConfigFilesPtr;
 
@@ -179,7 +228,7 @@ typedef struct {
 typedef struct __xconfigloadrec {
     struct __xconfigloadrec *next;
     int                      type;
-    char                    *name;
+    const char              *name;
     XConfigOptionPtr         opt;
     char                    *comment;
 } XConfigLoadRec, *XConfigLoadPtr;
@@ -216,8 +265,8 @@ typedef struct {
 
 typedef struct __xconfigconfmodelinerec {
     struct __xconfigconfmodelinerec *next;
-    char *identifier;
-    char *clock; /* stored in MHz */
+    const char *identifier;
+    const char *clock; /* stored in MHz */
     int hdisplay;
     int hsyncstart;
     int hsyncend;
@@ -240,21 +289,21 @@ typedef struct __xconfigconfmodelinerec {
 
 typedef struct __xconfigconfvideoportrec {
     struct __xconfigconfvideoportrec *next;
-    char             *identifier;
+    const char       *identifier;
     XConfigOptionPtr  options;
     char             *comment;
 } XConfigVideoPortRec, *XConfigVideoPortPtr;
 
 typedef struct __xconfigconfvideoadaptorrec {
     struct __xconfigconfvideoadaptorrec *next;
-    char                *identifier;
-    char                *vendor;
-    char                *board;
-    char                *busid;
-    char                *driver;
+    const char          *identifier;
+    const char          *vendor;
+    const char          *board;
+    const char          *busid;
+    const char          *driver;
     XConfigOptionPtr     options;
     XConfigVideoPortPtr  ports;
-    char                *fwdref;
+    const char          *fwdref;
     char                *comment;
 } XConfigVideoAdaptorRec, *XConfigVideoAdaptorPtr;
 
@@ -273,22 +322,22 @@ typedef struct { int red, green, blue; } parser_rgb;
 
 typedef struct __xconfigconfmodesrec {
     struct __xconfigconfmodesrec *next;
-    char                     *identifier;
+    const char               *identifier;
     XConfigModeLinePtr        modelines;
     char                     *comment;
 } XConfigModesRec, *XConfigModesPtr;
 
 typedef struct __xconfigconfmodeslinkrec {
     struct __xconfigconfmodeslinkrec *next;
-    char                             *modes_name;
+    const char                       *modes_name;
     XConfigModesPtr               modes;
 } XConfigModesLinkRec, *XConfigModesLinkPtr;
 
 typedef struct __xconfigconfmonitorrec {
     struct __xconfigconfmonitorrec *next;
-    char                *identifier;
-    char                *vendor;
-    char                *modelname;
+    const char          *identifier;
+    const char          *vendor;
+    const char          *modelname;
     int                  width;                /* in mm */
     int                  height;               /* in mm */
     XConfigModeLinePtr   modelines;
@@ -307,7 +356,8 @@ typedef struct __xconfigconfmonitorrec {
 
 
 /*
- * Device Section
+ * Device Section; clock, which few configs set, is only allocated
+ * when clocks is nonzero, and then has room for CONF_MAXCLOCKS.
  */
 
 #define CONF_MAXDACSPEEDS 4
@@ -315,23 +365,23 @@ typedef struct __xconfigconfmonitorrec {
 
 typedef struct __xconfigconfdevicerec {
     struct __xconfigconfdevicerec *next;
-    char             *identifier;
-    char             *vendor;
-    char             *board;
-    char             *chipset;
-    char             *busid;
-    char             *card;
-    char             *driver;
-    char             *ramdac;
+    const char       *identifier;
+    const char       *vendor;
+    const char       *board;
+    const char       *chipset;
+    const char       *busid;
+    const char       *card;
+    const char       *driver;
+    const char       *ramdac;
     int               dacSpeeds[CONF_MAXDACSPEEDS];
     int               videoram;
     int               textclockfreq;
     unsigned long     bios_base;
     unsigned long     mem_base;
     unsigned long     io_base;
-    char             *clockchip;
+    const char       *clockchip;
+    int              *clock;
     int               clocks;
-    int               clock[CONF_MAXCLOCKS];
     int               chipid;
     int               chiprev;
     int               irq;
@@ -349,7 +399,7 @@ typedef struct __xconfigconfdevicerec {
 
 typedef struct __xconfigmoderec {
     struct __xconfigmoderec *next;
-    char                    *mode_name;
+    const char              *mode_name;
 } XConfigModeRec, *XConfigModePtr;
 
 typedef struct __xconfigconfdisplayrec {
@@ -360,7 +410,7 @@ typedef struct __xconfigconfdisplayrec {
     int               virtualY;
     int               depth;
     int               bpp;
-    char             *visual;
+    const char       *visual;
     parser_rgb        weight;
     parser_rgb        black;
     parser_rgb        white;
@@ -371,20 +421,20 @@ typedef struct __xconfigconfdisplayrec {
 
 typedef struct __xconfigconfadaptorlinkrec {
     struct __xconfigconfadaptorlinkrec *next;
-    char                       *adaptor_name;
+    const char                 *adaptor_name;
     XConfigVideoAdaptorPtr  adaptor;
 } XConfigAdaptorLinkRec, *XConfigAdaptorLinkPtr;
 
 typedef struct __xconfigconfscreenrec {
     struct __xconfigconfscreenrec *next;
-    char                  *identifier;
-    char                  *obsolete_driver;
+    const char            *identifier;
+    const char            *obsolete_driver;
     int                    defaultdepth;
     int                    defaultbpp;
     int                    defaultfbbpp;
-    char                  *monitor_name;
+    const char            *monitor_name;
     XConfigMonitorPtr      monitor;
-    char                  *device_name;
+    const char            *device_name;
     XConfigDevicePtr       device;
     XConfigAdaptorLinkPtr  adaptors;
     XConfigDisplayPtr      displays;
@@ -400,8 +450,8 @@ typedef struct __xconfigconfscreenrec {
 
 typedef struct __xconfigconfinputrec {
     struct __xconfigconfinputrec *next;
-    char              *identifier;
-    char              *driver;
+    const char        *identifier;
+    const char        *driver;
     XConfigOptionPtr   options;
     char              *comment;
 } XConfigInputRec, *XConfigInputPtr;
@@ -414,22 +464,22 @@ typedef struct __xconfigconfinputrec {
 
 typedef struct __xconfigconfinputclassrec {
     struct __xconfigconfinputclassrec *next;
-    char              *identifier;
-    char              *driver;
-    char              *match_is_pointer;
-    char              *match_is_touchpad;
-    char              *match_is_touchscreen;
-    char              *match_is_keyboard;
-    char              *match_is_joystick;
-    char              *match_is_tablet;
-    char              *match_tag;
-    char              *match_device_path;
-    char              *match_os;
-    char              *match_usb_id;
-    char              *match_pnp_id;
-    char              *match_product;
-    char              *match_driver;
-    char              *match_vendor;
+    const char        *identifier;
+    const char        *driver;
+    const char        *match_is_pointer;
+    const char        *match_is_touchpad;
+    const char        *match_is_touchscreen;
+    const char        *match_is_keyboard;
+    const char        *match_is_joystick;
+    const char        *match_is_tablet;
+    const char        *match_tag;
+    const char        *match_device_path;
+    const char        *match_os;
+    const char        *match_usb_id;
+    const char        *match_pnp_id;
+    const char        *match_product;
+    const char        *match_driver;
+    const char        *match_vendor;
     XConfigOptionPtr   options;
     char              *comment;
 } XConfigInputClassRec, *XConfigInputClassPtr;
@@ -443,7 +493,7 @@ typedef struct __xconfigconfinputclassrec {
 typedef struct __xconfigconfinputrefrec {
     struct __xconfigconfinputrefrec *next;
     XConfigInputPtr  input;
-    char            *input_name;
+    const char      *input_name;
     XConfigOptionPtr options;
 } XConfigInputrefRec, *XConfigInputrefPtr;
 
@@ -465,21 +515,21 @@ typedef struct __xconfigconfinputrefrec {
 
 typedef struct __xconfigconfadjacencyrec {
     struct __xconfigconfadjacencyrec *next;
-    int               scrnum;
     XConfigScreenPtr  screen;
-    char             *screen_name;
+    const char       *screen_name;
     XConfigScreenPtr  top;
-    char             *top_name;
+    const char       *top_name;
     XConfigScreenPtr  bottom;
-    char             *bottom_name;
+    const char       *bottom_name;
     XConfigScreenPtr  left;
-    char             *left_name;
+    const char       *left_name;
     XConfigScreenPtr  right;
-    char             *right_name;
+    const char       *right_name;
+    int               scrnum;
     int               where;
     int               x;
     int               y;
-    char             *refscreen;
+    const char       *refscreen;
 } XConfigAdjacencyRec, *XConfigAdjacencyPtr;
 
 
@@ -490,7 +540,7 @@ typedef struct __xconfigconfadjacencyrec {
 
 typedef struct __xconfigconfinactiverec {
     struct __xconfigconfinactiverec *next;
-    char            *device_name;
+    const char      *device_name;
     XConfigDevicePtr device;
 } XConfigInactiveRec, *XConfigInactivePtr;
 
@@ -502,7 +552,7 @@ typedef struct __xconfigconfinactiverec {
 
 typedef struct __xconfigconflayoutrec {
     struct __xconfigconflayoutrec *next;
-    char                *identifier;
+    const char          *identifier;
     XConfigAdjacencyPtr  adjacencies;
     XConfigInactivePtr   inactives;
     XConfigInputrefPtr   inputs;
@@ -518,15 +568,15 @@ typedef struct __xconfigconflayoutrec {
 
 typedef struct __xconfigconfvendsubrec { 
     struct __xconfigconfvendsubrec *next;
-    char             *name;
-    char             *identifier;
+    const char       *name;
+    const char       *identifier;
     XConfigOptionPtr  options;
     char             *comment;
 } XConfigVendSubRec, *XConfigVendSubPtr;
 
 typedef struct __xconfigconfvendorrec {
     struct __xconfigconfvendorrec *next;
-    char              *identifier;
+    const char        *identifier;
     XConfigOptionPtr   options;
     XConfigVendSubPtr  subs;
     char              *comment;
@@ -542,12 +592,12 @@ typedef struct __xconfigconfbuffersrec {
     struct __xconfigconfbuffersrec *next;
     int            count;
     int            size;
-    char          *flags;
+    const char    *flags;
     char          *comment;
 } XConfigBuffersRec, *XConfigBuffersPtr;
 
 typedef struct {
-    char             *group_name;
+    const char       *group_name;
     int               group;
     int               mode;
     XConfigBuffersPtr buffers;
@@ -580,9 +630,49 @@ XConfigExtensionsRec, *XConfigExtensionsPtr;
 
 
 /*
- * Configuration file structure
+ * Deferred section; the verbatim text of a section that was not parsed
+ * when the config was read (see xconfigSetDeferredSections())
  */
 
+#define XCONFIG_DEFER_FILES       0x0001
+#define XCONFIG_DEFER_MODULE      0x0002
+#define XCONFIG_DEFER_FLAGS       0x0004
+#define XCONFIG_DEFER_VENDOR      0x0008
+#define XCONFIG_DEFER_INPUTCLASS  0x0010
+#define XCONFIG_DEFER_DRI         0x0020
+#define XCONFIG_DEFER_EXTENSIONS  0x0040
+#define XCONFIG_DEFER_ALL         0x007f
+
+typedef struct __xconfigdeferredrec {
+    struct __xconfigdeferredrec *next;
+    unsigned int  kind;     /* one of XCONFIG_DEFER_* */
+    int           line;     /* line of the Section keyword */
+    const char   *text;     /* "Section" through "EndSection" */
+    size_t        len;
+} XConfigDeferredRec, *XConfigDeferredPtr;
+
+
+/*
+ * Configuration file structure; everything in a config is allocated
+ * from its arena (see Arena.c) with xconfigArenaAlloc() and released
+ * along with the config.  Strings other than comments are held in the
+ * config's string pool (see Intern.c) and must be set with
+ * xconfigIntern().  A config read with source tracking on also keeps
+ * the text it was read from (see Source.c).  Sections are looked up by
+ * identifier through hash indexes (see Index.c).
+ */
+
+typedef struct __XConfigArenaRec XConfigArenaRec, *XConfigArenaPtr;
+typedef struct __XConfigStringPoolRec XConfigStringPoolRec,
+    *XConfigStringPoolPtr;
+typedef struct __XConfigSourceRec XConfigSourceRec, *XConfigSourcePtr;
+typedef struct __XConfigDiagnosticsRec XConfigDiagnosticsRec,
+    *XConfigDiagnosticsPtr;
+typedef struct __XConfigIndexRec XConfigIndexRec, *XConfigIndexPtr;
+typedef struct __XConfigOptionMapsRec XConfigOptionMapsRec,
+    *XConfigOptionMapsPtr;
+typedef struct __XConfigNameKeyRec XConfigNameKeyRec;
+
 typedef struct {
     XConfigFilesPtr        files;
     XConfigModulePtr       modules;
@@ -598,8 +688,16 @@ typedef struct {
     XConfigVendorPtr       vendors;
     XConfigDRIPtr          dri;
     XConfigExtensionsPtr   extensions;
+    XConfigDeferredPtr     deferred;
     char                  *comment;
-    char                  *filename;
+    const char            *filename;
+    XConfigArenaPtr        arena;
+    XConfigStringPoolPtr   strings;
+    XConfigSourcePtr       source;
+    XConfigDiagnosticsPtr  diagnostics; /* collecting validation messages */
+    XConfigIndexPtr        index;
+    XConfigOptionMapsPtr   optionMaps;
+    XConfigOptionRegistryPtr optionTypes; /* not owned by the config */
 } XConfigRec, *XConfigPtr;
 
 typedef struct {
@@ -608,6 +706,85 @@ typedef struct {
 } XConfigSymTabRec, *XConfigSymTabPtr;
 
 
+/*
+ * parser context; holds all of the lexer and parser state for one
+ * config file, so that independent config files can be parsed
+ * concurrently from different threads.  The contents are private to
+ * the parser.
+ */
+
+typedef struct __XConfigParserRec XConfigParserRec, *XConfigParserPtr;
+
+
+/*
+ * a message collected by a parser in error recovery mode, rather than
+ * printed (see xconfigSetErrorRecovery()).  type is ParseErrorMsg,
+ * ParseWarningMsg or ValidationErrorMsg, and code names the problem, eg
+ * "INVALID_KEYWORD", for tools that filter or count messages.  message
+ * does not include the location; validation messages have no line or
+ * section.  The list belongs to the parser.
+ */
+
+typedef struct __xconfigdiagnosticrec {
+    struct __xconfigdiagnosticrec *next;
+    MsgType     type;
+    const char *code;
+    const char *file;
+    int         line;
+    const char *section;
+    const char *message;
+} XConfigDiagnosticRec, *XConfigDiagnosticPtr;
+
+
+/*
+ * handler for xconfigStreamConfigFile(), which reports the contents of
+ * a config file as a sequence of events rather than building a tree.
+ * Each callback is passed the data given to xconfigStreamConfigFile()
+ * and the line the event starts on; a callback may be NULL if the
+ * events it handles are not needed.  All strings are only valid until
+ * the callback returns.  A callback returns FALSE to stop reading.
+ *
+ * sectionBegin, sectionEnd: kind is "Section", "SubSection" or "Mode",
+ *     and name is the quoted name that follows it, eg "Device".
+ * option: an Option line; value is NULL if the option has none.
+ * entry: any other line within a section; keyword is the first word
+ *     on the line, as written, followed by nvalues values.
+ */
+
+typedef enum {
+    XCONFIG_VALUE_STRING,       /* quoted string, without the quotes */
+    XCONFIG_VALUE_NUMBER,       /* number; also given in num */
+    XCONFIG_VALUE_WORD          /* anything else, eg "+hsync" or "-" */
+} XConfigValueType;
+
+typedef struct {
+    XConfigValueType type;
+    const char      *str;
+    double           num;
+} XConfigValueRec, *XConfigValuePtr;
+
+typedef struct {
+    int (*sectionBegin)(void *data, const char *kind, const char *name,
+                        int line);
+    int (*sectionEnd)(void *data, const char *kind, const char *name,
+                      int line);
+    int (*option)(void *data, const char *name, const char *value,
+                  int line);
+    int (*entry)(void *data, const char *keyword,
+                 const XConfigValueRec *values, int nvalues, int line);
+} XConfigStreamHandlerRec, *XConfigStreamHandlerPtr;
+
+
+/*
+ * for xconfigSetParallelParse(): use one thread per online processor,
+ * and a size below which parsing on more than one thread does not pay
+ * off
+ */
+
+#define XCONFIG_PARALLEL_AUTO      (-1)
+#define XCONFIG_PARALLEL_MIN_SIZE  (64 * 1024)
+
+
 /*
  * data structure containing options; used during generation of X
  * config, and when sanitizing an existing config
@@ -630,14 +807,41 @@ typedef struct {
 /*
  * Functions for open, reading, and writing XConfig files.
  */
-const char *xconfigOpenConfigFile(const char *, const char *);
-XConfigError xconfigReadConfigFile(XConfigPtr *);
+XConfigParserPtr xconfigAllocParser(void);
+void xconfigFreeParser(XConfigParserPtr *parser);
+const char *xconfigFindConfigFile(const char *, const char *);
+void xconfigForgetConfigSearches(void);
+const char *xconfigOpenConfigFile(XConfigParserPtr, const char *,
+                                  const char *);
+void xconfigOpenConfigBuffer(XConfigParserPtr, const char *, size_t,
+                             const char *);
+XConfigError xconfigReadConfigFile(XConfigParserPtr, XConfigPtr *);
+XConfigError xconfigReadConfigFromBuffer(const char *, size_t, const char *,
+                                         XConfigPtr *);
+XConfigError xconfigReadConfigFileCached(XConfigParserPtr, const char *,
+                                         XConfigPtr *);
+XConfigError xconfigStreamConfigFile(XConfigParserPtr,
+                                     const XConfigStreamHandlerRec *,
+                                     void *);
+void xconfigSetDeferredSections(XConfigParserPtr, unsigned int);
+void xconfigSetParallelParse(XConfigParserPtr, int, size_t);
+void xconfigSetErrorRecovery(XConfigParserPtr, int);
+void xconfigSetOptionRegistry(XConfigParserPtr, XConfigOptionRegistryPtr);
+XConfigDiagnosticPtr xconfigGetDiagnostics(XConfigParserPtr);
+int xconfigParseDeferredSections(XConfigPtr, unsigned int);
 int xconfigSanitizeConfig(XConfigPtr p, const char *screenName,
                           GenerateOptions *gop);
-void xconfigCloseConfigFile(void);
+void xconfigCloseConfigFile(XConfigParserPtr);
 int xconfigWriteConfigFile(const char *, XConfigPtr);
+void xconfigSetSourceTracking(XConfigParserPtr, int);
+int xconfigPatchConfigFile(const char *, XConfigPtr);
 
+XConfigPtr xconfigAllocConfig(void);
+XConfigPtr xconfigCopyConfig(XConfigPtr config);
 void xconfigFreeConfig(XConfigPtr *p);
+void *xconfigArenaAlloc(XConfigPtr config, size_t size);
+char *xconfigArenaStrdup(XConfigPtr config, const char *s);
+const char *xconfigIntern(XConfigPtr config, const char *s);
 
 /*
  * Functions for searching for entries in lists
@@ -657,38 +861,7 @@ XConfigInputPtr    xconfigFindInputByDriver(const char *driver,
 XConfigVendorPtr   xconfigFindVendor(const char *name, XConfigVendorPtr list);
 XConfigVideoAdaptorPtr xconfigFindVideoAdaptor(const char *ident,
                                                XConfigVideoAdaptorPtr p);
-
-/*
- * Functions for freeing lists
- */
-
-void xconfigFreeDeviceList(XConfigDevicePtr *ptr);
-void xconfigFreeFiles(XConfigFilesPtr *p);
-void xconfigFreeFlags(XConfigFlagsPtr *flags);
-void xconfigFreeInputList(XConfigInputPtr *ptr);
-void xconfigFreeInputClassList(XConfigInputClassPtr *ptr);
-void xconfigFreeLayoutList(XConfigLayoutPtr *ptr);
-void xconfigFreeAdjacencyList(XConfigAdjacencyPtr *ptr);
-void xconfigFreeInputrefList(XConfigInputrefPtr *ptr);
-void xconfigFreeModules(XConfigModulePtr *ptr);
-void xconfigFreeMonitorList(XConfigMonitorPtr *ptr);
-void xconfigFreeModesList(XConfigModesPtr *ptr);
-void xconfigFreeModeLineList(XConfigModeLinePtr *ptr);
-void xconfigFreeOptionList(XConfigOptionPtr *opt);
-void xconfigFreeScreenList(XConfigScreenPtr *ptr);
-void xconfigFreeAdaptorLinkList(XConfigAdaptorLinkPtr *ptr);
-void xconfigFreeDisplayList(XConfigDisplayPtr *ptr);
-void xconfigFreeModeList(XConfigModePtr *ptr);
-void xconfigFreeVendorList(XConfigVendorPtr *p);
-void xconfigFreeVendorSubList(XConfigVendSubPtr *ptr);
-void xconfigFreeVideoAdaptorList(XConfigVideoAdaptorPtr *ptr);
-void xconfigFreeVideoPortList(XConfigVideoPortPtr *ptr);
-void xconfigFreeBuffersList (XConfigBuffersPtr *ptr);
-void xconfigFreeDRI(XConfigDRIPtr *ptr);
-void xconfigFreeExtensions(XConfigExtensionsPtr *ptr);
-void xconfigFreeModesLinkList(XConfigModesLinkPtr *ptr);
-
-
+void xconfigInvalidateIndexes(XConfigPtr config);
 
 /*
  * item/list manipulation
@@ -696,35 +869,50 @@ void xconfigFreeModesLinkList(XConfigModesLinkPtr *ptr);
 
 void xconfigAddListItem(GenericListPtr *pHead, GenericListPtr c_new);
 void xconfigRemoveListItem(GenericListPtr *pHead, GenericListPtr item);
+void xconfigInitListTail(GenericListTailPtr tail, GenericListPtr *pHead);
+void xconfigAppendListItem(GenericListTailPtr tail, GenericListPtr item);
 int xconfigItemNotSublist(GenericListPtr list_1, GenericListPtr list_2);
-char *xconfigAddComment(char *cur, char *add);
-void xconfigAddNewLoadDirective(XConfigLoadPtr *pHead,
-                                char *name, int type,
-                                XConfigOptionPtr opts, int do_token);
+char *xconfigAddComment(XConfigPtr config, char *cur, const char *add);
+void xconfigAddNewLoadDirective(XConfigPtr config, XConfigLoadPtr *pHead,
+                                const char *name, int type,
+                                XConfigOptionPtr opts,
+                                XConfigParserPtr parser);
 void xconfigRemoveLoadDirective(XConfigLoadPtr *pHead, XConfigLoadPtr load);
 
 /*
  * Functions for manipulating Options
  */
 
-void xconfigAddNewOption(XConfigOptionPtr *pHead,
+void xconfigAddNewOption(XConfigPtr config, XConfigOptionPtr *pHead,
                          const char *name, const char *val);
 void xconfigRemoveOption(XConfigOptionPtr *pHead, XConfigOptionPtr opt);
-void xconfigRemoveNamedOption(XConfigOptionPtr *head, const char *name,
-                              char **comments);
-
-XConfigOptionPtr xconfigOptionListDup(XConfigOptionPtr opt);
-char            *xconfigOptionName(XConfigOptionPtr opt);
-char            *xconfigOptionValue(XConfigOptionPtr opt);
-XConfigOptionPtr xconfigNewOption(const char *name, const char *value);
+void xconfigRemoveNamedOption(XConfigPtr config, XConfigOptionPtr *head,
+                              const char *name, char **comments);
+
+XConfigOptionPtr xconfigOptionListDup(XConfigPtr config, XConfigOptionPtr opt);
+const char      *xconfigOptionName(XConfigOptionPtr opt);
+const char      *xconfigOptionValue(XConfigOptionPtr opt);
+XConfigOptionPtr xconfigNewOption(XConfigPtr config, const char *name,
+                                  const char *value);
 XConfigOptionPtr xconfigNextOption(XConfigOptionPtr list);
 XConfigOptionPtr xconfigFindOption(XConfigOptionPtr list, const char *name);
-char            *xconfigFindOptionValue(XConfigOptionPtr list,
+const char      *xconfigFindOptionValue(XConfigOptionPtr list,
                                         const char *name);
 int              xconfigFindOptionBoolean (XConfigOptionPtr,
                                            const char *name);
 XConfigOptionPtr xconfigOptionListMerge(XConfigOptionPtr head,
                                         XConfigOptionPtr tail);
+int              xconfigOptionTypedValue(XConfigOptionPtr opt,
+                                         XConfigOptionType type, int *value);
+
+XConfigOptionRegistryPtr xconfigAllocOptionRegistry(
+                                      const XConfigOptionTypeRec *types);
+void xconfigFreeOptionRegistry(XConfigOptionRegistryPtr *registry);
+const XConfigOptionTypeRec *xconfigFindOptionType(
+                                      XConfigOptionRegistryPtr registry,
+                                      const char *name);
+int xconfigParseOptionValue(const XConfigOptionTypeRec *type,
+                            const char *val, int *value);
 
 /*
  * Miscellaneous utility routines
@@ -735,16 +923,19 @@ char *xconfigStrcat(const char *str, ...);
 int xconfigNameCompare(const char *s1, const char *s2);
 int xconfigModelineCompare(XConfigModeLinePtr m1, XConfigModeLinePtr m2);
 char *xconfigULongToString(unsigned long i);
-XConfigOptionPtr xconfigParseOption(XConfigOptionPtr head);
+XConfigOptionPtr xconfigParseOption(XConfigParserPtr parser,
+                                    XConfigOptionPtr head);
 void xconfigPrintOptionList(FILE *fp, XConfigOptionPtr list, int tabs);
 int xconfigParsePciBusString(const char *busID,
                              int *bus, int *device, int *func);
 void xconfigFormatPciBusString(char *str, int len,
                                int domain, int bus, int device, int func);
 
-void xconfigAddDisplay(XConfigDisplayPtr *pHead, const int depth);
+void xconfigAddDisplay(XConfigPtr config, XConfigDisplayPtr *pHead,
+                       const int depth);
 
-void xconfigAddMode(XConfigModePtr *pHead, const char *name);
+void xconfigAddMode(XConfigPtr config, XConfigModePtr *pHead,
+                    const char *name);
 void xconfigRemoveMode(XConfigModePtr *pHead, const char *name);
 
 XConfigPtr xconfigGenerate(GenerateOptions *gop);
@@ -0,0 +1,830 @@
+/*
+ * nvidia-xconfig: A tool for manipulating X config files,
+ * specifically for use by the NVIDIA Linux graphics driver.
+ *
+ * Copyright (C) 2005 NVIDIA Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses>.
+ *
+ *
+ * xf86keywordhash.h - generated by gen-keyword-hash from
+ * xf86keywords.h; do not edit.  Run 'make update-keyword-hash'
+ * after changing the keyword tables.
+ */
+
+#define TopLevelTab_SEED 0U
+#define TopLevelTab_MASK 1U
+#define TopLevelTab_SLOTS \
+{ \
+    { 3, "section" }, \
+    { -1, NULL }, \
+}
+
+#define SectionTab_SEED 116U
+#define SectionTab_MASK 31U
+#define SectionTab_SLOTS \
+{ \
+    { 182, "module" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 180, "inputdevice" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 181, "inputclass" }, \
+    { 176, "device" }, \
+    { 175, "videoadaptor" }, \
+    { -1, NULL }, \
+    { 171, "files" }, \
+    { 183, "serverlayout" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 184, "vendor" }, \
+    { 177, "monitor" }, \
+    { 173, "keyboard" }, \
+    { 174, "pointer" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 179, "screen" }, \
+    { 178, "modes" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 185, "dri" }, \
+    { 172, "serverflags" }, \
+    { -1, NULL }, \
+    { 186, "extensions" }, \
+}
+
+#define FilesTab_SEED 4U
+#define FilesTab_MASK 15U
+#define FilesTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 20, "logfile" }, \
+    { -1, NULL }, \
+    { 16, "fontpath" }, \
+    { 18, "modulepath" }, \
+    { -1, NULL }, \
+    { 19, "inputdevices" }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 17, "rgbpath" }, \
+}
+
+#define ServerFlagsTab_SEED 257U
+#define ServerFlagsTab_MASK 31U
+#define ServerFlagsTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 23, "dontzoom" }, \
+    { 22, "dontzap" }, \
+    { 32, "offtime" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 21, "notrapsignals" }, \
+    { 24, "disablevidmodeextension" }, \
+    { 28, "allowmouseopenfail" }, \
+    { 29, "blanktime" }, \
+    { 26, "disablemodindev" }, \
+    { 25, "allownonlocalxvidtune" }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 33, "defaultserverlayout" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 31, "suspendtime" }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 30, "standbytime" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 27, "allownonlocalmodindev" }, \
+    { -1, NULL }, \
+}
+
+#define SubModuleTab_SEED 0U
+#define SubModuleTab_MASK 3U
+#define SubModuleTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { 6, "endsubsection" }, \
+}
+
+#define ModuleTab_SEED 2U
+#define ModuleTab_MASK 15U
+#define ModuleTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 71, "load" }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 72, "loaddriver" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 4, "subsection" }, \
+    { -1, NULL }, \
+    { 73, "disable" }, \
+    { -1, NULL }, \
+}
+
+#define MonitorTab_SEED 7U
+#define MonitorTab_MASK 31U
+#define MonitorTab_SLOTS \
+{ \
+    { 41, "usemodes" }, \
+    { 34, "modelname" }, \
+    { -1, NULL }, \
+    { 37, "horizsync" }, \
+    { -1, NULL }, \
+    { 36, "displaysize" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 8, "vendorname" }, \
+    { 7, "identifier" }, \
+    { 40, "gamma" }, \
+    { 38, "vertrefresh" }, \
+    { 35, "modeline" }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 39, "mode" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+}
+
+#define ModesTab_SEED 0U
+#define ModesTab_MASK 7U
+#define ModesTab_SLOTS \
+{ \
+    { 7, "identifier" }, \
+    { 35, "modeline" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { 39, "mode" }, \
+}
+
+#define TimingTab_SEED 33U
+#define TimingTab_MASK 31U
+#define TimingTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 59, "+hsync" }, \
+    { 64, "+csync" }, \
+    { -1, NULL }, \
+    { 63, "composite" }, \
+    { -1, NULL }, \
+    { 62, "-vsync" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 61, "+vsync" }, \
+    { 67, "hskew" }, \
+    { 58, "interlace" }, \
+    { 66, "doublescan" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 68, "bcast" }, \
+    { 60, "-hsync" }, \
+    { 65, "-csync" }, \
+    { -1, NULL }, \
+    { 70, "CUSTOM" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 69, "vscan" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+}
+
+#define ModeTab_SEED 5U
+#define ModeTab_MASK 15U
+#define ModeTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 43, "htimings" }, \
+    { 47, "bcast" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 45, "flags" }, \
+    { 49, "endmode" }, \
+    { 42, "dotclock" }, \
+    { -1, NULL }, \
+    { 44, "vtimings" }, \
+    { -1, NULL }, \
+    { 46, "hskew" }, \
+    { 48, "vscan" }, \
+    { -1, NULL }, \
+}
+
+#define DeviceTab_SEED 1U
+#define DeviceTab_MASK 63U
+#define DeviceTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 103, "textclockfreq" }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 159, "screen" }, \
+    { 89, "chipset" }, \
+    { 99, "chipid" }, \
+    { -1, NULL }, \
+    { 88, "driver" }, \
+    { -1, NULL }, \
+    { 91, "videoram" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 98, "clockchip" }, \
+    { 7, "identifier" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 92, "boardname" }, \
+    { 90, "clocks" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 101, "card" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 102, "busid" }, \
+    { 97, "membase" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 96, "biosbase" }, \
+    { -1, NULL }, \
+    { 104, "irq" }, \
+    { 94, "ramdac" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 93, "iobase" }, \
+    { -1, NULL }, \
+    { 95, "dacspeed" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 100, "chiprev" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 8, "vendorname" }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+}
+
+#define DisplayTab_SEED 0U
+#define DisplayTab_MASK 31U
+#define DisplayTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 150, "modes" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 151, "viewport" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 154, "black" }, \
+    { 155, "white" }, \
+    { 11, "option" }, \
+    { 158, "weight" }, \
+    { 157, "fbbpp" }, \
+    { -1, NULL }, \
+    { 156, "depth" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 152, "virtual" }, \
+    { 153, "visual" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 6, "endsubsection" }, \
+}
+
+#define ScreenTab_SEED 35U
+#define ScreenTab_MASK 31U
+#define ScreenTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 54, "defaultcolordepth" }, \
+    { 52, "monitor" }, \
+    { -1, NULL }, \
+    { 4, "subsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 56, "defaultfbbpp" }, \
+    { 53, "screenno" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 50, "driver" }, \
+    { -1, NULL }, \
+    { 55, "defaultbpp" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 57, "videoadaptor" }, \
+    { 7, "identifier" }, \
+    { 51, "device" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { 54, "defaultdepth" }, \
+}
+
+#define KeyboardTab_SEED 104U
+#define KeyboardTab_MASK 63U
+#define KeyboardTab_SLOTS \
+{ \
+    { 109, "xkbcompat" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 119, "xkbvariant" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 105, "autorepeat" }, \
+    { 121, "vtinit" }, \
+    { -1, NULL }, \
+    { 113, "xkbsymbols" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 116, "xkbrules" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 112, "xkbgeometry" }, \
+    { -1, NULL }, \
+    { 120, "xkboptions" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 125, "rightalt" }, \
+    { -1, NULL }, \
+    { 111, "xkbkeycodes" }, \
+    { 127, "rightctl" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 124, "leftalt" }, \
+    { -1, NULL }, \
+    { 108, "xkbkeymap" }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { 126, "scrolllock" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 107, "protocol" }, \
+    { 122, "vtsysreq" }, \
+    { 115, "panix106" }, \
+    { -1, NULL }, \
+    { 123, "servernumlock" }, \
+    { -1, NULL }, \
+    { 106, "xleds" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 125, "altgr" }, \
+    { -1, NULL }, \
+    { 117, "xkbmodel" }, \
+    { 118, "xkblayout" }, \
+    { -1, NULL }, \
+    { 110, "xkbtypes" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 114, "xkbdisable" }, \
+    { -1, NULL }, \
+}
+
+#define KeyMapTab_SEED 4U
+#define KeyMapTab_MASK 15U
+#define KeyMapTab_SLOTS \
+{ \
+    { 130, "modeshift" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 133, "control" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 129, "compose" }, \
+    { 132, "scrolllock" }, \
+    { 128, "meta" }, \
+    { -1, NULL }, \
+    { 131, "modelock" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+}
+
+#define PointerTab_SEED 27U
+#define PointerTab_MASK 63U
+#define PointerTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 145, "alwayscore" }, \
+    { 135, "baudrate" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 140, "chordmiddle" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 142, "device" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 147, "zaxismapping" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 139, "clearrts" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 137, "resolution" }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { 134, "emulate3buttons" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 136, "samplerate" }, \
+    { -1, NULL }, \
+    { 142, "port" }, \
+    { -1, NULL }, \
+    { 138, "cleardtr" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 143, "emulate3timeout" }, \
+    { -1, NULL }, \
+    { 144, "devicename" }, \
+    { 6, "endsubsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 146, "buttons" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 141, "protocol" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+}
+
+#define ZMapTab_SEED 0U
+#define ZMapTab_MASK 3U
+#define ZMapTab_SLOTS \
+{ \
+    { 148, "x" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 149, "y" }, \
+}
+
+#define InputTab_SEED 2U
+#define InputTab_MASK 7U
+#define InputTab_SLOTS \
+{ \
+    { 11, "option" }, \
+    { 7, "identifier" }, \
+    { 88, "driver" }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+}
+
+#define InputClassTab_SEED 13U
+#define InputClassTab_MASK 63U
+#define InputClassTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 79, "matchisjoystick" }, \
+    { 75, "matchispointer" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 77, "matchistouchscreen" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 86, "matchdriver" }, \
+    { -1, NULL }, \
+    { 76, "matchistouchpad" }, \
+    { -1, NULL }, \
+    { 85, "matchvendor" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 83, "matchusbid" }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 82, "matchtag" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 74, "matchproduct" }, \
+    { -1, NULL }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 84, "matchpnpid" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 78, "matchiskeyboard" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 88, "driver" }, \
+    { 80, "matchistablet" }, \
+    { 87, "matchdevicepath" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 7, "identifier" }, \
+    { 81, "matchos" }, \
+}
+
+#define LayoutTab_SEED 0U
+#define LayoutTab_MASK 15U
+#define LayoutTab_SLOTS \
+{ \
+    { 7, "identifier" }, \
+    { 11, "option" }, \
+    { 160, "inactive" }, \
+    { -1, NULL }, \
+    { 159, "screen" }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 161, "inputdevice" }, \
+    { -1, NULL }, \
+}
+
+#define AdjTab_SEED 2U
+#define AdjTab_MASK 15U
+#define AdjTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 162, "rightof" }, \
+    { 164, "above" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 163, "leftof" }, \
+    { 166, "relative" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 165, "below" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 167, "absolute" }, \
+    { -1, NULL }, \
+}
+
+#define VendorSubTab_SEED 0U
+#define VendorSubTab_MASK 7U
+#define VendorSubTab_SLOTS \
+{ \
+    { 7, "identifier" }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 6, "endsubsection" }, \
+}
+
+#define VendorTab_SEED 3U
+#define VendorTab_MASK 7U
+#define VendorTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { 7, "identifier" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 4, "subsection" }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { 11, "option" }, \
+}
+
+#define VideoPortTab_SEED 0U
+#define VideoPortTab_MASK 7U
+#define VideoPortTab_SLOTS \
+{ \
+    { 7, "identifier" }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 6, "endsubsection" }, \
+}
+
+#define VideoAdaptorTab_SEED 13U
+#define VideoAdaptorTab_MASK 15U
+#define VideoAdaptorTab_SLOTS \
+{ \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 11, "option" }, \
+    { 92, "boardname" }, \
+    { 88, "driver" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 4, "subsection" }, \
+    { 5, "endsection" }, \
+    { 102, "busid" }, \
+    { 7, "identifier" }, \
+    { 8, "vendorname" }, \
+}
+
+#define DRITab_SEED 2U
+#define DRITab_MASK 7U
+#define DRITab_SLOTS \
+{ \
+    { 39, "mode" }, \
+    { 169, "group" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+    { 170, "buffers" }, \
+    { -1, NULL }, \
+}
+
+#define ExtensionsTab_SEED 1U
+#define ExtensionsTab_MASK 3U
+#define ExtensionsTab_SLOTS \
+{ \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { -1, NULL }, \
+}
+
+#define StreamTab_SEED 4U
+#define StreamTab_MASK 15U
+#define StreamTab_SLOTS \
+{ \
+    { 49, "endmode" }, \
+    { 6, "endsubsection" }, \
+    { -1, NULL }, \
+    { 11, "option" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 5, "endsection" }, \
+    { 3, "section" }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { -1, NULL }, \
+    { 39, "mode" }, \
+    { -1, NULL }, \
+    { 4, "subsection" }, \
+}
+
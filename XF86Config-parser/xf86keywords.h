@@ -0,0 +1,526 @@
+/* 
+ * 
+ * Copyright (c) 1997  Metro Link Incorporated
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE X CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ * Except as contained in this notice, the name of the Metro Link shall not be
+ * used in advertising or otherwise to promote the sale, use or other dealings
+ * in this Software without prior written authorization from Metro Link.
+ * 
+ */
+/*
+ * Copyright (c) 1997-2003 by The XFree86 Project, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDER(S) OR AUTHOR(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the copyright holder(s)
+ * and author(s) shall not be used in advertising or otherwise to promote
+ * the sale, use or other dealings in this Software without prior written
+ * authorization from the copyright holder(s) and author(s).
+ */
+
+
+/*
+ * xf86keywords.h - the keywords recognized in each part of the config
+ * file.  This is only included by gen-keyword-hash, which turns each
+ * table into a perfect hash in xf86keywordhash.h; the parsers refer to
+ * the result with XCONFIG_KEYWORD_TABLE().  When adding a table, also
+ * add it to xconfigKeywordTables[] at the end of this file.
+ */
+
+#ifndef _xf86_keywords_h
+#define _xf86_keywords_h
+
+#include "xf86Parser.h"
+#include "xf86tokens.h"
+
+/* Read.c */
+
+static const XConfigSymTabRec TopLevelTab[] =
+{
+    {SECTION, "section"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec SectionTab[] =
+{
+    {FILES_SECTION, "files"},
+    {SERVERFLAGS_SECTION, "serverflags"},
+    {KEYBOARD_SECTION, "keyboard"},
+    {POINTER_SECTION, "pointer"},
+    {VIDEOADAPTOR_SECTION, "videoadaptor"},
+    {DEVICE_SECTION, "device"},
+    {MONITOR_SECTION, "monitor"},
+    {MODES_SECTION, "modes"},
+    {SCREEN_SECTION, "screen"},
+    {INPUTDEVICE_SECTION, "inputdevice"},
+    {INPUTCLASS_SECTION, "inputclass"},
+    {MODULE_SECTION, "module"},
+    {SERVERLAYOUT_SECTION, "serverlayout"},
+    {VENDOR_SECTION, "vendor"},
+    {DRI_SECTION, "dri"},
+    {EXTENSIONS_SECTION, "extensions"},
+    {-1, ""},
+};
+
+/* Files.c */
+
+static const XConfigSymTabRec FilesTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {FONTPATH, "fontpath"},
+    {RGBPATH, "rgbpath"},
+    {MODULEPATH, "modulepath"},
+    {INPUTDEVICES, "inputdevices"},
+    {LOGFILEPATH, "logfile"},
+    {-1, ""},
+};
+
+/* Flags.c */
+
+static const XConfigSymTabRec ServerFlagsTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {NOTRAPSIGNALS, "notrapsignals"},
+    {DONTZAP, "dontzap"},
+    {DONTZOOM, "dontzoom"},
+    {DISABLEVIDMODE, "disablevidmodeextension"},
+    {ALLOWNONLOCAL, "allownonlocalxvidtune"},
+    {DISABLEMODINDEV, "disablemodindev"},
+    {MODINDEVALLOWNONLOCAL, "allownonlocalmodindev"},
+    {ALLOWMOUSEOPENFAIL, "allowmouseopenfail"},
+    {OPTION, "option"},
+    {BLANKTIME, "blanktime"},
+    {STANDBYTIME, "standbytime"},
+    {SUSPENDTIME, "suspendtime"},
+    {OFFTIME, "offtime"},
+    {DEFAULTLAYOUT, "defaultserverlayout"},
+    {-1, ""},
+};
+
+/* Module.c */
+
+static const XConfigSymTabRec SubModuleTab[] =
+{
+    {ENDSUBSECTION, "endsubsection"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec ModuleTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {LOAD, "load"},
+    {LOAD_DRIVER, "loaddriver"},
+    {DISABLE, "disable"},
+    {SUBSECTION, "subsection"},
+    {-1, ""},
+};
+
+/* Monitor.c */
+
+static const XConfigSymTabRec MonitorTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {VENDOR, "vendorname"},
+    {MODEL, "modelname"},
+    {USEMODES, "usemodes"},
+    {MODELINE, "modeline"},
+    {DISPLAYSIZE, "displaysize"},
+    {HORIZSYNC, "horizsync"},
+    {VERTREFRESH, "vertrefresh"},
+    {MODE, "mode"},
+    {GAMMA, "gamma"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec ModesTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {MODELINE, "modeline"},
+    {MODE, "mode"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec TimingTab[] =
+{
+    {TT_INTERLACE, "interlace"},
+    {TT_PHSYNC, "+hsync"},
+    {TT_NHSYNC, "-hsync"},
+    {TT_PVSYNC, "+vsync"},
+    {TT_NVSYNC, "-vsync"},
+    {TT_CSYNC, "composite"},
+    {TT_PCSYNC, "+csync"},
+    {TT_NCSYNC, "-csync"},
+    {TT_DBLSCAN, "doublescan"},
+    {TT_HSKEW, "hskew"},
+    {TT_BCAST, "bcast"},
+    {TT_VSCAN, "vscan"},
+    {TT_CUSTOM, "CUSTOM"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec ModeTab[] =
+{
+    {DOTCLOCK, "dotclock"},
+    {HTIMINGS, "htimings"},
+    {VTIMINGS, "vtimings"},
+    {FLAGS, "flags"},
+    {HSKEW, "hskew"},
+    {BCAST, "bcast"},
+    {VSCAN, "vscan"},
+    {ENDMODE, "endmode"},
+    {-1, ""},
+};
+
+/* Device.c */
+
+static const XConfigSymTabRec DeviceTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {VENDOR, "vendorname"},
+    {BOARD, "boardname"},
+    {CHIPSET, "chipset"},
+    {RAMDAC, "ramdac"},
+    {DACSPEED, "dacspeed"},
+    {CLOCKS, "clocks"},
+    {OPTION, "option"},
+    {VIDEORAM, "videoram"},
+    {BIOSBASE, "biosbase"},
+    {MEMBASE, "membase"},
+    {IOBASE, "iobase"},
+    {CLOCKCHIP, "clockchip"},
+    {CHIPID, "chipid"},
+    {CHIPREV, "chiprev"},
+    {CARD, "card"},
+    {DRIVER, "driver"},
+    {BUSID, "busid"},
+    {TEXTCLOCKFRQ, "textclockfreq"},
+    {IRQ, "irq"},
+    {SCREEN, "screen"},
+    {-1, ""},
+};
+
+/* Screen.c */
+
+static const XConfigSymTabRec DisplayTab[] =
+{
+    {ENDSUBSECTION, "endsubsection"},
+    {MODES, "modes"},
+    {VIEWPORT, "viewport"},
+    {VIRTUAL, "virtual"},
+    {VISUAL, "visual"},
+    {BLACK_TOK, "black"},
+    {WHITE_TOK, "white"},
+    {DEPTH, "depth"},
+    {BPP, "fbbpp"},
+    {WEIGHT, "weight"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec ScreenTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {OBSDRIVER, "driver"},
+    {MDEVICE, "device"},
+    {MONITOR, "monitor"},
+    {VIDEOADAPTOR, "videoadaptor"},
+    {SCREENNO, "screenno"},
+    {SUBSECTION, "subsection"},
+    {DEFAULTDEPTH, "defaultcolordepth"},
+    {DEFAULTDEPTH, "defaultdepth"},
+    {DEFAULTBPP, "defaultbpp"},
+    {DEFAULTFBBPP, "defaultfbbpp"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+/* Keyboard.c */
+
+static const XConfigSymTabRec KeyboardTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {KPROTOCOL, "protocol"},
+    {AUTOREPEAT, "autorepeat"},
+    {XLEDS, "xleds"},
+    {PANIX106, "panix106"},
+    {XKBKEYMAP, "xkbkeymap"},
+    {XKBCOMPAT, "xkbcompat"},
+    {XKBTYPES, "xkbtypes"},
+    {XKBKEYCODES, "xkbkeycodes"},
+    {XKBGEOMETRY, "xkbgeometry"},
+    {XKBSYMBOLS, "xkbsymbols"},
+    {XKBDISABLE, "xkbdisable"},
+    {XKBRULES, "xkbrules"},
+    {XKBMODEL, "xkbmodel"},
+    {XKBLAYOUT, "xkblayout"},
+    {XKBVARIANT, "xkbvariant"},
+    {XKBOPTIONS, "xkboptions"},
+    /* The next two have become ServerFlags options */
+    {VTINIT, "vtinit"},
+    {VTSYSREQ, "vtsysreq"},
+    /* Obsolete keywords */
+    {SERVERNUM, "servernumlock"},
+    {LEFTALT, "leftalt"},
+    {RIGHTALT, "rightalt"},
+    {RIGHTALT, "altgr"},
+    {SCROLLLOCK_TOK, "scrolllock"},
+    {RIGHTCTL, "rightctl"},
+    {-1, ""},
+};
+
+/* Obsolete */
+static const XConfigSymTabRec KeyMapTab[] =
+{
+    {CONF_KM_META, "meta"},
+    {CONF_KM_COMPOSE, "compose"},
+    {CONF_KM_MODESHIFT, "modeshift"},
+    {CONF_KM_MODELOCK, "modelock"},
+    {CONF_KM_SCROLLLOCK, "scrolllock"},
+    {CONF_KM_CONTROL, "control"},
+    {-1, ""},
+};
+
+/* Pointer.c */
+
+static const XConfigSymTabRec PointerTab[] =
+{
+    {PROTOCOL, "protocol"},
+    {EMULATE3, "emulate3buttons"},
+    {EM3TIMEOUT, "emulate3timeout"},
+    {ENDSUBSECTION, "endsubsection"},
+    {ENDSECTION, "endsection"},
+    {PDEVICE, "device"},
+    {PDEVICE, "port"},
+    {BAUDRATE, "baudrate"},
+    {SAMPLERATE, "samplerate"},
+    {CLEARDTR, "cleardtr"},
+    {CLEARRTS, "clearrts"},
+    {CHORDMIDDLE, "chordmiddle"},
+    {PRESOLUTION, "resolution"},
+    {DEVICE_NAME, "devicename"},
+    {ALWAYSCORE, "alwayscore"},
+    {PBUTTONS, "buttons"},
+    {ZAXISMAPPING, "zaxismapping"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec ZMapTab[] =
+{
+    {XAXIS, "x"},
+    {YAXIS, "y"},
+    {-1, ""},
+};
+
+/* Input.c */
+
+static const XConfigSymTabRec InputTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {OPTION, "option"},
+    {DRIVER, "driver"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec InputClassTab[] =
+{   {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {MATCHPRODUCT, "matchproduct"},
+    {MATCHVENDOR, "matchvendor"},
+    {MATCHOS, "matchos"},
+    {MATCHDEVICEPATH, "matchdevicepath"},
+    {MATCHPNPID, "matchpnpid"},
+    {MATCHUSBID, "matchusbid"},
+    {MATCHDRIVER, "matchdriver"},
+    {MATCHTAG, "matchtag"},
+    {MATCHISKEYBOARD, "matchiskeyboard"},
+    {MATCHISJOYSTICK, "matchisjoystick"},
+    {MATCHISTABLET, "matchistablet"},
+    {MATCHISTOUCHSCREEN, "matchistouchscreen"},
+    {MATCHISTOUCHPAD, "matchistouchpad"},
+    {MATCHISPOINTER, "matchispointer"},
+    {OPTION, "option"},
+    {DRIVER, "driver"},
+    {-1, ""},
+};
+
+/* Layout.c */
+
+static const XConfigSymTabRec LayoutTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {SCREEN, "screen"},
+    {IDENTIFIER, "identifier"},
+    {INACTIVE, "inactive"},
+    {INPUTDEVICE, "inputdevice"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec AdjTab[] =
+{
+    {RIGHTOF, "rightof"},
+    {LEFTOF, "leftof"},
+    {ABOVE, "above"},
+    {BELOW, "below"},
+    {RELATIVE, "relative"},
+    {ABSOLUTE, "absolute"},
+    {-1, ""},
+};
+
+/* Vendor.c */
+
+static const XConfigSymTabRec VendorSubTab[] =
+{
+    {ENDSUBSECTION, "endsubsection"},
+    {IDENTIFIER, "identifier"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec VendorTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {OPTION, "option"},
+    {SUBSECTION, "subsection"},
+    {-1, ""},
+};
+
+/* Video.c */
+
+static const XConfigSymTabRec VideoPortTab[] =
+{
+    {ENDSUBSECTION, "endsubsection"},
+    {IDENTIFIER, "identifier"},
+    {OPTION, "option"},
+    {-1, ""},
+};
+
+static const XConfigSymTabRec VideoAdaptorTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {IDENTIFIER, "identifier"},
+    {VENDOR, "vendorname"},
+    {BOARD, "boardname"},
+    {BUSID, "busid"},
+    {DRIVER, "driver"},
+    {OPTION, "option"},
+    {SUBSECTION, "subsection"},
+    {-1, ""},
+};
+
+/* DRI.c */
+
+static const XConfigSymTabRec DRITab[] =
+{
+    {ENDSECTION, "endsection"},
+    {GROUP,      "group"},
+    {BUFFERS,    "buffers"},
+    {MODE,       "mode"},
+    {-1,         ""},
+};
+
+/* Extensions.c */
+
+static const XConfigSymTabRec ExtensionsTab[] =
+{
+    {ENDSECTION, "endsection"},
+    {OPTION,     "option"},
+    {-1,         ""},
+};
+
+/* Stream.c */
+
+static const XConfigSymTabRec StreamTab[] =
+{
+    {SECTION,       "section"},
+    {SUBSECTION,    "subsection"},
+    {ENDSECTION,    "endsection"},
+    {ENDSUBSECTION, "endsubsection"},
+    {MODE,          "mode"},
+    {ENDMODE,       "endmode"},
+    {OPTION,        "option"},
+    {-1,            ""},
+};
+
+
+#define KEYWORD_TABLE(tab) { #tab, tab }
+
+static const struct {
+    const char *name;
+    const XConfigSymTabRec *tab;
+} xconfigKeywordTables[] = {
+    KEYWORD_TABLE(TopLevelTab),
+    KEYWORD_TABLE(SectionTab),
+    KEYWORD_TABLE(FilesTab),
+    KEYWORD_TABLE(ServerFlagsTab),
+    KEYWORD_TABLE(SubModuleTab),
+    KEYWORD_TABLE(ModuleTab),
+    KEYWORD_TABLE(MonitorTab),
+    KEYWORD_TABLE(ModesTab),
+    KEYWORD_TABLE(TimingTab),
+    KEYWORD_TABLE(ModeTab),
+    KEYWORD_TABLE(DeviceTab),
+    KEYWORD_TABLE(DisplayTab),
+    KEYWORD_TABLE(ScreenTab),
+    KEYWORD_TABLE(KeyboardTab),
+    KEYWORD_TABLE(KeyMapTab),
+    KEYWORD_TABLE(PointerTab),
+    KEYWORD_TABLE(ZMapTab),
+    KEYWORD_TABLE(InputTab),
+    KEYWORD_TABLE(InputClassTab),
+    KEYWORD_TABLE(LayoutTab),
+    KEYWORD_TABLE(AdjTab),
+    KEYWORD_TABLE(VendorSubTab),
+    KEYWORD_TABLE(VendorTab),
+    KEYWORD_TABLE(VideoPortTab),
+    KEYWORD_TABLE(VideoAdaptorTab),
+    KEYWORD_TABLE(DRITab),
+    KEYWORD_TABLE(ExtensionsTab),
+    KEYWORD_TABLE(StreamTab),
+};
+
+#undef KEYWORD_TABLE
+
+#endif /* _xf86_keywords_h */
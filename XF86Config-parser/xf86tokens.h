@@ -287,7 +287,25 @@ typedef enum {
 
     /* DRI Tokens */
     GROUP,
-    BUFFERS
+    BUFFERS,
+
+    /* Section names */
+    FILES_SECTION,
+    SERVERFLAGS_SECTION,
+    KEYBOARD_SECTION,
+    POINTER_SECTION,
+    VIDEOADAPTOR_SECTION,
+    DEVICE_SECTION,
+    MONITOR_SECTION,
+    MODES_SECTION,
+    SCREEN_SECTION,
+    INPUTDEVICE_SECTION,
+    INPUTCLASS_SECTION,
+    MODULE_SECTION,
+    SERVERLAYOUT_SECTION,
+    VENDOR_SECTION,
+    DRI_SECTION,
+    EXTENSIONS_SECTION
 } ParserTokens;
 
 #endif /* _xf86_tokens_h */
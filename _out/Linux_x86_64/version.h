@@ -0,0 +1 @@
+#define NVIDIA_VERSION "610.57.04"
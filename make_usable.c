@@ -32,16 +32,17 @@
 #include "nvpci-utils.h"
 
 
-static void ensure_module_loaded(XConfigPtr config, char *name);
+static void ensure_module_loaded(XConfigPtr config, const char *name);
 static int update_device(Options *op, XConfigPtr config, XConfigDevicePtr device);
 static void update_depth(Options *op, XConfigScreenPtr screen);
-static void update_display(Options *op, XConfigScreenPtr screen);
+static void update_display(Options *op, XConfigPtr config,
+                           XConfigScreenPtr screen);
 
 /*
  * ensure_module_loaded() - make sure the given module is present
  */
 
-static void ensure_module_loaded(XConfigPtr config, char *name) {
+static void ensure_module_loaded(XConfigPtr config, const char *name) {
     XConfigLoadPtr load;
     int found = FALSE;
 
@@ -50,9 +51,9 @@ static void ensure_module_loaded(XConfigPtr config, char *name) {
     }
 
     if (!found) {
-        xconfigAddNewLoadDirective(&config->modules->loads,
+        xconfigAddNewLoadDirective(config, &config->modules->loads,
                                    name, XCONFIG_LOAD_MODULE,
-                                   NULL, FALSE);
+                                   NULL, NULL);
     }
 } /* ensure_module_loaded */
 
@@ -113,10 +114,10 @@ int update_screen(Options *op, XConfigPtr config, XConfigScreenPtr screen)
                                              screen->device->options);
     screen->device->options = NULL;
     
-    update_display(op, screen);
+    update_display(op, config, screen);
     update_depth(op, screen);
     update_device(op, config, screen->device);
-    update_options(op, screen);
+    update_options(op, config, screen);
     
     return TRUE;
 
@@ -169,7 +170,7 @@ XConfigLayoutPtr get_layout(Options *op, XConfigPtr config)
 
 int update_extensions(Options *op, XConfigPtr config)
 {
-    char *value;
+    const char *value;
 
     /* validate the composite option against any other options specified */
 
@@ -180,11 +181,12 @@ int update_extensions(Options *op, XConfigPtr config)
         /* if we don't already have the Extensions section, create it now */
 
         if (!config->extensions) {
-            config->extensions = calloc(1, sizeof(XConfigExtensionsRec));
+            config->extensions =
+                xconfigArenaAlloc(config, sizeof(XConfigExtensionsRec));
         }
 
         /* remove any existing composite extension option */
-        xconfigRemoveNamedOption(&(config->extensions->options), 
+        xconfigRemoveNamedOption(config, &(config->extensions->options), 
                                  op->gop.compositeExtensionName,
                                  NULL);
 
@@ -196,7 +198,7 @@ int update_extensions(Options *op, XConfigPtr config)
             "Enable" : "Disable";
         
         /* add the option */
-        xconfigAddNewOption(&config->extensions->options, 
+        xconfigAddNewOption(config, &config->extensions->options, 
                             op->gop.compositeExtensionName,
                             value);
     }
@@ -216,20 +218,20 @@ int update_server_flags(Options *op, XConfigPtr config)
     if (!op->handle_special_keys) return TRUE;
 
     if (!config->flags) {
-        config->flags = nvalloc(sizeof(XConfigFlagsRec));
+        config->flags = xconfigArenaAlloc(config, sizeof(XConfigFlagsRec));
         if ( !config->flags ) {
             return FALSE;
         }
     }
 
     if (config->flags->options) {
-        xconfigRemoveNamedOption(&(config->flags->options),
+        xconfigRemoveNamedOption(config, &(config->flags->options),
                                  "HandleSpecialKeys", NULL);
     }
 
     if (op->handle_special_keys != NV_DISABLE_STRING_OPTION) {
-        xconfigAddNewOption(&config->flags->options, "HandleSpecialKeys",
-                            op->handle_special_keys);
+        xconfigAddNewOption(config, &config->flags->options,
+                            "HandleSpecialKeys", op->handle_special_keys);
     }
 
     return TRUE;
@@ -265,6 +267,29 @@ static int count_non_nv_gpus(void)
 
 
 
+/*
+ * set_formatted_busid() - set the device's BusID to the PCI bus id of
+ * the GPU at its index; returns FALSE if that cannot be determined.
+ */
+
+static int set_formatted_busid(Options *op, XConfigPtr config,
+                               XConfigDevicePtr device)
+{
+    char *busid = nv_format_busid(op, device->index_id);
+
+    if (busid == NULL) {
+        return FALSE;
+    }
+
+    device->busid = xconfigIntern(config, busid);
+    nvfree(busid);
+
+    return TRUE;
+
+} /* set_formatted_busid() */
+
+
+
 /*
  * update_device() - update the device; there is a lot of information
  * in the device that is not relevant to the NVIDIA X driver.  In
@@ -276,7 +301,8 @@ static int count_non_nv_gpus(void)
 
 static int update_device(Options *op, XConfigPtr config, XConfigDevicePtr device)
 {
-    char *identifier, *vendor, *comment, *board, *busid, *driver;
+    const char *identifier, *vendor, *board, *busid, *driver;
+    char *comment;
     int screen;
     size_t index_id;
     XConfigDevicePtr next;
@@ -316,14 +342,13 @@ static int update_device(Options *op, XConfigPtr config, XConfigDevicePtr device
 
     if (GET_BOOL_OPTION(op->boolean_option_values, ENABLE_PRIME_OPTION) &&
         op->busid == NULL) {
-        device->busid = nv_format_busid(op, device->index_id);
-        if (device->busid == NULL) {
+        if (!set_formatted_busid(op, config, device)) {
             return FALSE;
     }
     } else if (op->busid == NV_DISABLE_STRING_OPTION) {
         device->busid = NULL;
     } else if (op->busid) {
-        device->busid = op->busid;
+        device->busid = xconfigIntern(config, op->busid);
     } else if (GET_BOOL_OPTION(op->boolean_options,
                                PRESERVE_BUSID_BOOL_OPTION)) {
         if (GET_BOOL_OPTION(op->boolean_option_values,
@@ -336,8 +361,7 @@ static int update_device(Options *op, XConfigPtr config, XConfigDevicePtr device
         /* enable_separate_x_screens() already generated a busid string */
         device->busid = busid;
     } else if (count_non_nv_gpus() > 0) {
-        device->busid = nv_format_busid(op, device->index_id);
-        if (device->busid == NULL) {
+        if (!set_formatted_busid(op, config, device)) {
             return FALSE;
         }
     }
@@ -349,7 +373,7 @@ static int update_device(Options *op, XConfigPtr config, XConfigDevicePtr device
     if (op->preserve_driver) {
         device->driver = driver;
     } else {
-        device->driver = "nvidia";
+        device->driver = xconfigIntern(config, "nvidia");
     }
     
     return TRUE;
@@ -412,16 +436,17 @@ static void update_depth(Options *op, XConfigScreenPtr screen)
  * update_display() - if there are no display subsections, create one
  */
 
-static void update_display(Options *op, XConfigScreenPtr screen)
+static void update_display(Options *op, XConfigPtr config,
+                           XConfigScreenPtr screen)
 {
     
     if (!screen->displays) {
         XConfigDisplayPtr display;
         XConfigModePtr mode = NULL;
         
-        xconfigAddMode(&mode, "nvidia-auto-select");
+        xconfigAddMode(config, &mode, "nvidia-auto-select");
         
-        display = nvalloc(sizeof(XConfigDisplayRec));
+        display = xconfigArenaAlloc(config, sizeof(XConfigDisplayRec));
         display->depth = screen->defaultdepth;
         display->modes = mode;
         display->frameX0 = -1;
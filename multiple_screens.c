@@ -34,9 +34,12 @@ static int enable_separate_x_screens(Options *op, XConfigPtr config,
 static int disable_separate_x_screens(Options *op, XConfigPtr config,
                                       XConfigLayoutPtr layout);
 
-static XConfigDisplayPtr clone_display_list(XConfigDisplayPtr display0);
-static XConfigDevicePtr clone_device(XConfigDevicePtr device0, int idx);
-static XConfigScreenPtr clone_screen(XConfigScreenPtr screen0, int idx);
+static XConfigDisplayPtr clone_display_list(XConfigPtr config,
+                                            XConfigDisplayPtr display0);
+static XConfigDevicePtr clone_device(XConfigPtr config,
+                                     XConfigDevicePtr device0, int idx);
+static XConfigScreenPtr clone_screen(XConfigPtr config,
+                                     XConfigScreenPtr screen0, int idx);
 
 static void create_adjacencies(Options *op, XConfigPtr config,
                                XConfigLayoutPtr layout);
@@ -217,8 +220,6 @@ static void clean_screen_list(XConfigScreenPtr *screen_list,
             }
             
             if ((bus[i] == bus0) && (slot[i] == slot0)) {
-                XConfigScreenPtr next;
-
                 if (prev) {
                     prev->next = screen->next;
                 }
@@ -226,10 +227,7 @@ static void clean_screen_list(XConfigScreenPtr *screen_list,
                     config->screens = screen->next;
                 }
 
-                next = screen->next;
-                screen->next = NULL;
-                xconfigFreeScreenList(&screen);
-                screen = next;
+                screen = screen->next;
             }
             else {
                 
@@ -276,6 +274,10 @@ int apply_multi_screen_options(Options *op, XConfigPtr config,
     if (op->only_one_screen) {
         if (!only_one_screen(op, config, layout)) return FALSE;
     }
+
+    /* the screen, device and monitor lists were edited in place */
+
+    xconfigInvalidateIndexes(config);
     
     return TRUE;
     
@@ -587,6 +589,7 @@ static int enable_separate_x_screens(Options *op, XConfigPtr config,
     
     if (!have_busids) {
         DevicesPtr pDevices;
+        char *busid;
         
         pDevices = find_devices(op);
         if (!pDevices) {
@@ -606,9 +609,12 @@ static int enable_separate_x_screens(Options *op, XConfigPtr config,
                 continue;
             }
             
-            screenlist[i]->device->busid = nv_format_busid(op, i);
+            busid = nv_format_busid(op, i);
+            screenlist[i]->device->busid = xconfigIntern(config, busid);
+            nvfree(busid);
 
-            screenlist[i]->device->board = nvstrdup(pDevices->devices[i].name);
+            screenlist[i]->device->board =
+                xconfigIntern(config, pDevices->devices[i].name);
         }
 
         free_devices(pDevices);
@@ -626,7 +632,7 @@ static int enable_separate_x_screens(Options *op, XConfigPtr config,
         if (!screenlist[i]) continue;
 
         while (--screens_to_clone[i] > 0) {
-            clone_screen(screenlist[i], screens_to_clone[i]);
+            clone_screen(config, screenlist[i], screens_to_clone[i]);
         }
     }
 
@@ -634,7 +640,7 @@ static int enable_separate_x_screens(Options *op, XConfigPtr config,
     
     /* step 6: wipe the existing adjacencies and recreate them */
     
-    xconfigFreeAdjacencyList(&layout->adjacencies);
+    layout->adjacencies = NULL;
     
     create_adjacencies(op, config, layout);
 
@@ -723,7 +729,7 @@ static int disable_separate_x_screens(Options *op, XConfigPtr config,
     
     /* step 4: wipe the existing adjacencies and recreate them */
     
-    xconfigFreeAdjacencyList(&layout->adjacencies);
+    layout->adjacencies = NULL;
     
     create_adjacencies(op, config, layout);
 
@@ -746,16 +752,16 @@ static int disable_separate_x_screens(Options *op, XConfigPtr config,
  * subsection.
  */
 
-static XConfigDisplayPtr clone_display_list(XConfigDisplayPtr display0)
+static XConfigDisplayPtr clone_display_list(XConfigPtr config,
+                                            XConfigDisplayPtr display0)
 {
     XConfigDisplayPtr d = NULL, prev = NULL, head = NULL;
     
     while (display0) {
-        d = nvalloc(sizeof(XConfigDisplayRec));
+        d = xconfigArenaAlloc(config, sizeof(XConfigDisplayRec));
         memcpy(d, display0, sizeof(XConfigDisplayRec));
-        if (display0->visual) d->visual = nvstrdup(display0->visual);
-        if (display0->comment) d->comment = nvstrdup(display0->comment);
-        d->options = xconfigOptionListDup(display0->options);
+        d->comment = xconfigArenaStrdup(config, display0->comment);
+        d->options = xconfigOptionListDup(config, display0->options);
         d->next = NULL;
         if (prev) prev->next = d;
         if (!head) head = d;
@@ -774,22 +780,26 @@ static XConfigDisplayPtr clone_display_list(XConfigDisplayPtr display0)
  * the screen indices as approprate for multiple X screens on one GPU
  */
 
-static XConfigDevicePtr clone_device(XConfigDevicePtr device0, int idx)
+static XConfigDevicePtr clone_device(XConfigPtr config,
+                                     XConfigDevicePtr device0, int idx)
 {
     XConfigDevicePtr device;
+    char *identifier;
 
-    device = nvalloc(sizeof(XConfigDeviceRec));
+    device = xconfigArenaAlloc(config, sizeof(XConfigDeviceRec));
     
-    device->identifier = nvasprintf("%s (%d)", device0->identifier, idx);
+    identifier = nvasprintf("%s (%d)", device0->identifier, idx);
+    device->identifier = xconfigIntern(config, identifier);
+    nvfree(identifier);
     
-    if (device0->vendor)  device->vendor  = nvstrdup(device0->vendor);
-    if (device0->board)   device->board   = nvstrdup(device0->board);
-    if (device0->chipset) device->chipset = nvstrdup(device0->chipset);
-    if (device0->busid)   device->busid   = nvstrdup(device0->busid);
-    if (device0->card)    device->card    = nvstrdup(device0->card);
-    if (device0->driver)  device->driver  = nvstrdup(device0->driver);
-    if (device0->ramdac)  device->ramdac  = nvstrdup(device0->ramdac);
-    if (device0->comment) device->comment = nvstrdup(device0->comment);
+    device->vendor  = device0->vendor;
+    device->board   = device0->board;
+    device->chipset = device0->chipset;
+    device->busid   = device0->busid;
+    device->card    = device0->card;
+    device->driver  = device0->driver;
+    device->ramdac  = device0->ramdac;
+    device->comment = xconfigArenaStrdup(config, device0->comment);
 
     /* these are needed for multiple X screens on one GPU */
 
@@ -800,7 +810,7 @@ static XConfigDevicePtr clone_device(XConfigDevicePtr device0, int idx)
     device->chiprev = -1;
     device->irq = -1;
 
-    device->options = xconfigOptionListDup(device0->options);
+    device->options = xconfigOptionListDup(config, device0->options);
     
     /* insert the new device after the original device */
     
@@ -818,24 +828,29 @@ static XConfigDevicePtr clone_device(XConfigDevicePtr device0, int idx)
  * X screen on one GPU
  */
 
-static XConfigScreenPtr clone_screen(XConfigScreenPtr screen0, int idx)
+static XConfigScreenPtr clone_screen(XConfigPtr config,
+                                     XConfigScreenPtr screen0, int idx)
 {
-    XConfigScreenPtr screen = nvalloc(sizeof(XConfigScreenRec));
+    XConfigScreenPtr screen =
+        xconfigArenaAlloc(config, sizeof(XConfigScreenRec));
+    char *identifier;
     
-    screen->identifier = nvasprintf("%s (%d)", screen0->identifier, idx);
+    identifier = nvasprintf("%s (%d)", screen0->identifier, idx);
+    screen->identifier = xconfigIntern(config, identifier);
+    nvfree(identifier);
     
-    screen->device = clone_device(screen0->device, idx);
-    screen->device_name = nvstrdup(screen->device->identifier);
+    screen->device = clone_device(config, screen0->device, idx);
+    screen->device_name = screen->device->identifier;
     
     screen->monitor = screen0->monitor;
-    screen->monitor_name = nvstrdup(screen0->monitor_name);
+    screen->monitor_name = screen0->monitor_name;
     
     screen->defaultdepth = screen0->defaultdepth;
     
-    screen->displays = clone_display_list(screen0->displays);
+    screen->displays = clone_display_list(config, screen0->displays);
     
-    screen->options = xconfigOptionListDup(screen0->options);
-    if (screen0->comment) screen->comment = nvstrdup(screen0->comment);
+    screen->options = xconfigOptionListDup(config, screen0->options);
+    screen->comment = xconfigArenaStrdup(config, screen0->comment);
 
     /* insert the new screen after the original screen */
 
@@ -866,10 +881,10 @@ static void create_adjacencies(Options *op, XConfigPtr config,
     
     for (screen = config->screens; screen; screen = screen->next) {
         
-        adj = nvalloc(sizeof(XConfigAdjacencyRec));
+        adj = xconfigArenaAlloc(config, sizeof(XConfigAdjacencyRec));
         
         adj->scrnum = i;
-        adj->screen_name = nvstrdup(screen->identifier);
+        adj->screen_name = screen->identifier;
         adj->screen = screen;
         
         if (prev_adj) {
@@ -909,12 +924,12 @@ static int enable_all_gpus(Options *op, XConfigPtr config,
         return FALSE;
     }
     
-    /* free all existing X screens, monitors, devices, and adjacencies */
+    /* drop all existing X screens, monitors, devices, and adjacencies */
     
-    xconfigFreeScreenList(&config->screens);
-    xconfigFreeDeviceList(&config->devices);
-    xconfigFreeMonitorList(&config->monitors);
-    xconfigFreeAdjacencyList(&layout->adjacencies);
+    config->screens = NULL;
+    config->devices = NULL;
+    config->monitors = NULL;
+    layout->adjacencies = NULL;
 
     /* add N new screens; this will also add device and monitor sections */
     
@@ -945,7 +960,7 @@ static int enable_all_gpus(Options *op, XConfigPtr config,
 
 static void free_unused_devices(Options *op, XConfigPtr config)
 {
-    XConfigDevicePtr device, prev, next;
+    XConfigDevicePtr device, prev;
     XConfigScreenPtr screen;
     int found;
 
@@ -970,10 +985,7 @@ static void free_unused_devices(Options *op, XConfigPtr config)
             } else {
                 config->devices = device->next;
             }
-            next = device->next;
-            device->next = NULL;
-            xconfigFreeDeviceList(&device);
-            device = next;
+            device = device->next;
         } else {
             prev = device;
             device = device->next;
@@ -989,7 +1001,7 @@ static void free_unused_devices(Options *op, XConfigPtr config)
 
 static void free_unused_monitors(Options *op, XConfigPtr config)
 {
-    XConfigMonitorPtr monitor, prev, next;
+    XConfigMonitorPtr monitor, prev;
     XConfigScreenPtr screen;
     int found;
 
@@ -1014,10 +1026,7 @@ static void free_unused_monitors(Options *op, XConfigPtr config)
             } else {
                 config->monitors = monitor->next;
             }
-            next = monitor->next;
-            monitor->next = NULL;
-            xconfigFreeMonitorList(&monitor);
-            monitor = next;
+            monitor = monitor->next;
         } else {
             prev = monitor;
             monitor = monitor->next;
@@ -1036,13 +1045,13 @@ static int only_one_screen(Options *op, XConfigPtr config,
 {
     if (!config->screens) return FALSE;
     
-    /* free all existing X screens after the first */
+    /* drop all existing X screens after the first */
     
-    xconfigFreeScreenList(&config->screens->next);
+    config->screens->next = NULL;
     
-    /* free all adjacencies */
+    /* drop all adjacencies */
     
-    xconfigFreeAdjacencyList(&layout->adjacencies);
+    layout->adjacencies = NULL;
     
     /* add new adjacency */
     
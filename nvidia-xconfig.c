@@ -203,36 +203,20 @@ static void parse_commandline(Options *op, int argc, char *argv[])
             break;
 
         case HANDLE_SPECIAL_KEYS_OPTION:
-            {
-                const char *valid_values[] = {
-                    "Always",
-                    "Never",
-                    "WhenNeeded",
-                    NULL,
-                };
-
-                int i;
-
-                if (disable) {
-                    op->handle_special_keys = NV_DISABLE_STRING_OPTION;
-                    break;
-                }
 
-                for (i = 0; valid_values[i]; i++) {
-                    if (!strcasecmp(strval, valid_values[i])) {
-                        break;
-                    }
-                }
-
-                if (valid_values[i]) {
-                    op->handle_special_keys = strval;
-                } else {
-                    fprintf(stderr, "Invalid HandleSpecialKeys option: %s.\n", strval);
-                    goto fail;
-                }
+            if (disable) {
+                op->handle_special_keys = NV_DISABLE_STRING_OPTION;
                 break;
             }
 
+            if (!check_option_value("HandleSpecialKeys", strval)) {
+                fprintf(stderr, "Invalid HandleSpecialKeys option: %s.\n", strval);
+                goto fail;
+            }
+
+            op->handle_special_keys = strval;
+            break;
+
         case TRANSPARENT_INDEX_OPTION:
 
             /* mark as disabled, so we can remove the option later */
@@ -355,6 +339,7 @@ static void parse_commandline(Options *op, int argc, char *argv[])
             break;
 
         case PRESERVE_DRIVER_NAME_OPTION: op->preserve_driver = TRUE; break;
+        case PRESERVE_FORMATTING_OPTION: op->preserve_formatting = TRUE; break;
         
         case DISABLE_SCF_OPTION: op->disable_scf = TRUE; break;
         
@@ -368,41 +353,27 @@ static void parse_commandline(Options *op, int argc, char *argv[])
             op->extract_edids_output_file = strval;
             break;
 
+        case PARSE_CACHE_OPTION: op->parse_cache = strval; break;
+
         case NVIDIA_XINERAMA_INFO_ORDER_OPTION:
             op->nvidia_xinerama_info_order =
                 disable ? NV_DISABLE_STRING_OPTION : strval;
             break;
 
         case METAMODE_ORIENTATION_OPTION:
-            {
-                const char* valid_values[] = {
-                    "RightOf",
-                    "LeftOf",
-                    "Above",
-                    "Below",
-                    "Clone",
-                    NULL
-                };
-                int i;
 
-                if (disable) {
-                    op->metamode_orientation = NV_DISABLE_STRING_OPTION;
-                    break;
-                }
-                
-                for (i = 0; valid_values[i]; i++) {
-                    if (!strcasecmp(strval, valid_values[i]))
-                        break;
-                }
+            if (disable) {
+                op->metamode_orientation = NV_DISABLE_STRING_OPTION;
+                break;
+            }
 
-                if (!valid_values[i]) {
-                    fprintf(stderr, "Invalid MetaModeOrientation option: "
-                            "\"%s\".\n", strval);
-                    goto fail;
-                }
-                
-                op->metamode_orientation = strval;
+            if (!check_option_value("MetaModeOrientation", strval)) {
+                fprintf(stderr, "Invalid MetaModeOrientation option: "
+                        "\"%s\".\n", strval);
+                goto fail;
             }
+
+            op->metamode_orientation = strval;
             break;
 
         case VIRTUAL_OPTION:
@@ -447,10 +418,18 @@ static void parse_commandline(Options *op, int argc, char *argv[])
             break;
 
         case COLOR_SPACE_OPTION:
+            if (!disable && !check_option_value("ColorSpace", strval)) {
+                fprintf(stderr, "Invalid ColorSpace option: %s.\n", strval);
+                goto fail;
+            }
             op->color_space = disable ? NV_DISABLE_STRING_OPTION : strval;
             break;
 
         case COLOR_RANGE_OPTION:
+            if (!disable && !check_option_value("ColorRange", strval)) {
+                fprintf(stderr, "Invalid ColorRange option: %s.\n", strval);
+                goto fail;
+            }
             op->color_range = disable ? NV_DISABLE_STRING_OPTION : strval;
             break;
 
@@ -529,6 +508,7 @@ static void parse_commandline(Options *op, int argc, char *argv[])
     
     op->xconfig = tilde_expansion(op->xconfig);
     op->output_xconfig = tilde_expansion(op->output_xconfig);
+    op->parse_cache = tilde_expansion(op->parse_cache);
 
     return;
     
@@ -641,7 +621,7 @@ static int backup_file(Options *op, const char *orig_filename,
  *
  * 2) config->filename
  *
- * 3) use xf86openConfigFile()
+ * 3) use xconfigFindConfigFile()
  */
 
 static char *find_xconfig(Options *op, XConfigPtr config)
@@ -660,16 +640,12 @@ static char *find_xconfig(Options *op, XConfigPtr config)
         filename = nvstrdup(config->filename);
     }
     
-    /* use xf86openConfigFile() */
+    /* use xconfigFindConfigFile() */
     
     if (!filename) {
-        const char *f;
-        f = xconfigOpenConfigFile(NULL, op->gop.x_project_root);
+        const char *f = xconfigFindConfigFile(NULL, op->gop.x_project_root);
         if (f) {
-            /* dup the string since closing the config file will free
-               the string */
             filename = nvstrdup(f);
-            xconfigCloseConfigFile();
         }
     }
 
@@ -772,7 +748,7 @@ static int write_xconfig(Options *op, XConfigPtr config, int first_touch)
 {
     char *filename = find_xconfig(op, config);
     char *d, *tmp = NULL;
-    int ret = FALSE;
+    int ret = FALSE, written;
 
     /*
      * XXX it's strange that lack of permission to write to the target
@@ -819,7 +795,13 @@ static int write_xconfig(Options *op, XConfigPtr config, int first_touch)
     
     /* write the config file */
 
-    if (!xconfigWriteConfigFile(filename, config)) {
+    if (op->preserve_formatting) {
+        written = xconfigPatchConfigFile(filename, config);
+    } else {
+        written = xconfigWriteConfigFile(filename, config);
+    }
+
+    if (!written) {
         nv_error_msg("Unable to write file \"%s\"; please use the "
                      "\"--output-xconfig\" commandline option to specify "
                      "an alternative output file.", filename);
@@ -909,7 +891,7 @@ static void update_banner(XConfigPtr config)
     static const char *prefix =
         "# nvidia-xconfig: ";
 
-    char *s = config->comment;
+    char *s = nvstrdup(config->comment);
     char *line, *eol, *tmp;
     
     /* remove all lines that begin with the prefix */
@@ -942,8 +924,10 @@ static void update_banner(XConfigPtr config)
     
     /* add our prefix lines at the start of the comment */
     
-    config->comment = nvstrcat(prefix, banner, "# " NV_ID_STRING "\n", s, NULL);
+    tmp = nvstrcat(prefix, banner, "# " NV_ID_STRING "\n", s, NULL);
+    config->comment = xconfigArenaStrdup(config, tmp);
     
+    free(tmp);
     if (s) free(s);
     
 } /* update_banner() */
@@ -958,32 +942,57 @@ static void update_banner(XConfigPtr config)
 static XConfigPtr find_system_xconfig(Options *op)
 {
     const char *filename;
+    XConfigParserPtr parser;
     XConfigPtr config;
     XConfigError error;
 
     /* Find and open the existing X config file */
     
-    filename = xconfigOpenConfigFile(op->xconfig, op->gop.x_project_root);
+    parser = xconfigAllocParser();
+    filename = xconfigOpenConfigFile(parser, op->xconfig,
+                                     op->gop.x_project_root);
+
+    /*
+     * when only printing the tree, don't bother parsing the sections
+     * that it does not show
+     */
+
+    if (op->tree) {
+        xconfigSetDeferredSections(parser, XCONFIG_DEFER_FILES |
+                                           XCONFIG_DEFER_MODULE |
+                                           XCONFIG_DEFER_VENDOR |
+                                           XCONFIG_DEFER_INPUTCLASS |
+                                           XCONFIG_DEFER_DRI);
+    }
+
+    xconfigSetSourceTracking(parser, op->preserve_formatting);
+    xconfigSetOptionRegistry(parser, get_option_registry());
     
     if (filename) {
         nv_info_msg(NULL, "");
         nv_info_msg(NULL, "Using X configuration file: \"%s\".", filename);
     } else {
         nv_warning_msg("Unable to locate/open X configuration file.");
+        xconfigFreeParser(&parser);
         return NULL;
     }
     
     /* Read the opened X config file */
     
-    error = xconfigReadConfigFile(&config);
+    if (op->parse_cache) {
+        error = xconfigReadConfigFileCached(parser, op->parse_cache,
+                                            &config);
+    } else {
+        error = xconfigReadConfigFile(parser, &config);
+    }
     if (error != XCONFIG_RETURN_SUCCESS) {
-        xconfigCloseConfigFile();
+        xconfigFreeParser(&parser);
         return NULL;;
     }
 
     /* Close the X config file */
     
-    xconfigCloseConfigFile();
+    xconfigFreeParser(&parser);
     
     /* Sanitize the X config file */
     
@@ -1040,7 +1049,7 @@ static int apply_enable_external_gpu_option(Options *op, XConfigPtr config,
                                ENABLE_EXTERNAL_GPU_BOOL_OPTION);
 
     if (GET_BOOL_OPTION(op->boolean_options, ENABLE_EXTERNAL_GPU_BOOL_OPTION)) {
-        xconfigAddNewOption(&(layout->options),
+        xconfigAddNewOption(config, &(layout->options),
                             "AllowExternalGpus",
                             (egpu ? "1" : "0"));
 
@@ -1270,7 +1279,8 @@ int main(int argc, char *argv[])
      * config file, remove it.
      */
 
-    xconfigRemoveNamedOption(&(config->layouts->options), "Xinerama", NULL);
+    xconfigRemoveNamedOption(config, &(config->layouts->options), "Xinerama",
+                             NULL);
 
     /* now, we have a good config; apply whatever the user requested */
     
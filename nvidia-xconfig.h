@@ -105,6 +105,7 @@ typedef struct __options {
     int disable_scf;
     int query_gpu_info;
     int preserve_driver;
+    int preserve_formatting;
     int restore_original_backup;
     
     /*
@@ -127,6 +128,7 @@ typedef struct __options {
 
     char *xconfig;
     char *output_xconfig;
+    char *parse_cache;
     char *layout;
     char *screen;
     char *device;
@@ -222,7 +224,9 @@ int print_tree(Options *op, XConfigPtr config);
 int check_boolean_option(Options *op, const int c, const int boolval);
 void set_boolean_option(Options *op, const int c, const int boolval);
 void validate_composite(Options *op, XConfigPtr config);
-void update_options(Options *op, XConfigScreenPtr screen);
+void update_options(Options *op, XConfigPtr config, XConfigScreenPtr screen);
+XConfigOptionRegistryPtr get_option_registry(void);
+int check_option_value(const char *name, const char *val);
 
 /* lscf.c */
 int update_scf_depth(int depth);
@@ -57,6 +57,8 @@ enum {
     FORCE_COMPOSITION_PIPELINE_OPTION,
     FORCE_FULL_COMPOSITION_PIPELINE_OPTION,
     ALLOW_HMD_OPTION,
+    PARSE_CACHE_OPTION,
+    PRESERVE_FORMATTING_OPTION,
 };
 
 /*
@@ -249,6 +251,13 @@ static const NVGetoptOption __options[] = {
       "for all configured X screens; this option preserves the existing driver "
       "name of each X screen." },
 
+    { "preserve-formatting", PRESERVE_FORMATTING_OPTION, 0, NULL,
+      "When updating an existing X configuration file, only rewrite the "
+      "sections that nvidia-xconfig changes.  Other sections are written "
+      "out exactly as they were, in their original order and with their "
+      "original formatting and comments.  New sections are added at the "
+      "end of the file." },
+
     { "egpu", XCONFIG_BOOL_VAL(ENABLE_EXTERNAL_GPU_BOOL_OPTION), NVGETOPT_IS_BOOLEAN, NULL,
       "Enable or disable the \"AllowExternalGpus\" X configuration option." },
 
@@ -415,6 +424,14 @@ static const NVGetoptOption __options[] = {
       "Pixel to use as transparent when using color index overlays.  "
       "Valid values for &TRANSPARENT-INDEX& are 0-255."},
 
+    { "parse-cache", PARSE_CACHE_OPTION, NVGETOPT_STRING_ARGUMENT, "FILE",
+      "Use &FILE& as a cache of the parsed X configuration file.  When the "
+      "X configuration file has not changed since the cache was written, "
+      "it is loaded from the cache instead of being parsed and validated "
+      "again.  The cache is rewritten whenever it is out of date.  It is "
+      "not used with '--preserve-formatting', which needs the text of the "
+      "file." },
+
     { "post-tree", 'T', 0, NULL,
       "Like the '--tree' option, but goes through the full process of "
       "applying any user requested updates to the X configuration, before "
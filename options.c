@@ -91,6 +91,99 @@ static const NvidiaXConfigOption *get_option(const int n)
     
 } /* get_option() */
 
+
+
+/*
+ * the types of the values of the NVIDIA X config options that
+ * nvidia-xconfig sets; the options in __options[] are added to these
+ * as booleans by get_option_registry(), except those listed here,
+ * which also take values other than booleans
+ */
+
+static const char * const __handle_special_keys_values[] = {
+    "Always", "Never", "WhenNeeded", NULL
+};
+
+static const char * const __metamode_orientation_values[] = {
+    "RightOf", "LeftOf", "Above", "Below", "Clone", NULL
+};
+
+static const char * const __color_space_values[] = {
+    "RGB", "YCbCr444", NULL
+};
+
+static const char * const __color_range_values[] = {
+    "Full", "Limited", NULL
+};
+
+static const XConfigOptionTypeRec __option_types[] = {
+    { "UseEdidDpi",          XCONFIG_OPTION_STRING,  NULL },
+    { "IncludeImplicitMetaModes", XCONFIG_OPTION_STRING, NULL },
+    { "Coolbits",            XCONFIG_OPTION_INTEGER, NULL },
+    { "Stereo",              XCONFIG_OPTION_INTEGER, NULL },
+    { "TransparentIndex",    XCONFIG_OPTION_INTEGER, NULL },
+    { "3DVisionDisplayType", XCONFIG_OPTION_INTEGER, NULL },
+    { "HandleSpecialKeys",   XCONFIG_OPTION_ENUM,
+      __handle_special_keys_values },
+    { "MetaModeOrientation", XCONFIG_OPTION_ENUM,
+      __metamode_orientation_values },
+    { "ColorSpace",          XCONFIG_OPTION_ENUM, __color_space_values },
+    { "ColorRange",          XCONFIG_OPTION_ENUM, __color_range_values },
+    { NULL,                  XCONFIG_OPTION_STRING, NULL },
+};
+
+
+
+/*
+ * get_option_registry() - get the registry of the types of the option
+ * values nvidia-xconfig knows, which is built the first time it is
+ * needed; configs read with it keep their values of these options
+ * parsed, rather than as text only.
+ */
+
+XConfigOptionRegistryPtr get_option_registry(void)
+{
+    static XConfigOptionRegistryPtr registry = NULL;
+    XConfigOptionTypeRec *types;
+    int i, n, m;
+
+    if (registry) return registry;
+
+    for (n = 0; __options[n].name; n++);
+    for (m = 0; __option_types[m].name; m++);
+
+    types = nvalloc((n + m + 1) * sizeof(XConfigOptionTypeRec));
+
+    /* the first entry of a name counts, so __option_types[] go first */
+
+    memcpy(types, __option_types, m * sizeof(XConfigOptionTypeRec));
+    for (i = 0; i < n; i++) {
+        types[m + i].name = __options[i].name;
+        types[m + i].type = XCONFIG_OPTION_BOOLEAN;
+    }
+
+    registry = xconfigAllocOptionRegistry(types);
+    nvfree(types);
+
+    return registry;
+
+} /* get_option_registry() */
+
+
+
+/*
+ * check_option_value() - check that 'val' is a valid value for the X
+ * config option 'name'; any value is valid for an option whose type
+ * nvidia-xconfig does not know.
+ */
+
+int check_option_value(const char *name, const char *val)
+{
+    return xconfigParseOptionValue(
+               xconfigFindOptionType(get_option_registry(), name), val, NULL);
+
+} /* check_option_value() */
+
 /*
  * check_boolean_option() - verify the boolean option 'c' can be
  * applied given other set options.
@@ -246,22 +339,23 @@ void validate_composite(Options *op, XConfigPtr config)
  * precedence is Display, Screen, Monitor, Device.
  */
 
-static void remove_option(XConfigScreenPtr screen, const char *name)
+static void remove_option(XConfigPtr config, XConfigScreenPtr screen,
+                          const char *name)
 {
     XConfigDisplayPtr display;
 
     if (!screen) return;
 
     if (screen->device) {
-        xconfigRemoveNamedOption(&screen->device->options, name, NULL);
+        xconfigRemoveNamedOption(config, &screen->device->options, name, NULL);
     }
     if (screen->monitor) {
-        xconfigRemoveNamedOption(&screen->monitor->options, name, NULL);
+        xconfigRemoveNamedOption(config, &screen->monitor->options, name, NULL);
     }
-    xconfigRemoveNamedOption(&screen->options, name, NULL);
+    xconfigRemoveNamedOption(config, &screen->options, name, NULL);
     
     for (display = screen->displays; display; display = display->next) {
-        xconfigRemoveNamedOption(&display->options, name, NULL);
+        xconfigRemoveNamedOption(config, &display->options, name, NULL);
     }
 } /* remove_option() */
 
@@ -307,17 +401,17 @@ static XConfigOptionPtr get_screen_option(XConfigScreenPtr screen,
  * set_option_value() - set the given option to the specified value
  */
 
-static void set_option_value(XConfigScreenPtr screen,
+static void set_option_value(XConfigPtr config, XConfigScreenPtr screen,
                              const char *name, const char *val)
 {
     /* first, remove the option to make sure it doesn't exist
        elsewhere */
 
-    remove_option(screen, name);
+    remove_option(config, screen, name);
 
     /* then, add the option to the screen's option list */
 
-    xconfigAddNewOption(&screen->options, name, val);
+    xconfigAddNewOption(config, &screen->options, name, val);
 
 } /* set_option_value() */
 
@@ -398,11 +492,12 @@ static char *find_metamode_offset(char *string, char **end)
  * offsets appear in the MetaModes string, return FALSE.
  */
 
-static int remove_metamode_offsets(XConfigScreenPtr screen,
+static int remove_metamode_offsets(XConfigPtr config,
+                                   XConfigScreenPtr screen,
                                    char **old_metamodes, char **new_metamodes)
 {
     char *start, *end = NULL;
-    char *new_string;
+    char *old_string, *new_string;
     char *n, *o, *tmp;
 
     XConfigOptionPtr opt = get_screen_option(screen, "MetaModes");
@@ -413,7 +508,12 @@ static int remove_metamode_offsets(XConfigScreenPtr screen,
 
     /* return if no explicit offsets in the MetaModes option */
 
-    if (!find_metamode_offset(opt->val, NULL)) return FALSE;
+    old_string = nvstrdup(opt->val);
+
+    if (!find_metamode_offset(old_string, NULL)) {
+        nvfree(old_string);
+        return FALSE;
+    }
 
     if (old_metamodes) *old_metamodes = nvstrdup(opt->val);
 
@@ -424,7 +524,7 @@ static int remove_metamode_offsets(XConfigScreenPtr screen,
 
     new_string = nvstrdup(opt->val);
 
-    o = start = opt->val;
+    o = start = old_string;
     n = new_string;
 
     while (1) {
@@ -442,9 +542,10 @@ static int remove_metamode_offsets(XConfigScreenPtr screen,
         o = start = end;
     }
 
-    nvfree(opt->val);
+    opt->val = xconfigIntern(config, new_string);
 
-    opt->val = new_string;
+    nvfree(old_string);
+    nvfree(new_string);
 
     if (new_metamodes) *new_metamodes = nvstrdup(opt->val);
 
@@ -458,7 +559,8 @@ static int remove_metamode_offsets(XConfigScreenPtr screen,
  * update_display_options() - update the Display SubSection options
  */
 
-static void update_display_options(Options *op, XConfigScreenPtr screen)
+static void update_display_options(Options *op, XConfigPtr config,
+                                   XConfigScreenPtr screen)
 {
     XConfigDisplayPtr display;
     int i;
@@ -485,12 +587,11 @@ static void update_display_options(Options *op, XConfigScreenPtr screen)
             xconfigRemoveMode(&display->modes, op->remove_modes.t[i]);
         }
         for (i = 0; i < op->add_modes.n; i++) {
-            xconfigAddMode(&display->modes, op->add_modes.t[i]);
+            xconfigAddMode(config, &display->modes, op->add_modes.t[i]);
         }
         if (op->add_modes_list.n) {
             int mode_list_size = op->add_modes_list.n;
 
-            xconfigFreeModeList(&display->modes);
             display->modes = NULL;
 
             /*
@@ -499,7 +600,7 @@ static void update_display_options(Options *op, XConfigScreenPtr screen)
              */
 
             for (i = 0; i < op->add_modes_list.n; i++) {
-                xconfigAddMode(&display->modes,
+                xconfigAddMode(config, &display->modes,
                                op->add_modes_list.t[mode_list_size-i-1]);
             }
         }
@@ -521,11 +622,11 @@ static void update_display_options(Options *op, XConfigScreenPtr screen)
  * command line arguments.
  */
 
-void update_options(Options *op, XConfigScreenPtr screen)
+void update_options(Options *op, XConfigPtr config, XConfigScreenPtr screen)
 {
     int i;
     const NvidiaXConfigOption *o;
-    char *val;
+    const char *val;
     char scratch[8];
 
     /* update any boolean options specified on the commandline */
@@ -558,7 +659,7 @@ void update_options(Options *op, XConfigScreenPtr screen)
                 val = o->invert ? "True" : "False";
             }
             
-            set_option_value(screen, o->name, val);
+            set_option_value(config, screen, o->name, val);
             nv_info_msg(NULL, "Option \"%s\" \"%s\" added to Screen \"%s\".",
                         o->name, val, screen->identifier);
         }
@@ -566,61 +667,62 @@ void update_options(Options *op, XConfigScreenPtr screen)
 
     /* update the Display SubSection options */
     
-    update_display_options(op, screen);
+    update_display_options(op, config, screen);
 
     /* add the transparent index option */
     
     if (op->transparent_index != -1) {
-        remove_option(screen, "transparentindex");
+        remove_option(config, screen, "transparentindex");
         if (op->transparent_index != -2) {
             snprintf(scratch, 8, "%d", op->transparent_index);
-            set_option_value(screen, "TransparentIndex", scratch);
+            set_option_value(config, screen, "TransparentIndex", scratch);
         }
     }
 
     /* add the stereo option */
     
     if (op->stereo != -1) {
-        remove_option(screen, "stereo");
+        remove_option(config, screen, "stereo");
         if (op->stereo != -2) {
             snprintf(scratch, 8, "%d", op->stereo);
-            set_option_value(screen, "Stereo", scratch);
+            set_option_value(config, screen, "Stereo", scratch);
         }
     }
 
     /* add the SLI option */
 
     if (op->sli) {
-        remove_option(screen, "SLI");
+        remove_option(config, screen, "SLI");
         if (op->sli != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "SLI", op->sli);
+            set_option_value(config, screen, "SLI", op->sli);
         }
     }
 
     /* add the metamodes option */
 
     if (op->metamodes_str) {
-        remove_option(screen, "MetaModes");
+        remove_option(config, screen, "MetaModes");
         if (op->metamodes_str != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "MetaModes", op->metamodes_str);
+            set_option_value(config, screen, "MetaModes", op->metamodes_str);
         }
     }
 
     /* add acpid socket path option*/
  
     if (op->acpid_socket_path) {
-        remove_option(screen, "AcpidSocketPath");
+        remove_option(config, screen, "AcpidSocketPath");
         if (op->acpid_socket_path != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "AcpidSocketPath", op->acpid_socket_path);
+            set_option_value(config, screen, "AcpidSocketPath",
+                             op->acpid_socket_path);
         }
     }
 
     /* add the nvidia xinerama info order option */
 
     if (op->nvidia_xinerama_info_order) {
-        remove_option(screen, "nvidiaXineramaInfoOrder");
+        remove_option(config, screen, "nvidiaXineramaInfoOrder");
         if (op->nvidia_xinerama_info_order != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "nvidiaXineramaInfoOrder",
+            set_option_value(config, screen, "nvidiaXineramaInfoOrder",
                              op->nvidia_xinerama_info_order);
         }
     }
@@ -628,12 +730,12 @@ void update_options(Options *op, XConfigScreenPtr screen)
     /* add the metamode orientation option */
     
     if (op->metamode_orientation) {
-        remove_option(screen, "MetaModeOrientation");
+        remove_option(config, screen, "MetaModeOrientation");
         if (op->metamode_orientation != NV_DISABLE_STRING_OPTION) {
             char *old_metamodes, *new_metamodes;
-            set_option_value(screen, "MetaModeOrientation",
+            set_option_value(config, screen, "MetaModeOrientation",
                              op->metamode_orientation);
-            if (remove_metamode_offsets(screen,
+            if (remove_metamode_offsets(config, screen,
                                         &old_metamodes, &new_metamodes)) {
                 nv_warning_msg("The MetaModes option contained explicit offsets, "
                                "which would have overridden the specified "
@@ -652,9 +754,9 @@ void update_options(Options *op, XConfigScreenPtr screen)
     /* add the UseDisplayDevice option */
  
     if (op->use_display_device) {
-        remove_option(screen, "UseDisplayDevice");
+        remove_option(config, screen, "UseDisplayDevice");
         if (op->use_display_device != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "UseDisplayDevice",
+            set_option_value(config, screen, "UseDisplayDevice",
                              op->use_display_device);
         }
     }
@@ -662,96 +764,100 @@ void update_options(Options *op, XConfigScreenPtr screen)
     /* add the CustomEDID option */
 
     if (op->custom_edid) {
-        remove_option(screen, "CustomEDID");
+        remove_option(config, screen, "CustomEDID");
         if (op->custom_edid != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "CustomEDID", op->custom_edid);
+            set_option_value(config, screen, "CustomEDID", op->custom_edid);
         }
     }
 
     /* add the Coolbits option */
 
     if (op->cool_bits != -1) {
-        remove_option(screen, "Coolbits");
+        remove_option(config, screen, "Coolbits");
         if (op->cool_bits != -2) {
             snprintf(scratch, 8, "%d", op->cool_bits);
-            set_option_value(screen, "Coolbits", scratch);
+            set_option_value(config, screen, "Coolbits", scratch);
         }
     }
 
     /* add the ConnectedMonitor option */
 
     if (op->connected_monitor) {
-        remove_option(screen, "ConnectedMonitor");
+        remove_option(config, screen, "ConnectedMonitor");
         if (op->connected_monitor != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "ConnectedMonitor", op->connected_monitor);
+            set_option_value(config, screen, "ConnectedMonitor",
+                             op->connected_monitor);
         }
     }
 
     if (op->registry_dwords) {
-        remove_option(screen, "RegistryDwords");
+        remove_option(config, screen, "RegistryDwords");
         if (op->registry_dwords != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "RegistryDwords", op->registry_dwords);
+            set_option_value(config, screen, "RegistryDwords",
+                             op->registry_dwords);
         }
     }
 
     /* add the ColorSpace option */
 
     if (op->color_space) {
-        remove_option(screen, "ColorSpace");
+        remove_option(config, screen, "ColorSpace");
         if (op->color_space != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "ColorSpace", op->color_space);
+            set_option_value(config, screen, "ColorSpace", op->color_space);
         }
     }
 
     if (op->color_range) {
-        remove_option(screen, "ColorRange");
+        remove_option(config, screen, "ColorRange");
         if (op->color_range != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "ColorRange", op->color_range);
+            set_option_value(config, screen, "ColorRange", op->color_range);
         }
     }
 
     /* add the flatpanel properties option */
 
     if (op->flatpanel_properties) {
-        remove_option(screen, "FlatPanelProperties");
+        remove_option(config, screen, "FlatPanelProperties");
         if (op->flatpanel_properties != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "FlatPanelProperties",
+            set_option_value(config, screen, "FlatPanelProperties",
                              op->flatpanel_properties);
         }
     }
 
     /* add the 3DVisionUSBPath option */
     if (op->nvidia_3dvision_usb_path) {
-        remove_option(screen, "3DVisionUSBPath");
+        remove_option(config, screen, "3DVisionUSBPath");
         if (op->nvidia_3dvision_usb_path != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "3DVisionUSBPath", op->nvidia_3dvision_usb_path);
+            set_option_value(config, screen, "3DVisionUSBPath",
+                             op->nvidia_3dvision_usb_path);
         }
     }
 
     /* add the 3DVisionProConfigFile option */
     if (op->nvidia_3dvisionpro_config_file) {
-        remove_option(screen, "3DVisionProConfigFile");
+        remove_option(config, screen, "3DVisionProConfigFile");
         if (op->nvidia_3dvisionpro_config_file != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "3DVisionProConfigFile", op->nvidia_3dvisionpro_config_file);
+            set_option_value(config, screen, "3DVisionProConfigFile",
+                             op->nvidia_3dvisionpro_config_file);
         }
     }
 
     /* add the 3DVisionDisplayType option */
 
     if (op->nvidia_3dvision_display_type != -1) {
-        remove_option(screen, "3DVisionDisplayType");
+        remove_option(config, screen, "3DVisionDisplayType");
         if (op->nvidia_3dvision_display_type != -2) {
             snprintf(scratch, 8, "%d", op->nvidia_3dvision_display_type);
-            set_option_value(screen, "3DVisionDisplayType", scratch);
+            set_option_value(config, screen, "3DVisionDisplayType", scratch);
         }
     }
 
     /* add the ForceCompositionPipeline option */
 
     if (op->force_composition_pipeline) {
-        remove_option(screen, "ForceCompositionPipeline");
+        remove_option(config, screen, "ForceCompositionPipeline");
         if (op->force_composition_pipeline != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "ForceCompositionPipeline",
+            set_option_value(config, screen, "ForceCompositionPipeline",
                              op->force_composition_pipeline);
         }
     }
@@ -759,9 +865,9 @@ void update_options(Options *op, XConfigScreenPtr screen)
     /* add the ForceFullCompositionPipeline option */
 
     if (op->force_full_composition_pipeline) {
-        remove_option(screen, "ForceFullCompositionPipeline");
+        remove_option(config, screen, "ForceFullCompositionPipeline");
         if (op->force_full_composition_pipeline != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "ForceFullCompositionPipeline",
+            set_option_value(config, screen, "ForceFullCompositionPipeline",
                              op->force_full_composition_pipeline);
         }
     }
@@ -769,9 +875,9 @@ void update_options(Options *op, XConfigScreenPtr screen)
     /* add the AllowHMD option */
 
     if (op->allow_hmd) {
-        remove_option(screen, "AllowHMD");
+        remove_option(config, screen, "AllowHMD");
         if (op->allow_hmd != NV_DISABLE_STRING_OPTION) {
-            set_option_value(screen, "AllowHMD", op->allow_hmd);
+            set_option_value(config, screen, "AllowHMD", op->allow_hmd);
         }
     }
 